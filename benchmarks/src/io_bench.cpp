@@ -0,0 +1,201 @@
+#include <benchmark/benchmark.h>
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/core/sparse_matrix_builder.hpp>
+#include <sparse_linalg/core/matrix_ops.hpp>
+#include <sparse_linalg/io/binary_format.hpp>
+#include <sparse_linalg/io/matrix_market.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <span>
+#include <vector>
+
+using namespace sparse_linalg;
+
+namespace {
+
+// Random matrix with about 10 nonzeros per row, as triplets so the
+// builder path pays for assembly but not for generation
+std::vector<Triplet<double>> make_triplets(std::size_t rows) {
+    std::vector<Triplet<double>> triplets;
+    triplets.reserve(rows * 10);
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<std::size_t> col_dist(0, rows - 1);
+    std::uniform_real_distribution<double> val_dist(1.0, 2.0);
+    for (std::size_t i = 0; i < rows; ++i) {
+        for (std::size_t k = 0; k < 10; ++k) {
+            triplets.push_back({i, col_dist(gen), val_dist(gen)});
+        }
+    }
+    return triplets;
+}
+
+SparseMatrix<double> build(std::size_t rows, std::span<const Triplet<double>> triplets) {
+    SparseMatrixBuilder<double> builder(rows, rows);
+    builder.add(triplets);
+    return builder.build();
+}
+
+// Binary file of the benchmark matrix, written once per size
+const std::filesystem::path& binary_file(std::size_t rows) {
+    static std::size_t written_rows = 0;
+    static const auto path = std::filesystem::temp_directory_path() / "sparse_linalg_io_bench.bin";
+    if (written_rows != rows) {
+        const auto triplets = make_triplets(rows);
+        io::write_binary(build(rows, triplets), path);
+        written_rows = rows;
+    }
+    return path;
+}
+
+// Matrix Market text of the same matrix
+const std::filesystem::path& text_file(std::size_t rows) {
+    static std::size_t written_rows = 0;
+    static const auto path = std::filesystem::temp_directory_path() / "sparse_linalg_io_bench.mtx";
+    if (written_rows != rows) {
+        const auto triplets = make_triplets(rows);
+        io::write_matrix_market(build(rows, triplets), path);
+        written_rows = rows;
+    }
+    return path;
+}
+
+void report_bytes(benchmark::State& state, std::size_t rows) {
+    state.SetBytesProcessed(static_cast<std::int64_t>(
+        static_cast<std::size_t>(state.iterations()) * std::filesystem::file_size(binary_file(rows))));
+}
+
+} // anonymous namespace
+
+// Baseline: assembling CSR from triplets already in memory
+void BM_BuildFromTriplets(benchmark::State& state) {
+    const auto rows = static_cast<std::size_t>(state.range(0));
+    const auto triplets = make_triplets(rows);
+    for (auto _ : state) {
+        auto matrix = build(rows, triplets);
+        benchmark::DoNotOptimize(matrix);
+    }
+    report_bytes(state, rows);
+}
+
+BENCHMARK(BM_BuildFromTriplets)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+void BM_WriteBinary(benchmark::State& state) {
+    const auto rows = static_cast<std::size_t>(state.range(0));
+    const auto triplets = make_triplets(rows);
+    const auto matrix = build(rows, triplets);
+    const auto path = std::filesystem::temp_directory_path() / "sparse_linalg_io_bench_write.bin";
+    for (auto _ : state) {
+        io::write_binary(matrix, path);
+    }
+    std::filesystem::remove(path);
+    report_bytes(state, rows);
+}
+
+BENCHMARK(BM_WriteBinary)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+// Owning copy out of the page cache
+void BM_ReadBinary(benchmark::State& state) {
+    const auto rows = static_cast<std::size_t>(state.range(0));
+    const auto& path = binary_file(rows);
+    for (auto _ : state) {
+        auto matrix = io::read_binary<double>(path);
+        benchmark::DoNotOptimize(matrix);
+    }
+    report_bytes(state, rows);
+}
+
+BENCHMARK(BM_ReadBinary)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+// Zero-copy open. Argument: 1 = verify the structure, 0 = trusted file.
+void BM_MapBinary(benchmark::State& state) {
+    const auto rows = static_cast<std::size_t>(state.range(0));
+    const auto& path = binary_file(rows);
+    io::MapOptions options;
+    options.verify = state.range(1) != 0;
+    for (auto _ : state) {
+        auto view = io::map_binary<double>(path, options);
+        benchmark::DoNotOptimize(view);
+    }
+    report_bytes(state, rows);
+}
+
+BENCHMARK(BM_MapBinary)
+    ->Args({1'000'000, 0})
+    ->Args({1'000'000, 1})
+    ->Unit(benchmark::kMillisecond);
+
+// Open and one SpMV straight from the mapping
+void BM_MapAndMultiply(benchmark::State& state) {
+    const auto rows = static_cast<std::size_t>(state.range(0));
+    const auto& path = binary_file(rows);
+    const std::vector<double> x(rows, 1.0);
+    std::vector<double> y(rows);
+    io::MapOptions options;
+    options.verify = false;
+    for (auto _ : state) {
+        const auto view = io::map_binary<double>(path, options);
+        MatrixOps<double>::multiply(view, std::span<const double>(x), std::span<double>(y));
+        benchmark::DoNotOptimize(y.data());
+    }
+    report_bytes(state, rows);
+}
+
+BENCHMARK(BM_MapAndMultiply)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+// Argument 1: 0 = sequential, otherwise a pool of that many threads.
+// Argument 2: 1 = streaming (two passes, no staged triplets).
+void BM_ReadMatrixMarket(benchmark::State& state) {
+    const auto rows = static_cast<std::size_t>(state.range(0));
+    const auto threads = static_cast<std::size_t>(state.range(1));
+    const auto& path = text_file(rows);
+    io::MatrixMarketOptions options;
+    options.streaming = state.range(2) != 0;
+    std::unique_ptr<execution::ThreadPool> pool;
+    if (threads > 0) {
+        pool = std::make_unique<execution::ThreadPool>(threads);
+    }
+    for (auto _ : state) {
+        auto matrix = pool ? io::read_matrix_market<double>(path, *pool, options)
+                           : io::read_matrix_market<double>(path, options);
+        benchmark::DoNotOptimize(matrix);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(
+        static_cast<std::size_t>(state.iterations()) * std::filesystem::file_size(path)));
+}
+
+BENCHMARK(BM_ReadMatrixMarket)
+    ->Args({1'000'000, 0, 0})
+    ->Args({1'000'000, 0, 1})
+    ->Args({1'000'000, 4, 0})
+    ->Args({1'000'000, 4, 1})
+    ->Unit(benchmark::kMillisecond);
+
+// Argument 1: 0 = sequential, otherwise a pool of that many threads
+void BM_WriteMatrixMarket(benchmark::State& state) {
+    const auto rows = static_cast<std::size_t>(state.range(0));
+    const auto threads = static_cast<std::size_t>(state.range(1));
+    const auto triplets = make_triplets(rows);
+    const auto matrix = build(rows, triplets);
+    const auto path = std::filesystem::temp_directory_path() / "sparse_linalg_io_bench_write.mtx";
+    std::unique_ptr<execution::ThreadPool> pool;
+    if (threads > 0) {
+        pool = std::make_unique<execution::ThreadPool>(threads);
+    }
+    for (auto _ : state) {
+        if (pool) {
+            io::write_matrix_market(matrix, path, *pool);
+        } else {
+            io::write_matrix_market(matrix, path);
+        }
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(
+        static_cast<std::size_t>(state.iterations()) * std::filesystem::file_size(path)));
+    std::filesystem::remove(path);
+}
+
+BENCHMARK(BM_WriteMatrixMarket)
+    ->Args({1'000'000, 0})
+    ->Args({1'000'000, 4})
+    ->Unit(benchmark::kMillisecond);
@@ -1,11 +1,22 @@
 #include <benchmark/benchmark.h>
 #include <sparse_linalg/core/sparse_matrix.hpp>
 #include <sparse_linalg/core/matrix_ops.hpp>
+#include <sparse_linalg/core/dense_block.hpp>
+#include <sparse_linalg/core/spgemm.hpp>
+#include <sparse_linalg/core/sparse_matrix_builder.hpp>
+#include <sparse_linalg/core/sell_matrix.hpp>
+#include <sparse_linalg/core/block_sparse_matrix.hpp>
+#include <sparse_linalg/core/mixed_precision_matrix.hpp>
 #include <sparse_linalg/execution/thread_pool.hpp>
+#include "roofline.hpp"
 #include <random>
 #include <memory>
+#include <span>
+#include <type_traits>
 
 using namespace sparse_linalg;
+using bench::report_roofline;
+using bench::spmv_traffic;
 
 namespace {
 
@@ -42,12 +53,14 @@ private:
     
     void TearDownImpl([[maybe_unused]] const benchmark::State& state) {
         matrix_ = SparseMatrix<T>{0, 0};
+        sell_.reset();
         vector_.clear();
         pool_.reset();
     }
     
     static SparseMatrix<T> create_random_matrix(std::size_t size, std::size_t nnz_per_row) {
-        SparseMatrix<T> matrix(size, size);
+        SparseMatrixBuilder<T> builder(size, size);
+        builder.reserve(size * nnz_per_row);
         std::mt19937 gen(42);
         std::uniform_int_distribution<std::size_t> col_dist(0, size - 1);
         std::uniform_real_distribution<T> val_dist(1.0, 2.0);
@@ -60,11 +73,11 @@ private:
                 std::size_t col = col_dist(gen);
                 if (std::find(cols.begin(), cols.end(), col) == cols.end()) {
                     cols.push_back(col);
-                    matrix.insert(i, col, val_dist(gen));
+                    builder.add(i, col, val_dist(gen));
                 }
             }
         }
-        return matrix;
+        return builder.build();
     }
     
     static std::vector<T> create_random_vector(std::size_t size) {
@@ -76,11 +89,74 @@ private:
     }
     
 protected:    
+    // SELL-C-sigma copy of matrix_, built on first use so CSR-only
+    // benchmarks do not pay for the conversion
+    const SellMatrix<T>& sell() {
+        if (!sell_) {
+            sell_ = std::make_unique<SellMatrix<T>>(matrix_);
+        }
+        return *sell_;
+    }
+
     SparseMatrix<T> matrix_{0, 0};
+    std::unique_ptr<SellMatrix<T>> sell_;
     std::vector<T> vector_;
     std::unique_ptr<execution::ThreadPool> pool_;
 };
 
+// Row kernel used before hardware gathers: vec entries are copied through a
+// stack buffer and summed into a single accumulator
+template<typename T>
+std::vector<T> multiply_scalar_gather(const SparseMatrix<T>& matrix, std::span<const T> vec) {
+    std::vector<T> result(matrix.rows(), T{});
+    
+    for (std::size_t row = 0; row < matrix.rows(); ++row) {
+        auto values = matrix.row_values(row);
+        auto indices = matrix.row_indices(row);
+        T sum{};
+        std::size_t i = 0;
+        
+        if constexpr (execution::SimdTraits<T>::is_vectorizable) {
+            using Simd = execution::SimdTraits<T>;
+            constexpr std::size_t vec_size = Simd::vector_size;
+            auto acc = Simd::set_zero();
+            
+            for (; i + vec_size <= values.size(); i += vec_size) {
+                T gathered_data[vec_size];
+                for (std::size_t j = 0; j < vec_size; ++j) {
+                    gathered_data[j] = vec[indices[i + j]];
+                }
+                acc = Simd::add(acc, Simd::multiply(Simd::load(&values[i]), Simd::load(gathered_data)));
+            }
+            sum = Simd::reduce_sum(acc);
+        }
+        
+        for (; i < values.size(); ++i) {
+            sum += values[i] * vec[indices[i]];
+        }
+        result[row] = sum;
+    }
+    
+    return result;
+}
+
+// Power-law row lengths: row i holds about size / (i + 1) nonzeros, so a few
+// leading rows dominate the work
+SparseMatrix<double> create_skewed_matrix(std::size_t size) {
+    SparseMatrixBuilder<double> builder(size, size);
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<std::size_t> col_dist(0, size - 1);
+    std::uniform_real_distribution<double> val_dist(1.0, 2.0);
+    
+    for (std::size_t i = 0; i < size; ++i) {
+        const std::size_t row_nnz = std::max<std::size_t>(size / (i + 1), 2);
+        for (std::size_t k = 0; k < row_nnz; ++k) {
+            builder.add(i, col_dist(gen), val_dist(gen));
+        }
+    }
+    return builder.build();
+}
+
 } // anonymous namespace
 
 BENCHMARK_TEMPLATE_DEFINE_F(BenchmarkFixture, Sequential, double)
@@ -90,16 +166,7 @@ BENCHMARK_TEMPLATE_DEFINE_F(BenchmarkFixture, Sequential, double)
         benchmark::DoNotOptimize(result);
     }
     
-    const auto iterations = static_cast<std::uint64_t>(state.iterations());
-    const auto nnz = static_cast<std::uint64_t>(matrix_.nnz());
-    state.SetItemsProcessed(static_cast<std::int64_t>(iterations * nnz));
-    
-    const auto bytes = iterations * nnz * 
-        (static_cast<std::uint64_t>(sizeof(double)) + 
-         static_cast<std::uint64_t>(sizeof(std::size_t)));
-    state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
-
-    state.SetComplexityN(static_cast<benchmark::ComplexityN>(nnz));
+    report_roofline(state, spmv_traffic(matrix_));
 }
 
 BENCHMARK_TEMPLATE_DEFINE_F(BenchmarkFixture, Parallel, double)
@@ -109,18 +176,93 @@ BENCHMARK_TEMPLATE_DEFINE_F(BenchmarkFixture, Parallel, double)
         benchmark::DoNotOptimize(result);
     }
     
-    const auto iterations = static_cast<std::uint64_t>(state.iterations());
-    const auto nnz = static_cast<std::uint64_t>(matrix_.nnz());
-    state.SetItemsProcessed(static_cast<std::int64_t>(iterations * nnz));
+    report_roofline(state, spmv_traffic(matrix_), pool_.get());
+}
+
+// In-place variants reuse one output buffer; the gap to Sequential/Parallel
+// is the per-call allocation and zero-fill of the result vector
+BENCHMARK_TEMPLATE_DEFINE_F(BenchmarkFixture, SequentialInPlace, double)
+(benchmark::State& state) {
+    std::vector<double> result(matrix_.rows());
+    for (auto _ : state) {
+        MatrixOps<double>::multiply(matrix_, vector_, result);
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    
+    report_roofline(state, spmv_traffic(matrix_));
+}
+
+BENCHMARK_TEMPLATE_DEFINE_F(BenchmarkFixture, ParallelInPlace, double)
+(benchmark::State& state) {
+    std::vector<double> result(matrix_.rows());
+    for (auto _ : state) {
+        MatrixOps<double>::multiply_parallel(matrix_, vector_, result, *pool_);
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    
+    report_roofline(state, spmv_traffic(matrix_), pool_.get());
+}
+
+// y = A * x + y: the beta != 0 path has to read the output as well
+BENCHMARK_TEMPLATE_DEFINE_F(BenchmarkFixture, SequentialAccumulate, double)
+(benchmark::State& state) {
+    std::vector<double> result(matrix_.rows(), 0.0);
+    for (auto _ : state) {
+        MatrixOps<double>::multiply(matrix_, vector_, result, 1.0, 1.0);
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    
+    report_roofline(state, spmv_traffic(matrix_, 1, true));
+}
+
+// Same products from the SELL-C-sigma copy, comparable to the InPlace runs
+BENCHMARK_TEMPLATE_DEFINE_F(BenchmarkFixture, SellSequential, double)
+(benchmark::State& state) {
+    const auto& sell = this->sell();
+    std::vector<double> result(matrix_.rows());
+    for (auto _ : state) {
+        MatrixOps<double>::multiply(sell, std::span<const double>(vector_), std::span<double>(result));
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    
+    report_roofline(state, spmv_traffic(sell));
+}
+
+BENCHMARK_TEMPLATE_DEFINE_F(BenchmarkFixture, SellParallel, double)
+(benchmark::State& state) {
+    const auto& sell = this->sell();
+    std::vector<double> result(matrix_.rows());
+    for (auto _ : state) {
+        MatrixOps<double>::multiply_parallel(sell, std::span<const double>(vector_), std::span<double>(result), *pool_);
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
     
-    const auto bytes = iterations * nnz * 
-        (static_cast<std::uint64_t>(sizeof(double)) + 
-         static_cast<std::uint64_t>(sizeof(std::size_t)));
-    state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+    report_roofline(state, spmv_traffic(sell), pool_.get());
+}
 
-    state.SetComplexityN(static_cast<benchmark::ComplexityN>(nnz));
+BENCHMARK_TEMPLATE_DEFINE_F(BenchmarkFixture, ScalarGather, double)
+(benchmark::State& state) {
+    for (auto _ : state) {
+        auto result = multiply_scalar_gather<double>(matrix_, vector_);
+        benchmark::DoNotOptimize(result);
+    }
+    
+    report_roofline(state, spmv_traffic(matrix_));
 }
 
+BENCHMARK_REGISTER_F(BenchmarkFixture, ScalarGather)
+    ->Args({1000, 1})
+    ->Args({1000, 5})
+    ->Args({5000, 1})
+    ->Args({5000, 5})
+    ->Complexity(benchmark::oN)
+    ->Unit(benchmark::kMicrosecond);
+
 BENCHMARK_REGISTER_F(BenchmarkFixture, Sequential)
     ->Args({1000, 1})   // 1000x1000 matrix with 1% density
     ->Args({1000, 5})   // 1000x1000 matrix with 5% density
@@ -138,4 +280,430 @@ BENCHMARK_REGISTER_F(BenchmarkFixture, Parallel)
     ->Unit(benchmark::kMicrosecond)
     ->UseRealTime();
 
+BENCHMARK_REGISTER_F(BenchmarkFixture, SequentialInPlace)
+    ->Args({1000, 1})
+    ->Args({1000, 5})
+    ->Args({5000, 1})
+    ->Args({5000, 5})
+    ->Complexity(benchmark::oN)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_REGISTER_F(BenchmarkFixture, SequentialAccumulate)
+    ->Args({1000, 1})
+    ->Args({5000, 1})
+    ->Complexity(benchmark::oN)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_REGISTER_F(BenchmarkFixture, SellSequential)
+    ->Args({1000, 1})
+    ->Args({1000, 5})
+    ->Args({5000, 1})
+    ->Args({5000, 5})
+    ->Complexity(benchmark::oN)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_REGISTER_F(BenchmarkFixture, SellParallel)
+    ->Args({1000, 1})
+    ->Args({1000, 5})
+    ->Args({5000, 1})
+    ->Args({5000, 5})
+    ->Complexity(benchmark::oN)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+BENCHMARK_REGISTER_F(BenchmarkFixture, ParallelInPlace)
+    ->Args({1000, 1})
+    ->Args({1000, 5})
+    ->Args({5000, 1})
+    ->Args({5000, 5})
+    ->Complexity(benchmark::oN)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+// Arguments: matrix size, density (%), number of right-hand sides k.
+// Block multiply streams the CSR arrays once for all k vectors; the
+// baseline below repeats a full SpMV per vector.
+BENCHMARK_TEMPLATE_DEFINE_F(BenchmarkFixture, BlockMultiply, double)
+(benchmark::State& state) {
+    const auto k = static_cast<std::size_t>(state.range(2));
+    const std::size_t n = matrix_.cols();
+    std::vector<double> x_data(n * k);
+    for (std::size_t i = 0; i < x_data.size(); ++i) {
+        x_data[i] = vector_[i % n];
+    }
+    std::vector<double> y_data(matrix_.rows() * k);
+    DenseBlockView<const double> x(std::span<const double>(x_data), n, k);
+    DenseBlockView<double> y(y_data, matrix_.rows(), k);
+    
+    for (auto _ : state) {
+        MatrixOps<double>::multiply(matrix_, x, y);
+        benchmark::DoNotOptimize(y_data.data());
+        benchmark::ClobberMemory();
+    }
+    
+    report_roofline(state, spmv_traffic(matrix_, k));
+}
+
+BENCHMARK_TEMPLATE_DEFINE_F(BenchmarkFixture, BlockMultiplyParallel, double)
+(benchmark::State& state) {
+    const auto k = static_cast<std::size_t>(state.range(2));
+    const std::size_t n = matrix_.cols();
+    std::vector<double> x_data(n * k);
+    for (std::size_t i = 0; i < x_data.size(); ++i) {
+        x_data[i] = vector_[i % n];
+    }
+    std::vector<double> y_data(matrix_.rows() * k);
+    DenseBlockView<const double> x(std::span<const double>(x_data), n, k);
+    DenseBlockView<double> y(y_data, matrix_.rows(), k);
+    
+    for (auto _ : state) {
+        MatrixOps<double>::multiply_parallel(matrix_, x, y, *pool_);
+        benchmark::DoNotOptimize(y_data.data());
+        benchmark::ClobberMemory();
+    }
+    
+    report_roofline(state, spmv_traffic(matrix_, k), pool_.get());
+}
+
+BENCHMARK_TEMPLATE_DEFINE_F(BenchmarkFixture, RepeatedSpMV, double)
+(benchmark::State& state) {
+    const auto k = static_cast<std::size_t>(state.range(2));
+    std::vector<double> result(matrix_.rows());
+    
+    for (auto _ : state) {
+        for (std::size_t c = 0; c < k; ++c) {
+            MatrixOps<double>::multiply(matrix_, vector_, result);
+            benchmark::DoNotOptimize(result.data());
+        }
+        benchmark::ClobberMemory();
+    }
+    
+    report_roofline(state, spmv_traffic(matrix_).repeated(k));
+}
+
+BENCHMARK_REGISTER_F(BenchmarkFixture, BlockMultiply)
+    ->Args({5000, 1, 8})
+    ->Args({5000, 1, 16})
+    ->Args({5000, 1, 32})
+    ->Args({5000, 1, 64})
+    ->Args({5000, 1, 24})  // no fixed-k kernel
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_REGISTER_F(BenchmarkFixture, BlockMultiplyParallel)
+    ->Args({5000, 1, 8})
+    ->Args({5000, 1, 64})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+BENCHMARK_REGISTER_F(BenchmarkFixture, RepeatedSpMV)
+    ->Args({5000, 1, 8})
+    ->Args({5000, 1, 16})
+    ->Args({5000, 1, 32})
+    ->Args({5000, 1, 64})
+    ->Unit(benchmark::kMicrosecond);
+
+// A * A: symbolic and numeric phases together, then the numeric phase alone
+// as in a Galerkin setup where only the values change
+BENCHMARK_TEMPLATE_DEFINE_F(BenchmarkFixture, SpGEMM, double)
+(benchmark::State& state) {
+    for (auto _ : state) {
+        auto product = MatrixOps<double>::multiply(matrix_, matrix_);
+        benchmark::DoNotOptimize(product);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(matrix_.nnz()));
+}
+
+BENCHMARK_TEMPLATE_DEFINE_F(BenchmarkFixture, SpGEMMNumeric, double)
+(benchmark::State& state) {
+    SparseProduct<double> product(matrix_, matrix_);
+    auto result = product.compute(matrix_, matrix_);
+    for (auto _ : state) {
+        product.recompute(matrix_, matrix_, result);
+        benchmark::DoNotOptimize(result.values().data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(matrix_.nnz()));
+}
+
+BENCHMARK_TEMPLATE_DEFINE_F(BenchmarkFixture, SpGEMMParallel, double)
+(benchmark::State& state) {
+    for (auto _ : state) {
+        auto product = MatrixOps<double>::multiply_parallel(matrix_, matrix_, *pool_);
+        benchmark::DoNotOptimize(product);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(matrix_.nnz()));
+}
+
+BENCHMARK_REGISTER_F(BenchmarkFixture, SpGEMM)
+    ->Args({1000, 1})
+    ->Args({5000, 1})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_REGISTER_F(BenchmarkFixture, SpGEMMNumeric)
+    ->Args({1000, 1})
+    ->Args({5000, 1})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_REGISTER_F(BenchmarkFixture, SpGEMMParallel)
+    ->Args({1000, 1})
+    ->Args({5000, 1})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// A^T x three ways: materialize the transpose and run a normal SpMV, or
+// scatter from the CSR rows through per-thread buffers or atomic adds
+BENCHMARK_TEMPLATE_DEFINE_F(BenchmarkFixture, Transpose, double)
+(benchmark::State& state) {
+    for (auto _ : state) {
+        auto transposed = MatrixOps<double>::transpose(matrix_, *pool_);
+        benchmark::DoNotOptimize(transposed);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(matrix_.nnz()));
+}
+
+BENCHMARK_TEMPLATE_DEFINE_F(BenchmarkFixture, TransposeThenMultiply, double)
+(benchmark::State& state) {
+    std::vector<double> result(matrix_.cols());
+    for (auto _ : state) {
+        auto transposed = MatrixOps<double>::transpose(matrix_, *pool_);
+        MatrixOps<double>::multiply_parallel(transposed, vector_, result, *pool_);
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    report_roofline(state, spmv_traffic(matrix_), pool_.get());
+}
+
+BENCHMARK_TEMPLATE_DEFINE_F(BenchmarkFixture, PretransposedMultiply, double)
+(benchmark::State& state) {
+    const auto transposed = MatrixOps<double>::transpose(matrix_);
+    std::vector<double> result(matrix_.cols());
+    for (auto _ : state) {
+        MatrixOps<double>::multiply_parallel(transposed, vector_, result, *pool_);
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    report_roofline(state, spmv_traffic(matrix_), pool_.get());
+}
+
+BENCHMARK_TEMPLATE_DEFINE_F(BenchmarkFixture, MultiplyTransposeBuffers, double)
+(benchmark::State& state) {
+    std::vector<double> result(matrix_.cols());
+    for (auto _ : state) {
+        MatrixOps<double>::multiply_transpose_parallel(matrix_, vector_, result, *pool_, 1.0, 0.0,
+                                                       TransposeScatter::private_buffers);
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    report_roofline(state, spmv_traffic(matrix_), pool_.get());
+}
+
+BENCHMARK_TEMPLATE_DEFINE_F(BenchmarkFixture, MultiplyTransposeAtomics, double)
+(benchmark::State& state) {
+    std::vector<double> result(matrix_.cols());
+    for (auto _ : state) {
+        MatrixOps<double>::multiply_transpose_parallel(matrix_, vector_, result, *pool_, 1.0, 0.0,
+                                                       TransposeScatter::atomics);
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    report_roofline(state, spmv_traffic(matrix_), pool_.get());
+}
+
+BENCHMARK_REGISTER_F(BenchmarkFixture, Transpose)
+    ->Args({1000, 1})
+    ->Args({5000, 1})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+BENCHMARK_REGISTER_F(BenchmarkFixture, TransposeThenMultiply)
+    ->Args({1000, 1})
+    ->Args({5000, 1})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+BENCHMARK_REGISTER_F(BenchmarkFixture, PretransposedMultiply)
+    ->Args({1000, 1})
+    ->Args({5000, 1})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+BENCHMARK_REGISTER_F(BenchmarkFixture, MultiplyTransposeBuffers)
+    ->Args({1000, 1})
+    ->Args({5000, 1})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+BENCHMARK_REGISTER_F(BenchmarkFixture, MultiplyTransposeAtomics)
+    ->Args({1000, 1})
+    ->Args({5000, 1})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+// Arguments: matrix size, PartitionStrategy
+void BM_ParallelSkewed(benchmark::State& state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const auto strategy = static_cast<PartitionStrategy>(state.range(1));
+    const auto matrix = create_skewed_matrix(size);
+    const std::vector<double> vec(size, 1.0);
+    execution::ThreadPool pool;
+    
+    for (auto _ : state) {
+        auto result = MatrixOps<double>::multiply_parallel(matrix, vec, pool, strategy);
+        benchmark::DoNotOptimize(result);
+    }
+    
+    report_roofline(state, spmv_traffic(matrix), &pool);
+}
+
+BENCHMARK(BM_ParallelSkewed)
+    ->Args({20000, static_cast<int>(PartitionStrategy::rows)})
+    ->Args({20000, static_cast<int>(PartitionStrategy::nnz)})
+    ->Args({20000, static_cast<int>(PartitionStrategy::merge_path)})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+// Short irregular rows (5 to 30 nonzeros, banded around the diagonal) are
+// where CSR row kernels spend most of their time in remainder loops and
+// horizontal sums. Arguments: rows, 0 = CSR, 1 = SELL-C-sigma.
+void BM_ShortRows(benchmark::State& state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    SparseMatrixBuilder<double> builder(size, size);
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<std::size_t> length_dist(5, 30);
+    std::uniform_int_distribution<std::size_t> offset_dist(0, 999);
+    std::uniform_real_distribution<double> val_dist(1.0, 2.0);
+    for (std::size_t i = 0; i < size; ++i) {
+        const std::size_t row_nnz = length_dist(gen);
+        for (std::size_t k = 0; k < row_nnz; ++k) {
+            builder.add(i, (i + offset_dist(gen)) % size, val_dist(gen));
+        }
+    }
+    const auto matrix = builder.build();
+    const SellMatrix<double> sell(matrix);
+    const std::vector<double> vec(size, 1.0);
+    std::vector<double> result(size);
+    
+    for (auto _ : state) {
+        if (state.range(1) == 0) {
+            MatrixOps<double>::multiply(matrix, vec, result);
+        } else {
+            MatrixOps<double>::multiply(sell, std::span<const double>(vec), std::span<double>(result));
+        }
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    
+    report_roofline(state, state.range(1) == 0 ? spmv_traffic(matrix) : spmv_traffic(sell));
+}
+
+BENCHMARK(BM_ShortRows)
+    ->Args({200000, 0})
+    ->Args({200000, 1})
+    ->Unit(benchmark::kMicrosecond);
+
+// Block-structured matrix with B unknowns per node and a 7-point node
+// stencil on an n^3 grid, as from a 3D multiphysics discretization
+template<std::size_t B>
+SparseMatrix<double> create_node_block_matrix(std::size_t n) {
+    const std::size_t nodes = n * n * n;
+    SparseMatrixBuilder<double> builder(nodes * B, nodes * B);
+    builder.reserve(nodes * 7 * B * B);
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> val_dist(1.0, 2.0);
+    for (std::size_t node = 0; node < nodes; ++node) {
+        const std::size_t i = node % n;
+        const std::size_t j = node / n % n;
+        const std::size_t k = node / (n * n);
+        std::vector<std::size_t> neighbours{node};
+        for (auto [coord, stride] : {std::pair{i, std::size_t{1}}, std::pair{j, n}, std::pair{k, n * n}}) {
+            if (coord > 0) {
+                neighbours.push_back(node - stride);
+            }
+            if (coord + 1 < n) {
+                neighbours.push_back(node + stride);
+            }
+        }
+        for (auto other : neighbours) {
+            for (std::size_t a = 0; a < B; ++a) {
+                for (std::size_t b = 0; b < B; ++b) {
+                    builder.add(node * B + a, other * B + b, val_dist(gen));
+                }
+            }
+        }
+    }
+    return builder.build();
+}
+
+// Arguments: grid edge, 0 = CSR, 1 = BSR with the node block size
+template<std::size_t B>
+void BM_NodeBlocks(benchmark::State& state) {
+    const auto matrix = create_node_block_matrix<B>(static_cast<std::size_t>(state.range(0)));
+    const BlockSparseMatrix<double, B, B> bsr(matrix);
+    const std::vector<double> vec(matrix.cols(), 1.0);
+    std::vector<double> result(matrix.rows());
+    
+    for (auto _ : state) {
+        if (state.range(1) == 0) {
+            MatrixOps<double>::multiply(matrix, vec, result);
+        } else {
+            MatrixOps<double>::multiply(bsr, std::span<const double>(vec), std::span<double>(result));
+        }
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    
+    report_roofline(state, state.range(1) == 0 ? spmv_traffic(matrix) : spmv_traffic(bsr));
+}
+
+BENCHMARK_TEMPLATE(BM_NodeBlocks, 3)
+    ->Args({40, 0})
+    ->Args({40, 1})
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_TEMPLATE(BM_NodeBlocks, 4)
+    ->Args({40, 0})
+    ->Args({40, 1})
+    ->Unit(benchmark::kMicrosecond);
+
+// Banded matrix with 32-bit indices, large enough to stream from memory.
+// A double matrix moves 12 bytes per nonzero, float 8, 16-bit types 6;
+// x and y stay double. Argument: rows.
+template<typename Storage>
+void BM_MixedPrecision(benchmark::State& state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    SparseMatrixBuilder<double, std::uint32_t, std::uint32_t> builder(size, size);
+    builder.reserve(size * 15);
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<std::size_t> offset_dist(0, 2000);
+    std::uniform_real_distribution<double> val_dist(-1.0, 1.0);
+    for (std::size_t i = 0; i < size; ++i) {
+        for (std::size_t k = 0; k < 15; ++k) {
+            builder.add(i, (i + offset_dist(gen)) % size, val_dist(gen));
+        }
+    }
+    const auto matrix = builder.build();
+    const std::vector<double> vec(size, 1.0);
+    std::vector<double> result(size);
+
+    auto run = [&](const auto& a, const bench::SpmvTraffic& traffic) {
+        for (auto _ : state) {
+            MatrixOps<double>::multiply(a, std::span<const double>(vec), std::span<double>(result));
+            benchmark::DoNotOptimize(result.data());
+            benchmark::ClobberMemory();
+        }
+        report_roofline(state, traffic);
+    };
+    if constexpr (std::is_same_v<Storage, double>) {
+        run(matrix, spmv_traffic(matrix));
+    } else {
+        const MixedPrecisionMatrix<Storage, std::uint32_t, std::uint32_t> mixed(matrix);
+        run(mixed, spmv_traffic<double>(mixed));
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_MixedPrecision, double)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_MixedPrecision, float)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_MixedPrecision, bfloat16)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_MixedPrecision, float16)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
 BENCHMARK_MAIN();
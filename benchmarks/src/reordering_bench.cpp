@@ -0,0 +1,117 @@
+#include <benchmark/benchmark.h>
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/core/sparse_matrix_builder.hpp>
+#include <sparse_linalg/core/matrix_ops.hpp>
+#include <sparse_linalg/core/reordering.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace sparse_linalg;
+
+namespace {
+
+// 5-point Laplacian whose vertices arrive in random order, as from a mesh
+// generator that numbers nodes arbitrarily
+SparseMatrix<double> make_scrambled_grid(std::size_t grid) {
+    const std::size_t n = grid * grid;
+    Permutation position(n);
+    std::iota(position.begin(), position.end(), std::size_t{0});
+    std::mt19937 gen(42);
+    std::shuffle(position.begin(), position.end(), gen);
+
+    SparseMatrixBuilder<double> builder(n, n);
+    builder.reserve(5 * n);
+    auto add = [&](std::size_t u, std::size_t v, double value) { builder.add(position[u], position[v], value); };
+    for (std::size_t i = 0; i < grid; ++i) {
+        for (std::size_t j = 0; j < grid; ++j) {
+            const std::size_t v = i * grid + j;
+            add(v, v, 4.0);
+            if (i > 0) add(v, v - grid, -1.0);
+            if (i + 1 < grid) add(v, v + grid, -1.0);
+            if (j > 0) add(v, v - 1, -1.0);
+            if (j + 1 < grid) add(v, v + 1, -1.0);
+        }
+    }
+    return builder.build();
+}
+
+SparseMatrix<double> reorder(const SparseMatrix<double>& a, int ordering, std::size_t parts) {
+    switch (ordering) {
+    case 1: {
+        const auto perm = reverse_cuthill_mckee(a);
+        return permute(a, perm, perm);
+    }
+    case 2: {
+        const auto perm = bisection_ordering(a, parts);
+        return permute(a, perm, perm);
+    }
+    default:
+        return a;
+    }
+}
+
+// SpMV before (0) and after RCM (1) or bisection (2) ordering. Bytes count
+// the CSR arrays, y, and one read of x per row; scattered x reads that miss
+// cache cost more than that, which shows up as lower throughput.
+void BM_SpmvOrdering(benchmark::State& state) {
+    execution::ThreadPool pool;
+    const auto a = reorder(make_scrambled_grid(static_cast<std::size_t>(state.range(0))),
+                           static_cast<int>(state.range(1)), pool.thread_count());
+    const std::vector<double> x(a.rows(), 1.0);
+    std::vector<double> y(a.rows());
+    const bool parallel = state.range(2) != 0;
+    for (auto _ : state) {
+        if (parallel) {
+            MatrixOps<double>::multiply_parallel(a, std::span<const double>(x), std::span<double>(y), pool);
+        } else {
+            MatrixOps<double>::multiply(a, std::span<const double>(x), std::span<double>(y));
+        }
+        benchmark::DoNotOptimize(y.data());
+    }
+    const auto stats = bandwidth_stats(a);
+    const auto bytes = a.nnz() * (sizeof(double) + sizeof(std::size_t)) +
+                       a.rows() * (sizeof(std::size_t) + 2 * sizeof(double));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(bytes));
+    state.counters["bandwidth"] = static_cast<double>(stats.bandwidth);
+    state.counters["profile"] = static_cast<double>(stats.profile);
+    state.counters["avg_distance"] = stats.average_distance;
+}
+
+void BM_ReverseCuthillMcKee(benchmark::State& state) {
+    const auto a = make_scrambled_grid(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(reverse_cuthill_mckee(a));
+    }
+}
+
+void BM_BisectionOrdering(benchmark::State& state) {
+    const auto a = make_scrambled_grid(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bisection_ordering(a, 8));
+    }
+}
+
+void BM_Permute(benchmark::State& state) {
+    const auto a = make_scrambled_grid(static_cast<std::size_t>(state.range(0)));
+    const auto perm = reverse_cuthill_mckee(a);
+    execution::ThreadPool pool;
+    for (auto _ : state) {
+        if (state.range(1) != 0) {
+            benchmark::DoNotOptimize(permute(a, perm, perm, pool));
+        } else {
+            benchmark::DoNotOptimize(permute(a, perm, perm));
+        }
+    }
+}
+
+} // namespace
+
+// Grid side, ordering (0 = scrambled, 1 = RCM, 2 = bisection), pool
+BENCHMARK(BM_SpmvOrdering)->ArgsProduct({{316, 1000}, {0, 1, 2}, {0, 1}})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ReverseCuthillMcKee)->Arg(316)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BisectionOrdering)->Arg(316)->Arg(1000)->Unit(benchmark::kMillisecond);
+// Grid side, pool
+BENCHMARK(BM_Permute)->ArgsProduct({{316, 1000}, {0, 1}})->Unit(benchmark::kMillisecond);
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/core/sell_matrix.hpp>
+#include <sparse_linalg/core/block_sparse_matrix.hpp>
+#include <sparse_linalg/core/mixed_precision_matrix.hpp>
+#include <sparse_linalg/core/parallel_utils.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <span>
+
+namespace sparse_linalg::bench {
+
+// Minimum memory traffic of one SpMV under the roofline model: every
+// matrix array is streamed once, x is read once (perfect reuse of its
+// cache lines), y is written once and, when accumulating, read once.
+// No write-allocate traffic is counted, matching STREAM's convention, so
+// effective bandwidth / STREAM bandwidth is the fraction of the memory
+// roofline a kernel reaches. Matrices that fit in cache can exceed 1.
+struct SpmvTraffic {
+    std::size_t nnz = 0;
+    std::size_t matrix_bytes = 0;
+    std::size_t vector_bytes = 0;
+    std::size_t flops = 0;
+
+    [[nodiscard]] std::size_t bytes() const noexcept { return matrix_bytes + vector_bytes; }
+
+    // The same product run `times` times, streaming everything again
+    [[nodiscard]] SpmvTraffic repeated(std::size_t times) const noexcept {
+        return {nnz * times, matrix_bytes * times, vector_bytes * times, flops * times};
+    }
+};
+
+namespace detail {
+    template<typename... Arrays>
+    std::size_t total_bytes(Arrays... arrays) {
+        return (std::size_t{0} + ... + arrays.size_bytes());
+    }
+
+    // x and y traffic for `vectors` right-hand sides of element type T
+    template<typename T>
+    SpmvTraffic with_vectors(std::size_t nnz, std::size_t matrix_bytes, std::size_t rows, std::size_t cols,
+                             std::size_t vectors, bool accumulate) {
+        const std::size_t y_passes = accumulate ? 2 : 1;
+        return {nnz * vectors, matrix_bytes, (cols + y_passes * rows) * vectors * sizeof(T), 2 * nnz * vectors};
+    }
+}
+
+template<typename T, typename ColIndex, typename RowPtr>
+[[nodiscard]] SpmvTraffic spmv_traffic(const SparseMatrix<T, ColIndex, RowPtr>& a, std::size_t vectors = 1,
+                                       bool accumulate = false) {
+    const auto& data = a.raw_data();
+    const std::size_t matrix_bytes = detail::total_bytes(std::span(data.values), std::span(data.col_indices),
+                                                         std::span(data.row_ptrs));
+    return detail::with_vectors<T>(a.nnz(), matrix_bytes, a.rows(), a.cols(), vectors, accumulate);
+}
+
+// Padding slots are streamed like nonzeros; the row permutation is read to scatter y
+template<typename T, typename ColIndex, typename ChunkPtr>
+[[nodiscard]] SpmvTraffic spmv_traffic(const SellMatrix<T, ColIndex, ChunkPtr>& a, bool accumulate = false) {
+    const std::size_t matrix_bytes = detail::total_bytes(a.values(), a.col_indices(), a.chunk_ptrs(),
+                                                         a.row_permutation());
+    return detail::with_vectors<T>(a.nnz(), matrix_bytes, a.rows(), a.cols(), 1, accumulate);
+}
+
+// Explicit zeros inside blocks are streamed like nonzeros
+template<typename T, std::size_t R, std::size_t C, typename ColIndex, typename RowPtr>
+[[nodiscard]] SpmvTraffic spmv_traffic(const BlockSparseMatrix<T, R, C, ColIndex, RowPtr>& a,
+                                       bool accumulate = false) {
+    const std::size_t matrix_bytes = detail::total_bytes(a.values(), a.block_col_indices(), a.block_row_ptrs());
+    return detail::with_vectors<T>(a.nnz(), matrix_bytes, a.rows(), a.cols(), 1, accumulate);
+}
+
+// Values in the storage type, vectors in the arithmetic type T
+template<typename T, typename Storage, typename ColIndex, typename RowPtr>
+[[nodiscard]] SpmvTraffic spmv_traffic(const MixedPrecisionMatrix<Storage, ColIndex, RowPtr>& a,
+                                       bool accumulate = false) {
+    const std::size_t matrix_bytes = detail::total_bytes(a.values(), a.col_indices(), a.row_ptrs());
+    return detail::with_vectors<T>(a.nnz(), matrix_bytes, a.rows(), a.cols(), 1, accumulate);
+}
+
+// STREAM triad a[i] = b[i] + s * c[i] over three 128 MiB arrays, best of
+// five runs, in bytes per second. Measured once per thread count: on the
+// pool when one is given, otherwise on the calling thread.
+inline double stream_bandwidth(execution::ThreadPool* pool = nullptr) {
+    static std::map<std::size_t, double> measured;
+    const std::size_t threads = pool ? pool->thread_count() : 0;
+    if (const auto it = measured.find(threads); it != measured.end()) {
+        return it->second;
+    }
+
+    constexpr std::size_t n = std::size_t{1} << 24;
+    const auto a = std::make_unique_for_overwrite<double[]>(n);
+    const auto b = std::make_unique_for_overwrite<double[]>(n);
+    const auto c = std::make_unique_for_overwrite<double[]>(n);
+    // First touch on the threads that run the triad
+    sparse_linalg::detail::for_each_partition(pool, n, [&](std::size_t begin, std::size_t end) {
+        std::fill(a.get() + begin, a.get() + end, 0.0);
+        std::fill(b.get() + begin, b.get() + end, 1.0);
+        std::fill(c.get() + begin, c.get() + end, 2.0);
+    });
+
+    double best = 0.0;
+    for (int run = 0; run < 5; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        sparse_linalg::detail::for_each_partition(pool, n, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                a[i] = b[i] + 3.0 * c[i];
+            }
+        });
+        benchmark::DoNotOptimize(a.get());
+        benchmark::ClobberMemory();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::max(best, static_cast<double>(3 * n * sizeof(double)) / elapsed.count());
+    }
+    measured.emplace(threads, best);
+    return best;
+}
+
+// Items are nonzeros, bytes the roofline traffic. Counters: stream_GB/s is
+// the baseline for the same thread count, stream_fraction the share of it
+// reached, flop/byte the kernel's arithmetic intensity.
+inline void report_roofline(benchmark::State& state, const SpmvTraffic& traffic,
+                            execution::ThreadPool* pool = nullptr) {
+    const auto iterations = static_cast<double>(state.iterations());
+    const auto bytes = static_cast<double>(traffic.bytes());
+    const double stream = stream_bandwidth(pool);
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(traffic.nnz));
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(traffic.bytes()));
+    state.SetComplexityN(static_cast<benchmark::ComplexityN>(traffic.nnz));
+    state.counters["stream_GB/s"] = stream * 1e-9;
+    state.counters["stream_fraction"] = benchmark::Counter(iterations * bytes / stream, benchmark::Counter::kIsRate);
+    state.counters["flop/byte"] = static_cast<double>(traffic.flops) / bytes;
+}
+
+} // namespace sparse_linalg::bench
@@ -0,0 +1,191 @@
+#include <benchmark/benchmark.h>
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/core/sparse_matrix_builder.hpp>
+#include <sparse_linalg/core/matrix_ops.hpp>
+#include <sparse_linalg/solvers/conjugate_gradient.hpp>
+#include <sparse_linalg/solvers/gmres.hpp>
+#include <sparse_linalg/solvers/jacobi.hpp>
+#include <sparse_linalg/solvers/ilu0.hpp>
+#include <sparse_linalg/solvers/ic0.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+using namespace sparse_linalg;
+
+namespace {
+
+SparseMatrix<double> make_poisson_2d(std::size_t grid) {
+    const std::size_t n = grid * grid;
+    SparseMatrixBuilder<double> builder(n, n);
+    builder.reserve(5 * n);
+    for (std::size_t i = 0; i < grid; ++i) {
+        for (std::size_t j = 0; j < grid; ++j) {
+            const std::size_t row = i * grid + j;
+            builder.add(row, row, 4.0);
+            if (i > 0) builder.add(row, row - grid, -1.0);
+            if (i + 1 < grid) builder.add(row, row + grid, -1.0);
+            if (j > 0) builder.add(row, row - 1, -1.0);
+            if (j + 1 < grid) builder.add(row, row + 1, -1.0);
+        }
+    }
+    return builder.build();
+}
+
+// CG written around MatrixOps::multiply the way callers did before the
+// solver existed: a fresh vector per product and one pass per operation
+std::size_t unfused_cg(const SparseMatrix<double>& a, const std::vector<double>& b,
+                       std::vector<double>& x, std::size_t iterations) {
+    auto dot = [](const std::vector<double>& u, const std::vector<double>& v) {
+        return std::inner_product(u.begin(), u.end(), v.begin(), 0.0);
+    };
+    auto ax = MatrixOps<double>::multiply(a, x);
+    std::vector<double> r(b.size());
+    for (std::size_t i = 0; i < b.size(); ++i) {
+        r[i] = b[i] - ax[i];
+    }
+    auto p = r;
+    double rr = dot(r, r);
+    for (std::size_t k = 0; k < iterations; ++k) {
+        const auto ap = MatrixOps<double>::multiply(a, p);
+        const double alpha = rr / dot(p, ap);
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            x[i] += alpha * p[i];
+        }
+        for (std::size_t i = 0; i < r.size(); ++i) {
+            r[i] -= alpha * ap[i];
+        }
+        const double rr_next = dot(r, r);
+        for (std::size_t i = 0; i < p.size(); ++i) {
+            p[i] = r[i] + rr_next / rr * p[i];
+        }
+        rr = rr_next;
+    }
+    return iterations;
+}
+
+constexpr std::size_t cg_iterations = 50;
+
+void BM_ConjugateGradient(benchmark::State& state) {
+    const auto a = make_poisson_2d(static_cast<std::size_t>(state.range(0)));
+    const std::vector<double> b(a.rows(), 1.0);
+    std::vector<double> x(a.rows());
+    ConjugateGradient<double> cg({.max_iterations = cg_iterations, .tolerance = 0.0, .record_history = false});
+    SolverTimings timings;
+    for (auto _ : state) {
+        std::fill(x.begin(), x.end(), 0.0);
+        const auto report = cg.solve(a, b, x);
+        timings.spmv += report.timings.spmv;
+        timings.vector_updates += report.timings.vector_updates;
+        benchmark::DoNotOptimize(x.data());
+    }
+    const auto iterations = static_cast<double>(state.iterations());
+    state.counters["spmv_us"] = static_cast<double>(timings.spmv.count()) / 1e3 / iterations;
+    state.counters["vector_us"] = static_cast<double>(timings.vector_updates.count()) / 1e3 / iterations;
+}
+
+void BM_ConjugateGradientParallel(benchmark::State& state) {
+    const auto a = make_poisson_2d(static_cast<std::size_t>(state.range(0)));
+    const std::vector<double> b(a.rows(), 1.0);
+    std::vector<double> x(a.rows());
+    execution::ThreadPool pool;
+    ConjugateGradient<double> cg({.max_iterations = cg_iterations, .tolerance = 0.0, .record_history = false});
+    for (auto _ : state) {
+        std::fill(x.begin(), x.end(), 0.0);
+        benchmark::DoNotOptimize(cg.solve(a, b, x, pool));
+    }
+}
+
+void BM_ConjugateGradientUnfused(benchmark::State& state) {
+    const auto a = make_poisson_2d(static_cast<std::size_t>(state.range(0)));
+    const std::vector<double> b(a.rows(), 1.0);
+    std::vector<double> x(a.rows());
+    for (auto _ : state) {
+        std::fill(x.begin(), x.end(), 0.0);
+        benchmark::DoNotOptimize(unfused_cg(a, b, x, cg_iterations));
+    }
+}
+
+// GMRES(30) on the same Poisson matrix; range(1) picks the Gram-Schmidt
+// variant and range(2) whether the solve runs on a pool
+void BM_Gmres(benchmark::State& state) {
+    const auto a = make_poisson_2d(static_cast<std::size_t>(state.range(0)));
+    const std::vector<double> b(a.rows(), 1.0);
+    std::vector<double> x(a.rows());
+    const auto variant = static_cast<GramSchmidt>(state.range(1));
+    Gmres<double> gmres({.max_iterations = cg_iterations, .tolerance = 0.0, .record_history = false},
+                        {.restart = 30, .gram_schmidt = variant});
+    execution::ThreadPool pool;
+    SolverTimings timings;
+    for (auto _ : state) {
+        std::fill(x.begin(), x.end(), 0.0);
+        const auto report = state.range(2) != 0 ? gmres.solve(a, b, x, pool) : gmres.solve(a, b, x);
+        timings.spmv += report.timings.spmv;
+        timings.orthogonalization += report.timings.orthogonalization;
+        benchmark::DoNotOptimize(x.data());
+    }
+    const auto iterations = static_cast<double>(state.iterations());
+    state.counters["spmv_us"] = static_cast<double>(timings.spmv.count()) / 1e3 / iterations;
+    state.counters["orth_us"] = static_cast<double>(timings.orthogonalization.count()) / 1e3 / iterations;
+}
+
+// CG to 1e-8 with no preconditioner (0), Jacobi (1) or IC(0) (2), setup
+// included; range(2) runs setup, sweeps and SpMV on a pool
+void BM_PreconditionedCg(benchmark::State& state) {
+    const auto a = make_poisson_2d(static_cast<std::size_t>(state.range(0)));
+    const std::vector<double> b(a.rows(), 1.0);
+    std::vector<double> x(a.rows());
+    execution::ThreadPool pool;
+    const bool parallel = state.range(2) != 0;
+    ConjugateGradient<double> cg({.max_iterations = 5000, .tolerance = 1e-8, .record_history = false});
+    SolverReport report;
+    for (auto _ : state) {
+        std::fill(x.begin(), x.end(), 0.0);
+        switch (state.range(1)) {
+        case 1: {
+            auto jacobi = parallel ? JacobiPreconditioner<double>(a, pool) : JacobiPreconditioner<double>(a);
+            report = parallel ? cg.solve(a, b, x, jacobi, pool) : cg.solve(a, b, x, jacobi);
+            break;
+        }
+        case 2: {
+            auto ic = parallel ? Ic0Preconditioner<double>(a, pool) : Ic0Preconditioner<double>(a);
+            report = parallel ? cg.solve(a, b, x, ic, pool) : cg.solve(a, b, x, ic);
+            break;
+        }
+        default:
+            report = parallel ? cg.solve(a, b, x, pool) : cg.solve(a, b, x);
+        }
+        benchmark::DoNotOptimize(x.data());
+    }
+    state.counters["iterations"] = static_cast<double>(report.iterations);
+    state.counters["precond_us"] = static_cast<double>(report.timings.preconditioner.count()) / 1e3;
+}
+
+// Numeric ILU(0) refactorization and one apply, without and with a pool
+void BM_Ilu0(benchmark::State& state) {
+    const auto a = make_poisson_2d(static_cast<std::size_t>(state.range(0)));
+    const std::vector<double> in(a.rows(), 1.0);
+    std::vector<double> out(a.rows());
+    execution::ThreadPool pool;
+    auto ilu = state.range(1) != 0 ? Ilu0Preconditioner<double>(a, pool) : Ilu0Preconditioner<double>(a);
+    for (auto _ : state) {
+        ilu.factorize(a);
+        ilu.apply(in, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.counters["levels"] = static_cast<double>(ilu.lower_levels());
+}
+
+} // namespace
+
+// Grid side; the matrix has side^2 rows. 50 iterations per solve.
+BENCHMARK(BM_ConjugateGradient)->Arg(100)->Arg(316)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ConjugateGradientParallel)->Arg(100)->Arg(316)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ConjugateGradientUnfused)->Arg(100)->Arg(316)->Arg(1000)->Unit(benchmark::kMillisecond);
+// Grid side, Gram-Schmidt variant (0 = modified, 1 = classical, 2 = classical twice), pool
+BENCHMARK(BM_Gmres)->ArgsProduct({{100, 316}, {0, 1, 2}, {0, 1}})->Unit(benchmark::kMillisecond);
+// Grid side, preconditioner (0 = none, 1 = Jacobi, 2 = IC(0)), pool
+BENCHMARK(BM_PreconditionedCg)->ArgsProduct({{100, 316}, {0, 1, 2}, {0, 1}})->Unit(benchmark::kMillisecond);
+// Grid side, pool
+BENCHMARK(BM_Ilu0)->ArgsProduct({{316, 1000}, {0, 1}})->Unit(benchmark::kMillisecond);
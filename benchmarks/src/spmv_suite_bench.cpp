@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/core/first_touch.hpp>
+#include <sparse_linalg/core/matrix_generators.hpp>
+#include <sparse_linalg/core/matrix_ops.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include "roofline.hpp"
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+using namespace sparse_linalg;
+
+namespace {
+
+// SpMV over the generator suite, from regular stencils to power-law rows,
+// each reported against the STREAM roofline. 32-bit indices throughout.
+enum class Structure { poisson_2d, poisson_3d, banded, block_diagonal, rmat, power_law, skewed };
+
+using Matrix = SparseMatrix<double, std::uint32_t, std::uint32_t>;
+
+// About `rows` rows of the given structure; generated on the pool
+Matrix generate(Structure structure, std::size_t rows, execution::ThreadPool& pool) {
+    switch (structure) {
+        case Structure::poisson_2d: {
+            const auto side = static_cast<std::size_t>(std::sqrt(static_cast<double>(rows)));
+            return poisson_2d<double, std::uint32_t, std::uint32_t>(side, side, pool);
+        }
+        case Structure::poisson_3d: {
+            const auto side = static_cast<std::size_t>(std::cbrt(static_cast<double>(rows)));
+            return poisson_3d<double, std::uint32_t, std::uint32_t>(side, side, side, pool);
+        }
+        case Structure::banded:
+            return banded<double, std::uint32_t, std::uint32_t>(rows, 7, 7, pool);
+        case Structure::block_diagonal:
+            return block_diagonal<double, std::uint32_t, std::uint32_t>(rows / 8, 8, pool);
+        case Structure::rmat:
+            return rmat<double, std::uint32_t, std::uint32_t>(
+                static_cast<std::size_t>(std::log2(static_cast<double>(rows))), 8, pool);
+        case Structure::power_law:
+            return power_law_rows<double, std::uint32_t, std::uint32_t>(rows, rows / 8, 0.9, pool);
+        case Structure::skewed:
+            return skewed_rows<double, std::uint32_t, std::uint32_t>(rows, 6, 40, rows / 20, pool);
+    }
+    return Matrix(0, 0);
+}
+
+// Generating tens of millions of nonzeros takes longer than the SpMV runs,
+// so the last matrix is kept for the next benchmark with the same arguments
+const Matrix& cached_matrix(Structure structure, std::size_t rows, execution::ThreadPool& pool) {
+    static std::unique_ptr<Matrix> matrix;
+    static Structure cached_structure{};
+    static std::size_t cached_rows = 0;
+    if (!matrix || cached_structure != structure || cached_rows != rows) {
+        matrix.reset();
+        matrix = std::make_unique<Matrix>(generate(structure, rows, pool));
+        cached_structure = structure;
+        cached_rows = rows;
+    }
+    return *matrix;
+}
+
+// Arguments: Structure, rows, 0 = sequential, 1 = parallel (nnz partition),
+// 2 = parallel on a pool pinned per NUMA node with the matrix and vectors
+// first-touched by the workers that use them
+void BM_SpmvSuite(benchmark::State& state) {
+    const auto mode = state.range(2);
+    execution::ThreadPool pool = mode == 2
+        ? execution::ThreadPool(std::thread::hardware_concurrency(), execution::ThreadAffinity::nodes)
+        : execution::ThreadPool();
+    const auto structure = static_cast<Structure>(state.range(0));
+    const auto& cached = cached_matrix(structure, static_cast<std::size_t>(state.range(1)), pool);
+    const auto placed = mode == 2 ? std::make_unique<Matrix>(first_touch_copy(cached, pool)) : nullptr;
+    const auto& matrix = placed ? *placed : cached;
+    const auto x = mode == 2 ? first_touch_vector(matrix, matrix.cols(), 1.0, pool)
+                             : std::vector<double>(matrix.cols(), 1.0);
+    auto y = mode == 2 ? first_touch_vector(matrix, matrix.rows(), 0.0, pool) : std::vector<double>(matrix.rows());
+
+    for (auto _ : state) {
+        if (mode != 0) {
+            MatrixOps<double>::multiply_parallel(matrix, std::span<const double>(x), std::span<double>(y), pool,
+                                                 1.0, 0.0, PartitionStrategy::nnz);
+        } else {
+            MatrixOps<double>::multiply(matrix, std::span<const double>(x), std::span<double>(y));
+        }
+        benchmark::DoNotOptimize(y.data());
+        benchmark::ClobberMemory();
+    }
+
+    bench::report_roofline(state, bench::spmv_traffic(matrix), mode != 0 ? &pool : nullptr);
+    state.counters["rows"] = static_cast<double>(matrix.rows());
+    state.counters["nnz/row"] = static_cast<double>(matrix.nnz()) / static_cast<double>(matrix.rows());
+}
+
+void suite_arguments(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"structure", "rows", "mode"});
+    for (int structure = 0; structure <= static_cast<int>(Structure::skewed); ++structure) {
+        for (int mode : {0, 1, 2}) {
+            b->Args({structure, 4'000'000, mode});
+        }
+    }
+}
+
+} // anonymous namespace
+
+BENCHMARK(BM_SpmvSuite)
+    ->Apply(suite_arguments)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace sparse_linalg;
+
+namespace {
+
+// Many tiny tasks from outside the pool: submission and scheduling overhead
+void BM_SubmitTiny(benchmark::State& state) {
+    const auto tasks = static_cast<std::size_t>(state.range(0));
+    execution::ThreadPool pool;
+    std::atomic<std::size_t> counter{0};
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < tasks; ++i) {
+            pool.submit([&counter]() { counter.fetch_add(1, std::memory_order_relaxed); });
+        }
+        pool.wait_all();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(tasks));
+}
+
+// Tasks spawned by tasks land in the workers' own deques and get stolen
+void BM_NestedSpawn(benchmark::State& state) {
+    const auto tasks = static_cast<std::size_t>(state.range(0));
+    execution::ThreadPool pool;
+    const std::size_t roots = pool.thread_count();
+    std::atomic<std::size_t> counter{0};
+    for (auto _ : state) {
+        for (std::size_t r = 0; r < roots; ++r) {
+            pool.submit([&pool, &counter, per_root = tasks / roots]() {
+                for (std::size_t i = 0; i < per_root; ++i) {
+                    pool.submit([&counter]() { counter.fetch_add(1, std::memory_order_relaxed); });
+                }
+            });
+        }
+        pool.wait_all();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(tasks));
+}
+
+// Future round trip for a single task
+void BM_SubmitGet(benchmark::State& state) {
+    execution::ThreadPool pool;
+    for (auto _ : state) {
+        auto future = pool.submit([]() { return 1; });
+        benchmark::DoNotOptimize(future.get());
+    }
+}
+
+// Fork-join of one empty task per worker through submit and futures
+void BM_DispatchSubmit(benchmark::State& state) {
+    execution::ThreadPool pool;
+    std::vector<std::future<void>> futures;
+    for (auto _ : state) {
+        futures.clear();
+        for (std::size_t i = 0; i < pool.thread_count(); ++i) {
+            futures.push_back(pool.submit([]() {}));
+        }
+        for (auto& future : futures) {
+            future.wait();
+        }
+    }
+}
+
+// The same fork-join through one parallel_for broadcast; arg 1 selects spin_then_park
+void BM_DispatchParallelFor(benchmark::State& state) {
+    const auto policy = state.range(0) == 1 ? execution::IdlePolicy::spin_then_park : execution::IdlePolicy::park;
+    execution::ThreadPool pool(std::thread::hardware_concurrency(), policy);
+    const std::size_t parts = pool.thread_count();
+    for (auto _ : state) {
+        pool.parallel_for(parts, 1, [](std::size_t begin, std::size_t end) {
+            benchmark::DoNotOptimize(begin + end);
+        });
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_SubmitTiny)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_NestedSpawn)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SubmitGet)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DispatchSubmit)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DispatchParallelFor)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,299 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace sparse_linalg {
+
+// Whether large allocations are backed by 2 MiB pages, which cut the TLB
+// misses of streaming through big matrices
+enum class HugePagePolicy {
+    none,         // ordinary pages
+    transparent,  // 2 MiB-aligned mapping with madvise(MADV_HUGEPAGE)
+    reserved      // MAP_HUGETLB from the pages reserved in vm.nr_hugepages,
+                  // falling back to transparent when none are free
+};
+
+inline constexpr std::size_t huge_page_size = std::size_t{2} << 20;
+
+namespace detail {
+    inline std::size_t round_up(std::size_t bytes, std::size_t multiple) {
+        if (bytes > std::numeric_limits<std::size_t>::max() - multiple) {
+            throw std::bad_alloc();
+        }
+        return (bytes + multiple - 1) / multiple * multiple;
+    }
+
+    // Requests at least huge_page_size bytes go to mmap when huge pages are
+    // asked for; everything else to the aligned operator new. Deallocation
+    // makes the same choice from the size, so the two always agree.
+    inline bool uses_huge_pages(std::size_t bytes, HugePagePolicy pages) {
+#ifdef __linux__
+        return pages != HugePagePolicy::none && bytes >= huge_page_size;
+#else
+        static_cast<void>(bytes);
+        static_cast<void>(pages);
+        return false;
+#endif
+    }
+
+#ifdef __linux__
+    // A mapping of round_up(bytes, huge_page_size) bytes starting on a huge
+    // page boundary; over-maps by one huge page and trims both ends
+    inline void* map_huge_pages(std::size_t bytes, HugePagePolicy pages) {
+        const std::size_t length = round_up(bytes, huge_page_size);
+#ifdef MAP_HUGETLB
+        if (pages == HugePagePolicy::reserved) {
+            void* p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p != MAP_FAILED) {
+                return p;
+            }
+        }
+#endif
+        const std::size_t mapped = length + huge_page_size;
+        void* raw = ::mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        const auto base = reinterpret_cast<std::uintptr_t>(raw);
+        const auto aligned = (base + huge_page_size - 1) / huge_page_size * huge_page_size;
+        if (aligned > base) {
+            ::munmap(raw, aligned - base);
+        }
+        if (const auto tail = base + mapped - (aligned + length); tail > 0) {
+            ::munmap(reinterpret_cast<void*>(aligned + length), tail);
+        }
+        void* p = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+        ::madvise(p, length, MADV_HUGEPAGE);
+#endif
+        return p;
+    }
+#endif
+
+    inline void* aligned_allocate(std::size_t bytes, std::size_t alignment, HugePagePolicy pages) {
+#ifdef __linux__
+        if (uses_huge_pages(bytes, pages)) {
+            return map_huge_pages(bytes, pages);
+        }
+#endif
+        return ::operator new(bytes, std::align_val_t{alignment});
+    }
+
+    inline void aligned_deallocate(void* p, std::size_t bytes, std::size_t alignment, HugePagePolicy pages) noexcept {
+#ifdef __linux__
+        if (uses_huge_pages(bytes, pages)) {
+            ::munmap(p, round_up(bytes, huge_page_size));
+            return;
+        }
+#endif
+        ::operator delete(p, bytes, std::align_val_t{alignment});
+    }
+}
+
+// Stateless allocator returning Alignment-aligned storage (a cache line and
+// a full AVX-512 vector by default), optionally on huge pages. Drop-in for
+// std::allocator in SparseMatrix, the solvers and plain vectors.
+template<typename T, std::size_t Alignment = 64, HugePagePolicy Pages = HugePagePolicy::none>
+class AlignedAllocator {
+    static_assert(std::has_single_bit(Alignment) && Alignment >= alignof(T),
+                  "Alignment must be a power of two no smaller than alignof(T)");
+
+public:
+    using value_type = T;
+    static constexpr std::size_t alignment = Alignment;
+    static constexpr HugePagePolicy huge_pages = Pages;
+
+    template<typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment, Pages>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment, Pages>&) noexcept {}
+
+    [[nodiscard]] T* allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(detail::aligned_allocate(n * sizeof(T), Alignment, Pages));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        detail::aligned_deallocate(p, n * sizeof(T), Alignment, Pages);
+    }
+
+    template<typename U>
+    bool operator==(const AlignedAllocator<U, Alignment, Pages>&) const noexcept { return true; }
+};
+
+template<typename T, HugePagePolicy Pages = HugePagePolicy::none>
+using aligned_vector = std::vector<T, AlignedAllocator<T, 64, Pages>>;
+
+struct MemoryPoolStats {
+    std::size_t hits = 0;           // allocations served from a cached block
+    std::size_t misses = 0;         // allocations that went to the system
+    std::size_t cached_bytes = 0;   // held in free lists right now
+};
+
+// Thread-safe cache of 64-byte-aligned blocks in power-of-two size classes.
+// Freed blocks go back to their class's free list instead of to the system,
+// so temporaries of recurring sizes (SpGEMM accumulators, scatter buffers,
+// factorization scratch) are recycled from call to call. At most
+// max_cached_bytes are kept; beyond that blocks are freed.
+class MemoryPool {
+public:
+    static constexpr std::size_t min_block = 64;
+
+    explicit MemoryPool(std::size_t max_cached_bytes = std::size_t{256} << 20,
+                        HugePagePolicy pages = HugePagePolicy::transparent)
+        : max_cached_bytes_(max_cached_bytes), pages_(pages) {}
+
+    ~MemoryPool() { release(); }
+
+    MemoryPool(const MemoryPool&) = delete;
+    MemoryPool& operator=(const MemoryPool&) = delete;
+
+    [[nodiscard]] void* allocate(std::size_t bytes) {
+        const std::size_t size_class = class_of(bytes);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto& list = free_[size_class];
+            if (!list.empty()) {
+                void* block = list.back();
+                list.pop_back();
+                cached_bytes_ -= block_size(size_class);
+                ++hits_;
+                return block;
+            }
+            ++misses_;
+        }
+        return detail::aligned_allocate(block_size(size_class), min_block, pages_);
+    }
+
+    void deallocate(void* p, std::size_t bytes) noexcept {
+        const std::size_t size_class = class_of(bytes);
+        const std::size_t size = block_size(size_class);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (cached_bytes_ + size <= max_cached_bytes_) {
+                try {
+                    free_[size_class].push_back(p);
+                    cached_bytes_ += size;
+                    return;
+                } catch (...) {
+                    // No room to remember the block: free it instead
+                }
+            }
+        }
+        detail::aligned_deallocate(p, size, min_block, pages_);
+    }
+
+    // Returns every cached block to the system
+    void release() noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (std::size_t c = 0; c < free_.size(); ++c) {
+            for (void* block : free_[c]) {
+                detail::aligned_deallocate(block, block_size(c), min_block, pages_);
+            }
+            free_[c].clear();
+        }
+        cached_bytes_ = 0;
+    }
+
+    [[nodiscard]] MemoryPoolStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return {hits_, misses_, cached_bytes_};
+    }
+
+    // Shared by PoolAllocators that are not given a pool. Never destroyed,
+    // so containers with static storage duration may still free into it.
+    static MemoryPool& global() {
+        static MemoryPool* pool = new MemoryPool();
+        return *pool;
+    }
+
+private:
+    static constexpr std::size_t classes = std::numeric_limits<std::size_t>::digits;
+
+    std::size_t max_cached_bytes_;
+    HugePagePolicy pages_;
+    mutable std::mutex mutex_;
+    std::array<std::vector<void*>, classes> free_;
+    std::size_t cached_bytes_ = 0;
+    std::size_t hits_ = 0;
+    std::size_t misses_ = 0;
+
+    static std::size_t class_of(std::size_t bytes) {
+        if (bytes > (std::size_t{1} << (classes - 2))) {
+            throw std::bad_alloc();
+        }
+        return static_cast<std::size_t>(std::bit_width(std::max(bytes, min_block) - 1));
+    }
+
+    static std::size_t block_size(std::size_t size_class) { return std::size_t{1} << size_class; }
+};
+
+// Allocator drawing from a MemoryPool, MemoryPool::global() by default.
+// Allocators compare equal when they share a pool.
+template<typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+    static constexpr std::size_t alignment = MemoryPool::min_block;
+
+    PoolAllocator() noexcept : pool_(&MemoryPool::global()) {}
+    explicit PoolAllocator(MemoryPool& pool) noexcept : pool_(&pool) {}
+
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept : pool_(&other.pool()) {}
+
+    [[nodiscard]] T* allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(pool_->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept { pool_->deallocate(p, n * sizeof(T)); }
+
+    [[nodiscard]] MemoryPool& pool() const noexcept { return *pool_; }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U>& other) const noexcept { return pool_ == &other.pool(); }
+
+private:
+    MemoryPool* pool_;
+};
+
+// Scratch vector recycled through MemoryPool::global()
+template<typename T>
+using pooled_vector = std::vector<T, PoolAllocator<T>>;
+
+namespace detail {
+    // Allocator rebound to U when its `alignment` is at least Alignment,
+    // AlignedAllocator<U, Alignment> otherwise (std::allocator, say)
+    template<typename Allocator, typename U, std::size_t Alignment>
+    using at_least_aligned = std::conditional_t<
+        requires { requires Allocator::alignment >= Alignment; },
+        typename std::allocator_traits<Allocator>::template rebind_alloc<U>,
+        AlignedAllocator<U, Alignment>>;
+}
+
+} // namespace sparse_linalg
@@ -0,0 +1,237 @@
+#pragma once
+
+#include "sparse_matrix.hpp"
+#include "parallel_utils.hpp"
+#include "../execution/thread_pool.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace sparse_linalg {
+
+// Block dimensions picked by detect_block_size
+struct BlockShape {
+    std::size_t rows = 1;
+    std::size_t cols = 1;
+    std::size_t blocks = 0;  // blocks at this shape; nnz when 1 x 1
+    double fill = 1.0;       // stored entries / nonzeros, >= 1
+};
+
+namespace detail {
+    inline constexpr std::size_t no_block = std::numeric_limits<std::size_t>::max();
+
+    // Visits the distinct block columns of the rows [first_row, last_row)
+    // in first-seen order. marker[block_col] == stamp flags a visited one,
+    // so one marker array serves every block row without being cleared.
+    template<typename ColIndices, typename RowPtrs, typename F>
+    void for_each_block_col(const ColIndices& col_indices, const RowPtrs& row_ptrs,
+                            std::size_t first_row, std::size_t last_row, std::size_t block_cols_per,
+                            std::vector<std::size_t>& marker, std::size_t stamp, F&& fn) {
+        for (std::size_t row = first_row; row < last_row; ++row) {
+            for (auto p = static_cast<std::size_t>(row_ptrs[row]); p < static_cast<std::size_t>(row_ptrs[row + 1]); ++p) {
+                const std::size_t block_col = static_cast<std::size_t>(col_indices[p]) / block_cols_per;
+                if (marker[block_col] != stamp) {
+                    marker[block_col] = stamp;
+                    fn(block_col);
+                }
+            }
+        }
+    }
+
+    // Blocks an R x C tiling of the matrix would store
+    template<typename T, typename ColIndex, typename RowPtr, typename Allocator>
+    std::size_t count_blocks(const SparseMatrix<T, ColIndex, RowPtr, Allocator>& a, std::size_t block_rows_per,
+                             std::size_t block_cols_per) {
+        const auto& data = a.raw_data();
+        const std::size_t block_rows = (a.rows() + block_rows_per - 1) / block_rows_per;
+        std::vector<std::size_t> marker((a.cols() + block_cols_per - 1) / block_cols_per, no_block);
+        std::size_t count = 0;
+        for (std::size_t block_row = 0; block_row < block_rows; ++block_row) {
+            const std::size_t first = block_row * block_rows_per;
+            for_each_block_col(data.col_indices, data.row_ptrs, first, std::min(first + block_rows_per, a.rows()),
+                               block_cols_per, marker, block_row, [&count](std::size_t) { ++count; });
+        }
+        return count;
+    }
+}
+
+// Picks the square block size among 2, 3 and 4 that minimizes the bytes an
+// SpMV streams: R*C values plus one column index per block against one of
+// each per nonzero for CSR. Returns 1 x 1 when no blocking beats CSR, e.g.
+// for scattered patterns where blocks would be mostly explicit zeros.
+template<typename T, typename ColIndex, typename RowPtr, typename Allocator>
+BlockShape detect_block_size(const SparseMatrix<T, ColIndex, RowPtr, Allocator>& a) {
+    auto bytes = [&a](std::size_t size, std::size_t blocks) {
+        const std::size_t block_rows = (a.rows() + size - 1) / size;
+        return blocks * (size * size * sizeof(T) + sizeof(ColIndex)) + block_rows * sizeof(RowPtr);
+    };
+    BlockShape best{1, 1, a.nnz(), 1.0};
+    std::size_t best_bytes = bytes(1, a.nnz());
+    if (a.nnz() == 0) {
+        return best;
+    }
+    for (std::size_t size : {std::size_t{2}, std::size_t{3}, std::size_t{4}}) {
+        const std::size_t blocks = detail::count_blocks(a, size, size);
+        if (bytes(size, blocks) < best_bytes) {
+            best_bytes = bytes(size, blocks);
+            best = BlockShape{size, size, blocks,
+                              static_cast<double>(blocks * size * size) / static_cast<double>(a.nnz())};
+        }
+    }
+    return best;
+}
+
+// Block CSR: the matrix is tiled into R x C blocks and every block holding
+// a nonzero is stored densely, with one column index per block instead of
+// one per entry. Blocks of a block row are sorted by block column; values
+// inside a block are column-major, so column c of a block is R consecutive
+// values that the SpMV kernels scale by one broadcast x entry.
+//
+// Rows and columns need not be multiples of R and C; the edge blocks are
+// padded with zeros and the kernels never touch x or y past the edge.
+template<typename T, std::size_t R, std::size_t C, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+    requires MatrixValue<T> && MatrixIndex<ColIndex> && MatrixIndex<RowPtr> && (R > 0) && (C > 0)
+class BlockSparseMatrix {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using index_type = ColIndex;
+    using offset_type = RowPtr;
+
+    static constexpr size_type block_rows_per = R;
+    static constexpr size_type block_cols_per = C;
+    static constexpr size_type block_size = R * C;
+
+    template<typename Allocator>
+    explicit BlockSparseMatrix(const SparseMatrix<T, ColIndex, RowPtr, Allocator>& csr)
+        : BlockSparseMatrix(csr, nullptr) {}
+
+    // Parallel conversion: block rows are counted and filled on the pool
+    template<typename Allocator>
+    BlockSparseMatrix(const SparseMatrix<T, ColIndex, RowPtr, Allocator>& csr, execution::ThreadPool& pool)
+        : BlockSparseMatrix(csr, &pool) {}
+
+    [[nodiscard]] auto rows() const noexcept -> size_type { return rows_; }
+    [[nodiscard]] auto cols() const noexcept -> size_type { return cols_; }
+    // Nonzeros of the source matrix; stored() adds the explicit zeros
+    [[nodiscard]] auto nnz() const noexcept -> size_type { return nnz_; }
+    [[nodiscard]] auto stored() const noexcept -> size_type { return values_.size(); }
+    [[nodiscard]] auto blocks() const noexcept -> size_type { return block_col_indices_.size(); }
+    [[nodiscard]] auto block_rows() const noexcept -> size_type { return block_row_ptrs_.size() - 1; }
+    [[nodiscard]] auto block_cols() const noexcept -> size_type { return (cols_ + C - 1) / C; }
+
+    [[nodiscard]] auto block_row_ptrs() const noexcept -> std::span<const offset_type> { return block_row_ptrs_; }
+    [[nodiscard]] auto block_col_indices() const noexcept -> std::span<const index_type> { return block_col_indices_; }
+    [[nodiscard]] auto values() const noexcept -> std::span<const value_type> { return values_; }
+
+    // The R * C values of block k, column-major
+    [[nodiscard]] auto block(size_type k) const -> std::span<const value_type, block_size> {
+        if (k >= blocks()) {
+            throw std::out_of_range("Block index out of range");
+        }
+        return std::span<const value_type, block_size>(values_.data() + k * block_size, block_size);
+    }
+
+    [[nodiscard]] auto operator()(size_type row, size_type col) const -> value_type {
+        if (row >= rows_ || col >= cols_) {
+            throw std::out_of_range("Matrix indices out of range");
+        }
+        const size_type block_row = row / R;
+        const auto first = block_col_indices_.begin() + static_cast<std::ptrdiff_t>(block_row_ptrs_[block_row]);
+        const auto last = block_col_indices_.begin() + static_cast<std::ptrdiff_t>(block_row_ptrs_[block_row + 1]);
+        const auto it = std::lower_bound(first, last, static_cast<index_type>(col / C));
+        if (it == last || static_cast<size_type>(*it) != col / C) {
+            return value_type{};
+        }
+        const auto k = static_cast<size_type>(it - block_col_indices_.begin());
+        return values_[k * block_size + (col % C) * R + row % R];
+    }
+
+private:
+    size_type rows_;
+    size_type cols_;
+    size_type nnz_;
+    std::vector<offset_type> block_row_ptrs_;
+    std::vector<index_type> block_col_indices_;
+    std::vector<value_type> values_;
+
+    template<typename Allocator>
+    BlockSparseMatrix(const SparseMatrix<T, ColIndex, RowPtr, Allocator>& csr, execution::ThreadPool* pool)
+        : rows_(csr.rows()), cols_(csr.cols()), nnz_(csr.nnz()) {
+        const auto& data = csr.raw_data();
+        const size_type block_row_count = (rows_ + R - 1) / R;
+        const size_type block_col_count = block_cols();
+        auto row_range = [this](size_type block_row) {
+            return std::pair{block_row * R, std::min(block_row * R + R, rows_)};
+        };
+
+        // Symbolic pass: distinct block columns per block row
+        std::vector<size_type> counts(block_row_count, 0);
+        detail::for_each_partition(pool, block_row_count, [&](size_type begin, size_type end) {
+            std::vector<size_type> marker(block_col_count, detail::no_block);
+            for (size_type block_row = begin; block_row < end; ++block_row) {
+                const auto [first, last] = row_range(block_row);
+                detail::for_each_block_col(data.col_indices, data.row_ptrs, first, last, C, marker, block_row,
+                                           [&counts, block_row](size_type) { ++counts[block_row]; });
+            }
+        });
+        block_row_ptrs_.assign(block_row_count + 1, offset_type{});
+        size_type total = 0;
+        for (size_type block_row = 0; block_row < block_row_count; ++block_row) {
+            total += counts[block_row];
+            block_row_ptrs_[block_row + 1] = detail::checked_index_cast<offset_type>(total);
+        }
+        block_col_indices_.resize(total);
+        values_.assign(total * block_size, value_type{});
+
+        // Numeric pass: sort each block row's columns, then drop every entry
+        // into its block through a block column -> position map
+        detail::for_each_partition(pool, block_row_count, [&](size_type begin, size_type end) {
+            std::vector<size_type> marker(block_col_count, detail::no_block);
+            std::vector<size_type> position(block_col_count);
+            for (size_type block_row = begin; block_row < end; ++block_row) {
+                const auto [first, last] = row_range(block_row);
+                const auto base = static_cast<size_type>(block_row_ptrs_[block_row]);
+                size_type next = base;
+                detail::for_each_block_col(data.col_indices, data.row_ptrs, first, last, C, marker, block_row,
+                                           [&](size_type block_col) {
+                                               block_col_indices_[next++] = static_cast<index_type>(block_col);
+                                           });
+                std::sort(block_col_indices_.begin() + static_cast<std::ptrdiff_t>(base),
+                          block_col_indices_.begin() + static_cast<std::ptrdiff_t>(next));
+                for (size_type k = base; k < next; ++k) {
+                    position[static_cast<size_type>(block_col_indices_[k])] = k;
+                }
+                for (size_type row = first; row < last; ++row) {
+                    for (auto p = static_cast<size_type>(data.row_ptrs[row]); p < static_cast<size_type>(data.row_ptrs[row + 1]); ++p) {
+                        const auto col = static_cast<size_type>(data.col_indices[p]);
+                        values_[position[col / C] * block_size + (col % C) * R + row % R] = data.values[p];
+                    }
+                }
+            }
+        });
+    }
+};
+
+// Converts A to the block size detect_block_size picks and passes the result
+// to fn, which must accept every BlockSparseMatrix<T, N, N> for N in 2..4 as
+// well as A itself, which it receives when blocking does not pay
+template<typename T, typename ColIndex, typename RowPtr, typename Allocator, typename F>
+auto with_block_format(const SparseMatrix<T, ColIndex, RowPtr, Allocator>& a, F&& fn) {
+    switch (detect_block_size(a).rows) {
+    case 2:
+        return fn(BlockSparseMatrix<T, 2, 2, ColIndex, RowPtr>(a));
+    case 3:
+        return fn(BlockSparseMatrix<T, 3, 3, ColIndex, RowPtr>(a));
+    case 4:
+        return fn(BlockSparseMatrix<T, 4, 4, ColIndex, RowPtr>(a));
+    default:
+        return fn(a);
+    }
+}
+
+} // namespace sparse_linalg
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "block_sparse_matrix.hpp"
+#include "spmv_kernels.hpp"
+#include "../execution/simd_utils.hpp"
+#include "../execution/cpu_features.hpp"
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+
+namespace sparse_linalg {
+
+namespace detail {
+    // Raw BSR arrays handed to the block-row kernels
+    template<typename T, typename Index, typename Ptr>
+    struct BsrArrays {
+        const Ptr* block_row_ptrs;
+        const Index* block_cols;
+        const T* values;
+        std::size_t rows;
+        std::size_t cols;
+    };
+
+    template<typename T, std::size_t R, std::size_t C, typename Index, typename Ptr>
+    auto bsr_arrays(const BlockSparseMatrix<T, R, C, Index, Ptr>& matrix) {
+        return BsrArrays<T, Index, Ptr>{
+            matrix.block_row_ptrs().data(), matrix.block_col_indices().data(), matrix.values().data(),
+            matrix.rows(), matrix.cols()
+        };
+    }
+
+    // The C entries of x a block column multiplies. Interior blocks read x
+    // in place; the edge block gets a zero-padded copy in tail.
+    template<std::size_t C, typename T>
+    inline const T* bsr_x_segment(const T* x, std::size_t block_col, std::size_t cols, T* tail) {
+        const std::size_t first = block_col * C;
+        if (first + C <= cols) {
+            return x + first;
+        }
+        for (std::size_t c = 0; c < C; ++c) {
+            tail[c] = first + c < cols ? x[first + c] : T{};
+        }
+        return tail;
+    }
+
+    // Writes a block row's sums, skipping padding rows of the edge block
+    template<std::size_t R, typename T>
+    inline void bsr_store(T* y, std::size_t block_row, std::size_t rows, const T* sums, T alpha, T beta) {
+        const std::size_t first = block_row * R;
+        const std::size_t count = std::min(R, rows - first);
+        for (std::size_t r = 0; r < count; ++r) {
+            spmv_store(y + first + r, sums[r], alpha, beta);
+        }
+    }
+
+    // Block-row kernels: y = alpha * A * x + beta * y for the block rows
+    // [block_row_begin, block_row_end). R and C are compile-time, so the
+    // block loops unroll fully and the R sums stay in registers.
+    template<typename T, std::size_t R, std::size_t C, typename Index, typename Ptr>
+    void spmv_bsr_scalar(BsrArrays<T, Index, Ptr> a, const T* x, T* y,
+                         std::size_t block_row_begin, std::size_t block_row_end, T alpha, T beta) {
+        T tail[C];
+        for (std::size_t block_row = block_row_begin; block_row < block_row_end; ++block_row) {
+            T sums[R] = {};
+            for (auto k = static_cast<std::size_t>(a.block_row_ptrs[block_row]);
+                 k < static_cast<std::size_t>(a.block_row_ptrs[block_row + 1]); ++k) {
+                const T* xs = bsr_x_segment<C>(x, static_cast<std::size_t>(a.block_cols[k]), a.cols, tail);
+                const T* block = a.values + k * R * C;
+                for (std::size_t c = 0; c < C; ++c) {
+                    const T xc = xs[c];
+                    for (std::size_t r = 0; r < R; ++r) {
+                        sums[r] += block[c * R + r] * xc;
+                    }
+                }
+            }
+            bsr_store<R>(y, block_row, a.rows, sums, alpha, beta);
+        }
+    }
+
+#if SPARSE_LINALG_HAS_X86_SIMD
+    // Vector microkernels: column c of a block is R consecutive values, so
+    // each step is R / lanes loads and FMAs against one broadcast x[c], with
+    // no horizontal sums. Even and odd columns feed separate accumulators.
+    // AVX2 needs R to be a multiple of its lane count.
+    template<typename T, std::size_t R, std::size_t C, typename Index, typename Ptr>
+    SPARSE_LINALG_TARGET_AVX2 void spmv_bsr_avx2(BsrArrays<T, Index, Ptr> a, const T* x, T* y,
+                                                std::size_t block_row_begin, std::size_t block_row_end, T alpha, T beta) {
+        using Simd = execution::SimdIsaTraits<T, execution::SimdLevel::avx2>;
+        constexpr std::size_t lanes = Simd::vector_size;
+        constexpr std::size_t vectors = R / lanes;
+        static_assert(R % lanes == 0);
+        T tail[C];
+        alignas(64) T sums[R];
+        typename Simd::vector_type even[vectors];
+        typename Simd::vector_type odd[vectors];
+        for (std::size_t block_row = block_row_begin; block_row < block_row_end; ++block_row) {
+            for (std::size_t v = 0; v < vectors; ++v) {
+                even[v] = Simd::set_zero();
+                odd[v] = Simd::set_zero();
+            }
+            for (auto k = static_cast<std::size_t>(a.block_row_ptrs[block_row]);
+                 k < static_cast<std::size_t>(a.block_row_ptrs[block_row + 1]); ++k) {
+                const T* xs = bsr_x_segment<C>(x, static_cast<std::size_t>(a.block_cols[k]), a.cols, tail);
+                const T* block = a.values + k * R * C;
+                for (std::size_t c = 0; c < C; ++c) {
+                    const auto xc = Simd::broadcast(xs[c]);
+                    auto* acc = c % 2 == 0 ? even : odd;
+                    for (std::size_t v = 0; v < vectors; ++v) {
+                        acc[v] = Simd::fmadd(Simd::load(block + c * R + v * lanes), xc, acc[v]);
+                    }
+                }
+            }
+            for (std::size_t v = 0; v < vectors; ++v) {
+                Simd::store(sums + v * lanes, Simd::add(even[v], odd[v]));
+            }
+            bsr_store<R>(y, block_row, a.rows, sums, alpha, beta);
+        }
+    }
+
+    // AVX-512 takes any R: the last vector of a block column is a masked
+    // load, so 3 x 3 blocks of doubles are one load per column
+    template<typename T, std::size_t R, std::size_t C, typename Index, typename Ptr>
+    SPARSE_LINALG_TARGET_AVX512 void spmv_bsr_avx512(BsrArrays<T, Index, Ptr> a, const T* x, T* y,
+                                                    std::size_t block_row_begin, std::size_t block_row_end, T alpha, T beta) {
+        using Simd = execution::SimdIsaTraits<T, execution::SimdLevel::avx512>;
+        constexpr std::size_t lanes = Simd::vector_size;
+        constexpr std::size_t vectors = (R + lanes - 1) / lanes;
+        constexpr std::size_t last_lanes = R - (vectors - 1) * lanes;
+        auto last_mask = static_cast<typename Simd::mask_type>(~0u);
+        if constexpr (last_lanes < lanes) {
+            last_mask = Simd::first_lanes(last_lanes);
+        }
+        T tail[C];
+        alignas(64) T sums[vectors * lanes];
+        typename Simd::vector_type even[vectors];
+        typename Simd::vector_type odd[vectors];
+        for (std::size_t block_row = block_row_begin; block_row < block_row_end; ++block_row) {
+            for (std::size_t v = 0; v < vectors; ++v) {
+                even[v] = Simd::set_zero();
+                odd[v] = Simd::set_zero();
+            }
+            for (auto k = static_cast<std::size_t>(a.block_row_ptrs[block_row]);
+                 k < static_cast<std::size_t>(a.block_row_ptrs[block_row + 1]); ++k) {
+                const T* xs = bsr_x_segment<C>(x, static_cast<std::size_t>(a.block_cols[k]), a.cols, tail);
+                const T* block = a.values + k * R * C;
+                for (std::size_t c = 0; c < C; ++c) {
+                    const auto xc = Simd::broadcast(xs[c]);
+                    auto* acc = c % 2 == 0 ? even : odd;
+                    for (std::size_t v = 0; v + 1 < vectors; ++v) {
+                        acc[v] = Simd::fmadd(Simd::load(block + c * R + v * lanes), xc, acc[v]);
+                    }
+                    acc[vectors - 1] = Simd::fmadd(
+                        Simd::mask_load(last_mask, block + c * R + (vectors - 1) * lanes), xc, acc[vectors - 1]);
+                }
+            }
+            for (std::size_t v = 0; v < vectors; ++v) {
+                Simd::store(sums + v * lanes, Simd::add(even[v], odd[v]));
+            }
+            bsr_store<R>(y, block_row, a.rows, sums, alpha, beta);
+        }
+    }
+#endif
+
+    // Picks the block-row kernel for a SIMD level. A block column that
+    // exactly fills AVX2 registers stays on AVX2 even on AVX-512 hosts,
+    // where it would run in half-masked registers; tall blocks that need
+    // more than four registers per column run scalar.
+    template<typename T, std::size_t R, std::size_t C, typename Index, typename Ptr>
+    struct BsrKernel {
+        using function_type = void (*)(BsrArrays<T, Index, Ptr>, const T*, T*, std::size_t, std::size_t, T, T);
+
+        static function_type select([[maybe_unused]] execution::SimdLevel level) {
+#if SPARSE_LINALG_HAS_X86_SIMD
+            if constexpr (std::floating_point<T>) {
+                constexpr std::size_t avx2_lanes = execution::SimdIsaTraits<T, execution::SimdLevel::avx2>::vector_size;
+                constexpr std::size_t avx512_lanes = execution::SimdIsaTraits<T, execution::SimdLevel::avx512>::vector_size;
+                constexpr bool fits_avx2 = R % avx2_lanes == 0 && R / avx2_lanes <= 4;
+                constexpr bool fits_avx512 = (R + avx512_lanes - 1) / avx512_lanes <= 4;
+                if constexpr (fits_avx512) {
+                    if (level == execution::SimdLevel::avx512 && !(fits_avx2 && R % avx512_lanes != 0)) {
+                        return &spmv_bsr_avx512<T, R, C, Index, Ptr>;
+                    }
+                }
+                if constexpr (fits_avx2) {
+                    if (level != execution::SimdLevel::scalar) {
+                        return &spmv_bsr_avx2<T, R, C, Index, Ptr>;
+                    }
+                }
+            }
+#endif
+            return &spmv_bsr_scalar<T, R, C, Index, Ptr>;
+        }
+
+        static function_type get() {
+            return select(execution::active_simd_level());
+        }
+    };
+}
+
+} // namespace sparse_linalg
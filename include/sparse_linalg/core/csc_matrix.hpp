@@ -0,0 +1,190 @@
+#pragma once
+
+#include "sparse_matrix.hpp"
+#include "allocators.hpp"
+#include "partition.hpp"
+#include "parallel_utils.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace sparse_linalg {
+
+namespace detail {
+    // Arrays of the transpose of a CSR matrix, which are also its CSC form
+    template<typename T, typename Index, typename Offset, typename Allocator = std::allocator<T>>
+    struct TransposedArrays {
+        template<typename U>
+        using vector_type = std::vector<U, typename std::allocator_traits<Allocator>::template rebind_alloc<U>>;
+
+        vector_type<Offset> ptrs;
+        vector_type<Index> indices;
+        vector_type<T> values;
+    };
+
+    // Counting-sort transpose in O(nnz + rows + cols). Each part counts the
+    // columns of its rows, the counts are prefix-summed in (column, part)
+    // order, and each part scatters its entries into its reserved slots.
+    // Parts own increasing row ranges and walk them in order, so indices
+    // come out sorted within every column. The result is stored with
+    // Allocator, whatever the input uses.
+    template<typename Allocator, typename T, typename Index, typename Offset, typename InputAllocator>
+    TransposedArrays<T, Index, Offset, Allocator> transpose_csr(
+        const SparseMatrix<T, Index, Offset, InputAllocator>& matrix,
+        execution::ThreadPool* pool
+    ) {
+        const std::size_t rows = matrix.rows();
+        const std::size_t cols = matrix.cols();
+        const auto& data = matrix.raw_data();
+        if (rows > 0) {
+            checked_index_cast<Index>(rows - 1);
+        }
+
+        const std::size_t parts = pool ? pool->thread_count() : 1;
+        const auto row_bounds = partition_by_nnz(std::span<const Offset>(data.row_ptrs), parts);
+        const auto part_ids = partition_range(std::size_t{0}, parts, parts);
+
+        // counts[part * cols + col]: entries of col within the part's rows
+        pooled_vector<std::size_t> counts(parts * cols, 0);
+        run_parts(pool, part_ids, [&](std::size_t first, std::size_t last) {
+            for (std::size_t part = first; part < last; ++part) {
+                std::size_t* local = counts.data() + part * cols;
+                const auto begin = static_cast<std::size_t>(data.row_ptrs[row_bounds[part]]);
+                const auto end = static_cast<std::size_t>(data.row_ptrs[row_bounds[part + 1]]);
+                for (std::size_t p = begin; p < end; ++p) {
+                    ++local[static_cast<std::size_t>(data.col_indices[p])];
+                }
+            }
+        });
+
+        // Per column: totals, and each part's offset inside the column
+        pooled_vector<std::size_t> col_start(cols + 1, 0);
+        for_each_partition(pool, cols, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t col = begin; col < end; ++col) {
+                std::size_t running = 0;
+                for (std::size_t part = 0; part < parts; ++part) {
+                    const std::size_t count = counts[part * cols + col];
+                    counts[part * cols + col] = running;
+                    running += count;
+                }
+                col_start[col + 1] = running;
+            }
+        });
+        for (std::size_t col = 0; col < cols; ++col) {
+            col_start[col + 1] += col_start[col];
+        }
+
+        TransposedArrays<T, Index, Offset, Allocator> result;
+        result.ptrs.resize(cols + 1);
+        std::transform(col_start.begin(), col_start.end(), result.ptrs.begin(),
+                       [](std::size_t offset) { return static_cast<Offset>(offset); });
+        result.indices.resize(matrix.nnz());
+        result.values.resize(matrix.nnz());
+
+        run_parts(pool, part_ids, [&](std::size_t first, std::size_t last) {
+            for (std::size_t part = first; part < last; ++part) {
+                std::size_t* cursor = counts.data() + part * cols;
+                for (std::size_t row = row_bounds[part]; row < row_bounds[part + 1]; ++row) {
+                    const auto stop = static_cast<std::size_t>(data.row_ptrs[row + 1]);
+                    for (auto p = static_cast<std::size_t>(data.row_ptrs[row]); p < stop; ++p) {
+                        const auto col = static_cast<std::size_t>(data.col_indices[p]);
+                        const std::size_t slot = col_start[col] + cursor[col]++;
+                        result.indices[slot] = static_cast<Index>(row);
+                        result.values[slot] = data.values[p];
+                    }
+                }
+            }
+        });
+
+        return result;
+    }
+}
+
+// Compressed Sparse Column storage, built from a CSR matrix by an O(nnz)
+// transpose. Gives column-wise access to the entries of A.
+template<typename T, typename RowIndex = std::size_t, typename ColPtr = std::size_t>
+    requires MatrixValue<T> && MatrixIndex<RowIndex> && MatrixIndex<ColPtr>
+class CscMatrix {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using index_type = RowIndex;
+    using offset_type = ColPtr;
+
+    struct CSCMatrix {
+        std::vector<value_type> values;
+        std::vector<index_type> row_indices;
+        std::vector<offset_type> col_ptrs;
+    };
+
+    // Sequential conversion
+    template<typename Allocator>
+    explicit CscMatrix(const SparseMatrix<T, RowIndex, ColPtr, Allocator>& csr)
+        : CscMatrix(csr, nullptr) {}
+
+    // Parallel conversion: per-thread histograms and scatter on the pool
+    template<typename Allocator>
+    CscMatrix(const SparseMatrix<T, RowIndex, ColPtr, Allocator>& csr, execution::ThreadPool& pool)
+        : CscMatrix(csr, &pool) {}
+
+    [[nodiscard]] auto rows() const noexcept -> size_type { return rows_; }
+    [[nodiscard]] auto cols() const noexcept -> size_type { return cols_; }
+    [[nodiscard]] auto nnz() const noexcept -> size_type { return data_.values.size(); }
+
+    [[nodiscard]] auto operator()(size_type row, size_type col) const -> value_type {
+        if (row >= rows_ || col >= cols_) {
+            throw std::out_of_range("Matrix indices out of range");
+        }
+        auto rows_of_col = col_indices(col);
+        auto it = std::lower_bound(rows_of_col.begin(), rows_of_col.end(), static_cast<index_type>(row));
+        if (it != rows_of_col.end() && *it == static_cast<index_type>(row)) {
+            return col_values(col)[static_cast<size_type>(it - rows_of_col.begin())];
+        }
+        return value_type{};
+    }
+
+    [[nodiscard]] auto col_values(size_type col) const -> std::span<const value_type> {
+        validate_col(col);
+        return std::span<const value_type>(
+            data_.values.begin() + static_cast<difference_type>(data_.col_ptrs[col]),
+            data_.values.begin() + static_cast<difference_type>(data_.col_ptrs[col + 1])
+        );
+    }
+
+    // Row indices of the entries in a column, ascending
+    [[nodiscard]] auto col_indices(size_type col) const -> std::span<const index_type> {
+        validate_col(col);
+        return std::span<const index_type>(
+            data_.row_indices.begin() + static_cast<difference_type>(data_.col_ptrs[col]),
+            data_.row_indices.begin() + static_cast<difference_type>(data_.col_ptrs[col + 1])
+        );
+    }
+
+    [[nodiscard]] const CSCMatrix& raw_data() const noexcept { return data_; }
+
+private:
+    size_type rows_;
+    size_type cols_;
+    CSCMatrix data_;
+
+    template<typename Allocator>
+    CscMatrix(const SparseMatrix<T, RowIndex, ColPtr, Allocator>& csr, execution::ThreadPool* pool)
+        : rows_(csr.rows()), cols_(csr.cols()) {
+        auto arrays = detail::transpose_csr<std::allocator<T>>(csr, pool);
+        data_.values = std::move(arrays.values);
+        data_.row_indices = std::move(arrays.indices);
+        data_.col_ptrs = std::move(arrays.ptrs);
+    }
+
+    void validate_col(size_type col) const {
+        if (col >= cols_) {
+            throw std::out_of_range("Column index out of range");
+        }
+    }
+};
+
+} // namespace sparse_linalg
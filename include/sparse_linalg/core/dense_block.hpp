@@ -0,0 +1,76 @@
+#pragma once
+
+#include "sparse_matrix.hpp"
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+namespace sparse_linalg {
+
+enum class Layout {
+    row_major,  // element (i, j) at i * leading_dimension + j
+    col_major   // element (i, j) at j * leading_dimension + i
+};
+
+// Non-owning view of a dense rows x cols block, e.g. k right-hand sides
+// stored side by side. T may be const for read-only operands.
+template<typename T>
+    requires MatrixValue<std::remove_const_t<T>>
+class DenseBlockView {
+public:
+    using value_type = std::remove_const_t<T>;
+    using size_type = std::size_t;
+
+    // A leading dimension of 0 means tightly packed (cols for row-major,
+    // rows for column-major)
+    DenseBlockView(std::span<T> data, size_type rows, size_type cols,
+                   Layout layout = Layout::row_major, size_type leading_dimension = 0)
+        : data_(data), rows_(rows), cols_(cols), layout_(layout),
+          ld_(leading_dimension != 0 ? leading_dimension : (layout == Layout::row_major ? cols : rows)) {
+        const size_type inner = layout_ == Layout::row_major ? cols_ : rows_;
+        const size_type outer = layout_ == Layout::row_major ? rows_ : cols_;
+        if (ld_ < inner) {
+            throw std::invalid_argument("Leading dimension smaller than the block");
+        }
+        if (outer > 0 && inner > 0 && data_.size() < (outer - 1) * ld_ + inner) {
+            throw std::invalid_argument("Dense block storage too small");
+        }
+    }
+
+    // Read-only view of a mutable block
+    operator DenseBlockView<const T>() const
+        requires (!std::is_const_v<T>) {
+        return DenseBlockView<const T>(std::span<const T>(data_), rows_, cols_, layout_, ld_);
+    }
+
+    [[nodiscard]] auto rows() const noexcept -> size_type { return rows_; }
+    [[nodiscard]] auto cols() const noexcept -> size_type { return cols_; }
+    [[nodiscard]] auto layout() const noexcept -> Layout { return layout_; }
+    [[nodiscard]] auto leading_dimension() const noexcept -> size_type { return ld_; }
+    [[nodiscard]] auto data() const noexcept -> T* { return data_.data(); }
+
+    // Distance between (i, j) and (i + 1, j) / (i, j + 1)
+    [[nodiscard]] auto row_stride() const noexcept -> size_type {
+        return layout_ == Layout::row_major ? ld_ : 1;
+    }
+    [[nodiscard]] auto col_stride() const noexcept -> size_type {
+        return layout_ == Layout::row_major ? 1 : ld_;
+    }
+
+    [[nodiscard]] T& operator()(size_type row, size_type col) const {
+        if (row >= rows_ || col >= cols_) {
+            throw std::out_of_range("Dense block indices out of range");
+        }
+        return data_[row * row_stride() + col * col_stride()];
+    }
+
+private:
+    std::span<T> data_;
+    size_type rows_;
+    size_type cols_;
+    Layout layout_;
+    size_type ld_;
+};
+
+} // namespace sparse_linalg
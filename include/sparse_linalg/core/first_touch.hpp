@@ -0,0 +1,138 @@
+#pragma once
+
+#include "sparse_matrix.hpp"
+#include "partition.hpp"
+#include "parallel_utils.hpp"
+#include "../execution/thread_pool.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace sparse_linalg {
+
+// Linux places a page on the NUMA node of the thread that first writes it.
+// These helpers build matrices and vectors whose pages are first written
+// by the pinned pool worker that processes them in multiply_parallel: with
+// the same strategy and pool size the partition plan, and with it the
+// worker of every row span, is the same on every call.
+
+namespace detail {
+    // Returns the whole pages inside [data, data + bytes) to the kernel, so
+    // the next write to each faults in a fresh zero page on the writer's
+    // node. The contents of those pages are lost.
+    inline void release_pages(void* data, std::size_t bytes) {
+#ifdef __linux__
+        static const auto page = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+        const auto begin = (reinterpret_cast<std::uintptr_t>(data) + page - 1) / page * page;
+        const auto end = (reinterpret_cast<std::uintptr_t>(data) + bytes) / page * page;
+        if (begin < end) {
+            ::madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+        }
+#else
+        static_cast<void>(data);
+        static_cast<void>(bytes);
+#endif
+    }
+
+    template<typename T, typename Allocator>
+    void release_pages(std::vector<T, Allocator>& vec) {
+        release_pages(vec.data(), vec.size() * sizeof(T));
+    }
+
+    // Boundaries splitting [0, size) like the row spans of a plan over `rows` rows
+    inline std::vector<std::size_t> span_bounds(const PartitionPlan& plan, std::size_t rows, std::size_t size) {
+        std::vector<std::size_t> bounds;
+        bounds.reserve(plan.spans.size() + 1);
+        for (const auto& span : plan.spans) {
+            const auto row = span.row_begin;
+            bounds.push_back(rows == 0 ? 0 : row * (size / rows) + row * (size % rows) / rows);
+        }
+        bounds.push_back(size);
+        return bounds;
+    }
+
+    template<typename Vector>
+    Vector placed_vector(std::size_t size, const std::vector<std::size_t>& bounds,
+                         execution::ThreadPool& pool, auto&& fill) {
+        Vector result(size);
+        release_pages(result);
+        run_parts(&pool, bounds, [&](std::size_t begin, std::size_t end) { fill(result.data(), begin, end); });
+        return result;
+    }
+}
+
+// Copy of `matrix` whose row span i (of the plan for `strategy` over
+// pool.thread_count() parts) is first written by the worker that runs it.
+// The plan is cached in the copy. Only useful on a pool pinned with
+// ThreadAffinity; generators given a pinned pool place their output the
+// same way without a copy.
+template<typename T, typename ColIndex, typename RowPtr, typename Allocator>
+[[nodiscard]] SparseMatrix<T, ColIndex, RowPtr, Allocator> first_touch_copy(
+    const SparseMatrix<T, ColIndex, RowPtr, Allocator>& matrix,
+    execution::ThreadPool& pool,
+    PartitionStrategy strategy = PartitionStrategy::nnz
+) {
+    const auto plan = matrix.partition_plan(strategy, pool.thread_count());
+    const auto& source = matrix.raw_data();
+    const std::size_t rows = matrix.rows();
+
+    std::vector<std::size_t> row_bounds;
+    std::vector<std::size_t> nnz_bounds;
+    for (const auto& span : plan->spans) {
+        row_bounds.push_back(span.row_begin);
+        nnz_bounds.push_back(span.nnz_begin);
+    }
+    row_bounds.push_back(rows + 1);
+    nnz_bounds.push_back(matrix.nnz());
+
+    auto copy_range = [](const auto& from) {
+        return [&from](auto* to, std::size_t begin, std::size_t end) {
+            std::copy(from.begin() + static_cast<std::ptrdiff_t>(begin),
+                      from.begin() + static_cast<std::ptrdiff_t>(end), to + begin);
+        };
+    };
+    using matrix_type = SparseMatrix<T, ColIndex, RowPtr, Allocator>;
+    typename matrix_type::CSRMatrix data{
+        detail::placed_vector<decltype(source.values)>(matrix.nnz(), nnz_bounds, pool, copy_range(source.values)),
+        detail::placed_vector<decltype(source.col_indices)>(matrix.nnz(), nnz_bounds, pool,
+                                                            copy_range(source.col_indices)),
+        detail::placed_vector<decltype(source.row_ptrs)>(rows + 1, row_bounds, pool, copy_range(source.row_ptrs))
+    };
+    matrix_type result(rows, matrix.cols(), std::move(data));
+    static_cast<void>(result.partition_plan(strategy, pool.thread_count()));
+    return result;
+}
+
+// Vector of `size` copies of `value` split like the row spans of `matrix`:
+// entry k goes to the worker owning row k * rows / size. Sized rows(), it
+// is a y that multiply_parallel writes locally; for a square matrix sized
+// cols() it is also the matching x.
+template<typename T, typename V, typename ColIndex, typename RowPtr, typename Allocator>
+[[nodiscard]] std::vector<T> first_touch_vector(
+    const SparseMatrix<V, ColIndex, RowPtr, Allocator>& matrix,
+    std::size_t size,
+    T value,
+    execution::ThreadPool& pool,
+    PartitionStrategy strategy = PartitionStrategy::nnz
+) {
+    const auto plan = matrix.partition_plan(strategy, pool.thread_count());
+    return detail::placed_vector<std::vector<T>>(size, detail::span_bounds(*plan, matrix.rows(), size), pool,
+        [&](T* to, std::size_t begin, std::size_t end) { std::fill(to + begin, to + end, value); });
+}
+
+// Vector split into pool.thread_count() equal blocks, block w first written
+// by worker w; matches parallel_for_static over the same range
+template<typename T>
+[[nodiscard]] std::vector<T> first_touch_vector(std::size_t size, T value, execution::ThreadPool& pool) {
+    return detail::placed_vector<std::vector<T>>(size, detail::partition_range(std::size_t{0}, size, pool.thread_count()), pool,
+        [&](T* to, std::size_t begin, std::size_t end) { std::fill(to + begin, to + end, value); });
+}
+
+} // namespace sparse_linalg
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstdint>
+
+namespace sparse_linalg {
+
+// 16-bit storage formats for matrix values. They hold bits only: values are
+// widened to float (exactly) before any arithmetic, and narrowed from float
+// with round-to-nearest-even; detail::narrow rounds doubles to them once, not
+// through float. Neither needs hardware support; SIMD kernels convert them in
+// registers where the host can (see SimdIsaTraits::load_widen).
+
+// bfloat16: float's sign and 8-bit exponent with a 7-bit mantissa. Same
+// range as float, about 3 significant decimal digits.
+struct bfloat16 {
+    std::uint16_t bits = 0;
+
+    constexpr bfloat16() = default;
+
+    constexpr explicit bfloat16(float value) : bits(narrow(std::bit_cast<std::uint32_t>(value))) {}
+
+    [[nodiscard]] static constexpr bfloat16 from_bits(std::uint16_t bits) {
+        bfloat16 result;
+        result.bits = bits;
+        return result;
+    }
+
+    constexpr explicit operator float() const {
+        return std::bit_cast<float>(static_cast<std::uint32_t>(bits) << 16);
+    }
+
+    friend constexpr bool operator==(bfloat16, bfloat16) = default;
+
+private:
+    static constexpr std::uint16_t narrow(std::uint32_t f) {
+        if ((f & 0x7FFFFFFFu) > 0x7F800000u) {
+            // NaN: keep the sign and set the quiet bit so truncation cannot make it infinite
+            return static_cast<std::uint16_t>((f >> 16) | 0x0040u);
+        }
+        const std::uint32_t round = 0x7FFFu + ((f >> 16) & 1u);
+        return static_cast<std::uint16_t>((f + round) >> 16);
+    }
+};
+
+// IEEE 754 binary16: 5-bit exponent and 10-bit mantissa. Largest finite
+// value 65504, about 3.3 significant decimal digits; magnitudes above the
+// range round to infinity and below 2^-24 to zero.
+struct float16 {
+    std::uint16_t bits = 0;
+
+    constexpr float16() = default;
+
+    constexpr explicit float16(float value) : bits(narrow(value)) {}
+
+    [[nodiscard]] static constexpr float16 from_bits(std::uint16_t bits) {
+        float16 result;
+        result.bits = bits;
+        return result;
+    }
+
+    constexpr explicit operator float() const {
+        const std::uint32_t sign = static_cast<std::uint32_t>(bits & 0x8000u) << 16;
+        const std::uint32_t exponent = (bits >> 10) & 0x1Fu;
+        const std::uint32_t mantissa = bits & 0x3FFu;
+        if (exponent == 0) {
+            // Zero or subnormal: mantissa * 2^-24, exact in float
+            const float magnitude = static_cast<float>(mantissa) * 0x1p-24f;
+            return std::bit_cast<float>(sign | std::bit_cast<std::uint32_t>(magnitude));
+        }
+        if (exponent == 0x1F) {
+            return std::bit_cast<float>(sign | 0x7F800000u | (mantissa << 13));
+        }
+        return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+    }
+
+    friend constexpr bool operator==(float16, float16) = default;
+
+private:
+    static constexpr std::uint16_t narrow(float value) {
+        std::uint32_t f = std::bit_cast<std::uint32_t>(value);
+        const auto sign = static_cast<std::uint16_t>((f >> 16) & 0x8000u);
+        f &= 0x7FFFFFFFu;
+
+        std::uint32_t half;
+        if (f >= 0x47800000u) {
+            // 2^16 and up, infinity or NaN (quieted)
+            half = f > 0x7F800000u ? 0x7E00u : 0x7C00u;
+        } else if (f < 0x38800000u) {
+            // Below 2^-14: subnormal or zero. Adding 0.5 lines the half's
+            // mantissa up with the low float bits and rounds to nearest even.
+            const float shifted = std::bit_cast<float>(f) + 0.5f;
+            half = std::bit_cast<std::uint32_t>(shifted) - 0x3F000000u;
+        } else {
+            // Rebias the exponent and round the 13 dropped bits to nearest
+            // even; a carry out of the mantissa bumps the exponent, up to infinity
+            const std::uint32_t odd = (f >> 13) & 1u;
+            f += 0xC8000FFFu + odd;  // (15 - 127) << 23, plus the rounding bias
+            half = f >> 13;
+        }
+        return static_cast<std::uint16_t>(sign | half);
+    }
+};
+
+static_assert(sizeof(bfloat16) == 2 && sizeof(float16) == 2);
+
+// Value types a matrix can be stored in with wider arithmetic on top
+template<typename S>
+concept ReducedPrecision = std::same_as<S, float> || std::same_as<S, bfloat16> || std::same_as<S, float16>;
+
+namespace detail {
+    // Converts a stored value to the compute type, exactly
+    template<typename T, typename S>
+    constexpr T widen(S value) {
+        return static_cast<T>(static_cast<float>(value));
+    }
+
+    // value rounded toward zero to float, with the last bit set if any bits
+    // were dropped (round-to-odd). Rounding that to nearest even at 22 bits
+    // or fewer gives the same as rounding value directly, so a double goes
+    // through float to bfloat16 or float16 without being rounded twice.
+    constexpr float round_to_odd(double value) {
+        const float nearest = static_cast<float>(value);
+        const auto back = static_cast<double>(nearest);
+        if (back == value || value != value) {
+            return nearest;
+        }
+        auto bits = std::bit_cast<std::uint32_t>(nearest);
+        if ((back > value) == (value > 0.0)) {
+            --bits;  // rounded away from zero, possibly to infinity: step back
+        }
+        return std::bit_cast<float>(bits | 1u);
+    }
+
+    // Rounds a value to the storage type to nearest even
+    template<typename S, typename T>
+    constexpr S narrow(T value) {
+        if constexpr (std::same_as<S, float> || std::same_as<T, float>) {
+            return S(static_cast<float>(value));
+        } else {
+            return S(round_to_odd(static_cast<double>(value)));
+        }
+    }
+}
+
+} // namespace sparse_linalg
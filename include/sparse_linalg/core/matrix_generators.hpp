@@ -0,0 +1,460 @@
+#pragma once
+
+#include "sparse_matrix.hpp"
+#include "partition.hpp"
+#include "parallel_utils.hpp"
+#include "first_touch.hpp"
+#include "../execution/thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace sparse_linalg {
+
+// Synthetic test matrices with the structures SpMV performance depends on:
+// stencils, bands, dense blocks and skewed or power-law row lengths. Each
+// generator writes CSR arrays directly, in parallel when given a pool, so
+// matrices with tens of millions of rows build in seconds. Random values
+// and columns come from a counter-based hash of (seed, row, position), so
+// the result depends on the seed only, not on the thread count.
+
+// Quadrant probabilities of the R-MAT recursion; d = 1 - a - b - c.
+// The defaults are Graph500's.
+struct RmatParameters {
+    double a = 0.57;
+    double b = 0.19;
+    double c = 0.19;
+};
+
+namespace detail {
+    // splitmix64 finalizer
+    constexpr std::uint64_t mix_bits(std::uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ull;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    constexpr std::uint64_t random_bits(std::uint64_t seed, std::uint64_t stream, std::uint64_t counter) {
+        return mix_bits(seed ^ mix_bits(stream * 0x9E3779B97F4A7C15ull + counter));
+    }
+
+    // Uniform in [0, 1) from the top 53 bits
+    constexpr double unit_interval(std::uint64_t bits) {
+        return static_cast<double>(bits >> 11) * 0x1p-53;
+    }
+
+    // Uniform in [lo, lo + span)
+    constexpr std::size_t uniform_below(std::uint64_t bits, std::size_t lo, std::size_t span) {
+        return lo + static_cast<std::size_t>(unit_interval(bits) * static_cast<double>(span));
+    }
+
+    // Off-diagonal value in [-1, 1)
+    template<typename T>
+    T random_entry(std::uint64_t seed, std::size_t row, std::size_t col) {
+        return static_cast<T>(2.0 * unit_interval(random_bits(seed, row, col)) - 1.0);
+    }
+
+    // Assembles a matrix row by row. row_length(row) gives the number of
+    // entries of a row; fill_row(row, cols, values) writes them in
+    // ascending column order. Both are called concurrently for different rows.
+    template<typename T, typename ColIndex, typename RowPtr, typename Length, typename Fill>
+    SparseMatrix<T, ColIndex, RowPtr> generate_rows(std::size_t rows, std::size_t cols, execution::ThreadPool* pool,
+                                                     Length&& row_length, Fill&& fill_row) {
+        if (cols > 0) {
+            checked_index_cast<ColIndex>(cols - 1);
+        }
+        typename SparseMatrix<T, ColIndex, RowPtr>::CSRMatrix data;
+        data.row_ptrs.resize(rows + 1);
+
+        // Two-level scan: part totals, then running offsets within each part
+        const std::size_t parts = pool && rows >= pool->thread_count() ? pool->thread_count() : 1;
+        const auto bounds = partition_range(std::size_t{0}, rows, parts);
+        std::vector<std::size_t> part_nnz(parts + 1, 0);
+        run_parts(pool, bounds, [&](std::size_t begin, std::size_t end) {
+            std::size_t count = 0;
+            for (std::size_t row = begin; row < end; ++row) {
+                count += row_length(row);
+            }
+            const auto part = static_cast<std::size_t>(
+                std::lower_bound(bounds.begin(), bounds.end(), begin) - bounds.begin());
+            part_nnz[part + 1] = count;
+        });
+        std::inclusive_scan(part_nnz.begin(), part_nnz.end(), part_nnz.begin());
+        checked_index_cast<RowPtr>(part_nnz.back());
+
+        run_parts(pool, bounds, [&](std::size_t begin, std::size_t end) {
+            const auto part = static_cast<std::size_t>(
+                std::lower_bound(bounds.begin(), bounds.end(), begin) - bounds.begin());
+            std::size_t offset = part_nnz[part];
+            for (std::size_t row = begin; row < end; ++row) {
+                offset += row_length(row);
+                data.row_ptrs[row + 1] = static_cast<RowPtr>(offset);
+            }
+        });
+
+        data.col_indices.resize(part_nnz.back());
+        data.values.resize(part_nnz.back());
+        // A pinned pool fills each span on the worker that multiplies it,
+        // so let those writes be the first touch
+        if (pool && pool->affinity() != execution::ThreadAffinity::none) {
+            release_pages(data.col_indices);
+            release_pages(data.values);
+        }
+        // Fill by nonzeros so a few long rows do not serialize the pass
+        const auto fill_bounds = pool
+            ? partition_by_nnz(std::span<const RowPtr>(data.row_ptrs), pool->thread_count())
+            : std::vector<std::size_t>{0, rows};
+        run_parts(pool, fill_bounds, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t row = begin; row < end; ++row) {
+                const auto first = static_cast<std::size_t>(data.row_ptrs[row]);
+                fill_row(row, data.col_indices.data() + first, data.values.data() + first);
+            }
+        });
+        return SparseMatrix<T, ColIndex, RowPtr>(rows, cols, std::move(data));
+    }
+
+    // Stencil of 2 * dims + 1 points on a grid with the given extents,
+    // first coordinate fastest: 2 * dims on the diagonal, -1 for neighbours
+    template<typename T, typename ColIndex, typename RowPtr, std::size_t Dims>
+    SparseMatrix<T, ColIndex, RowPtr> poisson(const std::size_t (&extent)[Dims], execution::ThreadPool* pool) {
+        std::size_t stride[Dims];
+        std::size_t n = 1;
+        for (std::size_t d = 0; d < Dims; ++d) {
+            if (extent[d] == 0) {
+                throw std::invalid_argument("Grid extents must be positive");
+            }
+            stride[d] = n;
+            if (n > static_cast<std::size_t>(-1) / extent[d]) {
+                throw std::overflow_error("Grid has too many points");
+            }
+            n *= extent[d];
+        }
+
+        auto coordinate = [&](std::size_t row, std::size_t d) { return row / stride[d] % extent[d]; };
+        return generate_rows<T, ColIndex, RowPtr>(n, n, pool,
+            [&](std::size_t row) {
+                std::size_t length = 1;
+                for (std::size_t d = 0; d < Dims; ++d) {
+                    const auto c = coordinate(row, d);
+                    if (c > 0) {
+                        ++length;
+                    }
+                    if (c + 1 < extent[d]) {
+                        ++length;
+                    }
+                }
+                return length;
+            },
+            [&](std::size_t row, ColIndex* cols, T* values) {
+                std::size_t k = 0;
+                auto put = [&](std::size_t col, T value) {
+                    cols[k] = static_cast<ColIndex>(col);
+                    values[k] = value;
+                    ++k;
+                };
+                // Lower neighbours from the slowest dimension down, then the
+                // diagonal, then upper neighbours: ascending columns
+                for (std::size_t d = Dims; d-- > 0;) {
+                    if (coordinate(row, d) > 0) {
+                        put(row - stride[d], T{-1});
+                    }
+                }
+                put(row, static_cast<T>(2 * Dims));
+                for (std::size_t d = 0; d < Dims; ++d) {
+                    if (coordinate(row, d) + 1 < extent[d]) {
+                        put(row + stride[d], T{-1});
+                    }
+                }
+            });
+    }
+
+    template<typename T, typename ColIndex, typename RowPtr>
+    SparseMatrix<T, ColIndex, RowPtr> banded(std::size_t n, std::size_t lower, std::size_t upper,
+                                              std::uint64_t seed, execution::ThreadPool* pool) {
+        const auto diagonal = static_cast<T>(lower + upper + 1);
+        return generate_rows<T, ColIndex, RowPtr>(n, n, pool,
+            [&](std::size_t row) {
+                return std::min(row, lower) + std::min(n - 1 - row, upper) + 1;
+            },
+            [&](std::size_t row, ColIndex* cols, T* values) {
+                const std::size_t first = row - std::min(row, lower);
+                const std::size_t last = row + std::min(n - 1 - row, upper);
+                for (std::size_t col = first; col <= last; ++col) {
+                    cols[col - first] = static_cast<ColIndex>(col);
+                    values[col - first] = col == row ? diagonal : random_entry<T>(seed, row, col);
+                }
+            });
+    }
+
+    template<typename T, typename ColIndex, typename RowPtr>
+    SparseMatrix<T, ColIndex, RowPtr> block_diagonal(std::size_t blocks, std::size_t block_size,
+                                                      std::uint64_t seed, execution::ThreadPool* pool) {
+        if (block_size > 0 && blocks > static_cast<std::size_t>(-1) / block_size) {
+            throw std::overflow_error("Matrix has too many rows");
+        }
+        const std::size_t n = blocks * block_size;
+        const auto diagonal = static_cast<T>(block_size);
+        return generate_rows<T, ColIndex, RowPtr>(n, n, pool,
+            [&](std::size_t) { return block_size; },
+            [&](std::size_t row, ColIndex* cols, T* values) {
+                const std::size_t first = row - row % block_size;
+                for (std::size_t k = 0; k < block_size; ++k) {
+                    cols[k] = static_cast<ColIndex>(first + k);
+                    values[k] = first + k == row ? diagonal : random_entry<T>(seed, row, first + k);
+                }
+            });
+    }
+
+    // Rows of the given lengths with columns spread over the whole matrix:
+    // one random column in each of `length` equal slices of [0, n)
+    template<typename T, typename ColIndex, typename RowPtr, typename Length>
+    SparseMatrix<T, ColIndex, RowPtr> scattered_rows(std::size_t n, std::uint64_t seed,
+                                                      execution::ThreadPool* pool, Length&& row_length) {
+        return generate_rows<T, ColIndex, RowPtr>(n, n, pool, row_length,
+            [&](std::size_t row, ColIndex* cols, T* values) {
+                const std::size_t length = row_length(row);
+                for (std::size_t k = 0; k < length; ++k) {
+                    const std::size_t lo = k * n / length;
+                    const std::size_t hi = (k + 1) * n / length;
+                    const std::size_t col = uniform_below(random_bits(seed, row, k), lo, hi - lo);
+                    cols[k] = static_cast<ColIndex>(col);
+                    values[k] = random_entry<T>(seed, row, col);
+                }
+            });
+    }
+
+    template<typename T, typename ColIndex, typename RowPtr>
+    SparseMatrix<T, ColIndex, RowPtr> power_law_rows(std::size_t n, std::size_t max_row_length, double exponent,
+                                                      std::uint64_t seed, execution::ThreadPool* pool) {
+        if (max_row_length > n) {
+            throw std::invalid_argument("Row length exceeds the matrix size");
+        }
+        if (!(exponent >= 0.0)) {
+            throw std::invalid_argument("Power-law exponent must be non-negative");
+        }
+        return scattered_rows<T, ColIndex, RowPtr>(n, seed, pool, [=](std::size_t row) {
+            const double length = std::floor(static_cast<double>(max_row_length) *
+                                             std::pow(static_cast<double>(row + 1), -exponent));
+            return std::max<std::size_t>(1, static_cast<std::size_t>(length));
+        });
+    }
+
+    template<typename T, typename ColIndex, typename RowPtr>
+    SparseMatrix<T, ColIndex, RowPtr> skewed_rows(std::size_t n, std::size_t row_length, std::size_t dense_rows,
+                                                   std::size_t dense_row_length, std::uint64_t seed,
+                                                   execution::ThreadPool* pool) {
+        if (row_length > n || dense_row_length > n || dense_rows > n) {
+            throw std::invalid_argument("Row length exceeds the matrix size");
+        }
+        // Dense rows sit at floor(k * n / dense_rows) for k < dense_rows
+        return scattered_rows<T, ColIndex, RowPtr>(n, seed, pool, [=](std::size_t row) {
+            const std::size_t k = (row * dense_rows + n - 1) / n;
+            return k < dense_rows && k * n / dense_rows == row ? dense_row_length : row_length;
+        });
+    }
+
+    template<typename T, typename ColIndex, typename RowPtr>
+    SparseMatrix<T, ColIndex, RowPtr> rmat(std::size_t scale, std::size_t edge_factor, RmatParameters params,
+                                            std::uint64_t seed, execution::ThreadPool* pool) {
+        if (scale >= 48 || (edge_factor > 0 && (std::size_t{1} << scale) > static_cast<std::size_t>(-1) / edge_factor)) {
+            throw std::overflow_error("R-MAT graph is too large");
+        }
+        if (!(params.a >= 0.0 && params.b >= 0.0 && params.c >= 0.0 && params.a + params.b + params.c <= 1.0)) {
+            throw std::invalid_argument("R-MAT probabilities must be non-negative and sum to at most 1");
+        }
+        const std::size_t n = std::size_t{1} << scale;
+        const std::size_t edges = edge_factor * n;
+        checked_index_cast<ColIndex>(n - 1);
+
+        // Edge e descends `scale` levels, picking a quadrant at each
+        auto edge = [&](std::size_t e) {
+            std::size_t row = 0;
+            std::size_t col = 0;
+            for (std::size_t level = 0; level < scale; ++level) {
+                const double u = unit_interval(random_bits(seed, e, level));
+                const std::size_t bit = std::size_t{1} << (scale - 1 - level);
+                if (u >= params.a + params.b) {
+                    row |= bit;
+                    if (u >= params.a + params.b + params.c) {
+                        col |= bit;
+                    }
+                } else if (u >= params.a) {
+                    col |= bit;
+                }
+            }
+            return std::pair{row, col};
+        };
+
+        // Counting sort on rows, regenerating the edges instead of storing them
+        std::vector<std::size_t> row_start(n + 1, 0);
+        for_each_partition(pool, edges, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t e = begin; e < end; ++e) {
+                std::atomic_ref<std::size_t>(row_start[edge(e).first + 1]).fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        std::inclusive_scan(row_start.begin(), row_start.end(), row_start.begin());
+
+        std::vector<ColIndex> targets(edges);
+        {
+            std::vector<std::size_t> cursor(row_start.begin(), row_start.end() - 1);
+            for_each_partition(pool, edges, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t e = begin; e < end; ++e) {
+                    const auto [row, col] = edge(e);
+                    const auto slot = std::atomic_ref<std::size_t>(cursor[row]).fetch_add(1, std::memory_order_relaxed);
+                    targets[slot] = static_cast<ColIndex>(col);
+                }
+            });
+        }
+
+        // Sorting makes the scatter order irrelevant; repeated edges collapse to one entry
+        std::vector<std::size_t> kept(n + 1, 0);
+        for_each_partition(pool, n, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t row = begin; row < end; ++row) {
+                const auto first = targets.begin() + static_cast<std::ptrdiff_t>(row_start[row]);
+                const auto last = targets.begin() + static_cast<std::ptrdiff_t>(row_start[row + 1]);
+                std::sort(first, last);
+                kept[row + 1] = static_cast<std::size_t>(std::unique(first, last) - first);
+            }
+        });
+        std::inclusive_scan(kept.begin(), kept.end(), kept.begin());
+        return generate_rows<T, ColIndex, RowPtr>(n, n, pool,
+            [&](std::size_t row) { return kept[row + 1] - kept[row]; },
+            [&](std::size_t row, ColIndex* cols, T* values) {
+                const std::size_t length = kept[row + 1] - kept[row];
+                std::copy_n(targets.begin() + static_cast<std::ptrdiff_t>(row_start[row]), length, cols);
+                for (std::size_t k = 0; k < length; ++k) {
+                    values[k] = random_entry<T>(seed, row, static_cast<std::size_t>(cols[k]));
+                }
+            });
+    }
+}
+
+// 5-point Laplacian on an nx x ny grid (Dirichlet boundary): symmetric
+// positive definite, 4 on the diagonal, -1 for each grid neighbour
+template<typename T = double, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+    requires std::floating_point<T>
+[[nodiscard]] SparseMatrix<T, ColIndex, RowPtr> poisson_2d(std::size_t nx, std::size_t ny) {
+    return detail::poisson<T, ColIndex, RowPtr>({nx, ny}, nullptr);
+}
+
+template<typename T = double, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+    requires std::floating_point<T>
+[[nodiscard]] SparseMatrix<T, ColIndex, RowPtr> poisson_2d(std::size_t nx, std::size_t ny,
+                                                           execution::ThreadPool& pool) {
+    return detail::poisson<T, ColIndex, RowPtr>({nx, ny}, &pool);
+}
+
+// 7-point Laplacian on an nx x ny x nz grid: 6 on the diagonal
+template<typename T = double, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+    requires std::floating_point<T>
+[[nodiscard]] SparseMatrix<T, ColIndex, RowPtr> poisson_3d(std::size_t nx, std::size_t ny, std::size_t nz) {
+    return detail::poisson<T, ColIndex, RowPtr>({nx, ny, nz}, nullptr);
+}
+
+template<typename T = double, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+    requires std::floating_point<T>
+[[nodiscard]] SparseMatrix<T, ColIndex, RowPtr> poisson_3d(std::size_t nx, std::size_t ny, std::size_t nz,
+                                                           execution::ThreadPool& pool) {
+    return detail::poisson<T, ColIndex, RowPtr>({nx, ny, nz}, &pool);
+}
+
+// n x n matrix with every entry from `lower` below to `upper` above the
+// diagonal stored: random off-diagonals in [-1, 1) and a strictly dominant
+// diagonal of lower + upper + 1
+template<typename T = double, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+    requires std::floating_point<T>
+[[nodiscard]] SparseMatrix<T, ColIndex, RowPtr> banded(std::size_t n, std::size_t lower, std::size_t upper,
+                                                       std::uint64_t seed = 42) {
+    return detail::banded<T, ColIndex, RowPtr>(n, lower, upper, seed, nullptr);
+}
+
+template<typename T = double, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+    requires std::floating_point<T>
+[[nodiscard]] SparseMatrix<T, ColIndex, RowPtr> banded(std::size_t n, std::size_t lower, std::size_t upper,
+                                                       execution::ThreadPool& pool, std::uint64_t seed = 42) {
+    return detail::banded<T, ColIndex, RowPtr>(n, lower, upper, seed, &pool);
+}
+
+// Dense block_size x block_size blocks along the diagonal, random
+// off-diagonals in [-1, 1) and block_size on the diagonal
+template<typename T = double, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+    requires std::floating_point<T>
+[[nodiscard]] SparseMatrix<T, ColIndex, RowPtr> block_diagonal(std::size_t blocks, std::size_t block_size,
+                                                               std::uint64_t seed = 42) {
+    return detail::block_diagonal<T, ColIndex, RowPtr>(blocks, block_size, seed, nullptr);
+}
+
+template<typename T = double, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+    requires std::floating_point<T>
+[[nodiscard]] SparseMatrix<T, ColIndex, RowPtr> block_diagonal(std::size_t blocks, std::size_t block_size,
+                                                               execution::ThreadPool& pool, std::uint64_t seed = 42) {
+    return detail::block_diagonal<T, ColIndex, RowPtr>(blocks, block_size, seed, &pool);
+}
+
+// Adjacency matrix of an R-MAT graph (Chakrabarti et al.) with 2^scale
+// vertices and edge_factor * 2^scale generated edges; repeated edges are
+// stored once, so nnz comes out somewhat lower. Vertices are not relabeled:
+// the highest degrees sit at the low indices. Values are random in [-1, 1).
+template<typename T = double, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+    requires std::floating_point<T>
+[[nodiscard]] SparseMatrix<T, ColIndex, RowPtr> rmat(std::size_t scale, std::size_t edge_factor,
+                                                     RmatParameters params = {}, std::uint64_t seed = 42) {
+    return detail::rmat<T, ColIndex, RowPtr>(scale, edge_factor, params, seed, nullptr);
+}
+
+template<typename T = double, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+    requires std::floating_point<T>
+[[nodiscard]] SparseMatrix<T, ColIndex, RowPtr> rmat(std::size_t scale, std::size_t edge_factor,
+                                                     execution::ThreadPool& pool,
+                                                     RmatParameters params = {}, std::uint64_t seed = 42) {
+    return detail::rmat<T, ColIndex, RowPtr>(scale, edge_factor, params, seed, &pool);
+}
+
+// n x n matrix whose row i holds max(1, floor(max_row_length / (i + 1)^exponent))
+// entries at random columns spread over the matrix: a few long leading rows
+// and a long tail of short ones
+template<typename T = double, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+    requires std::floating_point<T>
+[[nodiscard]] SparseMatrix<T, ColIndex, RowPtr> power_law_rows(std::size_t n, std::size_t max_row_length,
+                                                               double exponent, std::uint64_t seed = 42) {
+    return detail::power_law_rows<T, ColIndex, RowPtr>(n, max_row_length, exponent, seed, nullptr);
+}
+
+template<typename T = double, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+    requires std::floating_point<T>
+[[nodiscard]] SparseMatrix<T, ColIndex, RowPtr> power_law_rows(std::size_t n, std::size_t max_row_length,
+                                                               double exponent, execution::ThreadPool& pool,
+                                                               std::uint64_t seed = 42) {
+    return detail::power_law_rows<T, ColIndex, RowPtr>(n, max_row_length, exponent, seed, &pool);
+}
+
+// n x n matrix of row_length entries per row except for dense_rows rows,
+// evenly spaced, holding dense_row_length each: the load imbalance of a
+// few hub rows without the power-law tail
+template<typename T = double, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+    requires std::floating_point<T>
+[[nodiscard]] SparseMatrix<T, ColIndex, RowPtr> skewed_rows(std::size_t n, std::size_t row_length,
+                                                            std::size_t dense_rows, std::size_t dense_row_length,
+                                                            std::uint64_t seed = 42) {
+    return detail::skewed_rows<T, ColIndex, RowPtr>(n, row_length, dense_rows, dense_row_length, seed, nullptr);
+}
+
+template<typename T = double, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+    requires std::floating_point<T>
+[[nodiscard]] SparseMatrix<T, ColIndex, RowPtr> skewed_rows(std::size_t n, std::size_t row_length,
+                                                            std::size_t dense_rows, std::size_t dense_row_length,
+                                                            execution::ThreadPool& pool, std::uint64_t seed = 42) {
+    return detail::skewed_rows<T, ColIndex, RowPtr>(n, row_length, dense_rows, dense_row_length, seed, &pool);
+}
+
+} // namespace sparse_linalg
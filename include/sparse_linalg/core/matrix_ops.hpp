@@ -1,142 +1,692 @@
 #pragma once
 
 #include "sparse_matrix.hpp"
+#include "allocators.hpp"
+#include "sparse_matrix_view.hpp"
+#include "partition.hpp"
+#include "spmv_kernels.hpp"
+#include "spmm_kernels.hpp"
+#include "dense_block.hpp"
+#include "spgemm.hpp"
+#include "csc_matrix.hpp"
+#include "sell_matrix.hpp"
+#include "sell_kernels.hpp"
+#include "block_sparse_matrix.hpp"
+#include "bsr_kernels.hpp"
+#include "mixed_precision_matrix.hpp"
+#include "mixed_spmv_kernels.hpp"
+#include "parallel_utils.hpp"
+#include "../execution/instrumentation.hpp"
 #include "../execution/thread_pool.hpp"
-#include "../execution/simd_utils.hpp"
+#include <algorithm>
+#include <atomic>
+#include <concepts>
 #include <numeric>
 #include <span>
 
 namespace sparse_linalg {
 
-namespace detail {
-    template<typename Size>
-    auto partition_range(Size begin, Size end, Size num_parts) {
-        std::vector<Size> partitions;
-        partitions.reserve(num_parts + 1);
-        
-        Size chunk = (end - begin) / num_parts;
-        Size remainder = (end - begin) % num_parts;
-        
-        Size current = begin;
-        partitions.push_back(current);
-        
-        for (Size i = 0; i < num_parts; ++i) {
-            current += chunk + (i < remainder ? 1 : 0);
-            partitions.push_back(current);
-        }
-        
-        return partitions;
-    }
-}
+// How parallel A^T x combines the scattered updates of different threads
+enum class TransposeScatter {
+    private_buffers,  // one zeroed output copy per thread, summed afterwards
+    atomics           // relaxed atomic adds straight into y
+};
+
+inline namespace SPARSE_LINALG_INSTRUMENTATION_ABI {
 
 template<typename T>
     requires MatrixValue<T>
 class MatrixOps {
 public:
     // Sequential matrix-vector multiplication
+    template<typename ColIndex, typename RowPtr, typename Allocator>
     static std::vector<T> multiply(
-        const SparseMatrix<T>& matrix,
+        const SparseMatrix<T, ColIndex, RowPtr, Allocator>& matrix,
         std::span<const T> vec
     ) {
-        validate_dimensions(matrix, vec);
         std::vector<T> result(matrix.rows(), T{});
-        
-        for (std::size_t i = 0; i < matrix.rows(); ++i) {
-            auto row_vals = matrix.row_values(i);
-            auto row_cols = matrix.row_indices(i);
-            result[i] = sparse_dot_product(row_vals, row_cols, vec);
-        }
-        
+        multiply(matrix, vec, std::span<T>(result));
         return result;
     }
     
-    // Parallel and SIMD-accelerated matrix-vector multiplication
+    // In-place y = alpha * A * x + beta * y with BLAS gemv semantics: when
+    // beta == 0, y is write-only, and when alpha == 0, A and x are not read
+    template<typename ColIndex, typename RowPtr, typename Allocator>
+    static void multiply(
+        const SparseMatrix<T, ColIndex, RowPtr, Allocator>& matrix,
+        std::span<const T> x,
+        std::span<T> y,
+        T alpha = T{1},
+        T beta = T{}
+    ) {
+        validate_dimensions(matrix, x, y);
+        spmv(matrix, x, y, alpha, beta);
+    }
+    
+    // Parallel matrix-vector multiplication; both variants use the SIMD
+    // kernel selected for the host CPU at runtime. The work split comes from
+    // the matrix's cached partition plan: equal row counts, equal nonzero
+    // counts (default), or a merge-path split that may cut through long rows.
+    template<typename ColIndex, typename RowPtr, typename Allocator>
     static std::vector<T> multiply_parallel(
-        const SparseMatrix<T>& matrix,
+        const SparseMatrix<T, ColIndex, RowPtr, Allocator>& matrix,
         std::span<const T> vec,
-        execution::ThreadPool& pool
+        execution::ThreadPool& pool,
+        PartitionStrategy strategy = PartitionStrategy::nnz
     ) {
-        validate_dimensions(matrix, vec);
         std::vector<T> result(matrix.rows(), T{});
+        multiply_parallel(matrix, vec, std::span<T>(result), pool, T{1}, T{}, strategy);
+        return result;
+    }
+    
+    // Parallel in-place y = alpha * A * x + beta * y
+    template<typename ColIndex, typename RowPtr, typename Allocator>
+    static void multiply_parallel(
+        const SparseMatrix<T, ColIndex, RowPtr, Allocator>& matrix,
+        std::span<const T> x,
+        std::span<T> y,
+        execution::ThreadPool& pool,
+        T alpha = T{1},
+        T beta = T{},
+        PartitionStrategy strategy = PartitionStrategy::nnz
+    ) {
+        validate_dimensions(matrix, x, y);
+        spmv_parallel(matrix, x, y, pool, alpha, beta, strategy);
+    }
+
+    // The same products over a SparseMatrixView, e.g. of a mapped file
+    template<typename ColIndex, typename RowPtr>
+    static std::vector<T> multiply(
+        const SparseMatrixView<T, ColIndex, RowPtr>& matrix,
+        std::span<const T> vec
+    ) {
+        std::vector<T> result(matrix.rows(), T{});
+        multiply(matrix, vec, std::span<T>(result));
+        return result;
+    }
+
+    template<typename ColIndex, typename RowPtr>
+    static void multiply(
+        const SparseMatrixView<T, ColIndex, RowPtr>& matrix,
+        std::span<const T> x,
+        std::span<T> y,
+        T alpha = T{1},
+        T beta = T{}
+    ) {
+        validate_dimensions(matrix, x, y);
+        spmv(matrix, x, y, alpha, beta);
+    }
+
+    template<typename ColIndex, typename RowPtr>
+    static void multiply_parallel(
+        const SparseMatrixView<T, ColIndex, RowPtr>& matrix,
+        std::span<const T> x,
+        std::span<T> y,
+        execution::ThreadPool& pool,
+        T alpha = T{1},
+        T beta = T{},
+        PartitionStrategy strategy = PartitionStrategy::nnz
+    ) {
+        validate_dimensions(matrix, x, y);
+        spmv_parallel(matrix, x, y, pool, alpha, beta, strategy);
+    }
+
+    // SELL-C-sigma matrix-vector product; with the chunk height equal to the
+    // host's SIMD width each chunk is one vector of rows
+    template<typename ColIndex, typename ChunkPtr>
+    static std::vector<T> multiply(
+        const SellMatrix<T, ColIndex, ChunkPtr>& matrix,
+        std::span<const T> vec
+    ) {
+        std::vector<T> result(matrix.rows(), T{});
+        multiply(matrix, vec, std::span<T>(result));
+        return result;
+    }
+
+    template<typename ColIndex, typename ChunkPtr>
+    static void multiply(
+        const SellMatrix<T, ColIndex, ChunkPtr>& matrix,
+        std::span<const T> x,
+        std::span<T> y,
+        T alpha = T{1},
+        T beta = T{}
+    ) {
+        validate_dimensions(matrix, x, y);
+        if (alpha == T{}) {
+            scale(y, beta);
+            return;
+        }
+
+        KernelTimer timer(Kernel::sell_spmv, matrix.nnz());
+        const auto kernel = detail::SellKernel<T, ColIndex, ChunkPtr>::get(matrix.chunk_height());
+        kernel(detail::sell_arrays(matrix), x.data(), y.data(), 0, matrix.chunks(), alpha, beta);
+    }
+
+    // Parallel SELL product over chunk ranges balanced by stored entries.
+    // Chunks own whole rows, so unlike CSR spans no carries are needed.
+    template<typename ColIndex, typename ChunkPtr>
+    static void multiply_parallel(
+        const SellMatrix<T, ColIndex, ChunkPtr>& matrix,
+        std::span<const T> x,
+        std::span<T> y,
+        execution::ThreadPool& pool,
+        T alpha = T{1},
+        T beta = T{}
+    ) {
+        validate_dimensions(matrix, x, y);
+        if (alpha == T{}) {
+            scale(y, beta);
+            return;
+        }
+
+        const auto kernel = detail::SellKernel<T, ColIndex, ChunkPtr>::get(matrix.chunk_height());
+        const auto arrays = detail::sell_arrays(matrix);
+        const auto bounds = detail::partition_by_nnz(matrix.chunk_ptrs(), std::max<std::size_t>(pool.thread_count(), 1));
+        KernelTimer timer(Kernel::sell_spmv_parallel, matrix.nnz(), bounds.size() - 1);
+        detail::for_each_part(pool, bounds.size() - 1, [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                timer.time_part(i, [&] { kernel(arrays, x.data(), y.data(), bounds[i], bounds[i + 1], alpha, beta); });
+            }
+        });
+    }
+
+    // Block CSR matrix-vector product with the R x C microkernel for the host
+    template<std::size_t R, std::size_t C, typename ColIndex, typename RowPtr>
+    static std::vector<T> multiply(
+        const BlockSparseMatrix<T, R, C, ColIndex, RowPtr>& matrix,
+        std::span<const T> vec
+    ) {
+        std::vector<T> result(matrix.rows(), T{});
+        multiply(matrix, vec, std::span<T>(result));
+        return result;
+    }
+
+    template<std::size_t R, std::size_t C, typename ColIndex, typename RowPtr>
+    static void multiply(
+        const BlockSparseMatrix<T, R, C, ColIndex, RowPtr>& matrix,
+        std::span<const T> x,
+        std::span<T> y,
+        T alpha = T{1},
+        T beta = T{}
+    ) {
+        validate_dimensions(matrix, x, y);
+        if (alpha == T{}) {
+            scale(y, beta);
+            return;
+        }
+
+        KernelTimer timer(Kernel::bsr_spmv, matrix.nnz());
+        const auto kernel = detail::BsrKernel<T, R, C, ColIndex, RowPtr>::get();
+        kernel(detail::bsr_arrays(matrix), x.data(), y.data(), 0, matrix.block_rows(), alpha, beta);
+    }
+
+    // Parallel block CSR product over block-row ranges balanced by blocks
+    template<std::size_t R, std::size_t C, typename ColIndex, typename RowPtr>
+    static void multiply_parallel(
+        const BlockSparseMatrix<T, R, C, ColIndex, RowPtr>& matrix,
+        std::span<const T> x,
+        std::span<T> y,
+        execution::ThreadPool& pool,
+        T alpha = T{1},
+        T beta = T{}
+    ) {
+        validate_dimensions(matrix, x, y);
+        if (alpha == T{}) {
+            scale(y, beta);
+            return;
+        }
+
+        const auto kernel = detail::BsrKernel<T, R, C, ColIndex, RowPtr>::get();
+        const auto arrays = detail::bsr_arrays(matrix);
+        const auto bounds = detail::partition_by_nnz(matrix.block_row_ptrs(), std::max<std::size_t>(pool.thread_count(), 1));
+        KernelTimer timer(Kernel::bsr_spmv_parallel, matrix.nnz(), bounds.size() - 1);
+        detail::for_each_part(pool, bounds.size() - 1, [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                timer.time_part(i, [&] { kernel(arrays, x.data(), y.data(), bounds[i], bounds[i + 1], alpha, beta); });
+            }
+        });
+    }
+
+    // Products with values stored in a narrower type: each value is widened
+    // to T as it is loaded and the sums accumulate in T
+    template<typename Storage, typename ColIndex, typename RowPtr>
+    static std::vector<T> multiply(
+        const MixedPrecisionMatrix<Storage, ColIndex, RowPtr>& matrix,
+        std::span<const T> vec
+    ) {
+        std::vector<T> result(matrix.rows(), T{});
+        multiply(matrix, vec, std::span<T>(result));
+        return result;
+    }
+
+    template<typename Storage, typename ColIndex, typename RowPtr>
+    static void multiply(
+        const MixedPrecisionMatrix<Storage, ColIndex, RowPtr>& matrix,
+        std::span<const T> x,
+        std::span<T> y,
+        T alpha = T{1},
+        T beta = T{}
+    ) {
+        validate_dimensions(matrix, x, y);
+        spmv(matrix, x, y, alpha, beta);
+    }
+
+    template<typename Storage, typename ColIndex, typename RowPtr>
+    static void multiply_parallel(
+        const MixedPrecisionMatrix<Storage, ColIndex, RowPtr>& matrix,
+        std::span<const T> x,
+        std::span<T> y,
+        execution::ThreadPool& pool,
+        T alpha = T{1},
+        T beta = T{},
+        PartitionStrategy strategy = PartitionStrategy::nnz
+    ) {
+        validate_dimensions(matrix, x, y);
+        spmv_parallel(matrix, x, y, pool, alpha, beta, strategy);
+    }
+
+    // Sparse times dense block: Y = alpha * A * X + beta * Y for the k = X.cols()
+    // right-hand sides at once. Each nonzero of A is loaded once and applied
+    // to all k columns; k in {4, 8, 16, 32, 64} takes a register-blocked
+    // path. Column-major X is packed to row-major first. X and Y must not overlap.
+    template<typename ColIndex, typename RowPtr, typename Allocator>
+    static void multiply(
+        const SparseMatrix<T, ColIndex, RowPtr, Allocator>& matrix,
+        DenseBlockView<const T> x,
+        DenseBlockView<T> y,
+        T alpha = T{1},
+        T beta = T{}
+    ) {
+        validate_dimensions(matrix, x, y);
+        if (alpha == T{}) {
+            scale(y, beta);
+            return;
+        }
         
-        const std::size_t num_threads = pool.thread_count();
-        auto partitions = detail::partition_range(
-            std::size_t{0}, matrix.rows(), num_threads
-        );
-        
-        std::vector<std::future<void>> futures;
-        futures.reserve(num_threads);
+        KernelTimer timer(Kernel::spmm, matrix.nnz());
+        pooled_vector<T> packed;
+        if (x.layout() == Layout::col_major) {
+            packed.resize(x.rows() * x.cols());
+            pack_row_major(x, packed, 0, x.rows());
+        }
+        const auto args = make_spmm_args(x, y, alpha, beta, packed);
         
-        for (std::size_t i = 0; i < num_threads; ++i) {
-            futures.push_back(pool.submit([&, start = partitions[i], end = partitions[i + 1]]() {
-                for (std::size_t row = start; row < end; ++row) {
-                    auto row_vals = matrix.row_values(row);
-                    auto row_cols = matrix.row_indices(row);
-                    result[row] = sparse_dot_product(row_vals, row_cols, vec);
-                }
-            }));
+        pooled_vector<T> acc(x.cols());
+        const auto kernel = detail::SpmmKernel<T, ColIndex, RowPtr>::get(x.cols());
+        kernel(detail::csr_arrays(matrix), args, 0, matrix.rows(), acc.data());
+    }
+    
+    // Parallel Y = alpha * A * X + beta * Y over nnz-balanced row spans
+    template<typename ColIndex, typename RowPtr, typename Allocator>
+    static void multiply_parallel(
+        const SparseMatrix<T, ColIndex, RowPtr, Allocator>& matrix,
+        DenseBlockView<const T> x,
+        DenseBlockView<T> y,
+        execution::ThreadPool& pool,
+        T alpha = T{1},
+        T beta = T{}
+    ) {
+        validate_dimensions(matrix, x, y);
+        if (alpha == T{}) {
+            scale(y, beta);
+            return;
         }
         
-        for (auto& future : futures) {
-            future.wait();
+        const auto plan = matrix.partition_plan(PartitionStrategy::nnz, pool.thread_count());
+        KernelTimer timer(Kernel::spmm_parallel, matrix.nnz(), plan->spans.size());
+        pooled_vector<T> packed;
+        if (x.layout() == Layout::col_major) {
+            packed.resize(x.rows() * x.cols());
+            pool.parallel_for(x.rows(), 0, [&](std::size_t start, std::size_t end) {
+                pack_row_major(x, packed, start, end);
+            });
         }
+        const auto args = make_spmm_args(x, y, alpha, beta, packed);
+        
+        const auto kernel = detail::SpmmKernel<T, ColIndex, RowPtr>::get(x.cols());
+        const auto arrays = detail::csr_arrays(matrix);
+        
+        // One accumulator row per task, padded to a cache line
+        constexpr std::size_t line = 64 / sizeof(T) > 0 ? 64 / sizeof(T) : 1;
+        const std::size_t acc_stride = (x.cols() + line - 1) / line * line;
+        pooled_vector<T> acc(acc_stride * plan->spans.size());
         
+        detail::for_each_part(pool, plan->spans.size(), [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                const auto& span = plan->spans[i];
+                timer.time_part(i, [&] { kernel(arrays, args, span.row_begin, span.row_end, acc.data() + i * acc_stride); });
+            }
+        });
+    }
+
+    // Sparse matrix product C = A * B. Use SparseProduct directly to keep the
+    // symbolic phase and recompute values for a fixed pattern.
+    template<typename ColIndex, typename RowPtr, typename Allocator>
+    static SparseMatrix<T, ColIndex, RowPtr, Allocator> multiply(
+        const SparseMatrix<T, ColIndex, RowPtr, Allocator>& a,
+        const SparseMatrix<T, ColIndex, RowPtr, Allocator>& b
+    ) {
+        KernelTimer timer(Kernel::spgemm, a.nnz());
+        return SparseProduct<T, ColIndex, RowPtr, Allocator>(a, b).compute(a, b);
+    }
+    
+    template<typename ColIndex, typename RowPtr, typename Allocator>
+    static SparseMatrix<T, ColIndex, RowPtr, Allocator> multiply_parallel(
+        const SparseMatrix<T, ColIndex, RowPtr, Allocator>& a,
+        const SparseMatrix<T, ColIndex, RowPtr, Allocator>& b,
+        execution::ThreadPool& pool
+    ) {
+        KernelTimer timer(Kernel::spgemm_parallel, a.nnz());
+        return SparseProduct<T, ColIndex, RowPtr, Allocator>(a, b, pool).compute(a, b, pool);
+    }
+
+    // Materialized transpose in O(nnz + rows + cols)
+    template<typename ColIndex, typename RowPtr, typename Allocator>
+    static SparseMatrix<T, ColIndex, RowPtr, Allocator> transpose(const SparseMatrix<T, ColIndex, RowPtr, Allocator>& matrix) {
+        KernelTimer timer(Kernel::transpose, matrix.nnz());
+        return make_transpose(matrix, nullptr);
+    }
+    
+    // Parallel transpose: per-thread column histograms, prefix sum, scatter
+    template<typename ColIndex, typename RowPtr, typename Allocator>
+    static SparseMatrix<T, ColIndex, RowPtr, Allocator> transpose(
+        const SparseMatrix<T, ColIndex, RowPtr, Allocator>& matrix,
+        execution::ThreadPool& pool
+    ) {
+        KernelTimer timer(Kernel::transpose_parallel, matrix.nnz());
+        return make_transpose(matrix, &pool);
+    }
+    
+    // Transpose product A^T * x straight from the CSR arrays: row i of A
+    // scatters x[i] times its entries into y
+    template<typename ColIndex, typename RowPtr, typename Allocator>
+    static std::vector<T> multiply_transpose(
+        const SparseMatrix<T, ColIndex, RowPtr, Allocator>& matrix,
+        std::span<const T> vec
+    ) {
+        std::vector<T> result(matrix.cols(), T{});
+        multiply_transpose(matrix, vec, std::span<T>(result));
         return result;
     }
+    
+    // In-place y = alpha * A^T * x + beta * y
+    template<typename ColIndex, typename RowPtr, typename Allocator>
+    static void multiply_transpose(
+        const SparseMatrix<T, ColIndex, RowPtr, Allocator>& matrix,
+        std::span<const T> x,
+        std::span<T> y,
+        T alpha = T{1},
+        T beta = T{}
+    ) {
+        validate_transpose_dimensions(matrix, x, y);
+        KernelTimer timer(Kernel::spmv_transpose, matrix.nnz());
+        scale(y, beta);
+        if (alpha == T{}) {
+            return;
+        }
+        scatter_rows(matrix, x, y.data(), alpha, 0, matrix.rows());
+    }
+    
+    // Parallel y = alpha * A^T * x + beta * y. Rows are split by nonzeros;
+    // concurrent updates to the same y entry are resolved either through
+    // per-thread buffers (extra cols-sized memory per thread, no contention)
+    // or through atomic adds (no extra memory, contention on shared columns).
+    template<typename ColIndex, typename RowPtr, typename Allocator>
+    static void multiply_transpose_parallel(
+        const SparseMatrix<T, ColIndex, RowPtr, Allocator>& matrix,
+        std::span<const T> x,
+        std::span<T> y,
+        execution::ThreadPool& pool,
+        T alpha = T{1},
+        T beta = T{},
+        TransposeScatter scatter = TransposeScatter::private_buffers
+    ) {
+        validate_transpose_dimensions(matrix, x, y);
+        if (alpha == T{}) {
+            detail::for_each_partition(&pool, y.size(), [&](std::size_t begin, std::size_t end) {
+                scale(y.subspan(begin, end - begin), beta);
+            });
+            return;
+        }
+        
+        const std::size_t parts = pool.thread_count();
+        const auto plan = matrix.partition_plan(PartitionStrategy::nnz, parts);
+        const auto part_ids = detail::partition_range(std::size_t{0}, parts, parts);
+        KernelTimer timer(Kernel::spmv_transpose_parallel, matrix.nnz(), parts);
+        
+        if (scatter == TransposeScatter::atomics) {
+            detail::for_each_partition(&pool, y.size(), [&](std::size_t begin, std::size_t end) {
+                scale(y.subspan(begin, end - begin), beta);
+            });
+            detail::run_parts(&pool, part_ids, [&](std::size_t first, std::size_t last) {
+                for (std::size_t part = first; part < last; ++part) {
+                    timer.time_part(part, [&] {
+                        scatter_rows_atomic(matrix, x, y.data(), alpha,
+                                            plan->spans[part].row_begin, plan->spans[part].row_end);
+                    });
+                }
+            });
+            return;
+        }
+        
+        const std::size_t cols = matrix.cols();
+        pooled_vector<T> buffers(parts * cols, T{});
+        detail::run_parts(&pool, part_ids, [&](std::size_t first, std::size_t last) {
+            for (std::size_t part = first; part < last; ++part) {
+                timer.time_part(part, [&] {
+                    scatter_rows(matrix, x, buffers.data() + part * cols, T{1},
+                                 plan->spans[part].row_begin, plan->spans[part].row_end);
+                });
+            }
+        });
+        
+        // Reduce the buffers column slice by column slice, fused with the beta update
+        detail::for_each_partition(&pool, cols, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t col = begin; col < end; ++col) {
+                T sum{};
+                for (std::size_t part = 0; part < parts; ++part) {
+                    sum = static_cast<T>(sum + buffers[part * cols + col]);
+                }
+                detail::spmv_store(y.data() + col, sum, alpha, beta);
+            }
+        });
+    }
 
 private:
-    static void validate_dimensions(const SparseMatrix<T>& matrix, std::span<const T> vec) {
-        if (matrix.cols() != vec.size()) {
+    using Kernel = execution::Kernel;
+    using KernelTimer = execution::detail::KernelTimer;
+
+    // CSR SpMV bodies shared by SparseMatrix, SparseMatrixView and
+    // MixedPrecisionMatrix; the kernel follows the stored value type
+    template<typename Matrix>
+    using SpanKernel = detail::SpanKernelFor<typename Matrix::value_type, T,
+                                             typename Matrix::index_type, typename Matrix::offset_type>;
+
+    template<typename Matrix>
+    static void spmv(const Matrix& matrix, std::span<const T> x, std::span<T> y, T alpha, T beta) {
+        if (alpha == T{}) {
+            scale(y, beta);
+            return;
+        }
+        
+        KernelTimer timer(Kernel::spmv, matrix.nnz());
+        SpanKernel<Matrix>::get()(detail::csr_arrays(matrix), x.data(), y.data(),
+                      PartitionSpan{0, matrix.rows(), 0, matrix.nnz()}, alpha, beta);
+    }
+
+    template<typename Matrix>
+    static void spmv_parallel(
+        const Matrix& matrix,
+        std::span<const T> x,
+        std::span<T> y,
+        execution::ThreadPool& pool,
+        T alpha,
+        T beta,
+        PartitionStrategy strategy
+    ) {
+        if (alpha == T{}) {
+            scale(y, beta);
+            return;
+        }
+        
+        const auto plan = matrix.partition_plan(strategy, pool.thread_count());
+        const auto& spans = plan->spans;
+        
+        const auto kernel = SpanKernel<Matrix>::get();
+        const auto arrays = detail::csr_arrays(matrix);
+        
+        // Each span leaves the partial sum of a row it shares with the next
+        // span; these are folded in after the join so no two workers ever
+        // write the same entry of y
+        std::vector<T> carries(spans.size());
+        KernelTimer timer(Kernel::spmv_parallel, matrix.nnz(), spans.size());
+        detail::for_each_part(pool, spans.size(), [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                carries[i] = timer.time_part(i, [&] { return kernel(arrays, x.data(), y.data(), spans[i], alpha, beta); });
+            }
+        });
+        
+        for (std::size_t i = 0; i < spans.size(); ++i) {
+            if (spans[i].row_end < matrix.rows()) {
+                y[spans[i].row_end] += static_cast<T>(alpha * carries[i]);
+            }
+        }
+    }
+
+    // y = A x shapes, for every storage format
+    template<typename Matrix>
+        requires requires(const Matrix& m) {
+            { m.rows() } -> std::convertible_to<std::size_t>;
+            { m.cols() } -> std::convertible_to<std::size_t>;
+        }
+    static void validate_dimensions(const Matrix& matrix, std::span<const T> x, std::span<T> y) {
+        if (matrix.cols() != x.size()) {
             throw std::invalid_argument("Vector size must match matrix columns");
         }
+        if (matrix.rows() != y.size()) {
+            throw std::invalid_argument("Output size must match matrix rows");
+        }
     }
     
-    static T sparse_dot_product(
-        std::span<const T> values,
-        std::span<const std::size_t> indices,
-        std::span<const T> vec
+    template<typename ColIndex, typename RowPtr, typename Allocator>
+    static void validate_dimensions(
+        const SparseMatrix<T, ColIndex, RowPtr, Allocator>& matrix,
+        const DenseBlockView<const T>& x,
+        const DenseBlockView<T>& y
     ) {
-        if constexpr (execution::SimdTraits<T>::is_vectorizable) {
-            const std::size_t vec_size = execution::SimdTraits<T>::vector_size;
-            const std::size_t vec_count = values.size() / vec_size;
-            const std::size_t remainder = values.size() % vec_size;
-            
-            using VecType = typename execution::SimdTraits<T>::vector_type;
-            auto sum = execution::SimdTraits<T>::set_zero();
-            
-            // Process vector-sized chunks
-            for (std::size_t i = 0; i < vec_count; ++i) {
-                const std::size_t base = i * vec_size;
-                VecType vec_vals = execution::SimdTraits<T>::load(&values[base]);
-                
-                // Gather vector elements from sparse indices
-                T gathered_data[vec_size];
-                for (std::size_t j = 0; j < vec_size; ++j) {
-                    gathered_data[j] = vec[indices[base + j]];
-                }
-                VecType vec_vec = execution::SimdTraits<T>::load(gathered_data);
-                
-                sum = execution::SimdTraits<T>::add(
-                    sum,
-                    execution::SimdTraits<T>::multiply(vec_vals, vec_vec)
-                );
+        if (matrix.cols() != x.rows()) {
+            throw std::invalid_argument("Block rows must match matrix columns");
+        }
+        if (matrix.rows() != y.rows() || x.cols() != y.cols()) {
+            throw std::invalid_argument("Output block must be matrix rows x block columns");
+        }
+    }
+    
+    template<typename ColIndex, typename RowPtr, typename Allocator>
+    static void validate_transpose_dimensions(
+        const SparseMatrix<T, ColIndex, RowPtr, Allocator>& matrix,
+        std::span<const T> x,
+        std::span<T> y
+    ) {
+        if (matrix.rows() != x.size()) {
+            throw std::invalid_argument("Vector size must match matrix rows");
+        }
+        if (matrix.cols() != y.size()) {
+            throw std::invalid_argument("Output size must match matrix columns");
+        }
+    }
+    
+    template<typename ColIndex, typename RowPtr, typename Allocator>
+    static SparseMatrix<T, ColIndex, RowPtr, Allocator> make_transpose(
+        const SparseMatrix<T, ColIndex, RowPtr, Allocator>& matrix,
+        execution::ThreadPool* pool
+    ) {
+        auto arrays = detail::transpose_csr<Allocator>(matrix, pool);
+        typename SparseMatrix<T, ColIndex, RowPtr, Allocator>::CSRMatrix data;
+        data.values = std::move(arrays.values);
+        data.col_indices = std::move(arrays.indices);
+        data.row_ptrs = std::move(arrays.ptrs);
+        return SparseMatrix<T, ColIndex, RowPtr, Allocator>(matrix.cols(), matrix.rows(), std::move(data));
+    }
+    
+    // out[col] += alpha * x[row] * A(row, col) for rows [begin, end)
+    template<typename ColIndex, typename RowPtr, typename Allocator>
+    static void scatter_rows(const SparseMatrix<T, ColIndex, RowPtr, Allocator>& matrix, std::span<const T> x,
+                             T* out, T alpha, std::size_t begin, std::size_t end) {
+        const auto& data = matrix.raw_data();
+        for (std::size_t row = begin; row < end; ++row) {
+            const auto scaled = static_cast<T>(alpha * x[row]);
+            const auto stop = static_cast<std::size_t>(data.row_ptrs[row + 1]);
+            for (auto p = static_cast<std::size_t>(data.row_ptrs[row]); p < stop; ++p) {
+                T& target = out[static_cast<std::size_t>(data.col_indices[p])];
+                target = static_cast<T>(target + scaled * data.values[p]);
+            }
+        }
+    }
+    
+    template<typename ColIndex, typename RowPtr, typename Allocator>
+    static void scatter_rows_atomic(const SparseMatrix<T, ColIndex, RowPtr, Allocator>& matrix, std::span<const T> x,
+                                    T* out, T alpha, std::size_t begin, std::size_t end) {
+        const auto& data = matrix.raw_data();
+        for (std::size_t row = begin; row < end; ++row) {
+            const auto scaled = static_cast<T>(alpha * x[row]);
+            const auto stop = static_cast<std::size_t>(data.row_ptrs[row + 1]);
+            for (auto p = static_cast<std::size_t>(data.row_ptrs[row]); p < stop; ++p) {
+                std::atomic_ref<T>(out[static_cast<std::size_t>(data.col_indices[p])])
+                    .fetch_add(static_cast<T>(scaled * data.values[p]), std::memory_order_relaxed);
+            }
+        }
+    }
+    
+    // Copies rows [begin, end) of a column-major block into row-major storage
+    static void pack_row_major(const DenseBlockView<const T>& x, pooled_vector<T>& packed,
+                               std::size_t begin, std::size_t end) {
+        const std::size_t k = x.cols();
+        for (std::size_t c = 0; c < k; ++c) {
+            const T* column = x.data() + c * x.leading_dimension();
+            for (std::size_t row = begin; row < end; ++row) {
+                packed[row * k + c] = column[row];
             }
-            
-            // Process remainder
-            T result = execution::SimdTraits<T>::reduce_sum(sum);
-            for (std::size_t i = vec_count * vec_size; i < values.size(); ++i) {
-                result += values[i] * vec[indices[i]];
+        }
+    }
+    
+    static detail::SpmmArgs<T> make_spmm_args(
+        const DenseBlockView<const T>& x,
+        const DenseBlockView<T>& y,
+        T alpha,
+        T beta,
+        const pooled_vector<T>& packed
+    ) {
+        const bool is_packed = x.layout() == Layout::col_major;
+        return {
+            is_packed ? packed.data() : x.data(),
+            is_packed ? x.cols() : x.leading_dimension(),
+            y.data(), y.row_stride(), y.col_stride(),
+            x.cols(), alpha, beta
+        };
+    }
+    
+    static void scale(const DenseBlockView<T>& y, T beta) {
+        for (std::size_t row = 0; row < y.rows(); ++row) {
+            for (std::size_t col = 0; col < y.cols(); ++col) {
+                T& value = y.data()[row * y.row_stride() + col * y.col_stride()];
+                value = beta == T{} ? T{} : static_cast<T>(beta * value);
             }
-            
-            return result;
+        }
+    }
+    
+    // y = beta * y, writing zeros without reading y when beta == 0
+    static void scale(std::span<T> y, T beta) {
+        if (beta == T{}) {
+            std::fill(y.begin(), y.end(), T{});
         } else {
-            T sum{};
-            for (std::size_t i = 0; i < values.size(); ++i) {
-                sum += values[i] * vec[indices[i]];
+            for (auto& value : y) {
+                value = static_cast<T>(beta * value);
             }
-            return sum;
         }
     }
 };
 
-} // namespace sparse_linalg
\ No newline at end of file
+} // inline namespace SPARSE_LINALG_INSTRUMENTATION_ABI
+
+} // namespace sparse_linalg
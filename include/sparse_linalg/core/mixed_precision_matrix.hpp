@@ -0,0 +1,138 @@
+#pragma once
+
+#include "sparse_matrix.hpp"
+#include "half_precision.hpp"
+#include "partition.hpp"
+#include "parallel_utils.hpp"
+#include "../execution/thread_pool.hpp"
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace sparse_linalg {
+
+// CSR matrix whose values are stored in a narrower type than the vectors it
+// multiplies: float, bfloat16 or float16 values against double vectors, say.
+// MatrixOps<T> widens every value to T in registers and accumulates in T, so
+// only the storage is rounded. SpMV is bound by the bytes it streams, and
+// with 4-byte indices a float matrix moves 8 bytes per nonzero instead of
+// 12, a 16-bit one 6; the price is a relative error of about 2^-24
+// (float), 2^-11 (float16) or 2^-8 (bfloat16) per entry, which suits
+// preconditioners and inner solves rather than the outer residual.
+//
+// The structure is the source matrix's; entries that round to zero are kept.
+template<typename Storage, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+    requires ReducedPrecision<Storage> && MatrixIndex<ColIndex> && MatrixIndex<RowPtr>
+class MixedPrecisionMatrix {
+public:
+    using value_type = Storage;
+    using size_type = std::size_t;
+    using index_type = ColIndex;
+    using offset_type = RowPtr;
+
+    template<typename T, typename Allocator>
+        requires std::floating_point<T>
+    explicit MixedPrecisionMatrix(const SparseMatrix<T, ColIndex, RowPtr, Allocator>& a)
+        : MixedPrecisionMatrix(a, nullptr) {}
+
+    // Parallel conversion: the values are rounded on the pool
+    template<typename T, typename Allocator>
+        requires std::floating_point<T>
+    MixedPrecisionMatrix(const SparseMatrix<T, ColIndex, RowPtr, Allocator>& a, execution::ThreadPool& pool)
+        : MixedPrecisionMatrix(a, &pool) {}
+
+    [[nodiscard]] auto rows() const noexcept -> size_type { return rows_; }
+    [[nodiscard]] auto cols() const noexcept -> size_type { return cols_; }
+    [[nodiscard]] auto nnz() const noexcept -> size_type { return values_.size(); }
+
+    // Stored value; widen with static_cast<float>, which is exact
+    [[nodiscard]] auto operator()(size_type row, size_type col) const -> value_type {
+        if (row >= rows_ || col >= cols_) {
+            throw std::out_of_range("Matrix indices out of range");
+        }
+        const auto indices = row_indices(row);
+        const auto it = std::lower_bound(indices.begin(), indices.end(), static_cast<index_type>(col));
+        if (it != indices.end() && *it == static_cast<index_type>(col)) {
+            return row_values(row)[static_cast<size_type>(it - indices.begin())];
+        }
+        return value_type{};
+    }
+
+    [[nodiscard]] auto row_values(size_type row) const -> std::span<const value_type> {
+        validate_row(row);
+        const auto first = static_cast<size_type>(row_ptrs_[row]);
+        return std::span<const value_type>(values_).subspan(first, static_cast<size_type>(row_ptrs_[row + 1]) - first);
+    }
+
+    [[nodiscard]] auto row_indices(size_type row) const -> std::span<const index_type> {
+        validate_row(row);
+        const auto first = static_cast<size_type>(row_ptrs_[row]);
+        return std::span<const index_type>(col_indices_).subspan(first, static_cast<size_type>(row_ptrs_[row + 1]) - first);
+    }
+
+    [[nodiscard]] auto row_ptrs() const noexcept -> std::span<const offset_type> { return row_ptrs_; }
+    [[nodiscard]] auto col_indices() const noexcept -> std::span<const index_type> { return col_indices_; }
+    [[nodiscard]] auto values() const noexcept -> std::span<const value_type> { return values_; }
+
+    // Same caching as SparseMatrix::partition_plan
+    [[nodiscard]] auto partition_plan(PartitionStrategy strategy, size_type num_parts) const
+        -> std::shared_ptr<const PartitionPlan> {
+        if (num_parts == 0) {
+            throw std::invalid_argument("Partition plan needs at least one part");
+        }
+        auto plan = plan_cache_.load();
+        if (!plan || plan->strategy != strategy || plan->spans.size() != num_parts) {
+            plan = std::make_shared<const PartitionPlan>(
+                detail::make_partition_plan(std::span<const offset_type>(row_ptrs_), strategy, num_parts));
+            plan_cache_.store(plan);
+        }
+        return plan;
+    }
+
+    // The matrix widened back to T; differs from the source by the rounding
+    template<typename T>
+        requires std::floating_point<T>
+    [[nodiscard]] auto to_matrix() const -> SparseMatrix<T, ColIndex, RowPtr> {
+        typename SparseMatrix<T, ColIndex, RowPtr>::CSRMatrix data;
+        data.row_ptrs = row_ptrs_;
+        data.col_indices = col_indices_;
+        data.values.resize(values_.size());
+        std::transform(values_.begin(), values_.end(), data.values.begin(),
+                       [](value_type value) { return detail::widen<T>(value); });
+        return SparseMatrix<T, ColIndex, RowPtr>(rows_, cols_, std::move(data));
+    }
+
+private:
+    size_type rows_;
+    size_type cols_;
+    std::vector<offset_type> row_ptrs_;
+    std::vector<index_type> col_indices_;
+    std::vector<value_type> values_;
+    detail::PartitionPlanCache plan_cache_;
+
+    template<typename T, typename Allocator>
+    MixedPrecisionMatrix(const SparseMatrix<T, ColIndex, RowPtr, Allocator>& a, execution::ThreadPool* pool)
+        : rows_(a.rows()), cols_(a.cols()),
+          row_ptrs_(a.raw_data().row_ptrs.begin(), a.raw_data().row_ptrs.end()),
+          col_indices_(a.raw_data().col_indices.begin(), a.raw_data().col_indices.end()),
+          values_(a.nnz()) {
+        const auto& source = a.raw_data().values;
+        detail::for_each_partition(pool, values_.size(), [&](size_type begin, size_type end) {
+            for (size_type k = begin; k < end; ++k) {
+                values_[k] = detail::narrow<value_type>(source[k]);
+            }
+        });
+    }
+
+    void validate_row(size_type row) const {
+        if (row >= rows_) {
+            throw std::out_of_range("Row index out of range");
+        }
+    }
+};
+
+} // namespace sparse_linalg
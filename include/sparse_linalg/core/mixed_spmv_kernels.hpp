@@ -0,0 +1,196 @@
+#pragma once
+
+#include "mixed_precision_matrix.hpp"
+#include "spmv_kernels.hpp"
+#include "../execution/simd_utils.hpp"
+#include "../execution/cpu_features.hpp"
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+
+namespace sparse_linalg {
+
+namespace detail {
+    template<typename S, typename Index, typename Offset>
+    auto csr_arrays(const MixedPrecisionMatrix<S, Index, Offset>& matrix) {
+        return CsrArrays<S, Index, Offset>{
+            matrix.row_ptrs().data(), matrix.col_indices().data(), matrix.values().data()
+        };
+    }
+
+    // Dot products of stored S values with a T vector, accumulated in T
+    template<typename T, typename S, typename Index>
+    inline T mixed_dot_scalar(const S* values, const Index* indices, std::size_t count, const T* vec) {
+        T sum{};
+        for (std::size_t i = 0; i < count; ++i) {
+            sum += widen<T>(values[i]) * vec[static_cast<std::size_t>(indices[i])];
+        }
+        return sum;
+    }
+
+#if SPARSE_LINALG_HAS_X86_SIMD
+    // Traits of T at a level that widen S in registers
+    template<typename T, typename S, execution::SimdLevel Level>
+    concept WidensInRegisters = requires(const S* values) {
+        execution::SimdIsaTraits<T, Level>::load_widen(values);
+    };
+
+    // sparse_dot_avx2 with the values widened as they are loaded
+    template<typename T, typename S, typename Index>
+    SPARSE_LINALG_TARGET_AVX2_F16C inline T mixed_dot_avx2(
+        const S* values, const Index* indices, std::size_t count, const T* vec
+    ) {
+        using Simd = execution::SimdIsaTraits<T, execution::SimdLevel::avx2>;
+        using VecType = typename Simd::vector_type;
+        constexpr std::size_t vec_size = Simd::vector_size;
+        constexpr std::size_t unroll = 4;
+
+        VecType sum0 = Simd::set_zero();
+        VecType sum1 = Simd::set_zero();
+        VecType sum2 = Simd::set_zero();
+        VecType sum3 = Simd::set_zero();
+
+        std::size_t i = 0;
+        for (; i + unroll * vec_size <= count; i += unroll * vec_size) {
+            sum0 = Simd::fmadd(Simd::load_widen(values + i), Simd::gather(vec, indices + i), sum0);
+            sum1 = Simd::fmadd(Simd::load_widen(values + i + vec_size), Simd::gather(vec, indices + i + vec_size), sum1);
+            sum2 = Simd::fmadd(Simd::load_widen(values + i + 2 * vec_size), Simd::gather(vec, indices + i + 2 * vec_size), sum2);
+            sum3 = Simd::fmadd(Simd::load_widen(values + i + 3 * vec_size), Simd::gather(vec, indices + i + 3 * vec_size), sum3);
+        }
+        for (; i + vec_size <= count; i += vec_size) {
+            sum0 = Simd::fmadd(Simd::load_widen(values + i), Simd::gather(vec, indices + i), sum0);
+        }
+
+        T result = Simd::reduce_sum(Simd::add(Simd::add(sum0, sum1), Simd::add(sum2, sum3)));
+        for (; i < count; ++i) {
+            result += widen<T>(values[i]) * vec[static_cast<std::size_t>(indices[i])];
+        }
+        return result;
+    }
+
+    // `preceding` counts the array elements before `values`, which the tail may read
+    template<typename T, typename S, typename Index>
+    SPARSE_LINALG_TARGET_AVX512 inline T mixed_dot_avx512(
+        const S* values, const Index* indices, std::size_t count, const T* vec, std::size_t preceding
+    ) {
+        using Simd = execution::SimdIsaTraits<T, execution::SimdLevel::avx512>;
+        using VecType = typename Simd::vector_type;
+        constexpr std::size_t vec_size = Simd::vector_size;
+        constexpr std::size_t unroll = 4;
+
+        VecType sum0 = Simd::set_zero();
+        VecType sum1 = Simd::set_zero();
+        VecType sum2 = Simd::set_zero();
+        VecType sum3 = Simd::set_zero();
+
+        std::size_t i = 0;
+        for (; i + unroll * vec_size <= count; i += unroll * vec_size) {
+            sum0 = Simd::fmadd(Simd::load_widen(values + i), Simd::gather(vec, indices + i), sum0);
+            sum1 = Simd::fmadd(Simd::load_widen(values + i + vec_size), Simd::gather(vec, indices + i + vec_size), sum1);
+            sum2 = Simd::fmadd(Simd::load_widen(values + i + 2 * vec_size), Simd::gather(vec, indices + i + 2 * vec_size), sum2);
+            sum3 = Simd::fmadd(Simd::load_widen(values + i + 3 * vec_size), Simd::gather(vec, indices + i + 3 * vec_size), sum3);
+        }
+        for (; i + vec_size <= count; i += vec_size) {
+            sum0 = Simd::fmadd(Simd::load_widen(values + i), Simd::gather(vec, indices + i), sum0);
+        }
+
+        // Narrow types have no masked load in AVX-512F. The tail is widened
+        // from the full vector ending at the row's end instead, with the
+        // lanes before i (earlier steps or rows) masked off; only the first
+        // rows of the array fall back to a zero-padded copy.
+        if (i < count) {
+            const std::size_t shift = vec_size - (count - i);
+            if (count + preceding >= vec_size) {
+                const auto mask = static_cast<typename Simd::mask_type>(~Simd::first_lanes(shift));
+                sum1 = Simd::fmadd(Simd::mask_load_widen(mask, values + i - shift),
+                                   Simd::mask_gather(mask, vec, indices + i - shift), sum1);
+            } else {
+                S tail[vec_size] = {};
+                for (std::size_t k = i; k < count; ++k) {
+                    tail[k - i] = values[k];
+                }
+                const auto mask = Simd::first_lanes(count - i);
+                sum1 = Simd::fmadd(Simd::load_widen(tail), Simd::mask_gather(mask, vec, indices + i), sum1);
+            }
+        }
+
+        return Simd::reduce_sum(Simd::add(Simd::add(sum0, sum1), Simd::add(sum2, sum3)));
+    }
+#endif
+
+    // Span kernels with the contract of spmv_span_scalar
+    template<typename T, typename S, typename Index, typename Offset>
+    T spmv_mixed_scalar(CsrArrays<S, Index, Offset> a, const T* x, T* y, PartitionSpan span, T alpha, T beta) {
+        std::size_t start = span.nnz_begin;
+        for (std::size_t row = span.row_begin; row < span.row_end; ++row) {
+            const auto stop = static_cast<std::size_t>(a.row_ptrs[row + 1]);
+            spmv_store(y + row, mixed_dot_scalar(a.values + start, a.col_indices + start, stop - start, x), alpha, beta);
+            start = stop;
+        }
+        return mixed_dot_scalar(a.values + start, a.col_indices + start, span.nnz_end - start, x);
+    }
+
+#if SPARSE_LINALG_HAS_X86_SIMD
+    template<typename T, typename S, typename Index, typename Offset>
+    SPARSE_LINALG_TARGET_AVX2_F16C T spmv_mixed_avx2(
+        CsrArrays<S, Index, Offset> a, const T* x, T* y, PartitionSpan span, T alpha, T beta
+    ) {
+        std::size_t start = span.nnz_begin;
+        for (std::size_t row = span.row_begin; row < span.row_end; ++row) {
+            const auto stop = static_cast<std::size_t>(a.row_ptrs[row + 1]);
+            spmv_store(y + row, mixed_dot_avx2(a.values + start, a.col_indices + start, stop - start, x), alpha, beta);
+            start = stop;
+        }
+        return mixed_dot_avx2(a.values + start, a.col_indices + start, span.nnz_end - start, x);
+    }
+
+    template<typename T, typename S, typename Index, typename Offset>
+    SPARSE_LINALG_TARGET_AVX512 T spmv_mixed_avx512(
+        CsrArrays<S, Index, Offset> a, const T* x, T* y, PartitionSpan span, T alpha, T beta
+    ) {
+        std::size_t start = span.nnz_begin;
+        for (std::size_t row = span.row_begin; row < span.row_end; ++row) {
+            const auto stop = static_cast<std::size_t>(a.row_ptrs[row + 1]);
+            spmv_store(y + row, mixed_dot_avx512(a.values + start, a.col_indices + start, stop - start, x, start),
+                       alpha, beta);
+            start = stop;
+        }
+        return mixed_dot_avx512(a.values + start, a.col_indices + start, span.nnz_end - start, x, start);
+    }
+#endif
+
+    // Picks the span kernel for S storage and T arithmetic. SIMD kernels
+    // exist where the T traits widen S (float or 16-bit values into double,
+    // 16-bit values into float) with 32- or 64-bit column indices.
+    template<typename S, typename T, typename Index, typename Offset>
+    struct MixedSpmvKernel {
+        using function_type = T (*)(CsrArrays<S, Index, Offset>, const T*, T*, PartitionSpan, T, T);
+
+        static function_type select([[maybe_unused]] execution::SimdLevel level) {
+#if SPARSE_LINALG_HAS_X86_SIMD
+            if constexpr (execution::is_gather_index_v<Index>) {
+                if constexpr (WidensInRegisters<T, S, execution::SimdLevel::avx512>) {
+                    if (level == execution::SimdLevel::avx512) return &spmv_mixed_avx512<T, S, Index, Offset>;
+                }
+                if constexpr (WidensInRegisters<T, S, execution::SimdLevel::avx2>) {
+                    if (level >= execution::SimdLevel::avx2) return &spmv_mixed_avx2<T, S, Index, Offset>;
+                }
+            }
+#endif
+            return &spmv_mixed_scalar<T, S, Index, Offset>;
+        }
+
+        static function_type get() {
+            static const function_type kernel = select(execution::active_simd_level());
+            return kernel;
+        }
+    };
+
+    // Span kernel for a matrix storing S multiplied in T arithmetic
+    template<typename S, typename T, typename Index, typename Offset>
+    using SpanKernelFor = std::conditional_t<std::same_as<S, T>,
+                                             SpmvKernel<T, Index, Offset>,
+                                             MixedSpmvKernel<S, T, Index, Offset>>;
+}
+
+} // namespace sparse_linalg
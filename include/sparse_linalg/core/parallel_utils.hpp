@@ -0,0 +1,56 @@
+#pragma once
+
+#include "partition.hpp"
+#include "../execution/thread_pool.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace sparse_linalg {
+
+namespace detail {
+    // Runs fn(first, last) over part indices [0, parts) on the pool. On a
+    // pinned pool every part goes to the same worker on every call, so the
+    // rows it first touched stay local, unless that worker is busy with a
+    // submitted task and the caller runs its part; otherwise parts are
+    // claimed one at a time by whichever thread is free, the caller included.
+    template<typename F>
+    void for_each_part(execution::ThreadPool& pool, std::size_t parts, F&& fn) {
+        if (pool.affinity() != execution::ThreadAffinity::none) {
+            pool.parallel_for_static(parts, fn);
+        } else {
+            pool.parallel_for(parts, 1, fn);
+        }
+    }
+
+    // Runs fn(bounds[i], bounds[i + 1]) for every part, on the pool when one
+    // is given. Running parts finish before the first failure is rethrown.
+    template<typename F>
+    void run_parts(execution::ThreadPool* pool, const std::vector<std::size_t>& bounds, F&& fn) {
+        const std::size_t parts = bounds.size() - 1;
+        if (!pool) {
+            for (std::size_t i = 0; i < parts; ++i) {
+                fn(bounds[i], bounds[i + 1]);
+            }
+            return;
+        }
+
+        for_each_part(*pool, parts, [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                fn(bounds[i], bounds[i + 1]);
+            }
+        });
+    }
+
+    // Runs fn(begin, end) over num_parts slices of [0, n), on the pool when one is given
+    template<typename F>
+    void for_each_partition(execution::ThreadPool* pool, std::size_t n, F&& fn) {
+        const std::size_t num_parts = pool ? pool->thread_count() : 1;
+        if (num_parts <= 1 || n < num_parts) {
+            fn(std::size_t{0}, n);
+            return;
+        }
+        run_parts(pool, partition_range(std::size_t{0}, n, num_parts), fn);
+    }
+}
+
+} // namespace sparse_linalg
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace sparse_linalg {
+
+// How parallel SpMV splits a matrix between workers
+enum class PartitionStrategy {
+    rows,       // equal row counts
+    nnz,        // equal nonzero counts, whole rows per worker
+    merge_path  // equal rows + nonzeros; long rows are split between workers
+};
+
+// A worker's share of a CSR matrix: rows [row_begin, row_end) restricted to
+// nonzeros [nnz_begin, nnz_end). Nonzeros of row_end below nnz_end belong to a
+// row finished by a later span and are returned as a carry.
+struct PartitionSpan {
+    std::size_t row_begin;
+    std::size_t row_end;
+    std::size_t nnz_begin;
+    std::size_t nnz_end;
+};
+
+struct PartitionPlan {
+    PartitionStrategy strategy;
+    std::vector<PartitionSpan> spans;
+};
+
+namespace detail {
+    template<typename Size>
+    auto partition_range(Size begin, Size end, Size num_parts) {
+        std::vector<Size> partitions;
+        partitions.reserve(num_parts + 1);
+        
+        Size chunk = (end - begin) / num_parts;
+        Size remainder = (end - begin) % num_parts;
+        
+        Size current = begin;
+        partitions.push_back(current);
+        
+        for (Size i = 0; i < num_parts; ++i) {
+            current += chunk + (i < remainder ? 1 : 0);
+            partitions.push_back(current);
+        }
+        
+        return partitions;
+    }
+
+    // Row boundaries giving each part about nnz / num_parts nonzeros
+    template<typename Offset>
+    std::vector<std::size_t> partition_by_nnz(std::span<const Offset> row_ptrs, std::size_t num_parts) {
+        const std::size_t rows = row_ptrs.size() - 1;
+        const auto nnz = static_cast<std::size_t>(row_ptrs[rows]);
+
+        std::vector<std::size_t> partitions;
+        partitions.reserve(num_parts + 1);
+        partitions.push_back(0);
+
+        for (std::size_t i = 1; i < num_parts; ++i) {
+            const std::size_t target = nnz / num_parts * i + nnz % num_parts * i / num_parts;
+            // Row boundary whose start offset lies closest to the target
+            auto it = std::lower_bound(row_ptrs.begin(), row_ptrs.end() - 1, target,
+                [](Offset offset, std::size_t value) { return static_cast<std::size_t>(offset) < value; });
+            if (it != row_ptrs.begin() &&
+                target - static_cast<std::size_t>(*(it - 1)) < static_cast<std::size_t>(*it) - target) {
+                --it;
+            }
+            const auto row = static_cast<std::size_t>(it - row_ptrs.begin());
+            partitions.push_back(std::max(row, partitions.back()));
+        }
+
+        partitions.push_back(rows);
+        return partitions;
+    }
+
+    // Merge-path search (Merrill & Garland): finds where `diagonal` crosses the
+    // merge of the row end offsets with the nonzero indices 0..nnz-1
+    template<typename Offset>
+    std::pair<std::size_t, std::size_t> merge_path_search(std::span<const Offset> row_ptrs, std::size_t diagonal) {
+        const std::size_t rows = row_ptrs.size() - 1;
+        const auto nnz = static_cast<std::size_t>(row_ptrs[rows]);
+
+        std::size_t x_min = diagonal > nnz ? diagonal - nnz : 0;
+        std::size_t x_max = std::min(diagonal, rows);
+        while (x_min < x_max) {
+            const std::size_t pivot = x_min + (x_max - x_min) / 2;
+            if (static_cast<std::size_t>(row_ptrs[pivot + 1]) <= diagonal - pivot - 1) {
+                x_min = pivot + 1;
+            } else {
+                x_max = pivot;
+            }
+        }
+        return {x_min, diagonal - x_min};
+    }
+
+    template<typename Offset>
+    PartitionPlan make_partition_plan(
+        std::span<const Offset> row_ptrs,
+        PartitionStrategy strategy,
+        std::size_t num_parts
+    ) {
+        const std::size_t rows = row_ptrs.size() - 1;
+        PartitionPlan plan{strategy, {}};
+        plan.spans.reserve(num_parts);
+
+        if (strategy == PartitionStrategy::merge_path) {
+            const std::size_t total = rows + static_cast<std::size_t>(row_ptrs[rows]);
+            auto begin = merge_path_search(row_ptrs, 0);
+            for (std::size_t i = 0; i < num_parts; ++i) {
+                const auto end = merge_path_search(row_ptrs, total / num_parts * (i + 1) +
+                                                             total % num_parts * (i + 1) / num_parts);
+                plan.spans.push_back({begin.first, end.first, begin.second, end.second});
+                begin = end;
+            }
+            return plan;
+        }
+
+        const auto partitions = strategy == PartitionStrategy::nnz
+            ? partition_by_nnz(row_ptrs, num_parts)
+            : partition_range(std::size_t{0}, rows, num_parts);
+        for (std::size_t i = 0; i < num_parts; ++i) {
+            plan.spans.push_back({
+                partitions[i], partitions[i + 1],
+                static_cast<std::size_t>(row_ptrs[partitions[i]]),
+                static_cast<std::size_t>(row_ptrs[partitions[i + 1]])
+            });
+        }
+        return plan;
+    }
+}
+
+} // namespace sparse_linalg
@@ -0,0 +1,447 @@
+#pragma once
+
+#include "sparse_matrix.hpp"
+#include "parallel_utils.hpp"
+#include "../execution/thread_pool.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace sparse_linalg {
+
+// A permutation maps new positions to old ones: perm[new_index] = old_index.
+// permute(A, P, Q) gathers row P[i] and column Q[j] of A into B(i, j),
+// i.e. B = P A Q^T, and a vector x in the old numbering becomes x[P[i]].
+using Permutation = std::vector<std::size_t>;
+
+// Envelope statistics of a sparsity pattern; smaller is better for the
+// cache reuse of x in SpMV
+struct BandwidthStats {
+    std::size_t bandwidth = 0;  // max |i - j| over the stored entries
+    std::size_t profile = 0;    // sum over rows of i - min(j) for entries left of the diagonal
+    double average_distance = 0.0;  // mean |i - j| over the stored entries
+};
+
+namespace detail {
+    // Throws unless perm holds each of 0 .. n - 1 exactly once
+    inline void validate_permutation(std::span<const std::size_t> perm, std::size_t n) {
+        if (perm.size() != n) {
+            throw std::invalid_argument("Permutation size does not match the matrix");
+        }
+        std::vector<bool> seen(n, false);
+        for (auto old : perm) {
+            if (old >= n || seen[old]) {
+                throw std::invalid_argument("Permutation must contain every index exactly once");
+            }
+            seen[old] = true;
+        }
+    }
+
+    // Undirected adjacency of the pattern of A + A^T, without self loops,
+    // each list sorted
+    struct AdjacencyGraph {
+        std::vector<std::size_t> ptrs;
+        std::vector<std::size_t> neighbors;
+
+        [[nodiscard]] std::size_t size() const noexcept { return ptrs.size() - 1; }
+        [[nodiscard]] std::size_t degree(std::size_t v) const noexcept { return ptrs[v + 1] - ptrs[v]; }
+        [[nodiscard]] std::span<const std::size_t> adjacent(std::size_t v) const noexcept {
+            return {neighbors.data() + ptrs[v], degree(v)};
+        }
+    };
+
+    template<typename T, typename Index, typename Offset, typename Allocator>
+    AdjacencyGraph symmetric_graph(const SparseMatrix<T, Index, Offset, Allocator>& a) {
+        const std::size_t n = a.rows();
+        const auto& data = a.raw_data();
+        std::vector<std::size_t> counts(n + 1, 0);
+        for (std::size_t row = 0; row < n; ++row) {
+            for (auto p = static_cast<std::size_t>(data.row_ptrs[row]); p < static_cast<std::size_t>(data.row_ptrs[row + 1]); ++p) {
+                const auto col = static_cast<std::size_t>(data.col_indices[p]);
+                if (col != row) {
+                    ++counts[row + 1];
+                    ++counts[col + 1];
+                }
+            }
+        }
+        for (std::size_t v = 0; v < n; ++v) {
+            counts[v + 1] += counts[v];
+        }
+        std::vector<std::size_t> both(counts[n]);
+        std::vector<std::size_t> cursor(counts.begin(), counts.end() - 1);
+        for (std::size_t row = 0; row < n; ++row) {
+            for (auto p = static_cast<std::size_t>(data.row_ptrs[row]); p < static_cast<std::size_t>(data.row_ptrs[row + 1]); ++p) {
+                const auto col = static_cast<std::size_t>(data.col_indices[p]);
+                if (col != row) {
+                    both[cursor[row]++] = col;
+                    both[cursor[col]++] = row;
+                }
+            }
+        }
+
+        // Symmetric entries appear twice; keep each neighbor once
+        AdjacencyGraph graph;
+        graph.ptrs.assign(n + 1, 0);
+        graph.neighbors.reserve(both.size());
+        for (std::size_t v = 0; v < n; ++v) {
+            const auto first = both.begin() + static_cast<std::ptrdiff_t>(counts[v]);
+            const auto last = both.begin() + static_cast<std::ptrdiff_t>(counts[v + 1]);
+            std::sort(first, last);
+            std::unique_copy(first, last, std::back_inserter(graph.neighbors));
+            graph.ptrs[v + 1] = graph.neighbors.size();
+        }
+        return graph;
+    }
+
+    // Breadth-first searches over the vertices whose label equals the
+    // search label; one stamp array marks visits for all searches
+    class GraphSearch {
+    public:
+        explicit GraphSearch(const AdjacencyGraph& graph)
+            : graph_(graph), stamp_(graph.size(), 0) {}
+
+        // Level structure rooted at root: visit order, and where each level starts
+        struct Levels {
+            std::vector<std::size_t> order;
+            std::vector<std::size_t> level_starts;
+
+            [[nodiscard]] std::size_t depth() const noexcept { return level_starts.size(); }
+        };
+
+        Levels levels(std::size_t root, const std::vector<std::size_t>& labels, std::size_t label) {
+            ++search_;
+            Levels result;
+            result.order.push_back(root);
+            stamp_[root] = search_;
+            std::size_t level_begin = 0;
+            while (level_begin < result.order.size()) {
+                const std::size_t level_end = result.order.size();
+                result.level_starts.push_back(level_begin);
+                for (std::size_t k = level_begin; k < level_end; ++k) {
+                    for (auto w : graph_.adjacent(result.order[k])) {
+                        if (stamp_[w] != search_ && labels[w] == label) {
+                            stamp_[w] = search_;
+                            result.order.push_back(w);
+                        }
+                    }
+                }
+                level_begin = level_end;
+            }
+            return result;
+        }
+
+        // George-Liu: restart from a minimum-degree vertex of the last level
+        // while that deepens the level structure. The root ends up at one end
+        // of a long path through the component.
+        Levels pseudo_peripheral(std::size_t start, const std::vector<std::size_t>& labels, std::size_t label) {
+            auto best = levels(start, labels, label);
+            while (true) {
+                const auto last_level = std::span<const std::size_t>(best.order).subspan(best.level_starts.back());
+                const auto candidate = *std::min_element(last_level.begin(), last_level.end(),
+                    [this](std::size_t u, std::size_t v) { return graph_.degree(u) < graph_.degree(v); });
+                auto next = levels(candidate, labels, label);
+                if (next.depth() <= best.depth()) {
+                    return best;
+                }
+                best = std::move(next);
+            }
+        }
+
+    private:
+        const AdjacencyGraph& graph_;
+        std::vector<std::size_t> stamp_;
+        std::size_t search_ = 0;
+    };
+
+    // Cuthill-McKee order of the vertices carrying label, appended to order:
+    // BFS from a pseudo-peripheral vertex of each component, neighbors taken
+    // in increasing degree. With first_is_root, the component of
+    // vertices.front() starts from that vertex instead.
+    inline void cuthill_mckee(const AdjacencyGraph& graph, GraphSearch& search, std::vector<std::size_t>& labels,
+                              std::size_t label, std::span<const std::size_t> vertices,
+                              std::vector<std::size_t>& order, std::size_t done_label, bool first_is_root = false) {
+        std::vector<std::size_t> fresh;
+        for (auto start : vertices) {
+            if (labels[start] != label) {
+                continue;
+            }
+            const std::size_t root = first_is_root && start == vertices.front()
+                ? start : search.pseudo_peripheral(start, labels, label).order.front();
+            std::size_t head = order.size();
+            order.push_back(root);
+            labels[root] = done_label;
+            while (head < order.size()) {
+                fresh.clear();
+                for (auto w : graph.adjacent(order[head++])) {
+                    if (labels[w] == label) {
+                        labels[w] = done_label;
+                        fresh.push_back(w);
+                    }
+                }
+                std::stable_sort(fresh.begin(), fresh.end(),
+                    [&graph](std::size_t u, std::size_t v) { return graph.degree(u) < graph.degree(v); });
+                order.insert(order.end(), fresh.begin(), fresh.end());
+            }
+        }
+    }
+
+    inline void check_square(std::size_t rows, std::size_t cols) {
+        if (rows != cols) {
+            throw std::invalid_argument("Reordering needs a square matrix");
+        }
+    }
+}
+
+// Reverse Cuthill-McKee ordering of the symmetrized pattern of A. Applied
+// symmetrically, permute(A, P, P) clusters the entries of every row near
+// the diagonal, so SpMV reads x from a narrow sliding window.
+template<typename T, typename Index, typename Offset, typename Allocator>
+[[nodiscard]] Permutation reverse_cuthill_mckee(const SparseMatrix<T, Index, Offset, Allocator>& a) {
+    detail::check_square(a.rows(), a.cols());
+    const auto graph = detail::symmetric_graph(a);
+    const std::size_t n = graph.size();
+    detail::GraphSearch search(graph);
+
+    // Components are started from their lowest-degree vertex
+    std::vector<std::size_t> by_degree(n);
+    for (std::size_t v = 0; v < n; ++v) {
+        by_degree[v] = v;
+    }
+    std::stable_sort(by_degree.begin(), by_degree.end(),
+        [&graph](std::size_t u, std::size_t v) { return graph.degree(u) < graph.degree(v); });
+
+    std::vector<std::size_t> labels(n, 0);
+    Permutation order;
+    order.reserve(n);
+    detail::cuthill_mckee(graph, search, labels, 0, by_degree, order, 1);
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+// Nested level-structure bisection into `parts` contiguous blocks of near
+// equal size. Every split cuts a breadth-first level structure from a
+// pseudo-peripheral vertex in half, so each block is a connected region
+// with a short boundary. Blocks are then put in Cuthill-McKee order
+// starting from their first vertex in the split's search, which keeps the
+// rows on either side of a cut close together. With one block per worker,
+// most of the x entries a worker reads in SpMV belong to its own rows.
+template<typename T, typename Index, typename Offset, typename Allocator>
+[[nodiscard]] Permutation bisection_ordering(const SparseMatrix<T, Index, Offset, Allocator>& a, std::size_t parts) {
+    detail::check_square(a.rows(), a.cols());
+    if (parts == 0) {
+        throw std::invalid_argument("Bisection ordering needs at least one part");
+    }
+    const auto graph = detail::symmetric_graph(a);
+    const std::size_t n = graph.size();
+    detail::GraphSearch search(graph);
+
+    // Each block holds members[begin, end) and is still to be cut into
+    // `parts` pieces; its vertices all carry the block's label
+    std::vector<std::size_t> labels(n, 0);
+    Permutation members(n);
+    for (std::size_t v = 0; v < n; ++v) {
+        members[v] = v;
+    }
+
+    struct Block {
+        std::size_t begin;
+        std::size_t end;
+        std::size_t parts;
+        bool from_split;  // members are in the BFS order of the parent's split
+    };
+    std::vector<Block> pending{{0, n, std::min(parts, std::max<std::size_t>(n, 1)), false}};
+    std::size_t next_label = 1;
+    std::vector<std::size_t> visited;
+    std::vector<std::size_t> leaf;
+
+    while (!pending.empty()) {
+        const Block block = pending.back();
+        pending.pop_back();
+        if (block.begin == block.end) {
+            continue;
+        }
+        const std::size_t label = labels[members[block.begin]];
+        if (block.parts == 1) {
+            leaf.clear();
+            detail::cuthill_mckee(graph, search, labels, label,
+                                  std::span<const std::size_t>(members).subspan(block.begin, block.end - block.begin),
+                                  leaf, next_label++, block.from_split);
+            std::copy(leaf.begin(), leaf.end(), members.begin() + static_cast<std::ptrdiff_t>(block.begin));
+            continue;
+        }
+
+        // Breadth-first order of the block, component after component
+        visited.clear();
+        for (std::size_t k = block.begin; k < block.end; ++k) {
+            const std::size_t v = members[k];
+            if (labels[v] != label) {
+                continue;
+            }
+            const auto levels = search.pseudo_peripheral(v, labels, label);
+            for (auto w : levels.order) {
+                labels[w] = next_label;
+                visited.push_back(w);
+            }
+        }
+
+        // The first half, in proportion to the parts each side gets, goes left
+        const std::size_t left_parts = block.parts / 2;
+        const std::size_t size = block.end - block.begin;
+        const std::size_t split = size * left_parts / block.parts;
+        const std::size_t left_label = next_label;
+        const std::size_t right_label = next_label + 1;
+        next_label += 2;
+        for (std::size_t k = 0; k < size; ++k) {
+            labels[visited[k]] = k < split ? left_label : right_label;
+            members[block.begin + k] = visited[k];
+        }
+        // Right is pushed first so blocks come out left to right
+        pending.push_back({block.begin + split, block.end, block.parts - left_parts, true});
+        pending.push_back({block.begin, block.begin + split, left_parts, true});
+    }
+
+    return members;
+}
+
+// inverse[old_index] = new_index
+[[nodiscard]] inline Permutation inverse_permutation(std::span<const std::size_t> perm) {
+    Permutation inverse(perm.size());
+    for (std::size_t i = 0; i < perm.size(); ++i) {
+        inverse[perm[i]] = i;
+    }
+    return inverse;
+}
+
+// out[i] = in[perm[i]]
+template<typename T>
+void permute_vector(std::span<const std::size_t> perm, std::span<const T> in, std::span<T> out) {
+    if (in.size() != perm.size() || out.size() != perm.size()) {
+        throw std::invalid_argument("Vector sizes do not match the permutation");
+    }
+    for (std::size_t i = 0; i < perm.size(); ++i) {
+        out[i] = in[perm[i]];
+    }
+}
+
+namespace detail {
+    template<typename T, typename Index, typename Offset, typename Allocator>
+    SparseMatrix<T, Index, Offset, Allocator> permute_matrix(const SparseMatrix<T, Index, Offset, Allocator>& a,
+                                                             std::span<const std::size_t> row_perm,
+                                                             std::span<const std::size_t> col_perm,
+                                                             execution::ThreadPool* pool) {
+        validate_permutation(row_perm, a.rows());
+        validate_permutation(col_perm, a.cols());
+        const auto& data = a.raw_data();
+        const std::size_t rows = a.rows();
+        const auto col_inverse = inverse_permutation(col_perm);
+
+        typename SparseMatrix<T, Index, Offset, Allocator>::CSRMatrix result;
+        result.row_ptrs.assign(rows + 1, Offset{});
+        for (std::size_t i = 0; i < rows; ++i) {
+            const std::size_t old = row_perm[i];
+            result.row_ptrs[i + 1] = static_cast<Offset>(
+                static_cast<std::size_t>(result.row_ptrs[i]) +
+                static_cast<std::size_t>(data.row_ptrs[old + 1] - data.row_ptrs[old]));
+        }
+        result.col_indices.resize(a.nnz());
+        result.values.resize(a.nnz());
+
+        // Rows are independent: gather each row with its columns renumbered,
+        // then restore column order. Short rows, typical of meshes, sort by
+        // insertion; longer ones (e.g. the reversed runs RCM produces in hub
+        // rows) by a key/value sort, as insertion would be quadratic there
+        const std::span<const Offset> new_ptrs(result.row_ptrs);
+        const auto bounds = partition_by_nnz(new_ptrs, pool ? pool->thread_count() : 1);
+        run_parts(pool, bounds, [&](std::size_t begin, std::size_t end) {
+            std::vector<std::pair<Index, T>> scratch;
+            for (std::size_t i = begin; i < end; ++i) {
+                const std::size_t old = row_perm[i];
+                const auto first = static_cast<std::size_t>(result.row_ptrs[i]);
+                const auto old_first = static_cast<std::size_t>(data.row_ptrs[old]);
+                const auto old_last = static_cast<std::size_t>(data.row_ptrs[old + 1]);
+                auto renumbered = [&](std::size_t p) {
+                    return static_cast<Index>(col_inverse[static_cast<std::size_t>(data.col_indices[p])]);
+                };
+                if (old_last - old_first > 32) {
+                    scratch.clear();
+                    for (auto p = old_first; p < old_last; ++p) {
+                        scratch.emplace_back(renumbered(p), data.values[p]);
+                    }
+                    std::sort(scratch.begin(), scratch.end(),
+                              [](const auto& x, const auto& y) { return x.first < y.first; });
+                    for (std::size_t k = 0; k < scratch.size(); ++k) {
+                        result.col_indices[first + k] = scratch[k].first;
+                        result.values[first + k] = scratch[k].second;
+                    }
+                    continue;
+                }
+                auto slot = first;
+                for (auto p = old_first; p < old_last; ++p, ++slot) {
+                    const auto col = renumbered(p);
+                    const T value = data.values[p];
+                    auto k = slot;
+                    for (; k > first && result.col_indices[k - 1] > col; --k) {
+                        result.col_indices[k] = result.col_indices[k - 1];
+                        result.values[k] = result.values[k - 1];
+                    }
+                    result.col_indices[k] = col;
+                    result.values[k] = value;
+                }
+            }
+        });
+        return SparseMatrix<T, Index, Offset, Allocator>(a.rows(), a.cols(), std::move(result));
+    }
+}
+
+// B = P A Q^T: B(i, j) = A(row_perm[i], col_perm[j])
+template<typename T, typename Index, typename Offset, typename Allocator>
+[[nodiscard]] SparseMatrix<T, Index, Offset, Allocator> permute(const SparseMatrix<T, Index, Offset, Allocator>& a,
+                                                                std::span<const std::size_t> row_perm,
+                                                                std::span<const std::size_t> col_perm) {
+    return detail::permute_matrix(a, row_perm, col_perm, nullptr);
+}
+
+// Parallel version: rows are gathered and re-sorted on nnz-balanced parts
+template<typename T, typename Index, typename Offset, typename Allocator>
+[[nodiscard]] SparseMatrix<T, Index, Offset, Allocator> permute(const SparseMatrix<T, Index, Offset, Allocator>& a,
+                                                                std::span<const std::size_t> row_perm,
+                                                                std::span<const std::size_t> col_perm,
+                                                                execution::ThreadPool& pool) {
+    return detail::permute_matrix(a, row_perm, col_perm, &pool);
+}
+
+template<typename T, typename Index, typename Offset, typename Allocator>
+[[nodiscard]] BandwidthStats bandwidth_stats(const SparseMatrix<T, Index, Offset, Allocator>& a) {
+    const auto& data = a.raw_data();
+    BandwidthStats stats;
+    double distance = 0.0;
+    for (std::size_t row = 0; row < a.rows(); ++row) {
+        const auto begin = static_cast<std::size_t>(data.row_ptrs[row]);
+        const auto end = static_cast<std::size_t>(data.row_ptrs[row + 1]);
+        if (begin == end) {
+            continue;
+        }
+        // Columns are sorted, so the extremes are the first and last entries
+        const auto first = static_cast<std::size_t>(data.col_indices[begin]);
+        const auto last = static_cast<std::size_t>(data.col_indices[end - 1]);
+        stats.bandwidth = std::max({stats.bandwidth, row > first ? row - first : first - row,
+                                    row > last ? row - last : last - row});
+        if (first < row) {
+            stats.profile += row - first;
+        }
+        for (auto p = begin; p < end; ++p) {
+            const auto col = static_cast<std::size_t>(data.col_indices[p]);
+            distance += static_cast<double>(row > col ? row - col : col - row);
+        }
+    }
+    if (a.nnz() > 0) {
+        stats.average_distance = distance / static_cast<double>(a.nnz());
+    }
+    return stats;
+}
+
+} // namespace sparse_linalg
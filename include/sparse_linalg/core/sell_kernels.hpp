@@ -0,0 +1,156 @@
+#pragma once
+
+#include "sell_matrix.hpp"
+#include "spmv_kernels.hpp"
+#include "../execution/simd_utils.hpp"
+#include "../execution/cpu_features.hpp"
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+
+namespace sparse_linalg {
+
+namespace detail {
+    // Raw SELL arrays handed to the chunk kernels
+    template<typename T, typename Index, typename Ptr>
+    struct SellArrays {
+        const Ptr* chunk_ptrs;
+        const Index* col_indices;
+        const T* values;
+        const std::size_t* row_perm;  // nullptr when slots are rows
+        std::size_t rows;
+        std::size_t chunk_height;
+    };
+
+    template<typename T, typename Index, typename Ptr>
+    auto sell_arrays(const SellMatrix<T, Index, Ptr>& matrix) {
+        return SellArrays<T, Index, Ptr>{
+            matrix.chunk_ptrs().data(), matrix.col_indices().data(), matrix.values().data(),
+            matrix.row_permutation().empty() ? nullptr : matrix.row_permutation().data(),
+            matrix.rows(), matrix.chunk_height()
+        };
+    }
+
+    // Writes the sums of one chunk's lanes to their rows, skipping the
+    // padding lanes of the last chunk
+    template<typename T, typename Index, typename Ptr>
+    inline void sell_store(const SellArrays<T, Index, Ptr>& a, std::size_t chunk, const T* lanes,
+                           T* y, T alpha, T beta) {
+        const std::size_t first = chunk * a.chunk_height;
+        const std::size_t count = std::min(a.chunk_height, a.rows - first);
+        for (std::size_t lane = 0; lane < count; ++lane) {
+            const std::size_t row = a.row_perm ? a.row_perm[first + lane] : first + lane;
+            spmv_store(y + row, lanes[lane], alpha, beta);
+        }
+    }
+
+    // Chunk kernels: y = alpha * A * x + beta * y for the rows of chunks
+    // [chunk_begin, chunk_end). Chunks own disjoint rows, so no carries.
+    template<typename T, typename Index, typename Ptr>
+    void spmv_sell_scalar(SellArrays<T, Index, Ptr> a, const T* x, T* y,
+                          std::size_t chunk_begin, std::size_t chunk_end, T alpha, T beta) {
+        const std::size_t height = a.chunk_height;
+        for (std::size_t chunk = chunk_begin; chunk < chunk_end; ++chunk) {
+            const auto base = static_cast<std::size_t>(a.chunk_ptrs[chunk]);
+            const std::size_t width = (static_cast<std::size_t>(a.chunk_ptrs[chunk + 1]) - base) / height;
+            const std::size_t first = chunk * height;
+            const std::size_t count = std::min(height, a.rows - first);
+            for (std::size_t lane = 0; lane < count; ++lane) {
+                T sum{};
+                for (std::size_t j = 0; j < width; ++j) {
+                    const std::size_t k = base + j * height + lane;
+                    sum += a.values[k] * x[static_cast<std::size_t>(a.col_indices[k])];
+                }
+                const std::size_t row = a.row_perm ? a.row_perm[first + lane] : first + lane;
+                spmv_store(y + row, sum, alpha, beta);
+            }
+        }
+    }
+
+#if SPARSE_LINALG_HAS_X86_SIMD
+    // One vector per chunk, chunk height == lanes: every step is one load
+    // and one gather for all rows of the chunk. Two accumulators alternate
+    // over the chunk's columns to hide FMA latency.
+    template<typename T, typename Index, typename Ptr>
+    SPARSE_LINALG_TARGET_AVX2 void spmv_sell_avx2(SellArrays<T, Index, Ptr> a, const T* x, T* y,
+                                                 std::size_t chunk_begin, std::size_t chunk_end, T alpha, T beta) {
+        using Simd = execution::SimdIsaTraits<T, execution::SimdLevel::avx2>;
+        constexpr std::size_t lanes = Simd::vector_size;
+        alignas(64) T sums[lanes];
+        for (std::size_t chunk = chunk_begin; chunk < chunk_end; ++chunk) {
+            const auto base = static_cast<std::size_t>(a.chunk_ptrs[chunk]);
+            const std::size_t width = (static_cast<std::size_t>(a.chunk_ptrs[chunk + 1]) - base) / lanes;
+            const T* values = a.values + base;
+            const Index* cols = a.col_indices + base;
+            auto sum0 = Simd::set_zero();
+            auto sum1 = Simd::set_zero();
+            std::size_t j = 0;
+            for (; j + 2 <= width; j += 2) {
+                sum0 = Simd::fmadd(Simd::load(values + j * lanes), Simd::gather(x, cols + j * lanes), sum0);
+                sum1 = Simd::fmadd(Simd::load(values + (j + 1) * lanes), Simd::gather(x, cols + (j + 1) * lanes), sum1);
+            }
+            if (j < width) {
+                sum0 = Simd::fmadd(Simd::load(values + j * lanes), Simd::gather(x, cols + j * lanes), sum0);
+            }
+            Simd::store(sums, Simd::add(sum0, sum1));
+            sell_store(a, chunk, sums, y, alpha, beta);
+        }
+    }
+
+    template<typename T, typename Index, typename Ptr>
+    SPARSE_LINALG_TARGET_AVX512 void spmv_sell_avx512(SellArrays<T, Index, Ptr> a, const T* x, T* y,
+                                                     std::size_t chunk_begin, std::size_t chunk_end, T alpha, T beta) {
+        using Simd = execution::SimdIsaTraits<T, execution::SimdLevel::avx512>;
+        constexpr std::size_t lanes = Simd::vector_size;
+        alignas(64) T sums[lanes];
+        for (std::size_t chunk = chunk_begin; chunk < chunk_end; ++chunk) {
+            const auto base = static_cast<std::size_t>(a.chunk_ptrs[chunk]);
+            const std::size_t width = (static_cast<std::size_t>(a.chunk_ptrs[chunk + 1]) - base) / lanes;
+            const T* values = a.values + base;
+            const Index* cols = a.col_indices + base;
+            auto sum0 = Simd::set_zero();
+            auto sum1 = Simd::set_zero();
+            std::size_t j = 0;
+            for (; j + 2 <= width; j += 2) {
+                sum0 = Simd::fmadd(Simd::load(values + j * lanes), Simd::gather(x, cols + j * lanes), sum0);
+                sum1 = Simd::fmadd(Simd::load(values + (j + 1) * lanes), Simd::gather(x, cols + (j + 1) * lanes), sum1);
+            }
+            if (j < width) {
+                sum0 = Simd::fmadd(Simd::load(values + j * lanes), Simd::gather(x, cols + j * lanes), sum0);
+            }
+            Simd::store(sums, Simd::add(sum0, sum1));
+            sell_store(a, chunk, sums, y, alpha, beta);
+        }
+    }
+#endif
+
+    // Picks the chunk kernel for a SIMD level. The vector kernels need the
+    // chunk height to equal their lane count; any other height runs scalar.
+    template<typename T, typename Index, typename Ptr>
+    struct SellKernel {
+        using function_type = void (*)(SellArrays<T, Index, Ptr>, const T*, T*, std::size_t, std::size_t, T, T);
+
+        static function_type select([[maybe_unused]] execution::SimdLevel level,
+                                    [[maybe_unused]] std::size_t chunk_height) {
+#if SPARSE_LINALG_HAS_X86_SIMD
+            if constexpr (std::floating_point<T> && execution::is_gather_index_v<Index>) {
+                using Avx512 = execution::SimdIsaTraits<T, execution::SimdLevel::avx512>;
+                using Avx2 = execution::SimdIsaTraits<T, execution::SimdLevel::avx2>;
+                if (level == execution::SimdLevel::avx512 && chunk_height == Avx512::vector_size) {
+                    return &spmv_sell_avx512<T, Index, Ptr>;
+                }
+                if (level != execution::SimdLevel::scalar && chunk_height == Avx2::vector_size) {
+                    return &spmv_sell_avx2<T, Index, Ptr>;
+                }
+            }
+#endif
+            return &spmv_sell_scalar<T, Index, Ptr>;
+        }
+
+        static function_type get(std::size_t chunk_height) {
+            return select(execution::active_simd_level(), chunk_height);
+        }
+    };
+}
+
+} // namespace sparse_linalg
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "sparse_matrix.hpp"
+#include "parallel_utils.hpp"
+#include "../execution/cpu_features.hpp"
+#include "../execution/thread_pool.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace sparse_linalg {
+
+struct SellOptions {
+    // Rows per chunk; 0 picks the SIMD width of T on the host, so one chunk
+    // fills one vector register
+    std::size_t chunk_height = 0;
+    // Rows are sorted by length within windows of sigma rows so rows of
+    // similar length share a chunk. 1 disables sorting; 0 picks 32 chunks.
+    // Must be 1 or a multiple of the chunk height.
+    std::size_t sigma = 0;
+};
+
+namespace detail {
+    // Lanes in a vector register of T at a SIMD level
+    template<typename T>
+    constexpr std::size_t simd_lanes(execution::SimdLevel level) {
+        const std::size_t bytes = level == execution::SimdLevel::avx512 ? 64 : 32;
+        return std::max<std::size_t>(1, bytes / sizeof(T));
+    }
+}
+
+// Sliced ELLPACK with sigma sorting (SELL-C-sigma, Kreutzer et al.). Rows are
+// grouped into chunks of C; each chunk is padded to its longest row and
+// stored column-major, so entry j of the C rows is C consecutive values and
+// a SIMD kernel runs C rows at once, one per lane, with no remainder loop
+// per row. Sorting rows by length inside sigma-row windows keeps the
+// padding small while y stays nearly in order.
+//
+// Padding entries hold zero and repeat the last column of their row, so
+// gathers stay in bounds and hit lines the row already loaded.
+template<typename T, typename ColIndex = std::size_t, typename ChunkPtr = std::size_t>
+    requires MatrixValue<T> && MatrixIndex<ColIndex> && MatrixIndex<ChunkPtr>
+class SellMatrix {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using index_type = ColIndex;
+    using offset_type = ChunkPtr;
+
+    template<typename RowPtr, typename Allocator>
+    explicit SellMatrix(const SparseMatrix<T, ColIndex, RowPtr, Allocator>& csr, SellOptions options = {})
+        : SellMatrix(csr, options, nullptr) {}
+
+    // Parallel conversion: chunks are filled on the pool
+    template<typename RowPtr, typename Allocator>
+    SellMatrix(const SparseMatrix<T, ColIndex, RowPtr, Allocator>& csr, execution::ThreadPool& pool, SellOptions options = {})
+        : SellMatrix(csr, options, &pool) {}
+
+    [[nodiscard]] auto rows() const noexcept -> size_type { return rows_; }
+    [[nodiscard]] auto cols() const noexcept -> size_type { return cols_; }
+    // Nonzeros of the source matrix, without padding
+    [[nodiscard]] auto nnz() const noexcept -> size_type { return nnz_; }
+    // Stored entries, padding included
+    [[nodiscard]] auto stored() const noexcept -> size_type { return values_.size(); }
+    [[nodiscard]] auto chunk_height() const noexcept -> size_type { return chunk_height_; }
+    [[nodiscard]] auto sigma() const noexcept -> size_type { return sigma_; }
+    [[nodiscard]] auto chunks() const noexcept -> size_type { return chunk_ptrs_.size() - 1; }
+
+    // Slot of chunk storage -> original row; empty when sigma == 1, since
+    // rows then keep their order
+    [[nodiscard]] auto row_permutation() const noexcept -> std::span<const size_type> { return row_perm_; }
+    [[nodiscard]] auto chunk_ptrs() const noexcept -> std::span<const offset_type> { return chunk_ptrs_; }
+    [[nodiscard]] auto col_indices() const noexcept -> std::span<const index_type> { return col_indices_; }
+    [[nodiscard]] auto values() const noexcept -> std::span<const value_type> { return values_; }
+
+private:
+    size_type rows_;
+    size_type cols_;
+    size_type nnz_;
+    size_type chunk_height_;
+    size_type sigma_;
+    std::vector<offset_type> chunk_ptrs_;
+    std::vector<index_type> col_indices_;
+    std::vector<value_type> values_;
+    std::vector<size_type> row_perm_;
+
+    template<typename RowPtr, typename Allocator>
+    SellMatrix(const SparseMatrix<T, ColIndex, RowPtr, Allocator>& csr, SellOptions options, execution::ThreadPool* pool)
+        : rows_(csr.rows()), cols_(csr.cols()), nnz_(csr.nnz()),
+          chunk_height_(options.chunk_height != 0
+              ? options.chunk_height : detail::simd_lanes<T>(execution::active_simd_level())),
+          sigma_(options.sigma != 0 ? options.sigma : 32 * chunk_height_) {
+        if (sigma_ != 1 && sigma_ % chunk_height_ != 0) {
+            throw std::invalid_argument("SELL sigma must be 1 or a multiple of the chunk height");
+        }
+        const auto& data = csr.raw_data();
+        auto length = [&data](size_type row) {
+            return static_cast<size_type>(data.row_ptrs[row + 1] - data.row_ptrs[row]);
+        };
+
+        // Stable sort by decreasing length inside each window
+        if (sigma_ > 1) {
+            row_perm_.resize(rows_);
+            std::iota(row_perm_.begin(), row_perm_.end(), size_type{0});
+            for (size_type begin = 0; begin < rows_; begin += sigma_) {
+                const size_type end = std::min(begin + sigma_, rows_);
+                std::stable_sort(row_perm_.begin() + static_cast<std::ptrdiff_t>(begin),
+                                 row_perm_.begin() + static_cast<std::ptrdiff_t>(end),
+                                 [&length](size_type a, size_type b) { return length(a) > length(b); });
+            }
+        }
+        auto source_row = [this](size_type slot) { return row_perm_.empty() ? slot : row_perm_[slot]; };
+
+        const size_type chunk_count = (rows_ + chunk_height_ - 1) / chunk_height_;
+        chunk_ptrs_.assign(chunk_count + 1, offset_type{});
+        size_type offset = 0;
+        for (size_type chunk = 0; chunk < chunk_count; ++chunk) {
+            size_type width = 0;
+            const size_type last = std::min((chunk + 1) * chunk_height_, rows_);
+            for (size_type slot = chunk * chunk_height_; slot < last; ++slot) {
+                width = std::max(width, length(source_row(slot)));
+            }
+            offset += width * chunk_height_;
+            chunk_ptrs_[chunk + 1] = detail::checked_index_cast<offset_type>(offset);
+        }
+        col_indices_.resize(offset);
+        values_.resize(offset);
+
+        detail::for_each_partition(pool, chunk_count, [&](size_type first, size_type last) {
+            for (size_type chunk = first; chunk < last; ++chunk) {
+                const auto base = static_cast<size_type>(chunk_ptrs_[chunk]);
+                const size_type width = (static_cast<size_type>(chunk_ptrs_[chunk + 1]) - base) / chunk_height_;
+                for (size_type lane = 0; lane < chunk_height_; ++lane) {
+                    const size_type slot = chunk * chunk_height_ + lane;
+                    size_type j = 0;
+                    index_type pad_col{};
+                    if (slot < rows_) {
+                        const size_type row = source_row(slot);
+                        const auto begin = static_cast<size_type>(data.row_ptrs[row]);
+                        for (; j < length(row); ++j) {
+                            col_indices_[base + j * chunk_height_ + lane] = data.col_indices[begin + j];
+                            values_[base + j * chunk_height_ + lane] = data.values[begin + j];
+                        }
+                        if (j > 0) {
+                            pad_col = data.col_indices[begin + j - 1];
+                        }
+                    }
+                    for (; j < width; ++j) {
+                        col_indices_[base + j * chunk_height_ + lane] = pad_col;
+                        values_[base + j * chunk_height_ + lane] = value_type{};
+                    }
+                }
+            }
+        });
+    }
+};
+
+} // namespace sparse_linalg
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "partition.hpp"
 #include <vector>
 #include <span>
 #include <concepts>
@@ -7,6 +8,9 @@
 #include <ranges>
 #include <stdexcept>
 #include <cstddef>
+#include <utility>
+#include <atomic>
+#include <memory>
 
 namespace sparse_linalg {
 
@@ -14,25 +18,87 @@ template<typename T>
 concept MatrixValue = std::floating_point<T> || std::integral<T>;
 
 template<typename T>
-    requires MatrixValue<T>
+concept MatrixIndex = std::integral<T> && !std::same_as<T, bool>;
+
+namespace detail {
+    // Narrows a size or index to the storage type, throwing instead of wrapping
+    template<typename To, typename From>
+    constexpr To checked_index_cast(From value) {
+        if (!std::in_range<To>(value)) {
+            throw std::overflow_error("Index does not fit the matrix index type");
+        }
+        return static_cast<To>(value);
+    }
+
+    // Holds the most recent partition plan. Plans are immutable and shared,
+    // so copies of a matrix may keep using the same one.
+    class PartitionPlanCache {
+    public:
+        PartitionPlanCache() = default;
+        PartitionPlanCache(const PartitionPlanCache& other) : plan_(other.plan_.load()) {}
+        PartitionPlanCache& operator=(const PartitionPlanCache& other) {
+            plan_.store(other.plan_.load());
+            return *this;
+        }
+
+        [[nodiscard]] std::shared_ptr<const PartitionPlan> load() const { return plan_.load(); }
+        void store(std::shared_ptr<const PartitionPlan> plan) const { plan_.store(std::move(plan)); }
+        void clear() const { plan_.store(nullptr); }
+
+    private:
+        mutable std::atomic<std::shared_ptr<const PartitionPlan>> plan_;
+    };
+}
+
+// ColIndex and RowPtr select the CSR index widths, e.g. std::uint32_t columns
+// with std::uint64_t row pointers to halve index traffic on large matrices.
+// Allocator (rebound for the index arrays) places all three CSR arrays, e.g.
+// AlignedAllocator for cache-line-aligned, huge-page-backed storage.
+template<typename T, typename ColIndex = std::size_t, typename RowPtr = std::size_t,
+         typename Allocator = std::allocator<T>>
+    requires MatrixValue<T> && MatrixIndex<ColIndex> && MatrixIndex<RowPtr>
 class SparseMatrix {
 public:
     using value_type = T;
     using size_type = std::size_t;
     using difference_type = std::ptrdiff_t;
-    using index_type = std::int32_t;
+    using index_type = ColIndex;
+    using offset_type = RowPtr;
+    using allocator_type = Allocator;
+
+    template<typename U>
+    using vector_type = std::vector<U, typename std::allocator_traits<Allocator>::template rebind_alloc<U>>;
 
     struct CSRMatrix {
-        std::vector<value_type> values;
-        std::vector<size_type> col_indices;
-        std::vector<size_type> row_ptrs;
+        vector_type<value_type> values;
+        vector_type<index_type> col_indices;
+        vector_type<offset_type> row_ptrs;
     };
 
     SparseMatrix(size_type rows, size_type cols)
         : rows_(rows), cols_(cols) {
+        validate_extents();
         data_.row_ptrs.resize(rows + 1, 0);
     }
 
+    // Adopts prebuilt CSR arrays; column indices must be sorted within each row
+    SparseMatrix(size_type rows, size_type cols, CSRMatrix data)
+        : rows_(rows), cols_(cols), data_(std::move(data)) {
+        validate_extents();
+        validate_structure();
+    }
+
+    // Copy into storage from another allocator
+    template<typename OtherAllocator>
+        requires (!std::same_as<OtherAllocator, Allocator>)
+    explicit SparseMatrix(const SparseMatrix<T, ColIndex, RowPtr, OtherAllocator>& other)
+        : rows_(other.rows()), cols_(other.cols()) {
+        const auto& source = other.raw_data();
+        data_.values.assign(source.values.begin(), source.values.end());
+        data_.col_indices.assign(source.col_indices.begin(), source.col_indices.end());
+        data_.row_ptrs.assign(source.row_ptrs.begin(), source.row_ptrs.end());
+    }
+
     [[nodiscard]] auto rows() const noexcept -> size_type { return rows_; }
     [[nodiscard]] auto cols() const noexcept -> size_type { return cols_; }
     [[nodiscard]] auto nnz() const noexcept -> size_type { return data_.values.size(); }
@@ -45,10 +111,11 @@ public:
         auto it = std::lower_bound(
             data_.col_indices.begin() + static_cast<difference_type>(row_start),
             data_.col_indices.begin() + static_cast<difference_type>(row_end),
-            col
+            static_cast<index_type>(col)
         );
         
-        if (it != data_.col_indices.begin() + static_cast<difference_type>(row_end) && *it == col) {
+        if (it != data_.col_indices.begin() + static_cast<difference_type>(row_end) &&
+            *it == static_cast<index_type>(col)) {
             const auto pos = static_cast<size_type>(std::distance(data_.col_indices.begin(), it));
             return data_.values[pos];
         }
@@ -61,24 +128,28 @@ public:
 
         const auto row_start = data_.row_ptrs[row];
         const auto row_end = data_.row_ptrs[row + 1];
+        const auto index = static_cast<index_type>(col);
         
         auto it = std::lower_bound(
             data_.col_indices.begin() + static_cast<difference_type>(row_start),
             data_.col_indices.begin() + static_cast<difference_type>(row_end),
-            col
+            index
         );
         
         const auto pos = static_cast<size_type>(std::distance(data_.col_indices.begin(), it));
         
-        if (it != data_.col_indices.begin() + static_cast<difference_type>(row_end) && *it == col) {
+        if (it != data_.col_indices.begin() + static_cast<difference_type>(row_end) && *it == index) {
             data_.values[pos] = value;
         } else {
+            // Growing past the row pointer type must fail before anything is modified
+            detail::checked_index_cast<offset_type>(data_.values.size() + 1);
             data_.values.insert(data_.values.begin() + static_cast<difference_type>(pos), value);
-            data_.col_indices.insert(it, col);
+            data_.col_indices.insert(it, index);
             
             for (size_type i = row + 1; i < rows_ + 1; ++i) {
                 ++data_.row_ptrs[i];
             }
+            plan_cache_.clear();
         }
     }
 
@@ -90,9 +161,9 @@ public:
         );
     }
 
-    [[nodiscard]] auto row_indices(size_type row) const -> std::span<const size_type> {
+    [[nodiscard]] auto row_indices(size_type row) const -> std::span<const index_type> {
         validate_row(row);
-        return std::span<const size_type>(
+        return std::span<const index_type>(
             data_.col_indices.begin() + static_cast<difference_type>(data_.row_ptrs[row]),
             data_.col_indices.begin() + static_cast<difference_type>(data_.row_ptrs[row + 1])
         );
@@ -100,10 +171,31 @@ public:
 
     [[nodiscard]] const CSRMatrix& raw_data() const noexcept { return data_; }
 
+    // Stored values in CSR order. Writing through the span updates values
+    // in place without touching the sparsity pattern; zeros stay stored.
+    [[nodiscard]] auto values() noexcept -> std::span<value_type> { return data_.values; }
+
+    // Work split for parallel kernels. The plan is built on first use and
+    // cached until the sparsity pattern changes.
+    [[nodiscard]] auto partition_plan(PartitionStrategy strategy, size_type num_parts) const
+        -> std::shared_ptr<const PartitionPlan> {
+        if (num_parts == 0) {
+            throw std::invalid_argument("Partition plan needs at least one part");
+        }
+        auto plan = plan_cache_.load();
+        if (!plan || plan->strategy != strategy || plan->spans.size() != num_parts) {
+            plan = std::make_shared<const PartitionPlan>(detail::make_partition_plan(
+                std::span<const offset_type>(data_.row_ptrs), strategy, num_parts));
+            plan_cache_.store(plan);
+        }
+        return plan;
+    }
+
 private:
     size_type rows_;
     size_type cols_;
     CSRMatrix data_;
+    detail::PartitionPlanCache plan_cache_;
 
     void validate_indices(size_type row, size_type col) const {
         if (row >= rows_ || col >= cols_) {
@@ -116,6 +208,38 @@ private:
             throw std::out_of_range("Row index out of range");
         }
     }
+
+    // Every column index must be representable as index_type
+    void validate_extents() const {
+        if (cols_ > 0) {
+            detail::checked_index_cast<index_type>(cols_ - 1);
+        }
+    }
+
+    void validate_structure() const {
+        if (data_.row_ptrs.size() != rows_ + 1 || data_.row_ptrs.front() != 0) {
+            throw std::invalid_argument("Row pointer array does not match matrix rows");
+        }
+        if (std::cmp_not_equal(data_.row_ptrs.back(), data_.values.size()) ||
+            data_.col_indices.size() != data_.values.size()) {
+            throw std::invalid_argument("CSR array sizes are inconsistent");
+        }
+        for (size_type row = 0; row < rows_; ++row) {
+            const auto row_start = data_.row_ptrs[row];
+            const auto row_end = data_.row_ptrs[row + 1];
+            if (row_end < row_start) {
+                throw std::invalid_argument("Row pointers must be non-decreasing");
+            }
+            const auto first = static_cast<size_type>(row_start);
+            for (auto i = first; i < static_cast<size_type>(row_end); ++i) {
+                if (std::cmp_less(data_.col_indices[i], 0) ||
+                    std::cmp_greater_equal(data_.col_indices[i], cols_) ||
+                    (i > first && data_.col_indices[i] <= data_.col_indices[i - 1])) {
+                    throw std::invalid_argument("Column indices must be in range and strictly increasing");
+                }
+            }
+        }
+    }
 };
 
 } // namespace sparse_linalg
\ No newline at end of file
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "sparse_matrix.hpp"
+#include "parallel_utils.hpp"
+#include <atomic>
+#include <numeric>
+#include <span>
+
+namespace sparse_linalg {
+
+// How entries sharing the same (row, col) position are combined
+enum class DuplicatePolicy {
+    sum,        // accumulate all values
+    last_wins,  // keep the value added last
+    error       // throw std::invalid_argument
+};
+
+template<typename T>
+    requires MatrixValue<T>
+struct Triplet {
+    std::size_t row;
+    std::size_t col;
+    T value;
+};
+
+// Collects unsorted (row, col, value) triplets and assembles CSR storage in O(nnz + rows)
+template<typename T, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+    requires MatrixValue<T> && MatrixIndex<ColIndex> && MatrixIndex<RowPtr>
+class SparseMatrixBuilder {
+public:
+    using matrix_type = SparseMatrix<T, ColIndex, RowPtr>;
+    using value_type = T;
+    using size_type = std::size_t;
+    using index_type = ColIndex;
+    using offset_type = RowPtr;
+    using triplet_type = Triplet<T>;
+
+    SparseMatrixBuilder(size_type rows, size_type cols, DuplicatePolicy policy = DuplicatePolicy::sum)
+        : rows_(rows), cols_(cols), policy_(policy) {
+        if (cols_ > 0) {
+            detail::checked_index_cast<index_type>(cols_ - 1);
+        }
+    }
+
+    [[nodiscard]] auto rows() const noexcept -> size_type { return rows_; }
+    [[nodiscard]] auto cols() const noexcept -> size_type { return cols_; }
+    [[nodiscard]] auto size() const noexcept -> size_type { return triplets_.size(); }
+    [[nodiscard]] auto policy() const noexcept -> DuplicatePolicy { return policy_; }
+
+    void reserve(size_type count) { triplets_.reserve(count); }
+    void clear() noexcept { triplets_.clear(); }
+
+    void add(size_type row, size_type col, value_type value) {
+        if (row >= rows_ || col >= cols_) {
+            throw std::out_of_range("Matrix indices out of range");
+        }
+        triplets_.push_back({row, col, value});
+    }
+
+    void add(std::span<const triplet_type> triplets) {
+        triplets_.reserve(triplets_.size() + triplets.size());
+        for (const auto& t : triplets) {
+            add(t.row, t.col, t.value);
+        }
+    }
+
+    // Sequential assembly
+    [[nodiscard]] matrix_type build() const {
+        return assemble(nullptr);
+    }
+
+    // Parallel assembly; every phase is split across the pool's workers
+    [[nodiscard]] matrix_type build(execution::ThreadPool& pool) const {
+        return assemble(&pool);
+    }
+
+private:
+    size_type rows_;
+    size_type cols_;
+    DuplicatePolicy policy_;
+    std::vector<triplet_type> triplets_;
+
+    matrix_type assemble(execution::ThreadPool* pool) const {
+        const size_type count = triplets_.size();
+
+        // Counting sort on rows: histogram, exclusive prefix sum, scatter.
+        // Scatter order inside a row is not stable across threads; ties are
+        // broken by input position when each row is sorted below.
+        std::vector<size_type> row_start(rows_ + 1, 0);
+        detail::for_each_partition(pool, count, [&](size_type begin, size_type end) {
+            for (size_type i = begin; i < end; ++i) {
+                std::atomic_ref<size_type>(row_start[triplets_[i].row + 1])
+                    .fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        std::inclusive_scan(row_start.begin(), row_start.end(), row_start.begin());
+
+        std::vector<size_type> cursor(row_start.begin(), row_start.end() - 1);
+        std::vector<size_type> order(count);
+        detail::for_each_partition(pool, count, [&](size_type begin, size_type end) {
+            for (size_type i = begin; i < end; ++i) {
+                const auto slot = std::atomic_ref<size_type>(cursor[triplets_[i].row])
+                    .fetch_add(1, std::memory_order_relaxed);
+                order[slot] = i;
+            }
+        });
+
+        // Sort each row by column (then input position) and count the surviving entries
+        std::vector<size_type> row_ptrs(rows_ + 1, 0);
+        detail::for_each_partition(pool, rows_, [&](size_type begin, size_type end) {
+            for (size_type row = begin; row < end; ++row) {
+                auto first = order.begin() + static_cast<std::ptrdiff_t>(row_start[row]);
+                auto last = order.begin() + static_cast<std::ptrdiff_t>(row_start[row + 1]);
+                std::sort(first, last, [this](size_type a, size_type b) {
+                    return triplets_[a].col != triplets_[b].col
+                        ? triplets_[a].col < triplets_[b].col
+                        : a < b;
+                });
+                row_ptrs[row + 1] = merge_row(row_start[row], row_start[row + 1], order, nullptr, nullptr);
+            }
+        });
+        std::inclusive_scan(row_ptrs.begin(), row_ptrs.end(), row_ptrs.begin());
+
+        typename matrix_type::CSRMatrix data;
+        detail::checked_index_cast<offset_type>(row_ptrs.back());
+        data.values.resize(row_ptrs.back());
+        data.col_indices.resize(row_ptrs.back());
+        data.row_ptrs.resize(rows_ + 1);
+        detail::for_each_partition(pool, rows_, [&](size_type begin, size_type end) {
+            for (size_type row = begin; row < end; ++row) {
+                merge_row(row_start[row], row_start[row + 1], order,
+                          data.values.data() + row_ptrs[row],
+                          data.col_indices.data() + row_ptrs[row]);
+                data.row_ptrs[row + 1] = static_cast<offset_type>(row_ptrs[row + 1]);
+            }
+        });
+
+        return matrix_type(rows_, cols_, std::move(data));
+    }
+
+    // Combines duplicates of one sorted row, dropping zeros as insert() does.
+    // Writes to values/cols when given and returns the number of entries kept.
+    size_type merge_row(
+        size_type begin,
+        size_type end,
+        const std::vector<size_type>& order,
+        value_type* values,
+        index_type* cols
+    ) const {
+        size_type kept = 0;
+        size_type i = begin;
+        while (i < end) {
+            const auto col = triplets_[order[i]].col;
+            value_type value = triplets_[order[i]].value;
+            size_type j = i + 1;
+            for (; j < end && triplets_[order[j]].col == col; ++j) {
+                switch (policy_) {
+                    case DuplicatePolicy::sum:
+                        value += triplets_[order[j]].value;
+                        break;
+                    case DuplicatePolicy::last_wins:
+                        value = triplets_[order[j]].value;
+                        break;
+                    case DuplicatePolicy::error:
+                        throw std::invalid_argument("Duplicate matrix entry");
+                }
+            }
+
+            if (value != value_type{}) {
+                if (values) {
+                    values[kept] = value;
+                    cols[kept] = static_cast<index_type>(col);
+                }
+                ++kept;
+            }
+            i = j;
+        }
+        return kept;
+    }
+};
+
+} // namespace sparse_linalg
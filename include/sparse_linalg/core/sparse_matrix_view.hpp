@@ -0,0 +1,159 @@
+#pragma once
+
+#include "sparse_matrix.hpp"
+#include "partition.hpp"
+#include "spmv_kernels.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace sparse_linalg {
+
+// Read-only CSR matrix over arrays it does not own, e.g. a memory-mapped
+// file (see io::map_binary) or another matrix. Offers the read API of
+// SparseMatrix, and MatrixOps multiplies it in place, without a copy.
+//
+// The optional owner handle keeps the storage alive for as long as any
+// copy of the view exists; a view of a SparseMatrix holds none, so the
+// matrix must outlive it.
+template<typename T, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+    requires MatrixValue<T> && MatrixIndex<ColIndex> && MatrixIndex<RowPtr>
+class SparseMatrixView {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using index_type = ColIndex;
+    using offset_type = RowPtr;
+    using matrix_type = SparseMatrix<T, ColIndex, RowPtr>;
+
+    // Views a matrix of any allocator; the view itself never allocates
+    template<typename Allocator>
+    explicit SparseMatrixView(const SparseMatrix<T, ColIndex, RowPtr, Allocator>& matrix)
+        : SparseMatrixView(matrix.rows(), matrix.cols(), matrix.raw_data().row_ptrs,
+                           matrix.raw_data().col_indices, matrix.raw_data().values) {}
+
+    // Adopts raw CSR arrays. Only the array sizes and the end points of
+    // row_ptrs are checked here; validate_structure() checks every row.
+    SparseMatrixView(size_type rows, size_type cols,
+                     std::span<const offset_type> row_ptrs,
+                     std::span<const index_type> col_indices,
+                     std::span<const value_type> values,
+                     std::shared_ptr<const void> owner = {})
+        : rows_(rows), cols_(cols), row_ptrs_(row_ptrs), col_indices_(col_indices), values_(values),
+          owner_(std::move(owner)) {
+        if (cols_ > 0) {
+            detail::checked_index_cast<index_type>(cols_ - 1);
+        }
+        if (row_ptrs_.size() != rows_ + 1 || row_ptrs_.front() != 0) {
+            throw std::invalid_argument("Row pointer array does not match matrix rows");
+        }
+        if (std::cmp_not_equal(row_ptrs_.back(), values_.size()) || col_indices_.size() != values_.size()) {
+            throw std::invalid_argument("CSR array sizes are inconsistent");
+        }
+    }
+
+    [[nodiscard]] auto rows() const noexcept -> size_type { return rows_; }
+    [[nodiscard]] auto cols() const noexcept -> size_type { return cols_; }
+    [[nodiscard]] auto nnz() const noexcept -> size_type { return values_.size(); }
+
+    [[nodiscard]] auto operator()(size_type row, size_type col) const -> value_type {
+        if (row >= rows_ || col >= cols_) {
+            throw std::out_of_range("Matrix indices out of range");
+        }
+        const auto indices = row_indices(row);
+        const auto it = std::lower_bound(indices.begin(), indices.end(), static_cast<index_type>(col));
+        if (it != indices.end() && *it == static_cast<index_type>(col)) {
+            return row_values(row)[static_cast<size_type>(it - indices.begin())];
+        }
+        return value_type{};
+    }
+
+    [[nodiscard]] auto row_values(size_type row) const -> std::span<const value_type> {
+        validate_row(row);
+        const auto first = static_cast<size_type>(row_ptrs_[row]);
+        return values_.subspan(first, static_cast<size_type>(row_ptrs_[row + 1]) - first);
+    }
+
+    [[nodiscard]] auto row_indices(size_type row) const -> std::span<const index_type> {
+        validate_row(row);
+        const auto first = static_cast<size_type>(row_ptrs_[row]);
+        return col_indices_.subspan(first, static_cast<size_type>(row_ptrs_[row + 1]) - first);
+    }
+
+    [[nodiscard]] auto row_ptrs() const noexcept -> std::span<const offset_type> { return row_ptrs_; }
+    [[nodiscard]] auto col_indices() const noexcept -> std::span<const index_type> { return col_indices_; }
+    [[nodiscard]] auto values() const noexcept -> std::span<const value_type> { return values_; }
+
+    // Same caching as SparseMatrix::partition_plan
+    [[nodiscard]] auto partition_plan(PartitionStrategy strategy, size_type num_parts) const
+        -> std::shared_ptr<const PartitionPlan> {
+        if (num_parts == 0) {
+            throw std::invalid_argument("Partition plan needs at least one part");
+        }
+        auto plan = plan_cache_.load();
+        if (!plan || plan->strategy != strategy || plan->spans.size() != num_parts) {
+            plan = std::make_shared<const PartitionPlan>(detail::make_partition_plan(row_ptrs_, strategy, num_parts));
+            plan_cache_.store(plan);
+        }
+        return plan;
+    }
+
+    // Full check of untrusted arrays: row pointers non-decreasing, columns
+    // in range and strictly increasing within each row. Reads every index.
+    void validate_structure() const {
+        for (size_type row = 0; row < rows_; ++row) {
+            if (row_ptrs_[row + 1] < row_ptrs_[row]) {
+                throw std::invalid_argument("Row pointers must be non-decreasing");
+            }
+        }
+        for (size_type row = 0; row < rows_; ++row) {
+            const auto indices = row_indices(row);
+            for (size_type k = 0; k < indices.size(); ++k) {
+                if (std::cmp_less(indices[k], 0) || std::cmp_greater_equal(indices[k], cols_) ||
+                    (k > 0 && indices[k] <= indices[k - 1])) {
+                    throw std::invalid_argument("Column indices must be in range and strictly increasing");
+                }
+            }
+        }
+    }
+
+    // Owning copy of the viewed matrix
+    [[nodiscard]] auto to_matrix() const -> matrix_type {
+        typename matrix_type::CSRMatrix data;
+        data.row_ptrs.assign(row_ptrs_.begin(), row_ptrs_.end());
+        data.col_indices.assign(col_indices_.begin(), col_indices_.end());
+        data.values.assign(values_.begin(), values_.end());
+        return matrix_type(rows_, cols_, std::move(data));
+    }
+
+private:
+    size_type rows_;
+    size_type cols_;
+    std::span<const offset_type> row_ptrs_;
+    std::span<const index_type> col_indices_;
+    std::span<const value_type> values_;
+    std::shared_ptr<const void> owner_;
+    detail::PartitionPlanCache plan_cache_;
+
+    void validate_row(size_type row) const {
+        if (row >= rows_) {
+            throw std::out_of_range("Row index out of range");
+        }
+    }
+};
+
+namespace detail {
+    template<typename T, typename Index, typename Offset>
+    auto csr_arrays(const SparseMatrixView<T, Index, Offset>& matrix) {
+        return CsrArrays<T, Index, Offset>{
+            matrix.row_ptrs().data(), matrix.col_indices().data(), matrix.values().data()
+        };
+    }
+}
+
+} // namespace sparse_linalg
@@ -0,0 +1,355 @@
+#pragma once
+
+#include "sparse_matrix.hpp"
+#include "allocators.hpp"
+#include "partition.hpp"
+#include "parallel_utils.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace sparse_linalg {
+
+// Per-thread column accumulator used by the sparse matrix product
+enum class SpgemmAccumulator {
+    automatic,  // dense for narrow outputs, hash otherwise
+    dense,      // arrays over every column of B
+    hash        // open addressing sized to the row
+};
+
+namespace detail {
+    inline constexpr std::size_t spgemm_npos = std::numeric_limits<std::size_t>::max();
+
+    // Column -> slot map over all columns of B. Entries are stamped with the
+    // row that wrote them, so nothing is cleared between rows. Accumulator
+    // arrays come from the memory pool: every task of every product builds
+    // its own, and the sizes repeat from one product to the next.
+    class SpgemmDenseAccumulator {
+    public:
+        explicit SpgemmDenseAccumulator(std::size_t cols)
+            : stamp_(cols, spgemm_npos), slot_(cols) {}
+
+        void start_row(std::size_t row, [[maybe_unused]] std::size_t max_entries) { row_ = row; }
+        void finish_row() {}
+
+        // Records col for the current row; true the first time it is seen
+        bool insert(std::size_t col, std::size_t slot) {
+            if (stamp_[col] == row_) {
+                return false;
+            }
+            stamp_[col] = row_;
+            slot_[col] = slot;
+            return true;
+        }
+
+        // Slot of col, or spgemm_npos if the current row has not seen it
+        [[nodiscard]] std::size_t find(std::size_t col) const {
+            return stamp_[col] == row_ ? slot_[col] : spgemm_npos;
+        }
+
+    private:
+        pooled_vector<std::size_t> stamp_;
+        pooled_vector<std::size_t> slot_;
+        std::size_t row_ = spgemm_npos;
+    };
+
+    // Column -> slot map with linear probing, sized to at least twice the
+    // row's entries and cleared through the list of occupied buckets
+    class SpgemmHashAccumulator {
+    public:
+        void start_row([[maybe_unused]] std::size_t row, std::size_t max_entries) {
+            std::size_t capacity = 16;
+            int bits = 4;
+            while (capacity < 2 * max_entries) {
+                capacity *= 2;
+                ++bits;
+            }
+            if (capacity > keys_.size()) {
+                keys_.assign(capacity, spgemm_npos);
+                slots_.resize(capacity);
+                shift_ = 64 - bits;
+            }
+        }
+
+        void finish_row() {
+            for (auto bucket : used_) {
+                keys_[bucket] = spgemm_npos;
+            }
+            used_.clear();
+        }
+
+        bool insert(std::size_t col, std::size_t slot) {
+            const std::size_t mask = keys_.size() - 1;
+            for (std::size_t bucket = hash(col);; bucket = (bucket + 1) & mask) {
+                if (keys_[bucket] == col) {
+                    return false;
+                }
+                if (keys_[bucket] == spgemm_npos) {
+                    keys_[bucket] = col;
+                    slots_[bucket] = slot;
+                    used_.push_back(bucket);
+                    return true;
+                }
+            }
+        }
+
+        [[nodiscard]] std::size_t find(std::size_t col) const {
+            const std::size_t mask = keys_.size() - 1;
+            for (std::size_t bucket = hash(col);; bucket = (bucket + 1) & mask) {
+                if (keys_[bucket] == col) {
+                    return slots_[bucket];
+                }
+                if (keys_[bucket] == spgemm_npos) {
+                    return spgemm_npos;
+                }
+            }
+        }
+
+    private:
+        pooled_vector<std::size_t> keys_;
+        pooled_vector<std::size_t> slots_;
+        pooled_vector<std::size_t> used_;
+        int shift_ = 60;
+
+        // Fibonacci hashing: the top bits of col * 2^64 / phi
+        [[nodiscard]] std::size_t hash(std::size_t col) const {
+            return static_cast<std::size_t>((static_cast<std::uint64_t>(col) * 0x9E3779B97F4A7C15ull) >> shift_);
+        }
+    };
+}
+
+// Gustavson row-by-row product C = A * B, split into a symbolic phase that
+// fixes the pattern of C (done once, in the constructor) and a numeric phase
+// that fills values into storage of exactly that size. When A and B change
+// values but keep their patterns, as in repeated Galerkin products, only
+// the numeric phase has to run again.
+template<typename T, typename ColIndex = std::size_t, typename RowPtr = std::size_t,
+         typename Allocator = std::allocator<T>>
+    requires MatrixValue<T> && MatrixIndex<ColIndex> && MatrixIndex<RowPtr>
+class SparseProduct {
+public:
+    using matrix_type = SparseMatrix<T, ColIndex, RowPtr, Allocator>;
+    using value_type = T;
+    using size_type = std::size_t;
+    using index_type = ColIndex;
+    using offset_type = RowPtr;
+
+    // Sequential symbolic phase
+    SparseProduct(const matrix_type& a, const matrix_type& b,
+                  SpgemmAccumulator accumulator = SpgemmAccumulator::automatic)
+        : SparseProduct(a, b, nullptr, accumulator) {}
+
+    // Parallel symbolic phase over nnz-balanced rows of A
+    SparseProduct(const matrix_type& a, const matrix_type& b, execution::ThreadPool& pool,
+                  SpgemmAccumulator accumulator = SpgemmAccumulator::automatic)
+        : SparseProduct(a, b, &pool, accumulator) {}
+
+    [[nodiscard]] auto rows() const noexcept -> size_type { return rows_; }
+    [[nodiscard]] auto cols() const noexcept -> size_type { return cols_; }
+    [[nodiscard]] auto nnz() const noexcept -> size_type { return col_indices_.size(); }
+    [[nodiscard]] auto accumulator() const noexcept -> SpgemmAccumulator { return accumulator_; }
+
+    // Numeric phase into a new matrix. Entries that cancel to zero are kept,
+    // so the result always has the symbolic pattern.
+    [[nodiscard]] matrix_type compute(const matrix_type& a, const matrix_type& b) const {
+        return build(a, b, nullptr);
+    }
+
+    [[nodiscard]] matrix_type compute(const matrix_type& a, const matrix_type& b,
+                                      execution::ThreadPool& pool) const {
+        return build(a, b, &pool);
+    }
+
+    // Numeric-only update of a matrix previously returned by compute(), after
+    // the values of A and/or B changed but not their patterns
+    void recompute(const matrix_type& a, const matrix_type& b, matrix_type& c) const {
+        validate_output(c);
+        numeric(a, b, c.values(), nullptr);
+    }
+
+    void recompute(const matrix_type& a, const matrix_type& b, matrix_type& c,
+                   execution::ThreadPool& pool) const {
+        validate_output(c);
+        numeric(a, b, c.values(), &pool);
+    }
+
+private:
+    size_type rows_;
+    size_type cols_;
+    size_type a_nnz_;
+    size_type b_nnz_;
+    SpgemmAccumulator accumulator_;
+    typename matrix_type::template vector_type<offset_type> row_ptrs_;
+    typename matrix_type::template vector_type<index_type> col_indices_;
+
+    SparseProduct(const matrix_type& a, const matrix_type& b, execution::ThreadPool* pool,
+                  SpgemmAccumulator accumulator)
+        : rows_(a.rows()), cols_(b.cols()), a_nnz_(a.nnz()), b_nnz_(b.nnz()),
+          accumulator_(accumulator) {
+        if (a.cols() != b.rows()) {
+            throw std::invalid_argument("Matrix dimensions do not match for multiplication");
+        }
+        symbolic(a, b, pool);
+    }
+
+    // Upper bound on the entries of row i of C: the multiply-adds it takes
+    static size_type row_flops(const matrix_type& a, const matrix_type& b, size_type row) {
+        const auto& ad = a.raw_data();
+        const auto& bd = b.raw_data();
+        size_type flops = 0;
+        for (auto p = static_cast<size_type>(ad.row_ptrs[row]); p < static_cast<size_type>(ad.row_ptrs[row + 1]); ++p) {
+            const auto k = static_cast<size_type>(ad.col_indices[p]);
+            flops += static_cast<size_type>(bd.row_ptrs[k + 1] - bd.row_ptrs[k]);
+        }
+        return flops;
+    }
+
+    static std::vector<size_type> row_bounds(std::span<const offset_type> row_ptrs, execution::ThreadPool* pool) {
+        const size_type parts = pool ? pool->thread_count() : 1;
+        return detail::partition_by_nnz(row_ptrs, parts);
+    }
+
+    // Visits the distinct columns of row i of C (unordered); returns their count
+    template<typename Accumulator, typename F>
+    static size_type for_each_column(const matrix_type& a, const matrix_type& b, size_type row,
+                                     Accumulator& acc, F&& on_new) {
+        const auto& ad = a.raw_data();
+        const auto& bd = b.raw_data();
+        acc.start_row(row, row_flops(a, b, row));
+        size_type count = 0;
+        for (auto p = static_cast<size_type>(ad.row_ptrs[row]); p < static_cast<size_type>(ad.row_ptrs[row + 1]); ++p) {
+            const auto k = static_cast<size_type>(ad.col_indices[p]);
+            for (auto q = static_cast<size_type>(bd.row_ptrs[k]); q < static_cast<size_type>(bd.row_ptrs[k + 1]); ++q) {
+                const auto col = static_cast<size_type>(bd.col_indices[q]);
+                if (acc.insert(col, 0)) {
+                    on_new(col);
+                    ++count;
+                }
+            }
+        }
+        acc.finish_row();
+        return count;
+    }
+
+    void symbolic(const matrix_type& a, const matrix_type& b, execution::ThreadPool* pool) {
+        if (accumulator_ == SpgemmAccumulator::automatic) {
+            accumulator_ = choose_accumulator(b);
+        }
+
+        const auto bounds = row_bounds(std::span<const offset_type>(a.raw_data().row_ptrs), pool);
+
+        // Count pass: entries per row of C
+        pooled_vector<size_type> counts(rows_ + 1, 0);
+        with_accumulator(pool, bounds, [&](auto& acc, size_type row) {
+            counts[row + 1] = for_each_column(a, b, row, acc, [](size_type) {});
+        });
+        std::inclusive_scan(counts.begin(), counts.end(), counts.begin());
+
+        detail::checked_index_cast<offset_type>(counts.back());
+        row_ptrs_.resize(rows_ + 1);
+        col_indices_.resize(counts.back());
+        std::transform(counts.begin(), counts.end(), row_ptrs_.begin(),
+                       [](size_type count) { return static_cast<offset_type>(count); });
+
+        // Fill pass: write each row's columns into place, then sort them
+        with_accumulator(pool, bounds, [&](auto& acc, size_type row) {
+            auto out = col_indices_.begin() + static_cast<std::ptrdiff_t>(counts[row]);
+            const auto first = out;
+            for_each_column(a, b, row, acc, [&out](size_type col) {
+                *out++ = static_cast<index_type>(col);
+            });
+            std::sort(first, out);
+        });
+    }
+
+    // Dense arrays pay off while they stay small or rows of C fill a good
+    // share of them; beyond that the hash map keeps the working set per row
+    SpgemmAccumulator choose_accumulator(const matrix_type& b) const {
+        constexpr size_type dense_limit = size_type{1} << 16;
+        if (cols_ <= dense_limit) {
+            return SpgemmAccumulator::dense;
+        }
+        const size_type flops_per_row = rows_ > 0 ? b_nnz_ / std::max<size_type>(b.rows(), 1) * a_nnz_ / rows_ : 0;
+        return cols_ <= 16 * flops_per_row ? SpgemmAccumulator::dense : SpgemmAccumulator::hash;
+    }
+
+    // Runs fn(acc, row) for every row, one accumulator per task
+    template<typename F>
+    void with_accumulator(execution::ThreadPool* pool, const std::vector<size_type>& bounds, F&& fn) const {
+        detail::run_parts(pool, bounds, [&](size_type begin, size_type end) {
+            if (accumulator_ == SpgemmAccumulator::dense) {
+                detail::SpgemmDenseAccumulator acc(cols_);
+                for (size_type row = begin; row < end; ++row) {
+                    fn(acc, row);
+                }
+            } else {
+                detail::SpgemmHashAccumulator acc;
+                for (size_type row = begin; row < end; ++row) {
+                    fn(acc, row);
+                }
+            }
+        });
+    }
+
+    void numeric(const matrix_type& a, const matrix_type& b, std::span<value_type> values,
+                 execution::ThreadPool* pool) const {
+        validate_operands(a, b);
+        const auto& ad = a.raw_data();
+        const auto& bd = b.raw_data();
+
+        // Split on the nonzeros of C, which track the numeric work
+        const auto bounds = row_bounds(std::span<const offset_type>(row_ptrs_), pool);
+        with_accumulator(pool, bounds, [&](auto& acc, size_type row) {
+            const auto begin = static_cast<size_type>(row_ptrs_[row]);
+            const auto end = static_cast<size_type>(row_ptrs_[row + 1]);
+            acc.start_row(row, end - begin);
+            for (size_type slot = begin; slot < end; ++slot) {
+                acc.insert(static_cast<size_type>(col_indices_[slot]), slot);
+                values[slot] = value_type{};
+            }
+
+            for (auto p = static_cast<size_type>(ad.row_ptrs[row]); p < static_cast<size_type>(ad.row_ptrs[row + 1]); ++p) {
+                const value_type a_value = ad.values[p];
+                const auto k = static_cast<size_type>(ad.col_indices[p]);
+                for (auto q = static_cast<size_type>(bd.row_ptrs[k]); q < static_cast<size_type>(bd.row_ptrs[k + 1]); ++q) {
+                    const size_type slot = acc.find(static_cast<size_type>(bd.col_indices[q]));
+                    if (slot == detail::spgemm_npos) {
+                        throw std::invalid_argument("Operand pattern changed since the symbolic phase");
+                    }
+                    values[slot] = static_cast<value_type>(values[slot] + a_value * bd.values[q]);
+                }
+            }
+            acc.finish_row();
+        });
+    }
+
+    matrix_type build(const matrix_type& a, const matrix_type& b, execution::ThreadPool* pool) const {
+        typename matrix_type::CSRMatrix data;
+        data.row_ptrs = row_ptrs_;
+        data.col_indices = col_indices_;
+        data.values.resize(col_indices_.size());
+        numeric(a, b, data.values, pool);
+        return matrix_type(rows_, cols_, std::move(data));
+    }
+
+    // Only shapes and nonzero counts are checked; a changed pattern with the
+    // same counts is the caller's responsibility
+    void validate_operands(const matrix_type& a, const matrix_type& b) const {
+        if (a.rows() != rows_ || b.cols() != cols_ || a.cols() != b.rows() ||
+            a.nnz() != a_nnz_ || b.nnz() != b_nnz_) {
+            throw std::invalid_argument("Operands do not match the symbolic product");
+        }
+    }
+
+    void validate_output(const matrix_type& c) const {
+        if (c.rows() != rows_ || c.cols() != cols_ || c.nnz() != nnz()) {
+            throw std::invalid_argument("Output does not have the pattern of the product");
+        }
+    }
+};
+
+} // namespace sparse_linalg
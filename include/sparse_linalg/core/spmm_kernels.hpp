@@ -0,0 +1,328 @@
+#pragma once
+
+#include "sparse_matrix.hpp"
+#include "spmv_kernels.hpp"
+#include "../execution/simd_utils.hpp"
+#include "../execution/cpu_features.hpp"
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+
+namespace sparse_linalg {
+
+namespace detail {
+    // Dense operands of Y = alpha * A * X + beta * Y. X is always row-major
+    // here (MatrixOps packs column-major inputs first); Y may be either.
+    template<typename T>
+    struct SpmmArgs {
+        const T* x;
+        std::size_t x_stride;      // distance between rows of X
+        T* y;
+        std::size_t y_row_stride;
+        std::size_t y_col_stride;
+        std::size_t k;             // columns of X and Y
+        T alpha;
+        T beta;
+    };
+
+    // y(row, :) = alpha * acc + beta * y(row, :) for any layout of Y
+    template<typename T>
+    inline void spmm_store_strided(const SpmmArgs<T>& args, std::size_t row, const T* acc) {
+        T* y = args.y + row * args.y_row_stride;
+        for (std::size_t c = 0; c < args.k; ++c) {
+            spmv_store(y + c * args.y_col_stride, acc[c], args.alpha, args.beta);
+        }
+    }
+
+    // acc[0..k) += value * x[0..k)
+    template<typename T>
+    inline void spmm_axpy_scalar(T* acc, T value, const T* x, std::size_t k) {
+        for (std::size_t c = 0; c < k; ++c) {
+            acc[c] = static_cast<T>(acc[c] + value * x[c]);
+        }
+    }
+
+#if SPARSE_LINALG_HAS_X86_SIMD
+    template<typename T>
+    SPARSE_LINALG_TARGET_AVX2 inline void spmm_axpy_avx2(T* acc, T value, const T* x, std::size_t k) {
+        using Simd = execution::SimdIsaTraits<T, execution::SimdLevel::avx2>;
+        constexpr std::size_t vec_size = Simd::vector_size;
+
+        const auto v = Simd::broadcast(value);
+        std::size_t c = 0;
+        for (; c + vec_size <= k; c += vec_size) {
+            Simd::store(acc + c, Simd::fmadd(v, Simd::load(x + c), Simd::load(acc + c)));
+        }
+        for (; c < k; ++c) {
+            acc[c] += value * x[c];
+        }
+    }
+
+    template<typename T>
+    SPARSE_LINALG_TARGET_AVX2 inline void spmm_store_avx2(const SpmmArgs<T>& args, std::size_t row, const T* acc) {
+        using Simd = execution::SimdIsaTraits<T, execution::SimdLevel::avx2>;
+        constexpr std::size_t vec_size = Simd::vector_size;
+
+        if (args.y_col_stride != 1) {
+            spmm_store_strided(args, row, acc);
+            return;
+        }
+
+        T* y = args.y + row * args.y_row_stride;
+        const auto alpha = Simd::broadcast(args.alpha);
+        std::size_t c = 0;
+        if (args.beta == T{}) {
+            for (; c + vec_size <= args.k; c += vec_size) {
+                Simd::store(y + c, Simd::multiply(alpha, Simd::load(acc + c)));
+            }
+        } else {
+            const auto beta = Simd::broadcast(args.beta);
+            for (; c + vec_size <= args.k; c += vec_size) {
+                Simd::store(y + c, Simd::fmadd(alpha, Simd::load(acc + c), Simd::multiply(beta, Simd::load(y + c))));
+            }
+        }
+        for (; c < args.k; ++c) {
+            spmv_store(y + c, acc[c], args.alpha, args.beta);
+        }
+    }
+
+    template<typename T>
+    SPARSE_LINALG_TARGET_AVX512 inline void spmm_axpy_avx512(T* acc, T value, const T* x, std::size_t k) {
+        using Simd = execution::SimdIsaTraits<T, execution::SimdLevel::avx512>;
+        constexpr std::size_t vec_size = Simd::vector_size;
+
+        const auto v = Simd::broadcast(value);
+        std::size_t c = 0;
+        for (; c + vec_size <= k; c += vec_size) {
+            Simd::store(acc + c, Simd::fmadd(v, Simd::load(x + c), Simd::load(acc + c)));
+        }
+        if (c < k) {
+            const auto mask = Simd::first_lanes(k - c);
+            Simd::mask_store(acc + c, mask,
+                Simd::fmadd(v, Simd::mask_load(mask, x + c), Simd::mask_load(mask, acc + c)));
+        }
+    }
+
+    template<typename T>
+    SPARSE_LINALG_TARGET_AVX512 inline void spmm_store_avx512(const SpmmArgs<T>& args, std::size_t row, const T* acc) {
+        using Simd = execution::SimdIsaTraits<T, execution::SimdLevel::avx512>;
+        constexpr std::size_t vec_size = Simd::vector_size;
+
+        if (args.y_col_stride != 1) {
+            spmm_store_strided(args, row, acc);
+            return;
+        }
+
+        T* y = args.y + row * args.y_row_stride;
+        const auto alpha = Simd::broadcast(args.alpha);
+        std::size_t c = 0;
+        if (args.beta == T{}) {
+            for (; c + vec_size <= args.k; c += vec_size) {
+                Simd::store(y + c, Simd::multiply(alpha, Simd::load(acc + c)));
+            }
+        } else {
+            const auto beta = Simd::broadcast(args.beta);
+            for (; c + vec_size <= args.k; c += vec_size) {
+                Simd::store(y + c, Simd::fmadd(alpha, Simd::load(acc + c), Simd::multiply(beta, Simd::load(y + c))));
+            }
+        }
+        for (; c < args.k; ++c) {
+            spmv_store(y + c, acc[c], args.alpha, args.beta);
+        }
+    }
+#endif
+
+    // Row kernels for any k: each nonzero A(row, col) is loaded once and
+    // applied to all k entries of X(col, :), accumulating in acc (k entries
+    // of per-task scratch that stays in L1)
+    template<typename T, typename Index, typename Offset>
+    void spmm_rows_scalar(CsrArrays<T, Index, Offset> a, const SpmmArgs<T>& args,
+                          std::size_t begin, std::size_t end, T* acc) {
+        for (std::size_t row = begin; row < end; ++row) {
+            std::fill(acc, acc + args.k, T{});
+            const auto stop = static_cast<std::size_t>(a.row_ptrs[row + 1]);
+            for (auto p = static_cast<std::size_t>(a.row_ptrs[row]); p < stop; ++p) {
+                const auto col = static_cast<std::size_t>(a.col_indices[p]);
+                spmm_axpy_scalar(acc, a.values[p], args.x + col * args.x_stride, args.k);
+            }
+            spmm_store_strided(args, row, acc);
+        }
+    }
+
+#if SPARSE_LINALG_HAS_X86_SIMD
+    template<typename T, typename Index, typename Offset>
+    SPARSE_LINALG_TARGET_AVX2 void spmm_rows_avx2(CsrArrays<T, Index, Offset> a, const SpmmArgs<T>& args,
+                                                  std::size_t begin, std::size_t end, T* acc) {
+        for (std::size_t row = begin; row < end; ++row) {
+            std::fill(acc, acc + args.k, T{});
+            const auto stop = static_cast<std::size_t>(a.row_ptrs[row + 1]);
+            for (auto p = static_cast<std::size_t>(a.row_ptrs[row]); p < stop; ++p) {
+                const auto col = static_cast<std::size_t>(a.col_indices[p]);
+                spmm_axpy_avx2(acc, a.values[p], args.x + col * args.x_stride, args.k);
+            }
+            spmm_store_avx2(args, row, acc);
+        }
+    }
+
+    template<typename T, typename Index, typename Offset>
+    SPARSE_LINALG_TARGET_AVX512 void spmm_rows_avx512(CsrArrays<T, Index, Offset> a, const SpmmArgs<T>& args,
+                                                      std::size_t begin, std::size_t end, T* acc) {
+        for (std::size_t row = begin; row < end; ++row) {
+            std::fill(acc, acc + args.k, T{});
+            const auto stop = static_cast<std::size_t>(a.row_ptrs[row + 1]);
+            for (auto p = static_cast<std::size_t>(a.row_ptrs[row]); p < stop; ++p) {
+                const auto col = static_cast<std::size_t>(a.col_indices[p]);
+                spmm_axpy_avx512(acc, a.values[p], args.x + col * args.x_stride, args.k);
+            }
+            spmm_store_avx512(args, row, acc);
+        }
+    }
+#endif
+
+    // Fixed-k row kernels: with k known at compile time the accumulator row
+    // lives in registers for the whole row and is written out once
+    template<std::size_t K, typename T, typename Index, typename Offset>
+    void spmm_rows_fixed_scalar(CsrArrays<T, Index, Offset> a, const SpmmArgs<T>& args,
+                                std::size_t begin, std::size_t end, [[maybe_unused]] T* acc) {
+        for (std::size_t row = begin; row < end; ++row) {
+            T sum[K] = {};
+            const auto stop = static_cast<std::size_t>(a.row_ptrs[row + 1]);
+            for (auto p = static_cast<std::size_t>(a.row_ptrs[row]); p < stop; ++p) {
+                const T value = a.values[p];
+                const T* x = args.x + static_cast<std::size_t>(a.col_indices[p]) * args.x_stride;
+                for (std::size_t c = 0; c < K; ++c) {
+                    sum[c] = static_cast<T>(sum[c] + value * x[c]);
+                }
+            }
+            spmm_store_strided(args, row, sum);
+        }
+    }
+
+#if SPARSE_LINALG_HAS_X86_SIMD
+    // Register-blocked widths: K must be a whole number of vectors, and at
+    // most 8 accumulators so the loop body does not spill
+    template<typename T, execution::SimdLevel Level, std::size_t K>
+    inline constexpr bool spmm_fixed_fits_v =
+        K % execution::SimdIsaTraits<T, Level>::vector_size == 0 &&
+        K / execution::SimdIsaTraits<T, Level>::vector_size <= 8;
+
+    template<std::size_t K, typename T, typename Index, typename Offset>
+    SPARSE_LINALG_TARGET_AVX2 void spmm_rows_fixed_avx2(CsrArrays<T, Index, Offset> a, const SpmmArgs<T>& args,
+                                                        std::size_t begin, std::size_t end, T* acc) {
+        using Simd = execution::SimdIsaTraits<T, execution::SimdLevel::avx2>;
+        constexpr std::size_t vec_size = Simd::vector_size;
+        constexpr std::size_t vectors = K / vec_size;
+
+        for (std::size_t row = begin; row < end; ++row) {
+            typename Simd::vector_type sum[vectors];
+#pragma GCC unroll 8
+            for (std::size_t j = 0; j < vectors; ++j) {
+                sum[j] = Simd::set_zero();
+            }
+            const auto stop = static_cast<std::size_t>(a.row_ptrs[row + 1]);
+            for (auto p = static_cast<std::size_t>(a.row_ptrs[row]); p < stop; ++p) {
+                const auto value = Simd::broadcast(a.values[p]);
+                const T* x = args.x + static_cast<std::size_t>(a.col_indices[p]) * args.x_stride;
+#pragma GCC unroll 8
+                for (std::size_t j = 0; j < vectors; ++j) {
+                    sum[j] = Simd::fmadd(value, Simd::load(x + j * vec_size), sum[j]);
+                }
+            }
+#pragma GCC unroll 8
+            for (std::size_t j = 0; j < vectors; ++j) {
+                Simd::store(acc + j * vec_size, sum[j]);
+            }
+            spmm_store_avx2(args, row, acc);
+        }
+    }
+
+    template<std::size_t K, typename T, typename Index, typename Offset>
+    SPARSE_LINALG_TARGET_AVX512 void spmm_rows_fixed_avx512(CsrArrays<T, Index, Offset> a, const SpmmArgs<T>& args,
+                                                            std::size_t begin, std::size_t end, T* acc) {
+        using Simd = execution::SimdIsaTraits<T, execution::SimdLevel::avx512>;
+        constexpr std::size_t vec_size = Simd::vector_size;
+        constexpr std::size_t vectors = K / vec_size;
+
+        for (std::size_t row = begin; row < end; ++row) {
+            typename Simd::vector_type sum[vectors];
+#pragma GCC unroll 8
+            for (std::size_t j = 0; j < vectors; ++j) {
+                sum[j] = Simd::set_zero();
+            }
+            const auto stop = static_cast<std::size_t>(a.row_ptrs[row + 1]);
+            for (auto p = static_cast<std::size_t>(a.row_ptrs[row]); p < stop; ++p) {
+                const auto value = Simd::broadcast(a.values[p]);
+                const T* x = args.x + static_cast<std::size_t>(a.col_indices[p]) * args.x_stride;
+#pragma GCC unroll 8
+                for (std::size_t j = 0; j < vectors; ++j) {
+                    sum[j] = Simd::fmadd(value, Simd::load(x + j * vec_size), sum[j]);
+                }
+            }
+#pragma GCC unroll 8
+            for (std::size_t j = 0; j < vectors; ++j) {
+                Simd::store(acc + j * vec_size, sum[j]);
+            }
+            spmm_store_avx512(args, row, acc);
+        }
+    }
+#endif
+
+    // Picks the block kernel for a SIMD level and k. k in {4, 8, 16, 32, 64}
+    // gets a fixed-k kernel; the SIMD kernels need float/double values but,
+    // unlike SpMV, no gather, so any index type is vectorized.
+    template<typename T, typename Index, typename Offset>
+    struct SpmmKernel {
+        using function_type = void (*)(CsrArrays<T, Index, Offset>, const SpmmArgs<T>&,
+                                       std::size_t, std::size_t, T*);
+
+        static function_type select(execution::SimdLevel level, std::size_t k) {
+            switch (k) {
+                case 4: return select_fixed<4>(level);
+                case 8: return select_fixed<8>(level);
+                case 16: return select_fixed<16>(level);
+                case 32: return select_fixed<32>(level);
+                case 64: return select_fixed<64>(level);
+                default: return select_any(level);
+            }
+        }
+
+        static function_type get(std::size_t k) {
+            return select(execution::active_simd_level(), k);
+        }
+
+    private:
+        static function_type select_any([[maybe_unused]] execution::SimdLevel level) {
+#if SPARSE_LINALG_HAS_X86_SIMD
+            if constexpr (std::floating_point<T>) {
+                if (level == execution::SimdLevel::avx512) return &spmm_rows_avx512<T, Index, Offset>;
+                if (level == execution::SimdLevel::avx2) return &spmm_rows_avx2<T, Index, Offset>;
+            }
+#endif
+            return &spmm_rows_scalar<T, Index, Offset>;
+        }
+
+        template<std::size_t K>
+        static function_type select_fixed([[maybe_unused]] execution::SimdLevel level) {
+#if SPARSE_LINALG_HAS_X86_SIMD
+            if constexpr (std::floating_point<T>) {
+                using execution::SimdLevel;
+                if (level == SimdLevel::avx512) {
+                    if constexpr (spmm_fixed_fits_v<T, SimdLevel::avx512, K>) {
+                        return &spmm_rows_fixed_avx512<K, T, Index, Offset>;
+                    }
+                    return &spmm_rows_avx512<T, Index, Offset>;
+                }
+                if (level == SimdLevel::avx2) {
+                    if constexpr (spmm_fixed_fits_v<T, SimdLevel::avx2, K>) {
+                        return &spmm_rows_fixed_avx2<K, T, Index, Offset>;
+                    }
+                    return &spmm_rows_avx2<T, Index, Offset>;
+                }
+            }
+#endif
+            return &spmm_rows_fixed_scalar<K, T, Index, Offset>;
+        }
+    };
+}
+
+} // namespace sparse_linalg
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "sparse_matrix.hpp"
+#include "partition.hpp"
+#include "../execution/simd_utils.hpp"
+#include "../execution/cpu_features.hpp"
+#include <concepts>
+#include <cstddef>
+
+namespace sparse_linalg {
+
+namespace detail {
+    // Raw CSR arrays handed to the row kernels
+    template<typename T, typename Index, typename Offset>
+    struct CsrArrays {
+        const Offset* row_ptrs;
+        const Index* col_indices;
+        const T* values;
+    };
+
+    template<typename T, typename Index, typename Offset, typename Allocator>
+    auto csr_arrays(const SparseMatrix<T, Index, Offset, Allocator>& matrix) {
+        const auto& data = matrix.raw_data();
+        return CsrArrays<T, Index, Offset>{
+            data.row_ptrs.data(), data.col_indices.data(), data.values.data()
+        };
+    }
+
+    template<typename T, typename Index>
+    inline T sparse_dot_scalar(const T* values, const Index* indices, std::size_t count, const T* vec) {
+        T sum{};
+        for (std::size_t i = 0; i < count; ++i) {
+            sum += values[i] * vec[static_cast<std::size_t>(indices[i])];
+        }
+        return sum;
+    }
+
+#if SPARSE_LINALG_HAS_X86_SIMD
+    template<typename T, typename Index>
+    SPARSE_LINALG_TARGET_AVX2 inline T sparse_dot_avx2(
+        const T* values, const Index* indices, std::size_t count, const T* vec
+    ) {
+        using Simd = execution::SimdIsaTraits<T, execution::SimdLevel::avx2>;
+        using VecType = typename Simd::vector_type;
+        constexpr std::size_t vec_size = Simd::vector_size;
+        constexpr std::size_t unroll = 4;
+
+        // Independent accumulators keep several FMAs in flight
+        VecType sum0 = Simd::set_zero();
+        VecType sum1 = Simd::set_zero();
+        VecType sum2 = Simd::set_zero();
+        VecType sum3 = Simd::set_zero();
+
+        std::size_t i = 0;
+        for (; i + unroll * vec_size <= count; i += unroll * vec_size) {
+            sum0 = Simd::fmadd(Simd::load(values + i), Simd::gather(vec, indices + i), sum0);
+            sum1 = Simd::fmadd(Simd::load(values + i + vec_size), Simd::gather(vec, indices + i + vec_size), sum1);
+            sum2 = Simd::fmadd(Simd::load(values + i + 2 * vec_size), Simd::gather(vec, indices + i + 2 * vec_size), sum2);
+            sum3 = Simd::fmadd(Simd::load(values + i + 3 * vec_size), Simd::gather(vec, indices + i + 3 * vec_size), sum3);
+        }
+        for (; i + vec_size <= count; i += vec_size) {
+            sum0 = Simd::fmadd(Simd::load(values + i), Simd::gather(vec, indices + i), sum0);
+        }
+
+        // Process remainder
+        T result = Simd::reduce_sum(Simd::add(Simd::add(sum0, sum1), Simd::add(sum2, sum3)));
+        for (; i < count; ++i) {
+            result += values[i] * vec[static_cast<std::size_t>(indices[i])];
+        }
+        return result;
+    }
+
+    template<typename T, typename Index>
+    SPARSE_LINALG_TARGET_AVX512 inline T sparse_dot_avx512(
+        const T* values, const Index* indices, std::size_t count, const T* vec
+    ) {
+        using Simd = execution::SimdIsaTraits<T, execution::SimdLevel::avx512>;
+        using VecType = typename Simd::vector_type;
+        constexpr std::size_t vec_size = Simd::vector_size;
+        constexpr std::size_t unroll = 4;
+
+        VecType sum0 = Simd::set_zero();
+        VecType sum1 = Simd::set_zero();
+        VecType sum2 = Simd::set_zero();
+        VecType sum3 = Simd::set_zero();
+
+        std::size_t i = 0;
+        for (; i + unroll * vec_size <= count; i += unroll * vec_size) {
+            sum0 = Simd::fmadd(Simd::load(values + i), Simd::gather(vec, indices + i), sum0);
+            sum1 = Simd::fmadd(Simd::load(values + i + vec_size), Simd::gather(vec, indices + i + vec_size), sum1);
+            sum2 = Simd::fmadd(Simd::load(values + i + 2 * vec_size), Simd::gather(vec, indices + i + 2 * vec_size), sum2);
+            sum3 = Simd::fmadd(Simd::load(values + i + 3 * vec_size), Simd::gather(vec, indices + i + 3 * vec_size), sum3);
+        }
+        for (; i + vec_size <= count; i += vec_size) {
+            sum0 = Simd::fmadd(Simd::load(values + i), Simd::gather(vec, indices + i), sum0);
+        }
+
+        // The tail is a single masked step rather than a scalar loop
+        if (i < count) {
+            const auto mask = Simd::first_lanes(count - i);
+            sum1 = Simd::fmadd(Simd::mask_load(mask, values + i), Simd::mask_gather(mask, vec, indices + i), sum1);
+        }
+
+        return Simd::reduce_sum(Simd::add(Simd::add(sum0, sum1), Simd::add(sum2, sum3)));
+    }
+#endif
+
+    // y = alpha * dot + beta * y, following BLAS gemv: with beta == 0, y is
+    // overwritten without being read, so it may hold NaN or garbage
+    template<typename T>
+    inline void spmv_store(T* y, T dot, T alpha, T beta) {
+        *y = beta == T{}
+            ? static_cast<T>(alpha * dot)
+            : static_cast<T>(alpha * dot + beta * *y);
+    }
+
+    // Span kernels: y[row] = alpha * A(row, :) * x + beta * y[row] for every
+    // row the span completes. The unscaled partial sum of its trailing
+    // unfinished row is returned for the caller to fold in.
+    template<typename T, typename Index, typename Offset>
+    T spmv_span_scalar(CsrArrays<T, Index, Offset> a, const T* x, T* y, PartitionSpan span, T alpha, T beta) {
+        std::size_t start = span.nnz_begin;
+        for (std::size_t row = span.row_begin; row < span.row_end; ++row) {
+            const auto stop = static_cast<std::size_t>(a.row_ptrs[row + 1]);
+            spmv_store(y + row, sparse_dot_scalar(a.values + start, a.col_indices + start, stop - start, x), alpha, beta);
+            start = stop;
+        }
+        return sparse_dot_scalar(a.values + start, a.col_indices + start, span.nnz_end - start, x);
+    }
+
+#if SPARSE_LINALG_HAS_X86_SIMD
+    template<typename T, typename Index, typename Offset>
+    SPARSE_LINALG_TARGET_AVX2 T spmv_span_avx2(
+        CsrArrays<T, Index, Offset> a, const T* x, T* y, PartitionSpan span, T alpha, T beta
+    ) {
+        std::size_t start = span.nnz_begin;
+        for (std::size_t row = span.row_begin; row < span.row_end; ++row) {
+            const auto stop = static_cast<std::size_t>(a.row_ptrs[row + 1]);
+            spmv_store(y + row, sparse_dot_avx2(a.values + start, a.col_indices + start, stop - start, x), alpha, beta);
+            start = stop;
+        }
+        return sparse_dot_avx2(a.values + start, a.col_indices + start, span.nnz_end - start, x);
+    }
+
+    template<typename T, typename Index, typename Offset>
+    SPARSE_LINALG_TARGET_AVX512 T spmv_span_avx512(
+        CsrArrays<T, Index, Offset> a, const T* x, T* y, PartitionSpan span, T alpha, T beta
+    ) {
+        std::size_t start = span.nnz_begin;
+        for (std::size_t row = span.row_begin; row < span.row_end; ++row) {
+            const auto stop = static_cast<std::size_t>(a.row_ptrs[row + 1]);
+            spmv_store(y + row, sparse_dot_avx512(a.values + start, a.col_indices + start, stop - start, x), alpha, beta);
+            start = stop;
+        }
+        return sparse_dot_avx512(a.values + start, a.col_indices + start, span.nnz_end - start, x);
+    }
+#endif
+
+    // Picks the span kernel for a SIMD level. SIMD kernels exist for
+    // float/double with 32- or 64-bit column indices; everything else is scalar.
+    template<typename T, typename Index, typename Offset>
+    struct SpmvKernel {
+        using function_type = T (*)(CsrArrays<T, Index, Offset>, const T*, T*, PartitionSpan, T, T);
+
+        static function_type select([[maybe_unused]] execution::SimdLevel level) {
+#if SPARSE_LINALG_HAS_X86_SIMD
+            if constexpr (std::floating_point<T> && execution::is_gather_index_v<Index>) {
+                if (level == execution::SimdLevel::avx512) return &spmv_span_avx512<T, Index, Offset>;
+                if (level == execution::SimdLevel::avx2) return &spmv_span_avx2<T, Index, Offset>;
+            }
+#endif
+            return &spmv_span_scalar<T, Index, Offset>;
+        }
+
+        // Resolved once per instantiation from the host's active SIMD level
+        static function_type get() {
+            static const function_type kernel = select(execution::active_simd_level());
+            return kernel;
+        }
+    };
+}
+
+} // namespace sparse_linalg
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "simd_utils.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+
+#if SPARSE_LINALG_HAS_X86_SIMD
+#include <cpuid.h>
+#endif
+
+namespace sparse_linalg::execution {
+
+struct CpuFeatures {
+    bool avx2 = false;
+    bool fma = false;
+    bool f16c = false;
+    bool avx512f = false;
+};
+
+namespace detail {
+#if SPARSE_LINALG_HAS_X86_SIMD
+    // XCR0: which register states the OS saves on context switch
+    inline std::uint64_t read_xcr0() {
+        std::uint32_t eax = 0;
+        std::uint32_t edx = 0;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<std::uint64_t>(edx) << 32) | eax;
+    }
+#endif
+
+    inline SimdLevel parse_simd_level(std::string_view name, SimdLevel fallback) {
+        if (name == "scalar") return SimdLevel::scalar;
+        if (name == "avx2") return SimdLevel::avx2;
+        if (name == "avx512") return SimdLevel::avx512;
+        return fallback;
+    }
+}
+
+// Queries cpuid and checks that the OS has enabled the matching register state
+inline CpuFeatures detect_cpu_features() {
+    CpuFeatures features;
+#if SPARSE_LINALG_HAS_X86_SIMD
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return features;
+    }
+
+    const bool osxsave = (ecx & (1u << 27)) != 0;
+    const bool avx = (ecx & (1u << 28)) != 0;
+    const bool fma = (ecx & (1u << 12)) != 0;
+    const bool f16c = (ecx & (1u << 29)) != 0;
+    if (!osxsave || !avx) {
+        return features;
+    }
+
+    const std::uint64_t xcr0 = detail::read_xcr0();
+    const bool ymm_state = (xcr0 & 0x6) == 0x6;
+    const bool zmm_state = (xcr0 & 0xE6) == 0xE6;
+    if (!ymm_state || !__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return features;
+    }
+
+    features.fma = fma;
+    features.f16c = f16c;
+    features.avx2 = (ebx & (1u << 5)) != 0;
+    features.avx512f = zmm_state && (ebx & (1u << 16)) != 0;
+#endif
+    return features;
+}
+
+// Highest SIMD level this host can run; detected once
+inline SimdLevel detected_simd_level() {
+    static const SimdLevel level = [] {
+        const auto features = detect_cpu_features();
+        if (features.avx512f && features.avx2 && features.fma && features.f16c) return SimdLevel::avx512;
+        if (features.avx2 && features.fma && features.f16c) return SimdLevel::avx2;
+        return SimdLevel::scalar;
+    }();
+    return level;
+}
+
+// Level used by dispatched kernels: the detected level, optionally lowered
+// through the SPARSE_LINALG_SIMD environment variable (scalar, avx2, avx512)
+inline SimdLevel active_simd_level() {
+    static const SimdLevel level = [] {
+        const SimdLevel detected = detected_simd_level();
+        const char* requested = std::getenv("SPARSE_LINALG_SIMD");
+        if (requested == nullptr) {
+            return detected;
+        }
+        const SimdLevel parsed = detail::parse_simd_level(requested, detected);
+        return parsed < detected ? parsed : detected;
+    }();
+    return level;
+}
+
+} // namespace sparse_linalg::execution
@@ -0,0 +1,633 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Opt-in counters for MatrixOps kernels and the thread pool. Define
+// SPARSE_LINALG_ENABLE_INSTRUMENTATION (CMake option of the same name) to
+// record them; otherwise every hook is an empty inline type and compiles
+// to nothing, and snapshot_metrics() returns an empty snapshot.
+//
+// Recording is lock-free (relaxed atomics, one steady_clock read at each
+// end of a timed region); only a thread's first partition registers it
+// under a mutex.
+//
+// Everything whose definition depends on the macro (the hooks below,
+// ThreadPool and MatrixOps) lives in an inline namespace named after it.
+// TUs that disagree on the macro then see distinct entities rather than
+// two definitions of one: a function taking a ThreadPool& compiled one
+// way and called the other fails to link instead of misbehaving.
+#ifdef SPARSE_LINALG_ENABLE_INSTRUMENTATION
+#define SPARSE_LINALG_INSTRUMENTATION_ABI instrumented
+#else
+#define SPARSE_LINALG_INSTRUMENTATION_ABI uninstrumented
+#endif
+
+namespace sparse_linalg::execution {
+
+inline namespace SPARSE_LINALG_INSTRUMENTATION_ABI {
+#ifdef SPARSE_LINALG_ENABLE_INSTRUMENTATION
+inline constexpr bool instrumentation_enabled = true;
+#else
+inline constexpr bool instrumentation_enabled = false;
+#endif
+}
+
+// MatrixOps entry points that are timed
+enum class Kernel : std::uint8_t {
+    spmv,
+    spmv_parallel,
+    sell_spmv,
+    sell_spmv_parallel,
+    bsr_spmv,
+    bsr_spmv_parallel,
+    spmm,
+    spmm_parallel,
+    spmv_transpose,
+    spmv_transpose_parallel,
+    spgemm,
+    spgemm_parallel,
+    transpose,
+    transpose_parallel
+};
+
+inline constexpr std::size_t kernel_count = 14;
+
+[[nodiscard]] constexpr std::string_view kernel_name(Kernel kernel) {
+    constexpr std::array<std::string_view, kernel_count> names{
+        "spmv", "spmv_parallel", "sell_spmv", "sell_spmv_parallel", "bsr_spmv", "bsr_spmv_parallel",
+        "spmm", "spmm_parallel", "spmv_transpose", "spmv_transpose_parallel", "spgemm", "spgemm_parallel",
+        "transpose", "transpose_parallel"
+    };
+    return names[static_cast<std::size_t>(kernel)];
+}
+
+// Durations in power-of-two buckets: bucket i counts values below 2^i ns
+// (and at least 2^(i-1)), the last one everything from about 9 minutes up
+struct HistogramSnapshot {
+    static constexpr std::size_t bucket_count = 40;
+
+    std::uint64_t count = 0;
+    std::uint64_t sum_ns = 0;
+    std::uint64_t max_ns = 0;
+    std::array<std::uint64_t, bucket_count> buckets{};
+
+    // Exclusive upper bound of bucket i in nanoseconds
+    [[nodiscard]] static constexpr std::uint64_t upper_bound_ns(std::size_t i) {
+        return std::uint64_t{1} << i;
+    }
+
+    [[nodiscard]] double mean_ns() const noexcept {
+        return count == 0 ? 0.0 : static_cast<double>(sum_ns) / static_cast<double>(count);
+    }
+
+    // Upper bound of the bucket holding quantile q, capped at the maximum
+    [[nodiscard]] std::uint64_t quantile_ns(double q) const noexcept {
+        if (count == 0) {
+            return 0;
+        }
+        const auto rank = static_cast<std::uint64_t>(q * static_cast<double>(count - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < bucket_count; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                return std::min(upper_bound_ns(i), max_ns);
+            }
+        }
+        return max_ns;
+    }
+};
+
+struct KernelMetrics {
+    Kernel kernel{};
+    std::uint64_t calls = 0;
+    std::uint64_t nnz = 0;             // nonzeros processed, summed over calls
+    HistogramSnapshot latency;         // wall time per call
+    // Parallel kernels only, summed over calls
+    std::uint64_t partitions = 0;
+    std::uint64_t busy_ns = 0;         // time spent inside partitions, all threads
+    std::uint64_t critical_ns = 0;     // the slowest partition of each call
+    std::uint64_t balanced_ns = 0;     // busy time / partitions of each call
+
+    // Slowest over average partition; 1 is perfect balance
+    [[nodiscard]] double imbalance() const noexcept {
+        return balanced_ns == 0 ? 0.0 : static_cast<double>(critical_ns) / static_cast<double>(balanced_ns);
+    }
+
+    // Call time not covered by the slowest partition: partitioning,
+    // dispatch, wake-up and join
+    [[nodiscard]] std::uint64_t overhead_ns() const noexcept {
+        return partitions == 0 || latency.sum_ns < critical_ns ? 0 : latency.sum_ns - critical_ns;
+    }
+};
+
+// Partition time of one thread, numbered in order of first use
+struct ThreadMetrics {
+    std::size_t thread = 0;
+    std::uint64_t partitions = 0;
+    std::uint64_t busy_ns = 0;
+};
+
+struct PoolMetrics {
+    std::uint64_t tasks = 0;            // tasks submitted
+    std::uint64_t queue_depth = 0;      // tasks submitted and not finished, over all pools
+    std::uint64_t max_queue_depth = 0;
+    HistogramSnapshot queue_wait;       // submission to start
+    HistogramSnapshot task_latency;     // submission to completion
+};
+
+inline namespace SPARSE_LINALG_INSTRUMENTATION_ABI {
+struct MetricsSnapshot {
+    bool enabled = instrumentation_enabled;
+    std::vector<KernelMetrics> kernels;  // kernels called at least once
+    std::vector<ThreadMetrics> threads;
+    PoolMetrics pool;
+};
+}
+
+namespace detail {
+    using InstrumentClock = std::chrono::steady_clock;
+
+    inline std::uint64_t elapsed_ns(InstrumentClock::time_point since) {
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(InstrumentClock::now() - since).count();
+        return ns > 0 ? static_cast<std::uint64_t>(ns) : 0;
+    }
+
+    inline void atomic_max(std::atomic<std::uint64_t>& target, std::uint64_t value) {
+        auto current = target.load(std::memory_order_relaxed);
+        while (current < value && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    class LatencyHistogram {
+    public:
+        void record(std::uint64_t ns) {
+            const auto bucket = std::min<std::size_t>(static_cast<std::size_t>(std::bit_width(ns)),
+                                                      HistogramSnapshot::bucket_count - 1);
+            buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+            count_.fetch_add(1, std::memory_order_relaxed);
+            sum_.fetch_add(ns, std::memory_order_relaxed);
+            atomic_max(max_, ns);
+        }
+
+        [[nodiscard]] HistogramSnapshot snapshot() const {
+            HistogramSnapshot result;
+            result.count = count_.load(std::memory_order_relaxed);
+            result.sum_ns = sum_.load(std::memory_order_relaxed);
+            result.max_ns = max_.load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < buckets_.size(); ++i) {
+                result.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+            }
+            return result;
+        }
+
+        void reset() {
+            for (auto& bucket : buckets_) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+            count_.store(0, std::memory_order_relaxed);
+            sum_.store(0, std::memory_order_relaxed);
+            max_.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        std::array<std::atomic<std::uint64_t>, HistogramSnapshot::bucket_count> buckets_{};
+        std::atomic<std::uint64_t> count_{0};
+        std::atomic<std::uint64_t> sum_{0};
+        std::atomic<std::uint64_t> max_{0};
+    };
+
+    struct KernelCounters {
+        std::atomic<std::uint64_t> calls{0};
+        std::atomic<std::uint64_t> nnz{0};
+        LatencyHistogram latency;
+        std::atomic<std::uint64_t> partitions{0};
+        std::atomic<std::uint64_t> busy_ns{0};
+        std::atomic<std::uint64_t> critical_ns{0};
+        std::atomic<std::uint64_t> balanced_ns{0};
+    };
+
+    struct ThreadCounters {
+        std::size_t thread = 0;
+        std::atomic<std::uint64_t> partitions{0};
+        std::atomic<std::uint64_t> busy_ns{0};
+    };
+
+    class MetricsRegistry {
+    public:
+        static MetricsRegistry& instance() {
+            static MetricsRegistry registry;
+            return registry;
+        }
+
+        KernelCounters& kernel(Kernel kernel) { return kernels_[static_cast<std::size_t>(kernel)]; }
+
+        // Counters of the calling thread, registered on first use. They
+        // outlive the thread so its busy time stays in the totals.
+        ThreadCounters& this_thread() {
+            thread_local ThreadCounters* counters = nullptr;
+            if (!counters) {
+                std::lock_guard<std::mutex> lock(threads_mutex_);
+                counters = &threads_.emplace_back();
+                counters->thread = threads_.size() - 1;
+            }
+            return *counters;
+        }
+
+        void task_submitted() {
+            tasks_.fetch_add(1, std::memory_order_relaxed);
+            atomic_max(max_queue_depth_, queue_depth_.fetch_add(1, std::memory_order_relaxed) + 1);
+        }
+
+        void task_finished() { queue_depth_.fetch_sub(1, std::memory_order_relaxed); }
+
+        LatencyHistogram& queue_wait() { return queue_wait_; }
+        LatencyHistogram& task_latency() { return task_latency_; }
+
+        [[nodiscard]] MetricsSnapshot snapshot() {
+            MetricsSnapshot result;
+            for (std::size_t i = 0; i < kernel_count; ++i) {
+                const auto& counters = kernels_[i];
+                const auto calls = counters.calls.load(std::memory_order_relaxed);
+                if (calls == 0) {
+                    continue;
+                }
+                KernelMetrics metrics;
+                metrics.kernel = static_cast<Kernel>(i);
+                metrics.calls = calls;
+                metrics.nnz = counters.nnz.load(std::memory_order_relaxed);
+                metrics.latency = counters.latency.snapshot();
+                metrics.partitions = counters.partitions.load(std::memory_order_relaxed);
+                metrics.busy_ns = counters.busy_ns.load(std::memory_order_relaxed);
+                metrics.critical_ns = counters.critical_ns.load(std::memory_order_relaxed);
+                metrics.balanced_ns = counters.balanced_ns.load(std::memory_order_relaxed);
+                result.kernels.push_back(metrics);
+            }
+            {
+                std::lock_guard<std::mutex> lock(threads_mutex_);
+                for (const auto& counters : threads_) {
+                    result.threads.push_back({counters.thread, counters.partitions.load(std::memory_order_relaxed),
+                                              counters.busy_ns.load(std::memory_order_relaxed)});
+                }
+            }
+            result.pool.tasks = tasks_.load(std::memory_order_relaxed);
+            result.pool.queue_depth = queue_depth_.load(std::memory_order_relaxed);
+            result.pool.max_queue_depth = max_queue_depth_.load(std::memory_order_relaxed);
+            result.pool.queue_wait = queue_wait_.snapshot();
+            result.pool.task_latency = task_latency_.snapshot();
+            return result;
+        }
+
+        // Zeroes every counter but the queue depth gauge; threads stay
+        // registered. Not atomic with respect to concurrent recording.
+        void reset() {
+            for (auto& counters : kernels_) {
+                counters.calls.store(0, std::memory_order_relaxed);
+                counters.nnz.store(0, std::memory_order_relaxed);
+                counters.latency.reset();
+                counters.partitions.store(0, std::memory_order_relaxed);
+                counters.busy_ns.store(0, std::memory_order_relaxed);
+                counters.critical_ns.store(0, std::memory_order_relaxed);
+                counters.balanced_ns.store(0, std::memory_order_relaxed);
+            }
+            {
+                std::lock_guard<std::mutex> lock(threads_mutex_);
+                for (auto& counters : threads_) {
+                    counters.partitions.store(0, std::memory_order_relaxed);
+                    counters.busy_ns.store(0, std::memory_order_relaxed);
+                }
+            }
+            tasks_.store(0, std::memory_order_relaxed);
+            max_queue_depth_.store(queue_depth_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            queue_wait_.reset();
+            task_latency_.reset();
+        }
+
+    private:
+        MetricsRegistry() = default;
+
+        std::array<KernelCounters, kernel_count> kernels_{};
+        std::mutex threads_mutex_;
+        std::deque<ThreadCounters> threads_;  // stable addresses
+        std::atomic<std::uint64_t> tasks_{0};
+        std::atomic<std::uint64_t> queue_depth_{0};
+        std::atomic<std::uint64_t> max_queue_depth_{0};
+        LatencyHistogram queue_wait_;
+        LatencyHistogram task_latency_;
+    };
+
+    inline namespace SPARSE_LINALG_INSTRUMENTATION_ABI {
+#ifdef SPARSE_LINALG_ENABLE_INSTRUMENTATION
+    // Times one MatrixOps call. Parallel calls route each partition through
+    // time_part, which adds its busy time to the calling thread's counters
+    // and to the call's balance statistics.
+    class KernelTimer {
+    public:
+        KernelTimer(Kernel kernel, std::size_t nnz, std::size_t parts = 0)
+            : kernel_(kernel), nnz_(nnz), busy_(parts), start_(InstrumentClock::now()) {}
+
+        KernelTimer(const KernelTimer&) = delete;
+        KernelTimer& operator=(const KernelTimer&) = delete;
+
+        ~KernelTimer() {
+            auto& counters = MetricsRegistry::instance().kernel(kernel_);
+            counters.latency.record(elapsed_ns(start_));
+            counters.calls.fetch_add(1, std::memory_order_relaxed);
+            counters.nnz.fetch_add(nnz_, std::memory_order_relaxed);
+            if (!busy_.empty()) {
+                std::uint64_t total = 0;
+                std::uint64_t slowest = 0;
+                for (auto ns : busy_) {
+                    total += ns;
+                    slowest = std::max(slowest, ns);
+                }
+                counters.partitions.fetch_add(busy_.size(), std::memory_order_relaxed);
+                counters.busy_ns.fetch_add(total, std::memory_order_relaxed);
+                counters.critical_ns.fetch_add(slowest, std::memory_order_relaxed);
+                counters.balanced_ns.fetch_add(total / busy_.size(), std::memory_order_relaxed);
+            }
+        }
+
+        template<typename F>
+        decltype(auto) time_part(std::size_t part, F&& fn) {
+            struct Stop {
+                KernelTimer& timer;
+                std::size_t part;
+                InstrumentClock::time_point start = InstrumentClock::now();
+                ~Stop() {
+                    const auto ns = elapsed_ns(start);
+                    auto& thread = MetricsRegistry::instance().this_thread();
+                    thread.partitions.fetch_add(1, std::memory_order_relaxed);
+                    thread.busy_ns.fetch_add(ns, std::memory_order_relaxed);
+                    timer.busy_[part] = ns;
+                }
+            } stop{*this, part};
+            return std::forward<F>(fn)();
+        }
+
+    private:
+        Kernel kernel_;
+        std::size_t nnz_;
+        std::vector<std::uint64_t> busy_;
+        InstrumentClock::time_point start_;
+    };
+
+    // Submission time of a pool task, carried with it to the worker
+    class TaskStamp {
+    public:
+        TaskStamp() : queued_(InstrumentClock::now()) {}
+
+        void started() const { MetricsRegistry::instance().queue_wait().record(elapsed_ns(queued_)); }
+        void finished() const { MetricsRegistry::instance().task_latency().record(elapsed_ns(queued_)); }
+
+    private:
+        InstrumentClock::time_point queued_;
+    };
+
+    inline void task_submitted() { MetricsRegistry::instance().task_submitted(); }
+    inline void task_finished() { MetricsRegistry::instance().task_finished(); }
+#else
+    class KernelTimer {
+    public:
+        constexpr KernelTimer(Kernel, std::size_t, std::size_t = 0) noexcept {}
+
+        template<typename F>
+        decltype(auto) time_part(std::size_t, F&& fn) {
+            return std::forward<F>(fn)();
+        }
+    };
+
+    class TaskStamp {
+    public:
+        constexpr void started() const noexcept {}
+        constexpr void finished() const noexcept {}
+    };
+
+    constexpr void task_submitted() noexcept {}
+    constexpr void task_finished() noexcept {}
+#endif
+    }
+
+    inline void append_number(std::string& out, std::uint64_t value) {
+        char buffer[24];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+    }
+
+    inline void append_number(std::string& out, double value) {
+        char buffer[32];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+    }
+
+    inline void append_seconds(std::string& out, std::uint64_t ns) {
+        append_number(out, static_cast<double>(ns) * 1e-9);
+    }
+
+    inline void append_json_histogram(std::string& out, const HistogramSnapshot& h) {
+        out += "{\"count\":";
+        append_number(out, h.count);
+        out += ",\"sum_ns\":";
+        append_number(out, h.sum_ns);
+        out += ",\"max_ns\":";
+        append_number(out, h.max_ns);
+        out += ",\"p50_ns\":";
+        append_number(out, h.quantile_ns(0.5));
+        out += ",\"p99_ns\":";
+        append_number(out, h.quantile_ns(0.99));
+        // Non-empty buckets as [upper bound, count] pairs
+        out += ",\"buckets\":[";
+        bool first = true;
+        for (std::size_t i = 0; i < HistogramSnapshot::bucket_count; ++i) {
+            if (h.buckets[i] == 0) {
+                continue;
+            }
+            out += first ? "[" : ",[";
+            first = false;
+            append_number(out, HistogramSnapshot::upper_bound_ns(i));
+            out += ',';
+            append_number(out, h.buckets[i]);
+            out += ']';
+        }
+        out += "]}";
+    }
+
+    // Cumulative buckets up to the last non-empty one, then +Inf
+    inline void append_prometheus_histogram(std::string& out, std::string_view name, std::string_view labels,
+                                            const HistogramSnapshot& h) {
+        std::size_t last = 0;
+        for (std::size_t i = 0; i < HistogramSnapshot::bucket_count; ++i) {
+            if (h.buckets[i] != 0) {
+                last = i;
+            }
+        }
+        std::uint64_t cumulative = 0;
+        for (std::size_t i = 0; i <= last && h.count != 0; ++i) {
+            cumulative += h.buckets[i];
+            out.append(name).append("_bucket{").append(labels).append(labels.empty() ? "le=\"" : ",le=\"");
+            append_seconds(out, HistogramSnapshot::upper_bound_ns(i));
+            out += "\"} ";
+            append_number(out, cumulative);
+            out += '\n';
+        }
+        out.append(name).append("_bucket{").append(labels).append(labels.empty() ? "le=\"+Inf\"} " : ",le=\"+Inf\"} ");
+        append_number(out, h.count);
+        out.append("\n").append(name).append("_sum");
+        if (!labels.empty()) {
+            out.append("{").append(labels).append("}");
+        }
+        out += ' ';
+        append_seconds(out, h.sum_ns);
+        out.append("\n").append(name).append("_count");
+        if (!labels.empty()) {
+            out.append("{").append(labels).append("}");
+        }
+        out += ' ';
+        append_number(out, h.count);
+        out += '\n';
+    }
+}
+
+inline namespace SPARSE_LINALG_INSTRUMENTATION_ABI {
+// Current values of every counter; cheap enough to poll (no allocation
+// beyond the result, one mutex for the thread list)
+[[nodiscard]] inline MetricsSnapshot snapshot_metrics() {
+    if constexpr (instrumentation_enabled) {
+        return detail::MetricsRegistry::instance().snapshot();
+    } else {
+        return MetricsSnapshot{};
+    }
+}
+
+inline void reset_metrics() {
+    if constexpr (instrumentation_enabled) {
+        detail::MetricsRegistry::instance().reset();
+    }
+}
+}
+
+// One JSON object: {"enabled", "kernels": [...], "threads": [...], "pool": {...}}
+[[nodiscard]] inline std::string to_json(const MetricsSnapshot& snapshot) {
+    std::string out = snapshot.enabled ? "{\"enabled\":true,\"kernels\":[" : "{\"enabled\":false,\"kernels\":[";
+    for (std::size_t k = 0; k < snapshot.kernels.size(); ++k) {
+        const auto& m = snapshot.kernels[k];
+        out += k == 0 ? "{\"name\":\"" : ",{\"name\":\"";
+        out.append(kernel_name(m.kernel)).append("\",\"calls\":");
+        detail::append_number(out, m.calls);
+        out += ",\"nnz\":";
+        detail::append_number(out, m.nnz);
+        out += ",\"latency\":";
+        detail::append_json_histogram(out, m.latency);
+        if (m.partitions != 0) {
+            out += ",\"partitions\":";
+            detail::append_number(out, m.partitions);
+            out += ",\"busy_ns\":";
+            detail::append_number(out, m.busy_ns);
+            out += ",\"critical_ns\":";
+            detail::append_number(out, m.critical_ns);
+            out += ",\"overhead_ns\":";
+            detail::append_number(out, m.overhead_ns());
+            out += ",\"imbalance\":";
+            detail::append_number(out, m.imbalance());
+        }
+        out += '}';
+    }
+    out += "],\"threads\":[";
+    for (std::size_t t = 0; t < snapshot.threads.size(); ++t) {
+        const auto& m = snapshot.threads[t];
+        out += t == 0 ? "{\"thread\":" : ",{\"thread\":";
+        detail::append_number(out, std::uint64_t{m.thread});
+        out += ",\"partitions\":";
+        detail::append_number(out, m.partitions);
+        out += ",\"busy_ns\":";
+        detail::append_number(out, m.busy_ns);
+        out += '}';
+    }
+    out += "],\"pool\":{\"tasks\":";
+    detail::append_number(out, snapshot.pool.tasks);
+    out += ",\"queue_depth\":";
+    detail::append_number(out, snapshot.pool.queue_depth);
+    out += ",\"max_queue_depth\":";
+    detail::append_number(out, snapshot.pool.max_queue_depth);
+    out += ",\"queue_wait\":";
+    detail::append_json_histogram(out, snapshot.pool.queue_wait);
+    out += ",\"task_latency\":";
+    detail::append_json_histogram(out, snapshot.pool.task_latency);
+    out += "}}";
+    return out;
+}
+
+// Prometheus text exposition format, times in seconds
+[[nodiscard]] inline std::string to_prometheus(const MetricsSnapshot& snapshot) {
+    std::string out;
+    if (!snapshot.kernels.empty()) {
+        out += "# TYPE sparse_linalg_kernel_calls_total counter\n";
+        for (const auto& m : snapshot.kernels) {
+            out.append("sparse_linalg_kernel_calls_total{kernel=\"").append(kernel_name(m.kernel)).append("\"} ");
+            detail::append_number(out, m.calls);
+            out += '\n';
+        }
+        out += "# TYPE sparse_linalg_kernel_nonzeros_total counter\n";
+        for (const auto& m : snapshot.kernels) {
+            out.append("sparse_linalg_kernel_nonzeros_total{kernel=\"").append(kernel_name(m.kernel)).append("\"} ");
+            detail::append_number(out, m.nnz);
+            out += '\n';
+        }
+        out += "# TYPE sparse_linalg_kernel_seconds histogram\n";
+        for (const auto& m : snapshot.kernels) {
+            const std::string labels = "kernel=\"" + std::string(kernel_name(m.kernel)) + "\"";
+            detail::append_prometheus_histogram(out, "sparse_linalg_kernel_seconds", labels, m.latency);
+        }
+        const std::pair<std::string_view, std::uint64_t KernelMetrics::*> partition_counters[] = {
+            {"sparse_linalg_kernel_busy_seconds_total", &KernelMetrics::busy_ns},
+            {"sparse_linalg_kernel_critical_path_seconds_total", &KernelMetrics::critical_ns},
+            {"sparse_linalg_kernel_balanced_seconds_total", &KernelMetrics::balanced_ns},
+        };
+        for (const auto& [name, member] : partition_counters) {
+            out.append("# TYPE ").append(name).append(" counter\n");
+            for (const auto& m : snapshot.kernels) {
+                if (m.partitions != 0) {
+                    out.append(name).append("{kernel=\"").append(kernel_name(m.kernel)).append("\"} ");
+                    detail::append_seconds(out, m.*member);
+                    out += '\n';
+                }
+            }
+        }
+    }
+    if (!snapshot.threads.empty()) {
+        out += "# TYPE sparse_linalg_thread_busy_seconds_total counter\n";
+        for (const auto& m : snapshot.threads) {
+            out += "sparse_linalg_thread_busy_seconds_total{thread=\"";
+            detail::append_number(out, std::uint64_t{m.thread});
+            out += "\"} ";
+            detail::append_seconds(out, m.busy_ns);
+            out += '\n';
+        }
+    }
+    out += "# TYPE sparse_linalg_pool_tasks_total counter\nsparse_linalg_pool_tasks_total ";
+    detail::append_number(out, snapshot.pool.tasks);
+    out += "\n# TYPE sparse_linalg_pool_queue_depth gauge\nsparse_linalg_pool_queue_depth ";
+    detail::append_number(out, snapshot.pool.queue_depth);
+    out += "\n# TYPE sparse_linalg_pool_queue_depth_max gauge\nsparse_linalg_pool_queue_depth_max ";
+    detail::append_number(out, snapshot.pool.max_queue_depth);
+    out += "\n# TYPE sparse_linalg_pool_queue_wait_seconds histogram\n";
+    detail::append_prometheus_histogram(out, "sparse_linalg_pool_queue_wait_seconds", "", snapshot.pool.queue_wait);
+    out += "# TYPE sparse_linalg_pool_task_latency_seconds histogram\n";
+    detail::append_prometheus_histogram(out, "sparse_linalg_pool_task_latency_seconds", "",
+                                        snapshot.pool.task_latency);
+    return out;
+}
+
+} // namespace sparse_linalg::execution
@@ -1,49 +1,122 @@
 #pragma once
 
+#include "../core/half_precision.hpp"
 #include <cstddef>
+#include <cstdint>
 #include <span>
 #include <type_traits>
 
-#if defined(__AVX2__)
+// x86 SIMD code is compiled through per-function target attributes, so every
+// instruction set is available regardless of -m flags and the best one is
+// picked at runtime (see cpu_features.hpp)
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SPARSE_LINALG_HAS_X86_SIMD 1
+#define SPARSE_LINALG_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define SPARSE_LINALG_TARGET_AVX2_F16C __attribute__((target("avx2,fma,f16c")))
+#define SPARSE_LINALG_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma,f16c")))
 #include <immintrin.h>
+#else
+#define SPARSE_LINALG_HAS_X86_SIMD 0
 #endif
 
 namespace sparse_linalg::execution {
 
-template<typename T>
-struct SimdTraits {
+enum class SimdLevel {
+    scalar,
+    avx2,    // AVX2 + FMA + F16C
+    avx512   // AVX-512F
+};
+
+template<typename T, SimdLevel Level>
+struct SimdIsaTraits {
     static constexpr bool is_vectorizable = false;
     static constexpr std::size_t vector_size = 1;
 };
 
-#if defined(__AVX2__)
+// Index types with a hardware gather: 32-bit and 64-bit integers
+template<typename Index>
+inline constexpr bool is_gather_index_v =
+    std::is_integral_v<Index> && (sizeof(Index) == 4 || sizeof(Index) == 8);
+
+#if SPARSE_LINALG_HAS_X86_SIMD
 template<>
-struct SimdTraits<float> {
+struct SimdIsaTraits<float, SimdLevel::avx2> {
     static constexpr bool is_vectorizable = true;
     static constexpr std::size_t vector_size = 8;
     using vector_type = __m256;
-    
-    static vector_type load(const float* ptr) {
+
+    SPARSE_LINALG_TARGET_AVX2 static vector_type load(const float* ptr) {
         return _mm256_loadu_ps(ptr);
     }
-    
-    static void store(float* ptr, vector_type val) {
+
+    SPARSE_LINALG_TARGET_AVX2 static void store(float* ptr, vector_type val) {
         _mm256_storeu_ps(ptr, val);
     }
-    
-    static vector_type multiply(vector_type a, vector_type b) {
+
+    SPARSE_LINALG_TARGET_AVX2 static vector_type multiply(vector_type a, vector_type b) {
         return _mm256_mul_ps(a, b);
     }
-    
-    static vector_type add(vector_type a, vector_type b) {
+
+    SPARSE_LINALG_TARGET_AVX2 static vector_type add(vector_type a, vector_type b) {
         return _mm256_add_ps(a, b);
     }
-    
-    static vector_type set_zero() {
+
+    // a * b + c
+    SPARSE_LINALG_TARGET_AVX2 static vector_type fmadd(vector_type a, vector_type b, vector_type c) {
+        return _mm256_fmadd_ps(a, b, c);
+    }
+
+    SPARSE_LINALG_TARGET_AVX2 static vector_type set_zero() {
         return _mm256_setzero_ps();
     }
-    
-    static float reduce_sum(vector_type v) {
+
+    SPARSE_LINALG_TARGET_AVX2 static vector_type broadcast(float value) {
+        return _mm256_set1_ps(value);
+    }
+
+    // Loads vector_size 16-bit values and widens them to float in registers:
+    // bfloat16 is the high half of a float, float16 goes through F16C
+    SPARSE_LINALG_TARGET_AVX2 static vector_type load_widen(const bfloat16* ptr) {
+        const __m128i bits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(bits), 16));
+    }
+
+    SPARSE_LINALG_TARGET_AVX2_F16C static vector_type load_widen(const float16* ptr) {
+        return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)));
+    }
+
+    // Gather mask selecting every lane. The masked gather forms are used
+    // because the unmasked ones read an uninitialized source under GCC.
+    SPARSE_LINALG_TARGET_AVX2 static vector_type all_lanes() {
+        return _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    }
+
+    // Loads base[indices[0..7]]; unsigned 32-bit indices are widened so
+    // values above INT32_MAX stay correct
+    template<typename Index>
+        requires is_gather_index_v<Index>
+    SPARSE_LINALG_TARGET_AVX2 static vector_type gather(const float* base, const Index* indices) {
+        if constexpr (sizeof(Index) == 4 && std::is_signed_v<Index>) {
+            const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices));
+            return _mm256_mask_i32gather_ps(_mm256_setzero_ps(), base, idx, all_lanes(), 4);
+        } else {
+            __m256i lo_idx;
+            __m256i hi_idx;
+            if constexpr (sizeof(Index) == 4) {
+                const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices));
+                lo_idx = _mm256_cvtepu32_epi64(_mm256_castsi256_si128(idx));
+                hi_idx = _mm256_cvtepu32_epi64(_mm256_extracti128_si256(idx, 1));
+            } else {
+                lo_idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices));
+                hi_idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + 4));
+            }
+            const __m128 lo = _mm256_mask_i64gather_ps(_mm_setzero_ps(), base, lo_idx, _mm256_castps256_ps128(all_lanes()), 4);
+            const __m128 hi = _mm256_mask_i64gather_ps(_mm_setzero_ps(), base, hi_idx, _mm256_castps256_ps128(all_lanes()), 4);
+            return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+        }
+    }
+
+    SPARSE_LINALG_TARGET_AVX2 static float reduce_sum(vector_type v) {
         __m128 high = _mm256_extractf128_ps(v, 1);
         __m128 low = _mm256_castps256_ps128(v);
         __m128 sum = _mm_add_ps(high, low);
@@ -54,32 +127,78 @@ struct SimdTraits<float> {
 };
 
 template<>
-struct SimdTraits<double> {
+struct SimdIsaTraits<double, SimdLevel::avx2> {
     static constexpr bool is_vectorizable = true;
     static constexpr std::size_t vector_size = 4;
     using vector_type = __m256d;
-    
-    static vector_type load(const double* ptr) {
+
+    SPARSE_LINALG_TARGET_AVX2 static vector_type load(const double* ptr) {
         return _mm256_loadu_pd(ptr);
     }
-    
-    static void store(double* ptr, vector_type val) {
+
+    SPARSE_LINALG_TARGET_AVX2 static void store(double* ptr, vector_type val) {
         _mm256_storeu_pd(ptr, val);
     }
-    
-    static vector_type multiply(vector_type a, vector_type b) {
+
+    SPARSE_LINALG_TARGET_AVX2 static vector_type multiply(vector_type a, vector_type b) {
         return _mm256_mul_pd(a, b);
     }
-    
-    static vector_type add(vector_type a, vector_type b) {
+
+    SPARSE_LINALG_TARGET_AVX2 static vector_type add(vector_type a, vector_type b) {
         return _mm256_add_pd(a, b);
     }
-    
-    static vector_type set_zero() {
+
+    // a * b + c
+    SPARSE_LINALG_TARGET_AVX2 static vector_type fmadd(vector_type a, vector_type b, vector_type c) {
+        return _mm256_fmadd_pd(a, b, c);
+    }
+
+    SPARSE_LINALG_TARGET_AVX2 static vector_type set_zero() {
         return _mm256_setzero_pd();
     }
-    
-    static double reduce_sum(vector_type v) {
+
+    SPARSE_LINALG_TARGET_AVX2 static vector_type broadcast(double value) {
+        return _mm256_set1_pd(value);
+    }
+
+    // Loads vector_size narrower values and widens them to double in registers
+    SPARSE_LINALG_TARGET_AVX2 static vector_type load_widen(const float* ptr) {
+        return _mm256_cvtps_pd(_mm_loadu_ps(ptr));
+    }
+
+    SPARSE_LINALG_TARGET_AVX2 static vector_type load_widen(const bfloat16* ptr) {
+        const __m128i bits = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(ptr));
+        return _mm256_cvtps_pd(_mm_castsi128_ps(_mm_slli_epi32(_mm_cvtepu16_epi32(bits), 16)));
+    }
+
+    SPARSE_LINALG_TARGET_AVX2_F16C static vector_type load_widen(const float16* ptr) {
+        return _mm256_cvtps_pd(_mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(ptr))));
+    }
+
+    // Gather mask selecting every lane (see the float specialization)
+    SPARSE_LINALG_TARGET_AVX2 static vector_type all_lanes() {
+        return _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    }
+
+    // Loads base[indices[0..3]]; unsigned 32-bit indices are widened so
+    // values above INT32_MAX stay correct
+    template<typename Index>
+        requires is_gather_index_v<Index>
+    SPARSE_LINALG_TARGET_AVX2 static vector_type gather(const double* base, const Index* indices) {
+        if constexpr (sizeof(Index) == 4) {
+            const __m128i idx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices));
+            if constexpr (std::is_signed_v<Index>) {
+                return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, idx, all_lanes(), 8);
+            } else {
+                return _mm256_mask_i64gather_pd(_mm256_setzero_pd(), base, _mm256_cvtepu32_epi64(idx), all_lanes(), 8);
+            }
+        } else {
+            const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices));
+            return _mm256_mask_i64gather_pd(_mm256_setzero_pd(), base, idx, all_lanes(), 8);
+        }
+    }
+
+    SPARSE_LINALG_TARGET_AVX2 static double reduce_sum(vector_type v) {
         __m128d high = _mm256_extractf128_pd(v, 1);
         __m128d low = _mm256_castpd256_pd128(v);
         __m128d sum = _mm_add_pd(high, low);
@@ -87,6 +206,264 @@ struct SimdTraits<double> {
         return _mm_cvtsd_f64(sum);
     }
 };
+
+// GCC 12 implements several unmasked AVX-512 intrinsics (cvtepu32, cvtps_pd, extract,
+// insert and the 512->256 casts built on them) with a self-initialized source that
+// trips -Wmaybe-uninitialized, and its unoptimized gather macros pass masks as
+// plain char. The helpers below use the zero-masked forms instead, and the
+// sign-conversion warning is silenced for the AVX-512 traits only.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+
+namespace detail {
+    SPARSE_LINALG_TARGET_AVX512 inline __m512i avx512_widen_u32(__m256i v) {
+        return _mm512_maskz_cvtepu32_epi64(0xFF, v);
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 inline __m256i avx512_low_half(__m512i v) {
+        return _mm512_maskz_extracti64x4_epi64(0xFF, v, 0);
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 inline __m256i avx512_high_half(__m512i v) {
+        return _mm512_maskz_extracti64x4_epi64(0xFF, v, 1);
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 inline __m256d avx512_low_half(__m512d v) {
+        return _mm512_maskz_extractf64x4_pd(0xFF, v, 0);
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 inline __m256d avx512_high_half(__m512d v) {
+        return _mm512_maskz_extractf64x4_pd(0xFF, v, 1);
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 inline __m512 avx512_combine(__m256 lo, __m256 hi) {
+        return _mm512_castpd_ps(_mm512_maskz_insertf64x4(
+            0xFF, _mm512_castps_pd(_mm512_castps256_ps512(lo)), _mm256_castps_pd(hi), 1));
+    }
+}
+
+// AVX-512 traits add masked loads and gathers so a row's tail is processed
+// as one partial vector instead of a scalar loop
+template<>
+struct SimdIsaTraits<float, SimdLevel::avx512> {
+    static constexpr bool is_vectorizable = true;
+    static constexpr std::size_t vector_size = 16;
+    using vector_type = __m512;
+    using mask_type = __mmask16;
+
+    SPARSE_LINALG_TARGET_AVX512 static vector_type load(const float* ptr) {
+        return _mm512_loadu_ps(ptr);
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 static void store(float* ptr, vector_type val) {
+        _mm512_storeu_ps(ptr, val);
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 static vector_type multiply(vector_type a, vector_type b) {
+        return _mm512_mul_ps(a, b);
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 static vector_type add(vector_type a, vector_type b) {
+        return _mm512_add_ps(a, b);
+    }
+
+    // a * b + c
+    SPARSE_LINALG_TARGET_AVX512 static vector_type fmadd(vector_type a, vector_type b, vector_type c) {
+        return _mm512_fmadd_ps(a, b, c);
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 static vector_type set_zero() {
+        return _mm512_setzero_ps();
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 static vector_type broadcast(float value) {
+        return _mm512_set1_ps(value);
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 static vector_type load_widen(const bfloat16* ptr) {
+        return mask_load_widen(static_cast<mask_type>(0xFFFF), ptr);
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 static vector_type load_widen(const float16* ptr) {
+        return mask_load_widen(static_cast<mask_type>(0xFFFF), ptr);
+    }
+
+    // Reads a full vector of narrow values and zeroes the lanes outside the mask
+    SPARSE_LINALG_TARGET_AVX512 static vector_type mask_load_widen(mask_type mask, const bfloat16* ptr) {
+        const __m256i bits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+        return _mm512_castsi512_ps(_mm512_maskz_slli_epi32(mask, _mm512_maskz_cvtepu16_epi32(mask, bits), 16));
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 static vector_type mask_load_widen(mask_type mask, const float16* ptr) {
+        return _mm512_maskz_cvtph_ps(mask, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr)));
+    }
+
+    // Mask with the low `count` lanes set, count < vector_size
+    SPARSE_LINALG_TARGET_AVX512 static mask_type first_lanes(std::size_t count) {
+        return static_cast<mask_type>((1u << count) - 1u);
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 static vector_type mask_load(mask_type mask, const float* ptr) {
+        return _mm512_maskz_loadu_ps(mask, ptr);
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 static void mask_store(float* ptr, mask_type mask, vector_type val) {
+        _mm512_mask_storeu_ps(ptr, mask, val);
+    }
+
+    template<typename Index>
+        requires is_gather_index_v<Index>
+    SPARSE_LINALG_TARGET_AVX512 static vector_type gather(const float* base, const Index* indices) {
+        return mask_gather(static_cast<mask_type>(0xFFFF), base, indices);
+    }
+
+    // Gathers base[indices[i]] for the lanes in mask; inactive lanes read
+    // neither an index nor a value and come back as zero
+    template<typename Index>
+        requires is_gather_index_v<Index>
+    SPARSE_LINALG_TARGET_AVX512 static vector_type mask_gather(mask_type mask, const float* base, const Index* indices) {
+        if constexpr (sizeof(Index) == 4 && std::is_signed_v<Index>) {
+            const __m512i idx = _mm512_maskz_loadu_epi32(mask, indices);
+            return _mm512_mask_i32gather_ps(_mm512_setzero_ps(), mask, idx, base, 4);
+        } else {
+            const auto lo_mask = static_cast<__mmask8>(mask & 0xFF);
+            const auto hi_mask = static_cast<__mmask8>(mask >> 8);
+            __m512i lo_idx;
+            __m512i hi_idx;
+            if constexpr (sizeof(Index) == 4) {
+                const __m512i idx = _mm512_maskz_loadu_epi32(mask, indices);
+                lo_idx = detail::avx512_widen_u32(detail::avx512_low_half(idx));
+                hi_idx = detail::avx512_widen_u32(detail::avx512_high_half(idx));
+            } else {
+                lo_idx = _mm512_maskz_loadu_epi64(lo_mask, indices);
+                hi_idx = _mm512_maskz_loadu_epi64(hi_mask, indices + 8);
+            }
+            const __m256 lo = _mm512_mask_i64gather_ps(_mm256_setzero_ps(), lo_mask, lo_idx, base, 4);
+            const __m256 hi = _mm512_mask_i64gather_ps(_mm256_setzero_ps(), hi_mask, hi_idx, base, 4);
+            return detail::avx512_combine(lo, hi);
+        }
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 static float reduce_sum(vector_type v) {
+        const __m512d bits = _mm512_castps_pd(v);
+        const __m256 folded = _mm256_add_ps(
+            _mm256_castpd_ps(detail::avx512_low_half(bits)),
+            _mm256_castpd_ps(detail::avx512_high_half(bits)));
+        return SimdIsaTraits<float, SimdLevel::avx2>::reduce_sum(folded);
+    }
+};
+
+template<>
+struct SimdIsaTraits<double, SimdLevel::avx512> {
+    static constexpr bool is_vectorizable = true;
+    static constexpr std::size_t vector_size = 8;
+    using vector_type = __m512d;
+    using mask_type = __mmask8;
+
+    SPARSE_LINALG_TARGET_AVX512 static vector_type load(const double* ptr) {
+        return _mm512_loadu_pd(ptr);
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 static void store(double* ptr, vector_type val) {
+        _mm512_storeu_pd(ptr, val);
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 static vector_type multiply(vector_type a, vector_type b) {
+        return _mm512_mul_pd(a, b);
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 static vector_type add(vector_type a, vector_type b) {
+        return _mm512_add_pd(a, b);
+    }
+
+    // a * b + c
+    SPARSE_LINALG_TARGET_AVX512 static vector_type fmadd(vector_type a, vector_type b, vector_type c) {
+        return _mm512_fmadd_pd(a, b, c);
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 static vector_type set_zero() {
+        return _mm512_setzero_pd();
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 static vector_type broadcast(double value) {
+        return _mm512_set1_pd(value);
+    }
+
+    template<typename S>
+        requires ReducedPrecision<S>
+    SPARSE_LINALG_TARGET_AVX512 static vector_type load_widen(const S* ptr) {
+        return mask_load_widen(static_cast<mask_type>(0xFF), ptr);
+    }
+
+    // Reads a full vector of narrow values and zeroes the lanes outside the mask
+    SPARSE_LINALG_TARGET_AVX512 static vector_type mask_load_widen(mask_type mask, const float* ptr) {
+        return _mm512_maskz_cvtps_pd(mask, _mm256_loadu_ps(ptr));
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 static vector_type mask_load_widen(mask_type mask, const bfloat16* ptr) {
+        const __m128i bits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        return _mm512_maskz_cvtps_pd(mask, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(bits), 16)));
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 static vector_type mask_load_widen(mask_type mask, const float16* ptr) {
+        return _mm512_maskz_cvtps_pd(mask, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr))));
+    }
+
+    // Mask with the low `count` lanes set, count < vector_size
+    SPARSE_LINALG_TARGET_AVX512 static mask_type first_lanes(std::size_t count) {
+        return static_cast<mask_type>((1u << count) - 1u);
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 static vector_type mask_load(mask_type mask, const double* ptr) {
+        return _mm512_maskz_loadu_pd(mask, ptr);
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 static void mask_store(double* ptr, mask_type mask, vector_type val) {
+        _mm512_mask_storeu_pd(ptr, mask, val);
+    }
+
+    template<typename Index>
+        requires is_gather_index_v<Index>
+    SPARSE_LINALG_TARGET_AVX512 static vector_type gather(const double* base, const Index* indices) {
+        return mask_gather(static_cast<mask_type>(0xFF), base, indices);
+    }
+
+    // Gathers base[indices[i]] for the lanes in mask; inactive lanes read
+    // neither an index nor a value and come back as zero
+    template<typename Index>
+        requires is_gather_index_v<Index>
+    SPARSE_LINALG_TARGET_AVX512 static vector_type mask_gather(mask_type mask, const double* base, const Index* indices) {
+        if constexpr (sizeof(Index) == 4) {
+            const __m256i idx = detail::avx512_low_half(_mm512_maskz_loadu_epi32(mask, indices));
+            if constexpr (std::is_signed_v<Index>) {
+                return _mm512_mask_i32gather_pd(_mm512_setzero_pd(), mask, idx, base, 8);
+            } else {
+                return _mm512_mask_i64gather_pd(_mm512_setzero_pd(), mask, detail::avx512_widen_u32(idx), base, 8);
+            }
+        } else {
+            const __m512i idx = _mm512_maskz_loadu_epi64(mask, indices);
+            return _mm512_mask_i64gather_pd(_mm512_setzero_pd(), mask, idx, base, 8);
+        }
+    }
+
+    SPARSE_LINALG_TARGET_AVX512 static double reduce_sum(vector_type v) {
+        const __m256d folded = _mm256_add_pd(detail::avx512_low_half(v), detail::avx512_high_half(v));
+        return SimdIsaTraits<double, SimdLevel::avx2>::reduce_sum(folded);
+    }
+};
+
+#pragma GCC diagnostic pop
 #endif
 
-} // namespace sparse_linalg::execution
\ No newline at end of file
+// Best instruction set enabled by the compiler flags of this translation unit.
+// Kernels that must run on any host dispatch on cpu_features.hpp instead.
+#if SPARSE_LINALG_HAS_X86_SIMD && defined(__AVX2__) && defined(__FMA__)
+inline constexpr SimdLevel compiled_simd_level = SimdLevel::avx2;
+#else
+inline constexpr SimdLevel compiled_simd_level = SimdLevel::scalar;
+#endif
+
+template<typename T>
+struct SimdTraits : SimdIsaTraits<T, compiled_simd_level> {};
+
+} // namespace sparse_linalg::execution
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sparse_linalg::execution {
+
+// Move-only type-erased void() callable. Callables up to inline_capacity
+// bytes that are nothrow-movable live inside the task, so submitting small
+// lambdas does not allocate; larger ones fall back to the heap.
+class Task {
+public:
+    static constexpr std::size_t inline_capacity = 64;
+
+    Task() noexcept = default;
+
+    template<typename F>
+        requires (!std::same_as<std::remove_cvref_t<F>, Task>) && std::invocable<std::remove_cvref_t<F>&>
+    Task(F&& fn) {
+        using Fn = std::remove_cvref_t<F>;
+        if constexpr (fits_inline<Fn>) {
+            ::new (static_cast<void*>(storage_)) Fn(std::forward<F>(fn));
+            ops_ = &inline_ops<Fn>;
+        } else {
+            auto* heap = new Fn(std::forward<F>(fn));
+            ::new (static_cast<void*>(storage_)) Fn*(heap);
+            ops_ = &heap_ops<Fn>;
+        }
+    }
+
+    Task(Task&& other) noexcept : ops_(other.ops_) {
+        if (ops_) {
+            ops_->relocate(storage_, other.storage_);
+            other.ops_ = nullptr;
+        }
+    }
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.ops_) {
+                other.ops_->relocate(storage_, other.storage_);
+                ops_ = std::exchange(other.ops_, nullptr);
+            }
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() { reset(); }
+
+    explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+    void operator()() { ops_->invoke(storage_); }
+
+    void reset() noexcept {
+        if (ops_) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+    // Whether a callable of type F is stored without allocating
+    template<typename F>
+    static constexpr bool fits_inline =
+        sizeof(F) <= inline_capacity &&
+        alignof(F) <= alignof(std::max_align_t) &&
+        std::is_nothrow_move_constructible_v<F>;
+
+private:
+    struct Ops {
+        void (*invoke)(void*);
+        // Move-constructs into dst and destroys src
+        void (*relocate)(void* dst, void* src) noexcept;
+        void (*destroy)(void*) noexcept;
+    };
+
+    template<typename Fn>
+    static constexpr Ops inline_ops{
+        [](void* self) { std::invoke(*std::launder(static_cast<Fn*>(self))); },
+        [](void* dst, void* src) noexcept {
+            auto* from = std::launder(static_cast<Fn*>(src));
+            ::new (dst) Fn(std::move(*from));
+            from->~Fn();
+        },
+        [](void* self) noexcept { std::launder(static_cast<Fn*>(self))->~Fn(); }
+    };
+
+    template<typename Fn>
+    static constexpr Ops heap_ops{
+        [](void* self) { std::invoke(**std::launder(static_cast<Fn**>(self))); },
+        [](void* dst, void* src) noexcept {
+            ::new (dst) Fn*(*std::launder(static_cast<Fn**>(src)));
+        },
+        [](void* self) noexcept { delete *std::launder(static_cast<Fn**>(self)); }
+    };
+
+    alignas(std::max_align_t) std::byte storage_[inline_capacity];
+    const Ops* ops_ = nullptr;
+};
+
+} // namespace sparse_linalg::execution
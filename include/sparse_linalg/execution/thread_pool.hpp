@@ -1,163 +1,652 @@
 #pragma once
 
-#include <thread>
-#include <queue>
+#include "instrumentation.hpp"
+#include "task.hpp"
+#include "topology.hpp"
+#include "work_stealing_deque.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
 #include <functional>
-#include <mutex>
-#include <condition_variable>
 #include <future>
-#include <vector>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
 #include <stop_token>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace sparse_linalg::execution {
 
-class ThreadPool {
-private:
-    class Worker {
-    public:
-        Worker(ThreadPool& pool) : pool_(pool) {}
-        
-        void operator()(std::stop_token stoken) {
-            while (true) {
-                std::function<void()> task;
-                {
-                    std::unique_lock lock(pool_.mutex_);
-                    pool_.cv_.wait(lock, [this, &stoken] {
-                        return stoken.stop_requested() || !pool_.tasks_.empty();
-                    });
-                    
-                    // Check if we should exit
-                    if (stoken.stop_requested() && pool_.tasks_.empty()) {
-                        return;
-                    }
-                    
-                    if (!pool_.tasks_.empty()) {
-                        task = std::move(pool_.tasks_.front());
-                        pool_.tasks_.pop();
-                        ++pool_.active_tasks_;
-                    }
-                }
-                
-                if (task) {
-                    try {
-                        task();
-                    } catch (...) {
-                        std::lock_guard<std::mutex> lock(pool_.exception_mutex_);
-                        pool_.exceptions_.push_back(std::current_exception());
-                    }
-                    
-                    {
-                        std::lock_guard<std::mutex> lock(pool_.mutex_);
-                        --pool_.active_tasks_;
-                        if (pool_.active_tasks_ == 0 && pool_.tasks_.empty()) {
-                            pool_.completed_cv_.notify_all();
-                        }
-                    }
-                }
-            }
-        }
-        
-    private:
-        ThreadPool& pool_;
-    };
+// What a worker does once it runs out of work
+enum class IdlePolicy {
+    park,            // yield for a few rounds, then sleep until woken
+    spin_then_park   // busy-wait for spin_duration first, so back-to-back
+                     // parallel_for calls find the workers awake
+};
+
+// Where workers may run. Workers are spread over the nodes in contiguous
+// blocks (workers 0 .. k-1 on the first node, and so on), so consecutive
+// partitions of a parallel_for_static land on the same node.
+enum class ThreadAffinity {
+    none,   // left to the OS scheduler
+    cores,  // each worker pinned to one CPU of its node
+    nodes   // each worker allowed on every CPU of its node
+};
 
+namespace detail {
+    inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#else
+        std::this_thread::yield();
+#endif
+    }
+}
+
+inline namespace SPARSE_LINALG_INSTRUMENTATION_ABI {
+
+// Work-stealing pool. Each worker owns a Chase-Lev deque: tasks submitted
+// from a worker go to its own deque, tasks submitted from outside go to a
+// shared injection queue that idle workers drain in batches, and a worker
+// that runs dry steals the oldest task of another worker. Idle workers
+// spin briefly, then sleep until new work is published.
+//
+// parallel_for bypasses the queues: the job is published once to all
+// workers, which claim chunks from a shared counter alongside the caller.
+class ThreadPool {
 public:
-    explicit ThreadPool(std::size_t num_threads = std::thread::hardware_concurrency()) {
+    // Per-worker deque size; when it is full, tasks overflow into the shared queue
+    static constexpr std::size_t local_capacity = 1024;
+    // How long idle workers busy-wait under IdlePolicy::spin_then_park
+    static constexpr std::chrono::microseconds spin_duration{200};
+
+    explicit ThreadPool(std::size_t num_threads = std::thread::hardware_concurrency(),
+                        IdlePolicy idle_policy = IdlePolicy::park)
+        : idle_policy_(idle_policy) {
         if (num_threads == 0) {
             throw std::invalid_argument("Thread pool must have at least one thread");
         }
-        
-        active_tasks_ = 0;
-        
+
+        slots_ = std::make_unique<WorkerSlot[]>(num_threads);
+        queues_.reserve(num_threads);
+        for (std::size_t i = 0; i < num_threads; ++i) {
+            queues_.push_back(std::make_unique<WorkStealingDeque<Task>>(local_capacity));
+        }
+
         try {
+            workers_.reserve(num_threads);
             for (std::size_t i = 0; i < num_threads; ++i) {
-                workers_.emplace_back(Worker(*this));
+                workers_.emplace_back([this, i](std::stop_token stoken) { run_worker(i, stoken); });
             }
         } catch (...) {
             shutdown();
             throw;
         }
     }
-    
+
+    // Pins the workers with pthread_setaffinity_np according to `affinity`
+    // over `topology`; throws std::system_error if the OS refuses
+    ThreadPool(std::size_t num_threads, ThreadAffinity affinity,
+               const CpuTopology& topology = CpuTopology::detect(),
+               IdlePolicy idle_policy = IdlePolicy::park)
+        : ThreadPool(num_threads, idle_policy) {
+        place_workers(affinity, topology);
+    }
+
     ~ThreadPool() {
         shutdown();
     }
-    
+
     ThreadPool(const ThreadPool&) = delete;
     ThreadPool& operator=(const ThreadPool&) = delete;
-    
+
     template<typename F, typename... Args>
     auto submit(F&& f, Args&&... args) {
         using return_type = std::invoke_result_t<F, Args...>;
-        auto task = std::make_shared<std::packaged_task<return_type()>>(
-            std::bind(std::forward<F>(f), std::forward<Args>(args)...)
-        );
-        
-        auto future = task->get_future();
-        
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            if (workers_.empty()) {
-                throw std::runtime_error("ThreadPool is shutting down");
-            }
-            
-            tasks_.emplace([task]() { (*task)(); });
-        }
-        
-        cv_.notify_one();
+        if (stopping_.load(std::memory_order_acquire)) {
+            throw std::runtime_error("ThreadPool is shutting down");
+        }
+
+        std::promise<return_type> promise;
+        auto future = promise.get_future();
+        auto body = [promise = std::move(promise), fn = std::forward<F>(f),
+                     ... bound = std::forward<Args>(args)]() mutable {
+            try {
+                if constexpr (std::is_void_v<return_type>) {
+                    std::invoke(fn, bound...);
+                    promise.set_value();
+                } else {
+                    promise.set_value(std::invoke(fn, bound...));
+                }
+            } catch (...) {
+                promise.set_exception(std::current_exception());
+            }
+        };
+        if constexpr (instrumentation_enabled) {
+            enqueue(Task([stamp = detail::TaskStamp{}, body = std::move(body)]() mutable {
+                stamp.started();
+                body();
+                stamp.finished();
+            }));
+        } else {
+            enqueue(Task(std::move(body)));
+        }
         return future;
     }
-    
+
     void wait_all() {
-        std::unique_lock lock(mutex_);
-        completed_cv_.wait(lock, [this] { 
-            return active_tasks_ == 0 && tasks_.empty();
-        });
-        
+        wait_idle();
+
         // Check for exceptions
         std::lock_guard<std::mutex> ex_lock(exception_mutex_);
         if (!exceptions_.empty()) {
             std::rethrow_exception(exceptions_.front());
         }
     }
-    
-    [[nodiscard]] std::size_t thread_count() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return workers_.size();
+
+    // Calls fn(begin, end) over chunks of at most grain indices covering
+    // [0, n), on the workers and the calling thread, and returns when all
+    // chunks are done. grain == 0 picks a few chunks per thread. If fn
+    // throws, unclaimed chunks are skipped and the first exception is
+    // rethrown once running chunks finish. Called from a worker of this
+    // pool, the chunks run inline.
+    template<typename F>
+    void parallel_for(std::size_t n, std::size_t grain, F&& fn) {
+        if (n == 0) {
+            return;
+        }
+        if (grain == 0) {
+            grain = std::max<std::size_t>(1, n / (4 * (thread_count() + 1)));
+        }
+        if (n <= grain || current_pool_ == this) {
+            for (std::size_t begin = 0; begin < n; begin += grain) {
+                fn(begin, std::min(begin + grain, n));
+            }
+            return;
+        }
+
+        using Fn = std::remove_reference_t<F>;
+        BroadcastJob job;
+        job.invoke = [](void* context, std::size_t begin, std::size_t end) {
+            (*static_cast<Fn*>(context))(begin, end);
+        };
+        job.context = const_cast<void*>(static_cast<const void*>(std::addressof(fn)));
+        job.n = n;
+        job.grain = grain;
+        run_broadcast(job);
     }
 
+    // Calls fn(begin, end) once per worker, worker w taking the w-th of
+    // thread_count() contiguous blocks of [0, n), and returns when all are
+    // done. Unlike parallel_for the same indices go to the same worker on
+    // every call, so data a worker touched first stays in its node's memory.
+    // The block of a worker busy with a submitted task is run by the caller
+    // instead, off that worker's node, so the call never waits on a task.
+    // Called from a worker of this pool, the whole range runs inline.
+    template<typename F>
+    void parallel_for_static(std::size_t n, F&& fn) {
+        if (n == 0) {
+            return;
+        }
+        if (current_pool_ == this) {
+            fn(std::size_t{0}, n);
+            return;
+        }
+
+        using Fn = std::remove_reference_t<F>;
+        BroadcastJob job;
+        job.invoke = [](void* context, std::size_t begin, std::size_t end) {
+            (*static_cast<Fn*>(context))(begin, end);
+        };
+        job.context = const_cast<void*>(static_cast<const void*>(std::addressof(fn)));
+        job.n = n;
+        job.workers = thread_count();
+        run_broadcast(job);
+    }
+
+    [[nodiscard]] std::size_t thread_count() const noexcept {
+        return queues_.size();
+    }
+
+    [[nodiscard]] ThreadAffinity affinity() const noexcept { return affinity_; }
+
+    // Node and CPUs of worker i; node 0 and no CPUs without affinity
+    [[nodiscard]] std::size_t worker_node(std::size_t i) const {
+        return affinity_ == ThreadAffinity::none ? 0 : worker_nodes_.at(i);
+    }
+
+    [[nodiscard]] std::span<const unsigned> worker_cpus(std::size_t i) const {
+        if (affinity_ == ThreadAffinity::none) {
+            return {};
+        }
+        return worker_cpus_.at(i);
+    }
+
+    // Index of the worker running the calling thread, if it is one of ours
+    [[nodiscard]] std::optional<std::size_t> worker_index() const noexcept {
+        if (current_pool_ != this) {
+            return std::nullopt;
+        }
+        return current_index_;
+    }
+
+    [[nodiscard]] IdlePolicy idle_policy() const noexcept { return idle_policy_; }
+
 private:
-    friend class Worker;
-    
+    // Identifies the worker running on the current thread, if any
+    static inline thread_local const ThreadPool* current_pool_ = nullptr;
+    static inline thread_local std::size_t current_index_ = 0;
+
+    // Injected tasks a worker moves to its own deque at once, beyond the one it runs
+    static constexpr std::size_t injection_batch = 32;
+    // Failed rounds over every queue before an idle worker goes to sleep
+    static constexpr int spin_rounds = 64;
+
+    // Per-worker state the caller of a static job reads
+    struct alignas(64) WorkerSlot {
+        std::atomic<bool> in_task{false};         // running a submitted task
+        std::atomic<std::uint64_t> claimed{0};   // seq of the last static job whose block was taken
+    };
+
+    // A parallel_for or parallel_for_static call, living on the caller's stack
+    struct BroadcastJob {
+        void (*invoke)(void*, std::size_t, std::size_t) = nullptr;
+        void* context = nullptr;
+        std::size_t n = 0;
+        std::size_t grain = 1;
+        std::size_t workers = 0;  // static schedule over this many workers; 0 = shared counter
+        std::uint64_t seq = 0;    // broadcast_seq_ value this job is published under
+        alignas(64) std::atomic<std::size_t> next{0};
+        std::atomic<std::size_t> done{0};  // static blocks finished, by their worker or the caller
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+    };
+
+    // Publishes the job, helps with it or waits for every static block,
+    // then closes it and rethrows the first exception
+    void run_broadcast(BroadcastJob& job) {
+        std::lock_guard<std::mutex> lock(broadcast_mutex_);
+        job.seq = broadcast_seq_.load(std::memory_order_relaxed) + 1;
+        job_.store(&job, std::memory_order_seq_cst);
+        broadcast_seq_.store(job.seq, std::memory_order_seq_cst);
+        wake_all();
+
+        if (job.workers == 0) {
+            run_chunks(job);
+        } else {
+            // A worker raises in_task before it looks for a job and starts a
+            // task, so one seen idle here joins before its next task, and the
+            // blocks of the busy ones are taken now. After this pass every
+            // block is running or will be, and the wait below ends.
+            for (std::size_t index = 0; index < job.workers; ++index) {
+                if (slots_[index].in_task.load(std::memory_order_seq_cst)) {
+                    run_block(job, index);
+                }
+            }
+            for (int spin = 0;; ++spin) {
+                const auto done = job.done.load(std::memory_order_acquire);
+                if (done == job.workers) {
+                    break;
+                }
+                if (spin < 1024) {
+                    detail::cpu_relax();
+                } else {
+                    job.done.wait(done, std::memory_order_acquire);
+                }
+            }
+        }
+
+        // Close the job, then wait for the workers that joined it
+        job_.store(nullptr, std::memory_order_seq_cst);
+        for (int spin = 0;; ++spin) {
+            const auto joined = joined_.load(std::memory_order_acquire);
+            if (joined == 0) {
+                break;
+            }
+            if (spin < 1024) {
+                detail::cpu_relax();
+            } else {
+                joined_.wait(joined, std::memory_order_acquire);
+            }
+        }
+
+        if (job.error) {
+            std::rethrow_exception(job.error);
+        }
+    }
+
+    static void record_error(BroadcastJob& job) {
+        if (!job.failed.exchange(true, std::memory_order_acq_rel)) {
+            job.error = std::current_exception();
+        }
+    }
+
+    static void run_chunks(BroadcastJob& job) {
+        while (!job.failed.load(std::memory_order_relaxed)) {
+            const std::size_t begin = job.next.fetch_add(job.grain, std::memory_order_relaxed);
+            if (begin >= job.n) {
+                return;
+            }
+            try {
+                job.invoke(job.context, begin, std::min(begin + job.grain, job.n));
+            } catch (...) {
+                record_error(job);
+            }
+        }
+    }
+
+    // Worker `index`'s block of a static job, run by whichever of the worker
+    // and the caller claims it first; skipped once another block has thrown
+    void run_block(BroadcastJob& job, std::size_t index) {
+        if (slots_[index].claimed.exchange(job.seq, std::memory_order_acq_rel) == job.seq) {
+            return;
+        }
+        const std::size_t chunk = job.n / job.workers;
+        const std::size_t remainder = job.n % job.workers;
+        const std::size_t begin = index * chunk + std::min(index, remainder);
+        const std::size_t end = (index + 1) * chunk + std::min(index + 1, remainder);
+        if (begin < end && !job.failed.load(std::memory_order_relaxed)) {
+            try {
+                job.invoke(job.context, begin, end);
+            } catch (...) {
+                record_error(job);
+            }
+        }
+        if (job.done.fetch_add(1, std::memory_order_acq_rel) + 1 == job.workers) {
+            job.done.notify_one();
+        }
+    }
+
+    // Joins the current parallel_for if this worker has not seen it yet.
+    // The caller closes the job before waiting for joined_ to drain, so a
+    // worker that registers late either finds job_ empty or finds a newer
+    // job. A newer job is left alone here: its sequence number does not
+    // match the one loaded, so the next poll joins it under its own number
+    // and a static block never runs twice.
+    bool join_broadcast(std::size_t index, std::uint64_t& seen) {
+        const auto seq = broadcast_seq_.load(std::memory_order_seq_cst);
+        if (seq == seen) {
+            return false;
+        }
+        joined_.fetch_add(1, std::memory_order_seq_cst);
+        BroadcastJob* job = job_.load(std::memory_order_seq_cst);
+        if (job && job->seq != seq) {
+            job = nullptr;
+        } else {
+            seen = seq;
+            if (job && job->workers == 0) {
+                run_chunks(*job);
+            } else if (job) {
+                run_block(*job, index);
+            }
+        }
+        if (joined_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            joined_.notify_one();
+        }
+        return job != nullptr;
+    }
+
+    void enqueue(Task task) {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        detail::task_submitted();
+        if (current_pool_ != this || !queues_[current_index_]->push(task)) {
+            std::lock_guard<std::mutex> lock(injection_mutex_);
+            injected_.push_back(std::move(task));
+            injected_size_.store(injected_.size(), std::memory_order_relaxed);
+        }
+        wake_one();
+    }
+
+    // Publishes new work and wakes a sleeping worker if there is one. The
+    // seq_cst pair with park() means either the sleeper sees the new epoch
+    // or this thread sees the sleeper.
+    void wake_one() {
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        if (sleeping_.load(std::memory_order_seq_cst) > 0) {
+            epoch_.notify_one();
+        }
+    }
+
+    void wake_all() {
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        if (sleeping_.load(std::memory_order_seq_cst) > 0) {
+            epoch_.notify_all();
+        }
+    }
+
+    void run_worker(std::size_t index, std::stop_token stoken) {
+        current_pool_ = this;
+        current_index_ = index;
+        std::uint64_t rng = 0x9E3779B97F4A7C15ull * (index + 1);
+        std::uint64_t seen_broadcast = 0;
+
+        while (true) {
+            const auto epoch = epoch_.load(std::memory_order_seq_cst);
+            if (poll(index, rng, seen_broadcast)) {
+                continue;
+            }
+            if (stoken.stop_requested()) {
+                return;
+            }
+            park(epoch);
+        }
+    }
+
+    // Looks for work until it runs something (true) or the idle budget of
+    // the pool's IdlePolicy is spent (false)
+    bool poll(std::size_t index, std::uint64_t& rng, std::uint64_t& seen_broadcast) {
+        std::chrono::steady_clock::time_point deadline;
+        for (int round = 0;; ++round) {
+            if (join_broadcast(index, seen_broadcast)) {
+                return true;
+            }
+            if (Task task = find_task(index, rng)) {
+                run(task, index, seen_broadcast);
+                return true;
+            }
+
+            if (idle_policy_ == IdlePolicy::park) {
+                if (round == spin_rounds) {
+                    return false;
+                }
+                std::this_thread::yield();
+            } else {
+                if (round == 0) {
+                    deadline = std::chrono::steady_clock::now() + spin_duration;
+                } else if (round % 64 == 0 && std::chrono::steady_clock::now() >= deadline) {
+                    return false;
+                }
+                detail::cpu_relax();
+            }
+        }
+    }
+
+    Task find_task(std::size_t index, std::uint64_t& rng) {
+        if (auto task = queues_[index]->pop()) {
+            return std::move(*task);
+        }
+        if (Task task = take_injected(index)) {
+            return task;
+        }
+
+        // Visit the other workers from a random starting point
+        const std::size_t count = queues_.size();
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        const auto start = static_cast<std::size_t>(rng % count);
+        for (std::size_t k = 0; k < count; ++k) {
+            const std::size_t victim = (start + k) % count;
+            if (victim == index) {
+                continue;
+            }
+            if (auto task = queues_[victim]->steal()) {
+                return std::move(*task);
+            }
+        }
+        return Task{};
+    }
+
+    // Takes one injected task to run and moves a share of the rest to the
+    // worker's deque, where other workers can steal them without the lock
+    Task take_injected(std::size_t index) {
+        // Spinning workers poll this instead of the mutex
+        if (injected_size_.load(std::memory_order_relaxed) == 0) {
+            return Task{};
+        }
+        std::lock_guard<std::mutex> lock(injection_mutex_);
+        if (injected_.empty()) {
+            return Task{};
+        }
+        Task task = std::move(injected_.front());
+        injected_.pop_front();
+
+        const std::size_t share = std::min(injection_batch, injected_.size() / queues_.size());
+        auto& local = *queues_[index];
+        for (std::size_t k = 0; k < share && local.push(injected_.front()); ++k) {
+            injected_.pop_front();
+        }
+        injected_size_.store(injected_.size(), std::memory_order_relaxed);
+        return task;
+    }
+
+    // Runs a submitted task. A static job published just before is joined
+    // first; one published later finds in_task raised and the caller runs
+    // this worker's block.
+    void run(Task& task, std::size_t index, std::uint64_t& seen_broadcast) {
+        auto& slot = slots_[index];
+        slot.in_task.store(true, std::memory_order_seq_cst);
+        join_broadcast(index, seen_broadcast);
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(exception_mutex_);
+            exceptions_.push_back(std::current_exception());
+        }
+        task.reset();
+        slot.in_task.store(false, std::memory_order_release);
+
+        detail::task_finished();
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            pending_.notify_all();
+        }
+    }
+
+    void park(std::uint64_t epoch) {
+        sleeping_.fetch_add(1, std::memory_order_seq_cst);
+        if (epoch_.load(std::memory_order_seq_cst) == epoch) {
+            epoch_.wait(epoch, std::memory_order_seq_cst);
+        }
+        sleeping_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Blocks until every submitted task has finished
+    void wait_idle() {
+        auto pending = pending_.load(std::memory_order_acquire);
+        while (pending != 0) {
+            pending_.wait(pending, std::memory_order_acquire);
+            pending = pending_.load(std::memory_order_acquire);
+        }
+    }
+
     void shutdown() {
-        {
-            std::unique_lock lock(mutex_);
-            
-            // Wait for all tasks to complete
-            completed_cv_.wait(lock, [this] {
-                return active_tasks_ == 0 && tasks_.empty();
-            });
-        }
-        
+        // Wait for all tasks to complete; running tasks may still submit
+        wait_idle();
+        stopping_.store(true, std::memory_order_release);
+
         // Now stop the workers
         for (auto& worker : workers_) {
             worker.request_stop();
         }
-        
-        cv_.notify_all();
-        
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        epoch_.notify_all();
+
         workers_.clear();
     }
-    
-    mutable std::mutex mutex_;
-    std::condition_variable cv_;
-    std::condition_variable completed_cv_;
-    std::queue<std::function<void()>> tasks_;
+
+    // Pins worker i to the CPUs chosen for it; see ThreadAffinity
+    void place_workers(ThreadAffinity affinity, const CpuTopology& topology) {
+        if (affinity == ThreadAffinity::none) {
+            return;
+        }
+        const std::size_t threads = thread_count();
+        const auto& nodes = topology.nodes();
+        std::vector<std::size_t> placed(nodes.size(), 0);
+        for (std::size_t i = 0; i < threads; ++i) {
+            const std::size_t node = i * nodes.size() / threads;
+            const auto& cpus = nodes[node].cpus;
+            worker_nodes_.push_back(node);
+            if (affinity == ThreadAffinity::cores) {
+                worker_cpus_.push_back({cpus[placed[node]++ % cpus.size()]});
+            } else {
+                worker_cpus_.push_back(cpus);
+            }
+        }
+
+#ifdef __linux__
+        for (std::size_t i = 0; i < threads; ++i) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (unsigned cpu : worker_cpus_[i]) {
+                if (cpu >= CPU_SETSIZE) {
+                    throw std::invalid_argument("CPU number exceeds CPU_SETSIZE");
+                }
+                CPU_SET(cpu, &set);
+            }
+            const int error = ::pthread_setaffinity_np(workers_[i].native_handle(), sizeof(set), &set);
+            if (error != 0) {
+                throw std::system_error(error, std::generic_category(),
+                                        "Cannot pin worker " + std::to_string(i));
+            }
+        }
+        affinity_ = affinity;
+#else
+        throw std::runtime_error("Thread affinity is not supported on this platform");
+#endif
+    }
+
+    IdlePolicy idle_policy_;
+    ThreadAffinity affinity_ = ThreadAffinity::none;
+    std::vector<std::size_t> worker_nodes_;
+    std::vector<std::vector<unsigned>> worker_cpus_;
+    std::unique_ptr<WorkerSlot[]> slots_;
+    std::vector<std::unique_ptr<WorkStealingDeque<Task>>> queues_;
     std::vector<std::jthread> workers_;
-    std::size_t active_tasks_;
-    
+
+    std::mutex injection_mutex_;
+    std::deque<Task> injected_;
+    std::atomic<std::size_t> injected_size_{0};
+
+    alignas(64) std::atomic<std::size_t> pending_{0};
+    alignas(64) std::atomic<std::uint64_t> epoch_{0};
+    std::atomic<std::size_t> sleeping_{0};
+    std::atomic<bool> stopping_{false};
+
+    std::mutex broadcast_mutex_;
+    std::atomic<BroadcastJob*> job_{nullptr};
+    std::atomic<std::uint64_t> broadcast_seq_{0};
+    alignas(64) std::atomic<std::size_t> joined_{0};
+
     std::mutex exception_mutex_;
     std::vector<std::exception_ptr> exceptions_;
 };
 
-} // namespace sparse_linalg::execution
\ No newline at end of file
+} // inline namespace SPARSE_LINALG_INSTRUMENTATION_ABI
+
+} // namespace sparse_linalg::execution
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace sparse_linalg::execution {
+
+// A memory node and the logical CPUs attached to it
+struct NumaNode {
+    std::size_t id = 0;
+    std::vector<unsigned> cpus;
+};
+
+// Which CPUs belong to which NUMA node, restricted to the CPUs this process
+// may run on. detect() reads sysfs; emulated() lays out a made-up topology
+// over the CPUs that exist, so multi-node placement can be exercised on a
+// single-node machine (emulated nodes share physical CPUs when there are
+// fewer CPUs than emulated slots).
+class CpuTopology {
+public:
+    explicit CpuTopology(std::vector<NumaNode> nodes) : nodes_(std::move(nodes)) {
+        if (nodes_.empty()) {
+            throw std::invalid_argument("Topology must have at least one node");
+        }
+        for (const auto& node : nodes_) {
+            if (node.cpus.empty()) {
+                throw std::invalid_argument("Topology nodes must have at least one CPU");
+            }
+        }
+    }
+
+    [[nodiscard]] static CpuTopology detect();
+    [[nodiscard]] static CpuTopology emulated(std::size_t nodes, std::size_t cpus_per_node);
+
+    [[nodiscard]] const std::vector<NumaNode>& nodes() const noexcept { return nodes_; }
+    [[nodiscard]] std::size_t node_count() const noexcept { return nodes_.size(); }
+
+    [[nodiscard]] std::size_t cpu_count() const noexcept {
+        std::size_t count = 0;
+        for (const auto& node : nodes_) {
+            count += node.cpus.size();
+        }
+        return count;
+    }
+
+private:
+    std::vector<NumaNode> nodes_;
+};
+
+namespace detail {
+    // Parses the kernel's cpulist format, e.g. "0-3,8,10-11"
+    inline std::vector<unsigned> parse_cpu_list(std::string_view text) {
+        std::vector<unsigned> cpus;
+        auto parse_number = [&](std::string_view digits) {
+            if (digits.empty() || digits.size() > 9 ||
+                !std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+                throw std::invalid_argument("Malformed CPU list");
+            }
+            unsigned value = 0;
+            for (char c : digits) {
+                value = value * 10 + static_cast<unsigned>(c - '0');
+            }
+            return value;
+        };
+
+        while (!text.empty() && (text.back() == '\n' || text.back() == ' ')) {
+            text.remove_suffix(1);
+        }
+        while (!text.empty()) {
+            const auto comma = text.find(',');
+            const auto item = text.substr(0, comma);
+            text = comma == std::string_view::npos ? std::string_view{} : text.substr(comma + 1);
+
+            const auto dash = item.find('-');
+            const unsigned first = parse_number(item.substr(0, dash));
+            const unsigned last = dash == std::string_view::npos ? first : parse_number(item.substr(dash + 1));
+            if (last < first) {
+                throw std::invalid_argument("Malformed CPU list");
+            }
+            for (unsigned cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        }
+        std::sort(cpus.begin(), cpus.end());
+        cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+        return cpus;
+    }
+
+    // CPUs the calling thread may run on
+    inline std::vector<unsigned> allowed_cpus() {
+        std::vector<unsigned> cpus;
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (::sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &set)) {
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+#endif
+        if (cpus.empty()) {
+            cpus.push_back(0);
+        }
+        return cpus;
+    }
+
+    // Nodes listed under sysfs_root (normally /sys/devices/system/node),
+    // keeping only the allowed CPUs and dropping nodes left without any
+    inline std::vector<NumaNode> read_numa_nodes(const std::filesystem::path& sysfs_root,
+                                                 const std::vector<unsigned>& allowed) {
+        std::vector<NumaNode> nodes;
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(sysfs_root, error)) {
+            const auto name = entry.path().filename().string();
+            if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+                !std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+                continue;
+            }
+            std::ifstream file(entry.path() / "cpulist");
+            std::string line;
+            if (!file || !std::getline(file, line)) {
+                continue;
+            }
+            NumaNode node;
+            node.id = std::stoul(name.substr(4));
+            for (unsigned cpu : parse_cpu_list(line)) {
+                if (std::binary_search(allowed.begin(), allowed.end(), cpu)) {
+                    node.cpus.push_back(cpu);
+                }
+            }
+            if (!node.cpus.empty()) {
+                nodes.push_back(std::move(node));
+            }
+        }
+        std::sort(nodes.begin(), nodes.end(), [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+        return nodes;
+    }
+}
+
+// Falls back to one node holding every allowed CPU when sysfs has no node
+// information (non-NUMA kernels, some containers)
+inline CpuTopology CpuTopology::detect() {
+    const auto allowed = detail::allowed_cpus();
+    auto nodes = detail::read_numa_nodes("/sys/devices/system/node", allowed);
+    if (nodes.empty()) {
+        nodes.push_back({0, allowed});
+    }
+    return CpuTopology(std::move(nodes));
+}
+
+// Node n gets slots n * cpus_per_node ... (n + 1) * cpus_per_node - 1,
+// taken in order from the allowed CPUs and wrapping around when they run out
+inline CpuTopology CpuTopology::emulated(std::size_t nodes, std::size_t cpus_per_node) {
+    if (nodes == 0 || cpus_per_node == 0) {
+        throw std::invalid_argument("Emulated topology needs at least one node and one CPU per node");
+    }
+    const auto allowed = detail::allowed_cpus();
+    std::vector<NumaNode> result(nodes);
+    for (std::size_t n = 0; n < nodes; ++n) {
+        result[n].id = n;
+        for (std::size_t k = 0; k < cpus_per_node; ++k) {
+            result[n].cpus.push_back(allowed[(n * cpus_per_node + k) % allowed.size()]);
+        }
+    }
+    return CpuTopology(std::move(result));
+}
+
+} // namespace sparse_linalg::execution
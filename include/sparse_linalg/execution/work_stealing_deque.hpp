@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace sparse_linalg::execution {
+
+// Bounded Chase-Lev deque. The owning thread pushes and pops at the bottom
+// (LIFO, cache-warm); any other thread steals from the top (FIFO).
+//
+// Elements are moved in and out of their slots rather than copied as raw
+// words, so a thief only touches a slot after its CAS on top has claimed
+// it, and marks the slot free once the element has been moved out. The
+// owner never reuses a slot that is still being emptied; push() returns
+// false instead, as it does when the deque is full, and the caller falls
+// back to a shared queue.
+template<typename T>
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(std::size_t capacity)
+        : capacity_(std::bit_ceil(capacity)),
+          mask_(capacity_ - 1),
+          slots_(std::make_unique<Slot[]>(capacity_)) {
+        if (capacity == 0) {
+            throw std::invalid_argument("Deque capacity must be positive");
+        }
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+
+    // Owner only. Leaves value untouched and returns false when it cannot be stored.
+    bool push(T& value) {
+        const auto b = bottom_.load(std::memory_order_relaxed);
+        const auto t = top_.load(std::memory_order_acquire);
+        if (b - t >= static_cast<std::int64_t>(capacity_)) {
+            return false;
+        }
+        Slot& slot = slots_[index(b)];
+        if (slot.full.load(std::memory_order_acquire)) {
+            return false;
+        }
+        slot.value = std::move(value);
+        slot.full.store(true, std::memory_order_relaxed);
+        bottom_.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Owner only. Takes the most recently pushed element.
+    std::optional<T> pop() {
+        const auto b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        if (t == b) {
+            // Last element: race the thieves for it
+            const bool won = top_.compare_exchange_strong(
+                t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            if (!won) {
+                return std::nullopt;
+            }
+        }
+        return take(slots_[index(b)]);
+    }
+
+    // Any thread. Takes the oldest element, or nothing if the deque is empty
+    // or another thread got there first.
+    std::optional<T> steal() {
+        auto t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const auto b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) {
+            return std::nullopt;
+        }
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return std::nullopt;
+        }
+        return take(slots_[index(t)]);
+    }
+
+    // Racy estimate of the number of elements
+    [[nodiscard]] std::size_t size_hint() const noexcept {
+        const auto b = bottom_.load(std::memory_order_relaxed);
+        const auto t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<std::size_t>(b - t) : 0;
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<bool> full{false};
+        T value{};
+    };
+
+    std::size_t index(std::int64_t position) const noexcept {
+        return static_cast<std::size_t>(position) & mask_;
+    }
+
+    static T take(Slot& slot) {
+        T value = std::move(slot.value);
+        slot.full.store(false, std::memory_order_release);
+        return value;
+    }
+
+    std::size_t capacity_;
+    std::size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<std::int64_t> top_{0};
+    alignas(64) std::atomic<std::int64_t> bottom_{0};
+};
+
+} // namespace sparse_linalg::execution
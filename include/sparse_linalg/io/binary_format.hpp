@@ -0,0 +1,202 @@
+#pragma once
+
+#include "../core/sparse_matrix.hpp"
+#include "../core/sparse_matrix_view.hpp"
+#include "mapped_file.hpp"
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <stdexcept>
+#include <type_traits>
+
+namespace sparse_linalg::io {
+
+// On-disk CSR layout, version 1:
+//
+//   [0, 128)        BinaryHeader
+//   row_ptrs        (rows + 1) x RowPtr
+//   col_indices     nnz x ColIndex
+//   values          nnz x T
+//
+// Every array starts at a multiple of binary_alignment, so a mapping of the
+// file (page aligned) yields aligned typed arrays. Numbers are stored in
+// the writer's byte order, recorded by byte_order_tag; a reader with the
+// other order rejects the file rather than swapping.
+inline constexpr std::uint32_t binary_format_version = 1;
+inline constexpr std::size_t binary_alignment = 64;
+inline constexpr std::uint32_t byte_order_tag = 0x01020304;
+inline constexpr char binary_magic[8] = {'S', 'P', 'L', 'A', 'C', 'S', 'R', '\0'};
+
+struct BinaryHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    // Element types: kind (0 unsigned, 1 signed, 2 floating) and size
+    std::uint8_t value_kind;
+    std::uint8_t value_size;
+    std::uint8_t index_kind;
+    std::uint8_t index_size;
+    std::uint8_t offset_kind;
+    std::uint8_t offset_size;
+    std::uint8_t reserved0[2];
+    std::uint64_t rows;
+    std::uint64_t cols;
+    std::uint64_t nnz;
+    std::uint64_t row_ptrs_offset;
+    std::uint64_t col_indices_offset;
+    std::uint64_t values_offset;
+    std::uint64_t file_size;
+    std::uint8_t reserved[48];
+};
+static_assert(sizeof(BinaryHeader) == 128 && std::is_trivially_copyable_v<BinaryHeader>);
+
+namespace detail {
+    template<typename T>
+    constexpr std::uint8_t type_kind() {
+        if constexpr (std::floating_point<T>) {
+            return 2;
+        } else if constexpr (std::is_signed_v<T>) {
+            return 1;
+        } else {
+            return 0;
+        }
+    }
+
+    constexpr std::uint64_t align_up(std::uint64_t offset) {
+        return (offset + binary_alignment - 1) / binary_alignment * binary_alignment;
+    }
+
+    template<typename T, typename ColIndex, typename RowPtr>
+    BinaryHeader make_header(std::uint64_t rows, std::uint64_t cols, std::uint64_t nnz) {
+        BinaryHeader header{};
+        std::memcpy(header.magic, binary_magic, sizeof(binary_magic));
+        header.version = binary_format_version;
+        header.byte_order = byte_order_tag;
+        header.value_kind = type_kind<T>();
+        header.value_size = sizeof(T);
+        header.index_kind = type_kind<ColIndex>();
+        header.index_size = sizeof(ColIndex);
+        header.offset_kind = type_kind<RowPtr>();
+        header.offset_size = sizeof(RowPtr);
+        header.rows = rows;
+        header.cols = cols;
+        header.nnz = nnz;
+        header.row_ptrs_offset = align_up(sizeof(BinaryHeader));
+        header.col_indices_offset = align_up(header.row_ptrs_offset + (rows + 1) * sizeof(RowPtr));
+        header.values_offset = align_up(header.col_indices_offset + nnz * sizeof(ColIndex));
+        header.file_size = header.values_offset + nnz * sizeof(T);
+        return header;
+    }
+
+    template<typename T, typename ColIndex, typename RowPtr>
+    void check_header(const BinaryHeader& header, std::size_t file_size) {
+        if (std::memcmp(header.magic, binary_magic, sizeof(binary_magic)) != 0) {
+            throw std::runtime_error("Not a sparse_linalg binary matrix");
+        }
+        if (header.byte_order != byte_order_tag) {
+            throw std::runtime_error(header.byte_order == 0x04030201u
+                ? "Binary matrix was written with the other byte order"
+                : "Binary matrix has a corrupt byte order tag");
+        }
+        if (header.version != binary_format_version) {
+            throw std::runtime_error("Unsupported binary matrix version " + std::to_string(header.version));
+        }
+        if (header.value_kind != type_kind<T>() || header.value_size != sizeof(T) ||
+            header.index_kind != type_kind<ColIndex>() || header.index_size != sizeof(ColIndex) ||
+            header.offset_kind != type_kind<RowPtr>() || header.offset_size != sizeof(RowPtr)) {
+            throw std::runtime_error("Binary matrix element types do not match the requested types");
+        }
+        // Bound the counts by the file size first so the layout arithmetic
+        // below cannot wrap, then recompute it instead of trusting offsets
+        if (header.rows >= file_size || header.nnz >= file_size) {
+            throw std::runtime_error("Binary matrix is truncated or has a corrupt layout");
+        }
+        const auto expected = make_header<T, ColIndex, RowPtr>(header.rows, header.cols, header.nnz);
+        if (header.row_ptrs_offset != expected.row_ptrs_offset ||
+            header.col_indices_offset != expected.col_indices_offset ||
+            header.values_offset != expected.values_offset ||
+            header.file_size != expected.file_size || file_size < header.file_size) {
+            throw std::runtime_error("Binary matrix is truncated or has a corrupt layout");
+        }
+    }
+}
+
+// Writes A in the binary layout above. Throws std::system_error if the file
+// cannot be written.
+template<typename T, typename ColIndex, typename RowPtr, typename Allocator>
+void write_binary(const SparseMatrix<T, ColIndex, RowPtr, Allocator>& a, const std::filesystem::path& path) {
+    const auto& data = a.raw_data();
+    const auto header = detail::make_header<T, ColIndex, RowPtr>(a.rows(), a.cols(), a.nnz());
+
+    std::unique_ptr<std::FILE, detail::FileCloser> file(std::fopen(path.c_str(), "wb"));
+    if (!file) {
+        detail::throw_errno("Cannot create", path);
+    }
+    std::uint64_t offset = 0;
+    auto write_at = [&](std::uint64_t target, const void* bytes, std::size_t size) {
+        static constexpr std::byte zeros[binary_alignment] = {};
+        if (std::fwrite(zeros, 1, static_cast<std::size_t>(target - offset), file.get()) != target - offset ||
+            (size > 0 && std::fwrite(bytes, 1, size, file.get()) != size)) {
+            detail::throw_errno("Cannot write", path);
+        }
+        offset = target + size;
+    };
+    write_at(0, &header, sizeof(header));
+    write_at(header.row_ptrs_offset, data.row_ptrs.data(), data.row_ptrs.size() * sizeof(RowPtr));
+    write_at(header.col_indices_offset, data.col_indices.data(), data.col_indices.size() * sizeof(ColIndex));
+    write_at(header.values_offset, data.values.data(), data.values.size() * sizeof(T));
+    if (std::fclose(file.release()) != 0) {
+        detail::throw_errno("Cannot write", path);
+    }
+}
+
+// Maps a binary matrix file read-only and views it in place. Nothing is
+// copied: pages are faulted in from the page cache on first touch and
+// shared with every other process mapping the file. The mapping lives as
+// long as the view or any copy of it. The element types must match the
+// file's exactly.
+template<typename T, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+SparseMatrixView<T, ColIndex, RowPtr> map_binary(const std::filesystem::path& path, const MapOptions& options = {}) {
+    auto file = std::make_shared<const detail::MappedFile>(path, options);
+    if (file->size() < sizeof(BinaryHeader)) {
+        throw std::runtime_error("File is too small for a binary matrix: " + path.string());
+    }
+    BinaryHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    detail::check_header<T, ColIndex, RowPtr>(header, file->size());
+
+    const auto rows = static_cast<std::size_t>(header.rows);
+    const auto nnz = static_cast<std::size_t>(header.nnz);
+    // The offsets are aligned for every element type, so the casts are safe
+    const std::byte* base = file->data();
+    std::span<const RowPtr> row_ptrs(
+        reinterpret_cast<const RowPtr*>(static_cast<const void*>(base + header.row_ptrs_offset)), rows + 1);
+    std::span<const ColIndex> col_indices(
+        reinterpret_cast<const ColIndex*>(static_cast<const void*>(base + header.col_indices_offset)), nnz);
+    std::span<const T> values(
+        reinterpret_cast<const T*>(static_cast<const void*>(base + header.values_offset)), nnz);
+
+    SparseMatrixView<T, ColIndex, RowPtr> view(rows, static_cast<std::size_t>(header.cols),
+                                               row_ptrs, col_indices, values, std::move(file));
+    if (options.verify) {
+        view.validate_structure();
+    }
+    return view;
+}
+
+// Loads a binary matrix file into an owning SparseMatrix
+template<typename T, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+SparseMatrix<T, ColIndex, RowPtr> read_binary(const std::filesystem::path& path) {
+    MapOptions options;
+    options.access = AccessPattern::sequential;
+    options.verify = false;  // the SparseMatrix constructor checks the copy
+    return map_binary<T, ColIndex, RowPtr>(path, options).to_matrix();
+}
+
+} // namespace sparse_linalg::io
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace sparse_linalg::io {
+
+// How the mapped pages will be read; passed to madvise
+enum class AccessPattern {
+    normal,
+    sequential,  // one streaming pass, e.g. a copy: aggressive read-ahead
+    random       // scattered lookups: no read-ahead
+};
+
+struct MapOptions {
+    AccessPattern access = AccessPattern::normal;
+    // MADV_WILLNEED: start reading the whole file in the background
+    bool prefetch = false;
+    // MAP_POPULATE: fault every page in before the map call returns
+    bool populate = false;
+    // MADV_HUGEPAGE: back the mapping with transparent huge pages where the
+    // kernel supports it for page-cache files; ignored elsewhere
+    bool huge_pages = false;
+    // map_binary only: check every row pointer and column index before
+    // handing out the view. Reads the index arrays once; skip for trusted files.
+    bool verify = true;
+};
+
+namespace detail {
+    [[noreturn]] inline void throw_errno(const char* what, const std::filesystem::path& path) {
+        throw std::system_error(errno, std::generic_category(), std::string(what) + " " + path.string());
+    }
+
+    struct FileCloser {
+        void operator()(std::FILE* file) const { std::fclose(file); }
+    };
+
+    // Read-only shared mapping of a whole file. MAP_SHARED over the page
+    // cache means every process mapping the same file reads the same
+    // physical pages. An empty file maps to an empty range.
+    class MappedFile {
+    public:
+        MappedFile(const std::filesystem::path& path, const MapOptions& options) {
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                throw_errno("Cannot open", path);
+            }
+            struct stat info{};
+            if (::fstat(fd, &info) != 0) {
+                const int error = errno;
+                ::close(fd);
+                errno = error;
+                throw_errno("Cannot stat", path);
+            }
+            size_ = static_cast<std::size_t>(info.st_size);
+            if (size_ == 0) {
+                ::close(fd);
+                return;
+            }
+            int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+            if (options.populate) {
+                flags |= MAP_POPULATE;
+            }
+#endif
+            void* data = ::mmap(nullptr, size_, PROT_READ, flags, fd, 0);
+            const int error = errno;
+            ::close(fd);
+            if (data == MAP_FAILED) {
+                errno = error;
+                throw_errno("Cannot map", path);
+            }
+            data_ = static_cast<const std::byte*>(data);
+            advise(options);
+        }
+
+        ~MappedFile() {
+            if (data_) {
+                ::munmap(const_cast<std::byte*>(data_), size_);
+            }
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        [[nodiscard]] const std::byte* data() const noexcept { return data_; }
+        [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+    private:
+        const std::byte* data_ = nullptr;
+        std::size_t size_ = 0;
+
+        // Hints only: a kernel that rejects one leaves the mapping usable
+        void advise(const MapOptions& options) const {
+            auto* base = const_cast<std::byte*>(data_);
+            if (options.access == AccessPattern::sequential) {
+                ::madvise(base, size_, MADV_SEQUENTIAL);
+            } else if (options.access == AccessPattern::random) {
+                ::madvise(base, size_, MADV_RANDOM);
+            }
+            if (options.prefetch) {
+                ::madvise(base, size_, MADV_WILLNEED);
+            }
+#ifdef MADV_HUGEPAGE
+            if (options.huge_pages) {
+                ::madvise(base, size_, MADV_HUGEPAGE);
+            }
+#endif
+        }
+    };
+}
+
+} // namespace sparse_linalg::io
@@ -0,0 +1,617 @@
+#pragma once
+
+#include "../core/sparse_matrix.hpp"
+#include "../core/sparse_matrix_builder.hpp"
+#include "../core/parallel_utils.hpp"
+#include "../core/partition.hpp"
+#include "../execution/thread_pool.hpp"
+#include "mapped_file.hpp"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sparse_linalg::io {
+
+// Matrix Market coordinate files:
+//
+//   %%MatrixMarket matrix coordinate <field> <symmetry>
+//   % comment lines
+//   rows cols entries
+//   row col [value]        one entry per line, 1-based
+//
+// The field is real (or double), integer, or pattern: entries without a
+// value, read as 1. With symmetric or skew-symmetric storage the file holds
+// one triangle and the reader mirrors every off-diagonal entry, negated for
+// skew-symmetric. Dense array files and complex or hermitian fields are
+// rejected.
+enum class MatrixMarketField { real, integer, pattern };
+enum class MatrixMarketSymmetry { general, symmetric, skew_symmetric };
+
+struct MatrixMarketHeader {
+    MatrixMarketField field = MatrixMarketField::real;
+    MatrixMarketSymmetry symmetry = MatrixMarketSymmetry::general;
+    std::size_t rows = 0;
+    std::size_t cols = 0;
+    std::size_t entries = 0;  // entry lines in the file, before mirroring
+    std::size_t body = 0;     // byte offset of the first line after the size line
+};
+
+struct MatrixMarketOptions {
+    // Parse the body twice: once to count the entries of each row, then
+    // again to place them straight into the CSR arrays. Besides the CSR
+    // arrays, peak memory is two row-sized arrays at a time (the row
+    // offsets, with the scatter cursors and then the merged counts) instead
+    // of also holding a triplet copy of every entry, for about twice the
+    // parse time.
+    bool streaming = false;
+};
+
+namespace detail {
+    using sparse_linalg::detail::checked_index_cast;
+    using sparse_linalg::detail::for_each_partition;
+    using sparse_linalg::detail::partition_by_nnz;
+    using sparse_linalg::detail::partition_range;
+    using sparse_linalg::detail::run_parts;
+
+    [[noreturn]] inline void throw_mm_error(std::size_t offset, const std::string& what) {
+        throw std::runtime_error("Matrix Market parse error at byte " + std::to_string(offset) + ": " + what);
+    }
+
+    constexpr bool is_mm_blank(char c) noexcept {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    inline const char* skip_mm_blanks(const char* p, const char* end) noexcept {
+        while (p != end && is_mm_blank(*p)) {
+            ++p;
+        }
+        return p;
+    }
+
+    inline const char* skip_mm_line(const char* p, const char* end) noexcept {
+        while (p != end && *p != '\n') {
+            ++p;
+        }
+        return p == end ? end : p + 1;
+    }
+
+    inline bool mm_word_equals(std::string_view word, std::string_view lower) noexcept {
+        return std::equal(word.begin(), word.end(), lower.begin(), lower.end(), [](char a, char b) {
+            return (a >= 'A' && a <= 'Z' ? static_cast<char>(a - 'A' + 'a') : a) == b;
+        });
+    }
+
+    // Unsigned decimal at p; throws unless one is there
+    inline const char* parse_mm_size(const char* p, const char* end, const char* base, std::size_t& value) {
+        const auto [next, error] = std::from_chars(p, end, value);
+        if (error != std::errc{}) {
+            throw_mm_error(static_cast<std::size_t>(p - base),
+                           error == std::errc::result_out_of_range ? "number out of range" : "expected an index");
+        }
+        return next;
+    }
+
+    // Value at p. from_chars takes no leading '+', which some writers emit.
+    template<typename T>
+    const char* parse_mm_value(const char* p, const char* end, const char* base, T& value) {
+        const char* first = p != end && *p == '+' ? p + 1 : p;
+        const auto [next, error] = std::from_chars(first, end, value);
+        if (error != std::errc{}) {
+            throw_mm_error(static_cast<std::size_t>(p - base),
+                           error == std::errc::result_out_of_range ? "value out of range" : "expected a value");
+        }
+        return next;
+    }
+
+    // Header line, comments and size line; fails on anything this reader
+    // cannot turn into a T matrix
+    template<typename T>
+    MatrixMarketHeader parse_mm_header(std::string_view text) {
+        const char* base = text.data();
+        const char* end = base + text.size();
+        const char* line_end = skip_mm_line(base, end);
+
+        std::string_view words[5];
+        std::size_t count = 0;
+        for (const char* p = skip_mm_blanks(base, line_end); p != line_end && *p != '\n';
+             p = skip_mm_blanks(p, line_end)) {
+            const char* start = p;
+            while (p != line_end && *p != '\n' && !is_mm_blank(*p)) {
+                ++p;
+            }
+            if (count == 5) {
+                throw_mm_error(static_cast<std::size_t>(start - base), "unexpected text in the banner");
+            }
+            words[count++] = std::string_view(start, static_cast<std::size_t>(p - start));
+        }
+        if (count != 5 || !mm_word_equals(words[0], "%%matrixmarket") || !mm_word_equals(words[1], "matrix")) {
+            throw_mm_error(0, "missing %%MatrixMarket matrix banner");
+        }
+        if (!mm_word_equals(words[2], "coordinate")) {
+            throw std::runtime_error("Only Matrix Market coordinate files are supported");
+        }
+
+        MatrixMarketHeader header;
+        if (mm_word_equals(words[3], "real") || mm_word_equals(words[3], "double")) {
+            header.field = MatrixMarketField::real;
+        } else if (mm_word_equals(words[3], "integer")) {
+            header.field = MatrixMarketField::integer;
+        } else if (mm_word_equals(words[3], "pattern")) {
+            header.field = MatrixMarketField::pattern;
+        } else {
+            throw std::runtime_error("Unsupported Matrix Market field: " + std::string(words[3]));
+        }
+        if (mm_word_equals(words[4], "general")) {
+            header.symmetry = MatrixMarketSymmetry::general;
+        } else if (mm_word_equals(words[4], "symmetric")) {
+            header.symmetry = MatrixMarketSymmetry::symmetric;
+        } else if (mm_word_equals(words[4], "skew-symmetric")) {
+            header.symmetry = MatrixMarketSymmetry::skew_symmetric;
+        } else {
+            throw std::runtime_error("Unsupported Matrix Market symmetry: " + std::string(words[4]));
+        }
+        if (header.field == MatrixMarketField::real && !std::floating_point<T>) {
+            throw std::runtime_error("Matrix Market real values cannot be read into an integer matrix");
+        }
+        if (header.symmetry == MatrixMarketSymmetry::skew_symmetric && !std::is_signed_v<T>) {
+            throw std::runtime_error("Skew-symmetric Matrix Market files need a signed value type");
+        }
+
+        // Comments and blank lines, then the size line
+        const char* p = line_end;
+        for (;;) {
+            p = skip_mm_blanks(p, end);
+            if (p == end) {
+                throw_mm_error(text.size(), "missing size line");
+            }
+            if (*p == '%' || *p == '\n') {
+                p = skip_mm_line(p, end);
+                continue;
+            }
+            break;
+        }
+        p = parse_mm_size(p, end, base, header.rows);
+        p = parse_mm_size(skip_mm_blanks(p, end), end, base, header.cols);
+        p = parse_mm_size(skip_mm_blanks(p, end), end, base, header.entries);
+        p = skip_mm_blanks(p, end);
+        if (p != end && *p != '\n') {
+            throw_mm_error(static_cast<std::size_t>(p - base), "unexpected text after the size line");
+        }
+        if (header.symmetry != MatrixMarketSymmetry::general && header.rows != header.cols) {
+            throw std::runtime_error("Symmetric Matrix Market matrix must be square");
+        }
+        header.body = static_cast<std::size_t>(skip_mm_line(p, end) - base);
+        return header;
+    }
+
+    // Splits text[first, size) into num_chunks ranges that each begin at the start of a line
+    inline std::vector<std::size_t> split_mm_lines(std::string_view text, std::size_t first, std::size_t num_chunks) {
+        auto bounds = partition_range(first, text.size(), num_chunks);
+        for (std::size_t i = 1; i < num_chunks; ++i) {
+            auto pos = std::max(bounds[i], bounds[i - 1]);
+            if (pos > first && text[pos - 1] != '\n') {
+                const auto newline = text.find('\n', pos);
+                pos = newline == std::string_view::npos ? text.size() : newline + 1;
+            }
+            bounds[i] = pos;
+        }
+        return bounds;
+    }
+
+    // Parses the entry lines in text[first, last) and passes every stored
+    // entry, mirrored ones included, to sink(row, col, value) with 0-based
+    // indices. Returns the number of entry lines.
+    template<typename T, typename Sink>
+    std::size_t parse_mm_entries(std::string_view text, std::size_t first, std::size_t last,
+                                 const MatrixMarketHeader& header, Sink&& sink) {
+        const char* base = text.data();
+        const char* p = base + first;
+        const char* end = base + last;
+        std::size_t lines = 0;
+        while (p != end) {
+            p = skip_mm_blanks(p, end);
+            if (p == end) {
+                break;
+            }
+            if (*p == '\n' || *p == '%') {
+                p = skip_mm_line(p, end);
+                continue;
+            }
+
+            const char* line = p;
+            std::size_t row = 0;
+            std::size_t col = 0;
+            T value{1};
+            p = parse_mm_size(p, end, base, row);
+            p = parse_mm_size(skip_mm_blanks(p, end), end, base, col);
+            if (header.field != MatrixMarketField::pattern) {
+                p = parse_mm_value(skip_mm_blanks(p, end), end, base, value);
+            }
+            p = skip_mm_blanks(p, end);
+            if (p != end && *p != '\n') {
+                throw_mm_error(static_cast<std::size_t>(p - base), "unexpected text after an entry");
+            }
+            if (row == 0 || col == 0 || row > header.rows || col > header.cols) {
+                throw_mm_error(static_cast<std::size_t>(line - base),
+                               "entry (" + std::to_string(row) + ", " + std::to_string(col) +
+                               ") is outside the declared size");
+            }
+
+            sink(row - 1, col - 1, value);
+            if (header.symmetry != MatrixMarketSymmetry::general && row != col) {
+                sink(col - 1, row - 1, header.symmetry == MatrixMarketSymmetry::skew_symmetric
+                                           ? static_cast<T>(-value) : value);
+            }
+            ++lines;
+        }
+        return lines;
+    }
+
+    // An entry of a row being sorted, with its position in the row
+    template<typename T, typename ColIndex>
+    struct MmRowEntry {
+        ColIndex col;
+        std::size_t position;
+        T value;
+    };
+
+    // Sorts one row by column, then sums duplicates and drops zeros as
+    // SparseMatrixBuilder does. Both sorts keep duplicates in their order
+    // in the row, so they are summed in the order they were placed. The
+    // kept entries are compacted to the front; returns how many there are.
+    template<typename T, typename ColIndex>
+    std::size_t sort_and_merge_row(ColIndex* cols, T* values, std::size_t n,
+                                   std::vector<MmRowEntry<T, ColIndex>>& scratch) {
+        if (n <= 32) {
+            for (std::size_t i = 1; i < n; ++i) {
+                const auto col = cols[i];
+                const auto value = values[i];
+                std::size_t j = i;
+                for (; j > 0 && cols[j - 1] > col; --j) {
+                    cols[j] = cols[j - 1];
+                    values[j] = values[j - 1];
+                }
+                cols[j] = col;
+                values[j] = value;
+            }
+        } else if (!std::is_sorted(cols, cols + n)) {
+            scratch.resize(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                scratch[i] = {cols[i], i, values[i]};
+            }
+            std::sort(scratch.begin(), scratch.end(), [](const auto& a, const auto& b) {
+                return a.col != b.col ? a.col < b.col : a.position < b.position;
+            });
+            for (std::size_t i = 0; i < n; ++i) {
+                cols[i] = scratch[i].col;
+                values[i] = scratch[i].value;
+            }
+        }
+
+        std::size_t kept = 0;
+        std::size_t i = 0;
+        while (i < n) {
+            const auto col = cols[i];
+            T value = values[i];
+            std::size_t j = i + 1;
+            for (; j < n && cols[j] == col; ++j) {
+                value += values[j];
+            }
+            if (value != T{}) {
+                cols[kept] = col;
+                values[kept] = value;
+                ++kept;
+            }
+            i = j;
+        }
+        return kept;
+    }
+
+    // Chunks of the body are parsed in parallel; every entry goes through a
+    // counting sort on rows (histogram, prefix sum, scatter through atomic
+    // cursors), after which each row is sorted and merged in place.
+    template<typename T, typename ColIndex, typename RowPtr>
+    SparseMatrix<T, ColIndex, RowPtr> parse_matrix_market(std::string_view text, execution::ThreadPool* pool,
+                                                          const MatrixMarketOptions& options) {
+        using matrix_type = SparseMatrix<T, ColIndex, RowPtr>;
+        const auto header = parse_mm_header<T>(text);
+        const std::size_t rows = header.rows;
+        if (header.cols > 0) {
+            checked_index_cast<ColIndex>(header.cols - 1);
+        }
+
+        const std::size_t num_chunks = pool ? pool->thread_count() : 1;
+        const auto bounds = split_mm_lines(text, header.body, num_chunks);
+        std::vector<std::size_t> chunk_ids(num_chunks + 1);
+        std::iota(chunk_ids.begin(), chunk_ids.end(), std::size_t{0});
+        auto for_each_chunk = [&](auto&& fn) {
+            run_parts(pool, chunk_ids, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t chunk = begin; chunk < end; ++chunk) {
+                    fn(chunk);
+                }
+            });
+        };
+
+        // Pass 1: count the entries of every row, keeping them unless streaming
+        std::vector<std::size_t> row_start(rows + 1, 0);
+        std::vector<std::size_t> lines(num_chunks, 0);
+        std::vector<std::vector<Triplet<T>>> staged(options.streaming ? 0 : num_chunks);
+        for_each_chunk([&](std::size_t chunk) {
+            auto count = [&](std::size_t row) {
+                std::atomic_ref<std::size_t>(row_start[row + 1]).fetch_add(1, std::memory_order_relaxed);
+            };
+            if (options.streaming) {
+                lines[chunk] = parse_mm_entries<T>(text, bounds[chunk], bounds[chunk + 1], header,
+                    [&](std::size_t row, std::size_t, T) { count(row); });
+                return;
+            }
+            auto& triplets = staged[chunk];
+            const std::size_t body = text.size() - header.body;
+            if (body > 0) {
+                const auto share = static_cast<double>(bounds[chunk + 1] - bounds[chunk]) / static_cast<double>(body);
+                const auto mirror = header.symmetry == MatrixMarketSymmetry::general ? 1.0 : 2.0;
+                triplets.reserve(static_cast<std::size_t>(share * mirror * static_cast<double>(header.entries)) + 16);
+            }
+            lines[chunk] = parse_mm_entries<T>(text, bounds[chunk], bounds[chunk + 1], header,
+                [&](std::size_t row, std::size_t col, T value) {
+                    count(row);
+                    triplets.push_back({row, col, value});
+                });
+        });
+        const auto found = std::accumulate(lines.begin(), lines.end(), std::size_t{0});
+        if (found != header.entries) {
+            throw std::runtime_error("Matrix Market file declares " + std::to_string(header.entries) +
+                                     " entries but holds " + std::to_string(found));
+        }
+        std::inclusive_scan(row_start.begin(), row_start.end(), row_start.begin());
+
+        // Pass 2: scatter into rows
+        const std::size_t total = row_start.back();
+        checked_index_cast<RowPtr>(total);
+        typename matrix_type::CSRMatrix data;
+        data.col_indices.resize(total);
+        data.values.resize(total);
+        std::vector<std::size_t> cursor(row_start.begin(), row_start.end() - 1);
+        auto place = [&](std::size_t row, std::size_t col, T value) {
+            const auto slot = std::atomic_ref<std::size_t>(cursor[row]).fetch_add(1, std::memory_order_relaxed);
+            data.col_indices[slot] = static_cast<ColIndex>(col);
+            data.values[slot] = value;
+        };
+        for_each_chunk([&](std::size_t chunk) {
+            if (options.streaming) {
+                parse_mm_entries<T>(text, bounds[chunk], bounds[chunk + 1], header, place);
+                return;
+            }
+            for (const auto& t : staged[chunk]) {
+                place(t.row, t.col, t.value);
+            }
+            std::vector<Triplet<T>>().swap(staged[chunk]);
+        });
+        std::vector<std::size_t>().swap(cursor);
+
+        // Sort and merge every row in place, then close the gaps if any
+        // duplicates or zeros were dropped
+        std::vector<std::size_t> kept(rows + 1, 0);
+        for_each_partition(pool, rows, [&](std::size_t begin, std::size_t end) {
+            std::vector<MmRowEntry<T, ColIndex>> scratch;
+            for (std::size_t row = begin; row < end; ++row) {
+                kept[row + 1] = sort_and_merge_row(data.col_indices.data() + row_start[row],
+                                                   data.values.data() + row_start[row],
+                                                   row_start[row + 1] - row_start[row], scratch);
+            }
+        });
+        std::inclusive_scan(kept.begin(), kept.end(), kept.begin());
+
+        if (kept.back() != total) {
+            typename matrix_type::CSRMatrix compact;
+            compact.col_indices.resize(kept.back());
+            compact.values.resize(kept.back());
+            for_each_partition(pool, rows, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t row = begin; row < end; ++row) {
+                    const auto from = static_cast<std::ptrdiff_t>(row_start[row]);
+                    const auto n = static_cast<std::ptrdiff_t>(kept[row + 1] - kept[row]);
+                    const auto to = static_cast<std::ptrdiff_t>(kept[row]);
+                    std::copy_n(data.col_indices.begin() + from, n, compact.col_indices.begin() + to);
+                    std::copy_n(data.values.begin() + from, n, compact.values.begin() + to);
+                }
+            });
+            data = std::move(compact);
+        }
+        data.row_ptrs.resize(rows + 1);
+        std::transform(kept.begin(), kept.end(), data.row_ptrs.begin(),
+                       [](std::size_t offset) { return static_cast<RowPtr>(offset); });
+        return matrix_type(rows, header.cols, std::move(data));
+    }
+
+    // Widest line the writer emits: two indices, a value and separators
+    inline constexpr std::size_t mm_max_line = 2 * 20 + 48 + 3;
+    // Entries formatted per block; a wave of blocks is formatted in
+    // parallel, then written in order
+    inline constexpr std::size_t mm_block_entries = std::size_t{1} << 16;
+
+    inline bool mm_writes(MatrixMarketSymmetry symmetry, std::size_t row, std::size_t col) noexcept {
+        switch (symmetry) {
+            case MatrixMarketSymmetry::symmetric:
+                return col <= row;
+            case MatrixMarketSymmetry::skew_symmetric:
+                return col < row;
+            case MatrixMarketSymmetry::general:
+                break;
+        }
+        return true;
+    }
+
+    // Formats rows [first, last) into out, which must have room for
+    // mm_max_line bytes per entry; returns the bytes written
+    template<typename T, typename ColIndex, typename RowPtr, typename Allocator>
+    std::size_t format_mm_rows(const SparseMatrix<T, ColIndex, RowPtr, Allocator>& a, std::size_t first, std::size_t last,
+                               MatrixMarketSymmetry symmetry, char* out) {
+        char* p = out;
+        for (std::size_t row = first; row < last; ++row) {
+            const auto cols = a.row_indices(row);
+            const auto values = a.row_values(row);
+            for (std::size_t k = 0; k < cols.size(); ++k) {
+                const auto col = static_cast<std::size_t>(cols[k]);
+                if (!mm_writes(symmetry, row, col)) {
+                    continue;
+                }
+                char* line_end = p + mm_max_line;
+                p = std::to_chars(p, line_end, row + 1).ptr;
+                *p++ = ' ';
+                p = std::to_chars(p, line_end, col + 1).ptr;
+                *p++ = ' ';
+                p = std::to_chars(p, line_end, values[k]).ptr;
+                *p++ = '\n';
+            }
+        }
+        return static_cast<std::size_t>(p - out);
+    }
+
+    template<typename T, typename ColIndex, typename RowPtr, typename Allocator>
+    void write_matrix_market(const SparseMatrix<T, ColIndex, RowPtr, Allocator>& a, const std::filesystem::path& path,
+                             execution::ThreadPool* pool, MatrixMarketSymmetry symmetry) {
+        if (symmetry != MatrixMarketSymmetry::general && a.rows() != a.cols()) {
+            throw std::invalid_argument("Symmetric Matrix Market output needs a square matrix");
+        }
+        std::size_t entries = a.nnz();
+        if (symmetry != MatrixMarketSymmetry::general) {
+            entries = 0;
+            for (std::size_t row = 0; row < a.rows(); ++row) {
+                for (const auto col : a.row_indices(row)) {
+                    if (mm_writes(symmetry, row, static_cast<std::size_t>(col))) {
+                        ++entries;
+                    }
+                }
+            }
+        }
+
+        std::unique_ptr<std::FILE, FileCloser> file(std::fopen(path.c_str(), "wb"));
+        if (!file) {
+            throw_errno("Cannot create", path);
+        }
+        auto write = [&](const char* bytes, std::size_t size) {
+            if (size > 0 && std::fwrite(bytes, 1, size, file.get()) != size) {
+                throw_errno("Cannot write", path);
+            }
+        };
+        const std::string header = std::string("%%MatrixMarket matrix coordinate ") +
+            (std::floating_point<T> ? "real " : "integer ") +
+            (symmetry == MatrixMarketSymmetry::general ? "general"
+                : symmetry == MatrixMarketSymmetry::symmetric ? "symmetric" : "skew-symmetric") + "\n" +
+            std::to_string(a.rows()) + " " + std::to_string(a.cols()) + " " + std::to_string(entries) + "\n";
+        write(header.data(), header.size());
+
+        const auto& row_ptrs = a.raw_data().row_ptrs;
+        const std::size_t blocks = std::max<std::size_t>(1, (a.nnz() + mm_block_entries - 1) / mm_block_entries);
+        const auto block_rows = partition_by_nnz(std::span<const RowPtr>(row_ptrs), blocks);
+        const std::size_t wave = pool ? std::min(pool->thread_count(), blocks) : 1;
+        std::vector<std::vector<char>> buffers(wave);
+        std::vector<std::size_t> used(wave, 0);
+        std::vector<std::size_t> slots(wave + 1);
+        std::iota(slots.begin(), slots.end(), std::size_t{0});
+
+        for (std::size_t first_block = 0; first_block < blocks; first_block += wave) {
+            const std::size_t count = std::min(wave, blocks - first_block);
+            slots.resize(count + 1);
+            run_parts(pool, slots, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t slot = begin; slot < end; ++slot) {
+                    const auto first = block_rows[first_block + slot];
+                    const auto last = block_rows[first_block + slot + 1];
+                    const auto nnz = static_cast<std::size_t>(row_ptrs[last] - row_ptrs[first]);
+                    if (buffers[slot].size() < nnz * mm_max_line) {
+                        buffers[slot].resize(nnz * mm_max_line);
+                    }
+                    used[slot] = format_mm_rows(a, first, last, symmetry, buffers[slot].data());
+                }
+            });
+            for (std::size_t slot = 0; slot < count; ++slot) {
+                write(buffers[slot].data(), used[slot]);
+            }
+        }
+        if (std::fclose(file.release()) != 0) {
+            throw_errno("Cannot write", path);
+        }
+    }
+}
+
+// Reads the banner and size line only
+template<typename T = double>
+MatrixMarketHeader parse_matrix_market_header(std::string_view text) {
+    return detail::parse_mm_header<T>(text);
+}
+
+// Parses a Matrix Market file held in memory. Duplicate entries are summed
+// in file order and explicit zeros dropped, as SparseMatrixBuilder does.
+// Throws std::runtime_error for malformed or unsupported input, naming the
+// byte offset of the first bad line.
+template<typename T = double, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+SparseMatrix<T, ColIndex, RowPtr> parse_matrix_market(std::string_view text,
+                                                      const MatrixMarketOptions& options = {}) {
+    return detail::parse_matrix_market<T, ColIndex, RowPtr>(text, nullptr, options);
+}
+
+// Parallel parse: the body is split at line boundaries into one byte range
+// per worker. Duplicates are summed in an unspecified order.
+template<typename T = double, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+SparseMatrix<T, ColIndex, RowPtr> parse_matrix_market(std::string_view text, execution::ThreadPool& pool,
+                                                      const MatrixMarketOptions& options = {}) {
+    return detail::parse_matrix_market<T, ColIndex, RowPtr>(text, &pool, options);
+}
+
+// Reads a .mtx file through a read-only mapping, so the text is parsed
+// straight from the page cache without a copy
+template<typename T = double, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+SparseMatrix<T, ColIndex, RowPtr> read_matrix_market(const std::filesystem::path& path,
+                                                     const MatrixMarketOptions& options = {}) {
+    MapOptions map_options;
+    map_options.access = AccessPattern::sequential;
+    const detail::MappedFile file(path, map_options);
+    const std::string_view text(reinterpret_cast<const char*>(file.data()), file.size());
+    return detail::parse_matrix_market<T, ColIndex, RowPtr>(text, nullptr, options);
+}
+
+template<typename T = double, typename ColIndex = std::size_t, typename RowPtr = std::size_t>
+SparseMatrix<T, ColIndex, RowPtr> read_matrix_market(const std::filesystem::path& path, execution::ThreadPool& pool,
+                                                     const MatrixMarketOptions& options = {}) {
+    MapOptions map_options;
+    map_options.prefetch = true;
+    const detail::MappedFile file(path, map_options);
+    const std::string_view text(reinterpret_cast<const char*>(file.data()), file.size());
+    return detail::parse_matrix_market<T, ColIndex, RowPtr>(text, &pool, options);
+}
+
+// Writes A as a coordinate file, real for floating-point values and integer
+// otherwise. Values use the shortest text that reads back to the same
+// number, so a round trip is exact. With symmetric or skew-symmetric
+// storage only the lower triangle is written (the strict one for skew);
+// A is assumed to have that symmetry and is not checked. Throws
+// std::system_error if the file cannot be written.
+template<typename T, typename ColIndex, typename RowPtr, typename Allocator>
+void write_matrix_market(const SparseMatrix<T, ColIndex, RowPtr, Allocator>& a, const std::filesystem::path& path,
+                         MatrixMarketSymmetry symmetry = MatrixMarketSymmetry::general) {
+    detail::write_matrix_market(a, path, nullptr, symmetry);
+}
+
+// Formats blocks of rows in parallel; the file is written in row order
+template<typename T, typename ColIndex, typename RowPtr, typename Allocator>
+void write_matrix_market(const SparseMatrix<T, ColIndex, RowPtr, Allocator>& a, const std::filesystem::path& path,
+                         execution::ThreadPool& pool,
+                         MatrixMarketSymmetry symmetry = MatrixMarketSymmetry::general) {
+    detail::write_matrix_market(a, path, &pool, symmetry);
+}
+
+} // namespace sparse_linalg::io
@@ -0,0 +1,278 @@
+#pragma once
+
+#include "solver_common.hpp"
+#include "preconditioner.hpp"
+#include "../core/sparse_matrix.hpp"
+#include "../core/partition.hpp"
+#include "../core/spmv_kernels.hpp"
+#include "../execution/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace sparse_linalg {
+
+// Conjugate Gradient for symmetric positive definite A. Each iteration makes
+// three passes over the vectors:
+//   1. Ap = A p fused with p.Ap, in row blocks small enough that the block
+//      of Ap is still in L1 when the dot reads it back
+//   2. x += alpha p, r -= alpha Ap fused with r.r
+//   3. p = r + beta p
+// With a preconditioner M (which must be SPD too), z = M^-1 r and a pass
+// for r.z come between 2 and 3, and step 3 becomes p = z + beta p.
+// Work is split on the nonzero-balanced partition plan of A, and every pass
+// uses the same row spans. Workspace is sized on the first solve, reused
+// by later solves of the same size, and allocated like the matrix.
+template<typename T, typename ColIndex = std::size_t, typename RowPtr = std::size_t,
+         typename Allocator = std::allocator<T>>
+    requires std::floating_point<T> && MatrixIndex<ColIndex> && MatrixIndex<RowPtr>
+class ConjugateGradient {
+public:
+    using matrix_type = SparseMatrix<T, ColIndex, RowPtr, Allocator>;
+    using value_type = T;
+    using size_type = std::size_t;
+
+    explicit ConjugateGradient(SolverOptions options = {})
+        : options_(options) {
+        detail::validate_solver_options(options_);
+    }
+
+    [[nodiscard]] const SolverOptions& options() const noexcept { return options_; }
+
+    // Solves A x = b, starting from the values in x
+    SolverReport solve(const matrix_type& a, std::span<const T> b, std::span<T> x) {
+        IdentityPreconditioner identity;
+        return run(a, b, x, identity, nullptr);
+    }
+
+    SolverReport solve(const matrix_type& a, std::span<const T> b, std::span<T> x,
+                       execution::ThreadPool& pool) {
+        IdentityPreconditioner identity;
+        return run(a, b, x, identity, &pool);
+    }
+
+    template<typename P>
+        requires Preconditioner<P, T>
+    SolverReport solve(const matrix_type& a, std::span<const T> b, std::span<T> x, P& preconditioner) {
+        return run(a, b, x, preconditioner, nullptr);
+    }
+
+    template<typename P>
+        requires Preconditioner<P, T>
+    SolverReport solve(const matrix_type& a, std::span<const T> b, std::span<T> x, P& preconditioner,
+                       execution::ThreadPool& pool) {
+        return run(a, b, x, preconditioner, &pool);
+    }
+
+private:
+    template<typename U>
+    using vector_type = typename matrix_type::template vector_type<U>;
+
+    // Rows per block of the fused SpMV + dot
+    static constexpr size_type fuse_block = 256;
+
+    SolverOptions options_;
+    vector_type<T> r_;
+    vector_type<T> p_;
+    vector_type<T> ap_;
+    vector_type<T> z_;  // M^-1 r; unused without a preconditioner
+    detail::PartialSums partials_;
+    detail::PartialSums b_partials_;
+
+    template<typename P>
+    SolverReport run(const matrix_type& a, std::span<const T> b, std::span<T> x, P& preconditioner,
+                     execution::ThreadPool* pool) {
+        constexpr bool preconditioned = !std::same_as<P, IdentityPreconditioner>;
+        validate_dimensions(a, b, x);
+        SolverReport report;
+        detail::PhaseTimer total_timer(report.timings.total);
+
+        const size_type parts = pool ? pool->thread_count() : 1;
+        const auto plan = a.partition_plan(PartitionStrategy::nnz, parts);
+        const auto kernel = detail::SpmvKernel<T, ColIndex, RowPtr>::get();
+        const auto arrays = detail::csr_arrays(a);
+
+        double rr = 0.0;
+        double b_norm = 0.0;
+        {
+            detail::PhaseTimer timer(report.timings.setup);
+            const size_type n = a.rows();
+            if (r_.size() != n) {
+                r_.assign(n, T{});
+                p_.assign(n, T{});
+                ap_.assign(n, T{});
+            }
+            if (preconditioned && z_.size() != n) {
+                z_.assign(n, T{});
+            }
+            partials_.resize(plan->spans.size());
+            b_partials_.resize(plan->spans.size());
+
+            // r = b - A x and p = r, with ||b||^2 alongside r.r
+            detail::for_each_span(pool, *plan, [&](size_type part, const PartitionSpan& span) {
+                kernel(arrays, x.data(), ap_.data(), span, T{1}, T{});
+                double sum_rr = 0.0;
+                double sum_bb = 0.0;
+                for (size_type i = span.row_begin; i < span.row_end; ++i) {
+                    r_[i] = static_cast<T>(b[i] - ap_[i]);
+                    p_[i] = r_[i];
+                    sum_rr += static_cast<double>(r_[i]) * static_cast<double>(r_[i]);
+                    sum_bb += static_cast<double>(b[i]) * static_cast<double>(b[i]);
+                }
+                partials_[part] = sum_rr;
+                b_partials_[part] = sum_bb;
+            });
+            rr = partials_.total();
+            b_norm = std::sqrt(b_partials_.total());
+        }
+
+        if (b_norm == 0.0) {
+            // The solution of A x = 0 is x = 0
+            std::fill(x.begin(), x.end(), T{});
+            report.status = SolverStatus::converged;
+            record(report, 0.0);
+            return report;
+        }
+
+        double residual = std::sqrt(rr) / b_norm;
+        record(report, residual);
+        const double target = options_.tolerance;
+        if (residual <= target) {
+            report.status = SolverStatus::converged;
+            return report;
+        }
+
+        // rz = r.z, which is r.r without a preconditioner
+        double rz = rr;
+        if constexpr (preconditioned) {
+            rz = precondition(preconditioner, pool, *plan, report.timings);
+            std::copy(z_.begin(), z_.end(), p_.begin());
+        }
+
+        while (report.iterations < options_.max_iterations) {
+            double pap = 0.0;
+            {
+                detail::PhaseTimer timer(report.timings.spmv);
+                detail::for_each_span(pool, *plan, [&](size_type part, const PartitionSpan& span) {
+                    partials_[part] = spmv_dot(arrays, kernel, span);
+                });
+                pap = partials_.total();
+            }
+            if (!(pap > 0.0) || !std::isfinite(pap)) {
+                report.status = SolverStatus::breakdown;
+                break;
+            }
+
+            const auto alpha = static_cast<T>(rz / pap);
+            double rr_next = 0.0;
+            {
+                detail::PhaseTimer timer(report.timings.vector_updates);
+                detail::for_each_span(pool, *plan, [&](size_type part, const PartitionSpan& span) {
+                    partials_[part] = update_solution(x.data(), alpha, span.row_begin, span.row_end);
+                });
+                rr_next = partials_.total();
+            }
+            ++report.iterations;
+            residual = std::sqrt(rr_next) / b_norm;
+            record(report, residual);
+            if (residual <= target) {
+                report.status = SolverStatus::converged;
+                break;
+            }
+
+            double rz_next = rr_next;
+            if constexpr (preconditioned) {
+                rz_next = precondition(preconditioner, pool, *plan, report.timings);
+            }
+            const auto beta = static_cast<T>(rz_next / rz);
+            const T* z = preconditioned ? z_.data() : r_.data();
+            {
+                detail::PhaseTimer timer(report.timings.vector_updates);
+                detail::for_each_span(pool, *plan, [&](size_type, const PartitionSpan& span) {
+                    for (size_type i = span.row_begin; i < span.row_end; ++i) {
+                        p_[i] = static_cast<T>(z[i] + beta * p_[i]);
+                    }
+                });
+            }
+            rz = rz_next;
+        }
+
+        return report;
+    }
+
+    // z = M^-1 r, returning r.z
+    template<typename P>
+    double precondition(P& preconditioner, execution::ThreadPool* pool, const PartitionPlan& plan,
+                        SolverTimings& timings) {
+        {
+            detail::PhaseTimer timer(timings.preconditioner);
+            preconditioner.apply(std::span<const T>(r_), std::span<T>(z_));
+        }
+        detail::PhaseTimer timer(timings.vector_updates);
+        detail::for_each_span(pool, plan, [&](size_type part, const PartitionSpan& span) {
+            partials_[part] = detail::dot(r_.data() + span.row_begin, z_.data() + span.row_begin,
+                                          span.row_end - span.row_begin);
+        });
+        return partials_.total();
+    }
+
+    // Ap = A p over a span, block by block, returning p.Ap for the span
+    template<typename Arrays, typename Kernel>
+    double spmv_dot(const Arrays& arrays, Kernel kernel, const PartitionSpan& span) {
+        double sum = 0.0;
+        for (size_type begin = span.row_begin; begin < span.row_end; begin += fuse_block) {
+            const size_type end = std::min(begin + fuse_block, span.row_end);
+            const PartitionSpan block{
+                begin, end,
+                static_cast<size_type>(arrays.row_ptrs[begin]),
+                static_cast<size_type>(arrays.row_ptrs[end])
+            };
+            kernel(arrays, p_.data(), ap_.data(), block, T{1}, T{});
+            sum += detail::dot(p_.data() + begin, ap_.data() + begin, end - begin);
+        }
+        return sum;
+    }
+
+    // x += alpha p and r -= alpha Ap over [begin, end), returning r.r there
+    double update_solution(T* x, T alpha, size_type begin, size_type end) {
+        double sum0 = 0.0;
+        double sum1 = 0.0;
+        size_type i = begin;
+        for (; i + 2 <= end; i += 2) {
+            x[i] = static_cast<T>(x[i] + alpha * p_[i]);
+            x[i + 1] = static_cast<T>(x[i + 1] + alpha * p_[i + 1]);
+            r_[i] = static_cast<T>(r_[i] - alpha * ap_[i]);
+            r_[i + 1] = static_cast<T>(r_[i + 1] - alpha * ap_[i + 1]);
+            sum0 += static_cast<double>(r_[i]) * static_cast<double>(r_[i]);
+            sum1 += static_cast<double>(r_[i + 1]) * static_cast<double>(r_[i + 1]);
+        }
+        for (; i < end; ++i) {
+            x[i] = static_cast<T>(x[i] + alpha * p_[i]);
+            r_[i] = static_cast<T>(r_[i] - alpha * ap_[i]);
+            sum0 += static_cast<double>(r_[i]) * static_cast<double>(r_[i]);
+        }
+        return sum0 + sum1;
+    }
+
+    void record(SolverReport& report, double residual) const {
+        report.residual_norm = residual;
+        if (options_.record_history) {
+            report.residual_history.push_back(residual);
+        }
+    }
+
+    static void validate_dimensions(const matrix_type& a, std::span<const T> b, std::span<T> x) {
+        if (a.rows() != a.cols()) {
+            throw std::invalid_argument("Conjugate Gradient needs a square matrix");
+        }
+        if (b.size() != a.rows() || x.size() != a.cols()) {
+            throw std::invalid_argument("Vector sizes do not match the matrix");
+        }
+    }
+};
+
+} // namespace sparse_linalg
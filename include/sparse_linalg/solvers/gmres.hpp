@@ -0,0 +1,474 @@
+#pragma once
+
+#include "solver_common.hpp"
+#include "preconditioner.hpp"
+#include "../core/allocators.hpp"
+#include "../core/sparse_matrix.hpp"
+#include "../core/partition.hpp"
+#include "../core/matrix_ops.hpp"
+#include "../execution/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace sparse_linalg {
+
+enum class GramSchmidt {
+    modified,        // one pass per basis vector; the axpy of each step is fused with the next dot
+    classical,       // all dots in one pass, all updates in a second
+    classical_twice  // classical with one reorthogonalization, about as stable as modified
+};
+
+struct GmresOptions {
+    // Krylov vectors per cycle before restarting
+    std::size_t restart = 30;
+    GramSchmidt gram_schmidt = GramSchmidt::modified;
+};
+
+// Restarted GMRES(m) for general square A, right-preconditioned so the
+// tracked residual is the true residual of A x = b.
+//
+// The m + 1 Krylov vectors live in one 64-byte aligned buffer, each padded
+// to a whole number of cache lines. The buffer comes from Allocator when that
+// aligns to 64 bytes or more, so an AlignedAllocator with huge pages puts the
+// basis on them, and from AlignedAllocator<T> otherwise. Orthogonalization
+// sweeps the basis in row blocks so the block of the new vector stays in L1
+// while every basis vector is applied to it; the sweeps run on the
+// nonzero-balanced spans of A with per-span partial sums reduced in span
+// order.
+template<typename T, typename ColIndex = std::size_t, typename RowPtr = std::size_t,
+         typename Allocator = std::allocator<T>>
+    requires std::floating_point<T> && MatrixIndex<ColIndex> && MatrixIndex<RowPtr>
+class Gmres {
+public:
+    using matrix_type = SparseMatrix<T, ColIndex, RowPtr, Allocator>;
+    using value_type = T;
+    using size_type = std::size_t;
+
+    explicit Gmres(SolverOptions options = {}, GmresOptions gmres_options = {})
+        : options_(options), gmres_options_(gmres_options) {
+        detail::validate_solver_options(options_);
+        if (gmres_options_.restart == 0) {
+            throw std::invalid_argument("GMRES restart length must be positive");
+        }
+    }
+
+    [[nodiscard]] const SolverOptions& options() const noexcept { return options_; }
+    [[nodiscard]] const GmresOptions& gmres_options() const noexcept { return gmres_options_; }
+
+    // Solves A x = b, starting from the values in x
+    SolverReport solve(const matrix_type& a, std::span<const T> b, std::span<T> x) {
+        IdentityPreconditioner identity;
+        return run(a, b, x, identity, nullptr);
+    }
+
+    SolverReport solve(const matrix_type& a, std::span<const T> b, std::span<T> x,
+                       execution::ThreadPool& pool) {
+        IdentityPreconditioner identity;
+        return run(a, b, x, identity, &pool);
+    }
+
+    template<typename P>
+        requires Preconditioner<P, T>
+    SolverReport solve(const matrix_type& a, std::span<const T> b, std::span<T> x, P& preconditioner) {
+        return run(a, b, x, preconditioner, nullptr);
+    }
+
+    template<typename P>
+        requires Preconditioner<P, T>
+    SolverReport solve(const matrix_type& a, std::span<const T> b, std::span<T> x, P& preconditioner,
+                       execution::ThreadPool& pool) {
+        return run(a, b, x, preconditioner, &pool);
+    }
+
+private:
+    template<typename U>
+    using vector_type = typename matrix_type::template vector_type<U>;
+
+    // Rows per block of the orthogonalization sweeps
+    static constexpr size_type sweep_block = 512;
+
+    SolverOptions options_;
+    GmresOptions gmres_options_;
+
+    // Workspace, kept across solves of the same shape
+    std::vector<T, detail::at_least_aligned<Allocator, T, 64>> basis_;
+    size_type ld_ = 0;                // stride between basis vectors
+    vector_type<T> z_;                // M^-1 v for the current step
+    vector_type<double> hessenberg_;  // (m + 1) x m, column-major
+    vector_type<double> cs_;
+    vector_type<double> sn_;
+    vector_type<double> g_;           // rotated right-hand side of the least-squares problem
+    vector_type<double> y_;
+    vector_type<double> partials_;    // per span, partial_stride sums each
+    vector_type<double> coefficients_;
+    size_type partial_stride_ = 0;
+
+    template<typename P>
+    SolverReport run(const matrix_type& a, std::span<const T> b, std::span<T> x, P& preconditioner,
+                     execution::ThreadPool* pool) {
+        validate_dimensions(a, b, x);
+        SolverReport report;
+        detail::PhaseTimer total_timer(report.timings.total);
+
+        const size_type n = a.rows();
+        const size_type parts = pool ? pool->thread_count() : 1;
+        const auto plan = a.partition_plan(PartitionStrategy::nnz, parts);
+        const size_type m = std::max<size_type>(1, std::min(gmres_options_.restart, n));
+
+        double b_norm = 0.0;
+        {
+            detail::PhaseTimer timer(report.timings.setup);
+            reserve(n, m, plan->spans.size());
+            detail::for_each_span(pool, *plan, [&](size_type part, const PartitionSpan& span) {
+                partial(part, 0) = detail::dot(b.data() + span.row_begin, b.data() + span.row_begin,
+                                               span.row_end - span.row_begin);
+            });
+            b_norm = std::sqrt(reduce(0));
+        }
+        if (b_norm == 0.0) {
+            // The solution of A x = 0 is x = 0
+            std::fill(x.begin(), x.end(), T{});
+            report.status = SolverStatus::converged;
+            record(report, 0.0);
+            return report;
+        }
+
+        const double target = options_.tolerance;
+        bool first_cycle = true;
+        while (true) {
+            // v0 = b - A x, with ||v0|| alongside
+            T* v0 = vector(0);
+            {
+                detail::PhaseTimer timer(report.timings.spmv);
+                multiply(a, std::span<const T>(x.data(), n), v0, pool);
+            }
+            double beta = 0.0;
+            {
+                detail::PhaseTimer timer(report.timings.vector_updates);
+                detail::for_each_span(pool, *plan, [&](size_type part, const PartitionSpan& span) {
+                    for (size_type i = span.row_begin; i < span.row_end; ++i) {
+                        v0[i] = static_cast<T>(b[i] - v0[i]);
+                    }
+                    partial(part, 0) = detail::dot(v0 + span.row_begin, v0 + span.row_begin,
+                                                   span.row_end - span.row_begin);
+                });
+                beta = std::sqrt(reduce(0));
+            }
+
+            report.residual_norm = beta / b_norm;
+            if (first_cycle) {
+                record(report, report.residual_norm);
+                first_cycle = false;
+            }
+            if (!std::isfinite(beta)) {
+                report.status = SolverStatus::breakdown;
+                break;
+            }
+            if (report.residual_norm <= target) {
+                report.status = SolverStatus::converged;
+                break;
+            }
+            if (report.iterations >= options_.max_iterations) {
+                report.status = SolverStatus::max_iterations;
+                break;
+            }
+
+            {
+                detail::PhaseTimer timer(report.timings.vector_updates);
+                scale(v0, 1.0 / beta, pool, *plan);
+            }
+            std::fill(g_.begin(), g_.end(), 0.0);
+            g_[0] = beta;
+
+            size_type k = 0;
+            double residual = report.residual_norm;
+            while (k < m && report.iterations < options_.max_iterations) {
+                const size_type j = k;
+                const T* input = vector(j);
+                if constexpr (!std::same_as<P, IdentityPreconditioner>) {
+                    detail::PhaseTimer timer(report.timings.preconditioner);
+                    preconditioner.apply(std::span<const T>(vector(j), n), std::span<T>(z_));
+                    input = z_.data();
+                }
+                {
+                    detail::PhaseTimer timer(report.timings.spmv);
+                    multiply(a, std::span<const T>(input, n), vector(j + 1), pool);
+                }
+
+                double h_next = 0.0;
+                {
+                    detail::PhaseTimer timer(report.timings.orthogonalization);
+                    h_next = orthogonalize(j, pool, *plan);
+                    if (h_next > 0.0) {
+                        scale(vector(j + 1), 1.0 / h_next, pool, *plan);
+                    }
+                }
+                h(j + 1, j) = h_next;
+                rotate(j);
+
+                ++k;
+                ++report.iterations;
+                residual = std::abs(g_[j + 1]) / b_norm;
+                record(report, residual);
+                // h_next == 0: the Krylov space is invariant and holds the solution
+                if (!(residual > target) || !(h_next > 0.0)) {
+                    break;
+                }
+            }
+
+            if (!std::isfinite(residual)) {
+                report.status = SolverStatus::breakdown;
+                break;
+            }
+            update_solution(k, x, preconditioner, pool, *plan, report.timings);
+            if (residual <= target) {
+                report.status = SolverStatus::converged;
+                break;
+            }
+        }
+
+        return report;
+    }
+
+    void reserve(size_type n, size_type m, size_type parts) {
+        constexpr size_type line = 64 / sizeof(T) > 0 ? 64 / sizeof(T) : 1;
+        ld_ = (n + line - 1) / line * line;
+        if (basis_.size() != (m + 1) * ld_) {
+            basis_.assign((m + 1) * ld_, T{});
+        }
+        if (z_.size() != n) {
+            z_.assign(n, T{});
+        }
+        hessenberg_.assign((m + 1) * m, 0.0);
+        cs_.assign(m, 0.0);
+        sn_.assign(m, 0.0);
+        g_.assign(m + 1, 0.0);
+        y_.assign(m, 0.0);
+        coefficients_.assign(m + 1, 0.0);
+        constexpr size_type doubles_per_line = 64 / sizeof(double);
+        partial_stride_ = (m + 2 + doubles_per_line - 1) / doubles_per_line * doubles_per_line;
+        partials_.assign(parts * partial_stride_, 0.0);
+    }
+
+    T* vector(size_type i) { return basis_.data() + i * ld_; }
+    double& h(size_type row, size_type col) { return hessenberg_[col * g_.size() + row]; }
+    double& partial(size_type part, size_type col) { return partials_[part * partial_stride_ + col]; }
+
+    // Sum of column col over all spans, in span order
+    double reduce(size_type col) const {
+        double sum = 0.0;
+        for (size_type offset = col; offset < partials_.size(); offset += partial_stride_) {
+            sum += partials_[offset];
+        }
+        return sum;
+    }
+
+    static void multiply(const matrix_type& a, std::span<const T> in, T* out, execution::ThreadPool* pool) {
+        const std::span<T> y(out, a.rows());
+        if (pool) {
+            MatrixOps<T>::multiply_parallel(a, in, y, *pool);
+        } else {
+            MatrixOps<T>::multiply(a, in, y);
+        }
+    }
+
+    void scale(T* v, double factor, execution::ThreadPool* pool, const PartitionPlan& plan) {
+        const auto s = static_cast<T>(factor);
+        detail::for_each_span(pool, plan, [&](size_type, const PartitionSpan& span) {
+            for (size_type i = span.row_begin; i < span.row_end; ++i) {
+                v[i] = static_cast<T>(v[i] * s);
+            }
+        });
+    }
+
+    // Orthogonalizes w = v_{j+1} against v_0..v_j, filling column j of H;
+    // returns ||w|| after orthogonalization
+    double orthogonalize(size_type j, execution::ThreadPool* pool, const PartitionPlan& plan) {
+        switch (gmres_options_.gram_schmidt) {
+        case GramSchmidt::modified:
+            return modified_gram_schmidt(j, pool, plan);
+        case GramSchmidt::classical:
+            return classical_gram_schmidt(j, false, pool, plan);
+        case GramSchmidt::classical_twice:
+            return classical_gram_schmidt(j, true, pool, plan);
+        }
+        return 0.0;
+    }
+
+    // Pass i subtracts the projection on v_{i-1} found by pass i - 1 and
+    // takes the dot with v_i in the same sweep; the last pass takes w.w
+    double modified_gram_schmidt(size_type j, execution::ThreadPool* pool, const PartitionPlan& plan) {
+        T* w = vector(j + 1);
+        for (size_type i = 0; i <= j + 1; ++i) {
+            const T* previous = i > 0 ? vector(i - 1) : nullptr;
+            const auto coefficient = i > 0 ? static_cast<T>(h(i - 1, j)) : T{};
+            const T* next = i <= j ? vector(i) : w;
+            detail::for_each_span(pool, plan, [&](size_type part, const PartitionSpan& span) {
+                double sum = 0.0;
+                for (size_type begin = span.row_begin; begin < span.row_end; begin += sweep_block) {
+                    const size_type end = std::min(begin + sweep_block, span.row_end);
+                    if (previous) {
+                        for (size_type r = begin; r < end; ++r) {
+                            w[r] = static_cast<T>(w[r] - coefficient * previous[r]);
+                        }
+                    }
+                    sum += detail::dot(next + begin, w + begin, end - begin);
+                }
+                partial(part, 0) = sum;
+            });
+            const double value = reduce(0);
+            if (i <= j) {
+                h(i, j) = value;
+            } else {
+                return std::sqrt(value);
+            }
+        }
+        return 0.0;
+    }
+
+    // One sweep computes all j + 1 dots; the next subtracts the projection
+    // and, in the same sweep, either takes the reorthogonalization dots or
+    // the norm of the result
+    double classical_gram_schmidt(size_type j, bool twice, execution::ThreadPool* pool, const PartitionPlan& plan) {
+        T* w = vector(j + 1);
+        const size_type count = j + 1;
+
+        sweep(w, count, nullptr, true, false, pool, plan);
+        for (size_type i = 0; i < count; ++i) {
+            h(i, j) = reduce(i);
+            coefficients_[i] = h(i, j);
+        }
+        if (twice) {
+            sweep(w, count, coefficients_.data(), true, false, pool, plan);
+            for (size_type i = 0; i < count; ++i) {
+                coefficients_[i] = reduce(i);
+                h(i, j) += coefficients_[i];
+            }
+        }
+        sweep(w, count, coefficients_.data(), false, true, pool, plan);
+        return std::sqrt(reduce(count));
+    }
+
+    // Row-blocked pass over v_0..v_{count-1} and w: optionally
+    // w -= sum_i subtract[i] v_i, then optionally dots v_i.w into partial
+    // columns 0..count-1 and w.w into column count
+    void sweep(T* w, size_type count, const double* subtract, bool dots, bool norm,
+               execution::ThreadPool* pool, const PartitionPlan& plan) {
+        detail::for_each_span(pool, plan, [&](size_type part, const PartitionSpan& span) {
+            double* sums = &partial(part, 0);
+            std::fill(sums, sums + count + 1, 0.0);
+            for (size_type begin = span.row_begin; begin < span.row_end; begin += sweep_block) {
+                const size_type end = std::min(begin + sweep_block, span.row_end);
+                if (subtract) {
+                    for (size_type i = 0; i < count; ++i) {
+                        const auto c = static_cast<T>(subtract[i]);
+                        const T* v = vector(i);
+                        for (size_type r = begin; r < end; ++r) {
+                            w[r] = static_cast<T>(w[r] - c * v[r]);
+                        }
+                    }
+                }
+                if (dots) {
+                    for (size_type i = 0; i < count; ++i) {
+                        sums[i] += detail::dot(vector(i) + begin, w + begin, end - begin);
+                    }
+                }
+                if (norm) {
+                    sums[count] += detail::dot(w + begin, w + begin, end - begin);
+                }
+            }
+        });
+    }
+
+    // Applies the earlier Givens rotations to column j of H, then the one
+    // that zeroes H(j + 1, j), and carries it into g
+    void rotate(size_type j) {
+        for (size_type i = 0; i < j; ++i) {
+            const double upper = h(i, j);
+            const double lower = h(i + 1, j);
+            h(i, j) = cs_[i] * upper + sn_[i] * lower;
+            h(i + 1, j) = -sn_[i] * upper + cs_[i] * lower;
+        }
+        const double diagonal = h(j, j);
+        const double below = h(j + 1, j);
+        const double radius = std::hypot(diagonal, below);
+        cs_[j] = radius > 0.0 ? diagonal / radius : 1.0;
+        sn_[j] = radius > 0.0 ? below / radius : 0.0;
+        h(j, j) = radius;
+        h(j + 1, j) = 0.0;
+        g_[j + 1] = -sn_[j] * g_[j];
+        g_[j] = cs_[j] * g_[j];
+    }
+
+    // x += M^-1 V_k y, where H_k y = g solves the least-squares problem
+    template<typename P>
+    void update_solution(size_type k, std::span<T> x, P& preconditioner, execution::ThreadPool* pool,
+                         const PartitionPlan& plan, SolverTimings& timings) {
+        for (size_type i = k; i-- > 0;) {
+            double sum = g_[i];
+            for (size_type c = i + 1; c < k; ++c) {
+                sum -= h(i, c) * y_[c];
+            }
+            y_[i] = h(i, i) != 0.0 ? sum / h(i, i) : 0.0;
+        }
+
+        // Without a preconditioner V_k y goes straight into x; otherwise it
+        // is built in v_k, which this cycle no longer needs
+        constexpr bool identity = std::same_as<P, IdentityPreconditioner>;
+        T* target = identity ? x.data() : vector(k);
+        {
+            detail::PhaseTimer timer(timings.vector_updates);
+            detail::for_each_span(pool, plan, [&](size_type, const PartitionSpan& span) {
+                for (size_type begin = span.row_begin; begin < span.row_end; begin += sweep_block) {
+                    const size_type end = std::min(begin + sweep_block, span.row_end);
+                    if (!identity) {
+                        std::fill(target + begin, target + end, T{});
+                    }
+                    for (size_type i = 0; i < k; ++i) {
+                        const auto c = static_cast<T>(y_[i]);
+                        const T* v = vector(i);
+                        for (size_type r = begin; r < end; ++r) {
+                            target[r] = static_cast<T>(target[r] + c * v[r]);
+                        }
+                    }
+                }
+            });
+        }
+
+        if constexpr (!identity) {
+            {
+                detail::PhaseTimer timer(timings.preconditioner);
+                preconditioner.apply(std::span<const T>(target, x.size()), std::span<T>(z_));
+            }
+            detail::PhaseTimer timer(timings.vector_updates);
+            detail::for_each_span(pool, plan, [&](size_type, const PartitionSpan& span) {
+                for (size_type i = span.row_begin; i < span.row_end; ++i) {
+                    x[i] = static_cast<T>(x[i] + z_[i]);
+                }
+            });
+        }
+    }
+
+    void record(SolverReport& report, double residual) const {
+        report.residual_norm = residual;
+        if (options_.record_history) {
+            report.residual_history.push_back(residual);
+        }
+    }
+
+    static void validate_dimensions(const matrix_type& a, std::span<const T> b, std::span<T> x) {
+        if (a.rows() != a.cols()) {
+            throw std::invalid_argument("GMRES needs a square matrix");
+        }
+        if (b.size() != a.rows() || x.size() != a.cols()) {
+            throw std::invalid_argument("Vector sizes do not match the matrix");
+        }
+    }
+};
+
+} // namespace sparse_linalg
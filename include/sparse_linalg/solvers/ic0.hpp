@@ -0,0 +1,220 @@
+#pragma once
+
+#include "preconditioner.hpp"
+#include "level_schedule.hpp"
+#include "../core/allocators.hpp"
+#include "../core/sparse_matrix.hpp"
+#include "../core/parallel_utils.hpp"
+#include "../execution/thread_pool.hpp"
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace sparse_linalg {
+
+// Incomplete Cholesky with zero fill for symmetric positive definite A:
+// A ~ L L^T where L keeps the pattern of the lower triangle of A. Only the
+// lower triangle of A is read. As with Ilu0Preconditioner the constructor
+// runs the symbolic phase and factorize() repeats the numeric one.
+//
+// L is stored row-wise for the forward sweep, and L^T row-wise as well so
+// the backward sweep reads contiguous rows instead of scattering down the
+// columns of L. The numeric phase fills L on the forward schedule, then
+// gathers L^T through a precomputed position map.
+template<typename T, typename ColIndex = std::size_t, typename RowPtr = std::size_t,
+         typename Allocator = std::allocator<T>>
+    requires std::floating_point<T> && MatrixIndex<ColIndex> && MatrixIndex<RowPtr>
+class Ic0Preconditioner {
+public:
+    using matrix_type = SparseMatrix<T, ColIndex, RowPtr, Allocator>;
+    using value_type = T;
+    using size_type = std::size_t;
+
+    explicit Ic0Preconditioner(const matrix_type& a) : Ic0Preconditioner(a, nullptr) {}
+
+    Ic0Preconditioner(const matrix_type& a, execution::ThreadPool& pool) : Ic0Preconditioner(a, &pool) {}
+
+    [[nodiscard]] auto size() const noexcept -> size_type { return lower_ptrs_.size() - 1; }
+    // Entries of L
+    [[nodiscard]] auto nnz() const noexcept -> size_type { return lower_indices_.size(); }
+    [[nodiscard]] auto lower_levels() const noexcept -> size_type { return forward_.levels(); }
+    [[nodiscard]] auto upper_levels() const noexcept -> size_type { return backward_.levels(); }
+
+    // Numeric phase. Only shapes and nonzero counts are checked; a changed
+    // pattern with the same counts is the caller's responsibility.
+    void factorize(const matrix_type& a) {
+        if (a.rows() != size() || a.cols() != size() || a.nnz() != source_nnz_) {
+            throw std::invalid_argument("Matrix does not match the symbolic factorization");
+        }
+        const auto& source = a.raw_data().values;
+        detail::for_each_partition(pool_, nnz(), [&](size_type begin, size_type end) {
+            for (size_type p = begin; p < end; ++p) {
+                lower_values_[p] = source[source_[p]];
+            }
+        });
+        detail::for_each_level(pool_, forward_, [this](size_type row) { factorize_row(row); });
+        detail::for_each_partition(pool_, nnz(), [&](size_type begin, size_type end) {
+            for (size_type q = begin; q < end; ++q) {
+                upper_values_[q] = lower_values_[transpose_[q]];
+            }
+        });
+        detail::for_each_partition(pool_, size(), [&](size_type begin, size_type end) {
+            for (size_type row = begin; row < end; ++row) {
+                inverse_diagonal_[row] = T{1} / upper_values_[static_cast<size_type>(upper_ptrs_[row])];
+            }
+        });
+    }
+
+    // out = L^-T L^-1 in
+    void apply(std::span<const T> in, std::span<T> out) const {
+        if (in.size() != size() || out.size() != size()) {
+            throw std::invalid_argument("Preconditioner vector sizes do not match");
+        }
+        // L y = in, with y kept in out; the diagonal is last in each row of L
+        detail::for_each_level(pool_, forward_, [&](size_type row) {
+            const auto last = static_cast<size_type>(lower_ptrs_[row + 1]) - 1;
+            T sum = in[row];
+            for (auto p = static_cast<size_type>(lower_ptrs_[row]); p < last; ++p) {
+                sum -= lower_values_[p] * out[static_cast<size_type>(lower_indices_[p])];
+            }
+            out[row] = sum * inverse_diagonal_[row];
+        });
+        // L^T out = y, in place; the diagonal is first in each row of L^T
+        detail::for_each_level(pool_, backward_, [&](size_type row) {
+            const auto first = static_cast<size_type>(upper_ptrs_[row]);
+            T sum = out[row];
+            for (auto q = first + 1; q < static_cast<size_type>(upper_ptrs_[row + 1]); ++q) {
+                sum -= upper_values_[q] * out[static_cast<size_type>(upper_indices_[q])];
+            }
+            out[row] = sum * inverse_diagonal_[row];
+        });
+    }
+
+private:
+    template<typename U>
+    using vector_type = typename matrix_type::template vector_type<U>;
+
+    execution::ThreadPool* pool_;
+    size_type source_nnz_;
+    vector_type<RowPtr> lower_ptrs_;
+    vector_type<ColIndex> lower_indices_;
+    vector_type<size_type> source_;     // position in A of each entry of L
+    vector_type<RowPtr> upper_ptrs_;    // L^T
+    vector_type<ColIndex> upper_indices_;
+    vector_type<size_type> transpose_;  // position in L of each entry of L^T
+    detail::LevelSchedule forward_;
+    detail::LevelSchedule backward_;
+    vector_type<T> lower_values_;
+    vector_type<T> upper_values_;
+    vector_type<T> inverse_diagonal_;  // 1 / l_ii, so the sweeps do not divide
+
+    Ic0Preconditioner(const matrix_type& a, execution::ThreadPool* pool)
+        : pool_(pool), source_nnz_(a.nnz()) {
+        if (a.rows() != a.cols()) {
+            throw std::invalid_argument("Preconditioner needs a square matrix");
+        }
+        symbolic(a);
+        factorize(a);
+    }
+
+    void symbolic(const matrix_type& a) {
+        const auto& data = a.raw_data();
+        const size_type n = a.rows();
+        const std::span<const RowPtr> row_ptrs(data.row_ptrs);
+        const std::span<const ColIndex> col_indices(data.col_indices);
+
+        // Lower triangle of A: each row up to and including its diagonal
+        lower_ptrs_.assign(n + 1, RowPtr{});
+        pooled_vector<size_type> diagonal(n);
+        detail::for_each_partition(pool_, n, [&](size_type begin, size_type end) {
+            for (size_type row = begin; row < end; ++row) {
+                diagonal[row] = detail::diagonal_position(row_ptrs, col_indices, row);
+            }
+        });
+        size_type count = 0;
+        for (size_type row = 0; row < n; ++row) {
+            count += diagonal[row] + 1 - static_cast<size_type>(data.row_ptrs[row]);
+            lower_ptrs_[row + 1] = detail::checked_index_cast<RowPtr>(count);
+        }
+        lower_indices_.resize(count);
+        source_.resize(count);
+        detail::for_each_partition(pool_, n, [&](size_type begin, size_type end) {
+            for (size_type row = begin; row < end; ++row) {
+                auto q = static_cast<size_type>(lower_ptrs_[row]);
+                for (auto p = static_cast<size_type>(data.row_ptrs[row]); p <= diagonal[row]; ++p, ++q) {
+                    lower_indices_[q] = data.col_indices[p];
+                    source_[q] = p;
+                }
+            }
+        });
+
+        // L^T by a counting pass over the columns of L; rows of L are
+        // visited in order, so each row of L^T comes out sorted
+        upper_ptrs_.assign(n + 1, RowPtr{});
+        pooled_vector<size_type> next(n + 1, 0);
+        for (auto col : lower_indices_) {
+            ++next[static_cast<size_type>(col) + 1];
+        }
+        for (size_type row = 0; row < n; ++row) {
+            next[row + 1] += next[row];
+            upper_ptrs_[row + 1] = static_cast<RowPtr>(next[row + 1]);
+        }
+        upper_indices_.resize(count);
+        transpose_.resize(count);
+        for (size_type row = 0; row < n; ++row) {
+            for (auto p = static_cast<size_type>(lower_ptrs_[row]); p < static_cast<size_type>(lower_ptrs_[row + 1]); ++p) {
+                const auto q = next[static_cast<size_type>(lower_indices_[p])]++;
+                upper_indices_[q] = static_cast<ColIndex>(row);
+                transpose_[q] = p;
+            }
+        }
+
+        forward_ = detail::lower_level_schedule(std::span<const RowPtr>(lower_ptrs_),
+                                                std::span<const ColIndex>(lower_indices_));
+        backward_ = detail::upper_level_schedule(std::span<const RowPtr>(upper_ptrs_),
+                                                 std::span<const ColIndex>(upper_indices_));
+        lower_values_.resize(count);
+        upper_values_.resize(count);
+        inverse_diagonal_.resize(n);
+    }
+
+    // Up-looking Cholesky of one row: l_ik = (a_ik - sum_{j<k} l_ij l_kj) / l_kk
+    // for each k < i in the pattern, then l_ii = sqrt(a_ii - sum_{j<i} l_ij^2).
+    // The partial dot is a merge of the finished prefix of row i with row k.
+    void factorize_row(size_type row) {
+        const auto row_begin = static_cast<size_type>(lower_ptrs_[row]);
+        const auto last = static_cast<size_type>(lower_ptrs_[row + 1]) - 1;
+        T squares{};
+        for (auto p = row_begin; p < last; ++p) {
+            const auto k = static_cast<size_type>(lower_indices_[p]);
+            const auto k_last = static_cast<size_type>(lower_ptrs_[k + 1]) - 1;
+            T sum = lower_values_[p];
+            auto q = static_cast<size_type>(lower_ptrs_[k]);
+            auto r = row_begin;
+            while (q < k_last && r < p) {
+                if (lower_indices_[q] == lower_indices_[r]) {
+                    sum -= lower_values_[q] * lower_values_[r];
+                    ++q;
+                    ++r;
+                } else if (lower_indices_[q] < lower_indices_[r]) {
+                    ++q;
+                } else {
+                    ++r;
+                }
+            }
+            const T l = sum / lower_values_[k_last];
+            lower_values_[p] = l;
+            squares += l * l;
+        }
+        const T pivot = lower_values_[last] - squares;
+        if (!(pivot > T{}) || !std::isfinite(pivot)) {
+            throw std::invalid_argument("IC(0) hit a non-positive pivot");
+        }
+        lower_values_[last] = std::sqrt(pivot);
+    }
+};
+
+} // namespace sparse_linalg
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "preconditioner.hpp"
+#include "level_schedule.hpp"
+#include "../core/sparse_matrix.hpp"
+#include "../core/parallel_utils.hpp"
+#include "../execution/thread_pool.hpp"
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace sparse_linalg {
+
+// Incomplete LU with zero fill: A ~ L U where L (unit diagonal) and U keep
+// exactly the pattern of A. The constructor runs the symbolic phase, which
+// copies the pattern, locates the diagonal and builds level schedules for
+// the forward and backward sweeps, then factorizes. factorize() repeats
+// only the numeric phase, for when the values of A change but not its
+// pattern.
+//
+// Row i of the factorization reads the finished rows k < i it has entries
+// in, the same dependencies as the forward sweep, so the numeric phase runs
+// on the forward schedule. Constructed with a pool, both phases and apply()
+// split each level across it.
+template<typename T, typename ColIndex = std::size_t, typename RowPtr = std::size_t,
+         typename Allocator = std::allocator<T>>
+    requires std::floating_point<T> && MatrixIndex<ColIndex> && MatrixIndex<RowPtr>
+class Ilu0Preconditioner {
+public:
+    using matrix_type = SparseMatrix<T, ColIndex, RowPtr, Allocator>;
+    using value_type = T;
+    using size_type = std::size_t;
+
+    explicit Ilu0Preconditioner(const matrix_type& a) : Ilu0Preconditioner(a, nullptr) {}
+
+    Ilu0Preconditioner(const matrix_type& a, execution::ThreadPool& pool) : Ilu0Preconditioner(a, &pool) {}
+
+    [[nodiscard]] auto size() const noexcept -> size_type { return row_ptrs_.size() - 1; }
+    [[nodiscard]] auto nnz() const noexcept -> size_type { return col_indices_.size(); }
+    [[nodiscard]] auto lower_levels() const noexcept -> size_type { return lower_.levels(); }
+    [[nodiscard]] auto upper_levels() const noexcept -> size_type { return upper_.levels(); }
+
+    // Numeric phase. Only shapes and nonzero counts are checked; a changed
+    // pattern with the same counts is the caller's responsibility.
+    void factorize(const matrix_type& a) {
+        if (a.rows() != size() || a.cols() != size() || a.nnz() != nnz()) {
+            throw std::invalid_argument("Matrix does not match the symbolic factorization");
+        }
+        const auto& source = a.raw_data().values;
+        std::copy(source.begin(), source.end(), values_.begin());
+        detail::for_each_level(pool_, lower_, [this](size_type row) { factorize_row(row); });
+    }
+
+    // out = U^-1 L^-1 in
+    void apply(std::span<const T> in, std::span<T> out) const {
+        if (in.size() != size() || out.size() != size()) {
+            throw std::invalid_argument("Preconditioner vector sizes do not match");
+        }
+        // L y = in, with y kept in out
+        detail::for_each_level(pool_, lower_, [&](size_type row) {
+            T sum = in[row];
+            for (auto p = static_cast<size_type>(row_ptrs_[row]); p < diagonal_[row]; ++p) {
+                sum -= values_[p] * out[static_cast<size_type>(col_indices_[p])];
+            }
+            out[row] = sum;
+        });
+        // U out = y, in place: row i reads y_i and the finished entries j > i
+        detail::for_each_level(pool_, upper_, [&](size_type row) {
+            T sum = out[row];
+            for (auto p = diagonal_[row] + 1; p < static_cast<size_type>(row_ptrs_[row + 1]); ++p) {
+                sum -= values_[p] * out[static_cast<size_type>(col_indices_[p])];
+            }
+            out[row] = sum * inverse_diagonal_[row];
+        });
+    }
+
+private:
+    template<typename U>
+    using vector_type = typename matrix_type::template vector_type<U>;
+
+    execution::ThreadPool* pool_;
+    vector_type<RowPtr> row_ptrs_;
+    vector_type<ColIndex> col_indices_;
+    vector_type<size_type> diagonal_;  // position of the diagonal entry in each row
+    detail::LevelSchedule lower_;
+    detail::LevelSchedule upper_;
+    vector_type<T> values_;            // L strictly below the diagonal, U on and above it
+    vector_type<T> inverse_diagonal_;  // 1 / u_ii, so the backward sweep does not divide
+
+    Ilu0Preconditioner(const matrix_type& a, execution::ThreadPool* pool)
+        : pool_(pool), row_ptrs_(a.raw_data().row_ptrs), col_indices_(a.raw_data().col_indices),
+          diagonal_(a.rows()), values_(a.nnz()), inverse_diagonal_(a.rows()) {
+        if (a.rows() != a.cols()) {
+            throw std::invalid_argument("Preconditioner needs a square matrix");
+        }
+        const std::span<const RowPtr> row_ptrs(row_ptrs_);
+        const std::span<const ColIndex> col_indices(col_indices_);
+        detail::for_each_partition(pool_, size(), [&](size_type begin, size_type end) {
+            for (size_type row = begin; row < end; ++row) {
+                diagonal_[row] = detail::diagonal_position(row_ptrs, col_indices, row);
+            }
+        });
+        lower_ = detail::lower_level_schedule(row_ptrs, col_indices);
+        upper_ = detail::upper_level_schedule(row_ptrs, col_indices);
+        factorize(a);
+    }
+
+    // IKJ elimination of one row against the finished rows above it. Both
+    // rows are sorted, so the updates a_ij -= l_ik u_kj are a merge of the
+    // tail of row i with the strict upper part of row k.
+    void factorize_row(size_type row) {
+        const auto row_end = static_cast<size_type>(row_ptrs_[row + 1]);
+        for (auto p = static_cast<size_type>(row_ptrs_[row]); p < diagonal_[row]; ++p) {
+            const auto k = static_cast<size_type>(col_indices_[p]);
+            const T l = values_[p] * inverse_diagonal_[k];
+            values_[p] = l;
+            auto q = diagonal_[k] + 1;
+            const auto k_end = static_cast<size_type>(row_ptrs_[k + 1]);
+            auto r = p + 1;
+            while (q < k_end && r < row_end) {
+                if (col_indices_[q] == col_indices_[r]) {
+                    values_[r] -= l * values_[q];
+                    ++q;
+                    ++r;
+                } else if (col_indices_[q] < col_indices_[r]) {
+                    ++q;
+                } else {
+                    ++r;
+                }
+            }
+        }
+        const T pivot = values_[diagonal_[row]];
+        if (pivot == T{} || !std::isfinite(pivot)) {
+            throw std::invalid_argument("ILU(0) hit a zero or non-finite pivot");
+        }
+        inverse_diagonal_[row] = T{1} / pivot;
+    }
+};
+
+} // namespace sparse_linalg
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "preconditioner.hpp"
+#include "../core/sparse_matrix.hpp"
+#include "../core/parallel_utils.hpp"
+#include "../execution/thread_pool.hpp"
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace sparse_linalg {
+
+// Diagonal scaling, M = diag(A). Constructed with a pool, setup and apply
+// split the rows across it.
+template<typename T, typename ColIndex = std::size_t, typename RowPtr = std::size_t,
+         typename Allocator = std::allocator<T>>
+    requires std::floating_point<T> && MatrixIndex<ColIndex> && MatrixIndex<RowPtr>
+class JacobiPreconditioner {
+public:
+    using matrix_type = SparseMatrix<T, ColIndex, RowPtr, Allocator>;
+    using value_type = T;
+    using size_type = std::size_t;
+
+    explicit JacobiPreconditioner(const matrix_type& a) : JacobiPreconditioner(a, nullptr) {}
+
+    JacobiPreconditioner(const matrix_type& a, execution::ThreadPool& pool) : JacobiPreconditioner(a, &pool) {}
+
+    [[nodiscard]] auto size() const noexcept -> size_type { return inverse_diagonal_.size(); }
+
+    // Refreshes the diagonal after the values of A changed
+    void factorize(const matrix_type& a) {
+        if (a.rows() != size() || a.cols() != size()) {
+            throw std::invalid_argument("Matrix does not match the preconditioner");
+        }
+        const auto& data = a.raw_data();
+        const std::span<const RowPtr> row_ptrs(data.row_ptrs);
+        const std::span<const ColIndex> col_indices(data.col_indices);
+        detail::for_each_partition(pool_, size(), [&](size_type begin, size_type end) {
+            for (size_type row = begin; row < end; ++row) {
+                const T diagonal = data.values[detail::diagonal_position(row_ptrs, col_indices, row)];
+                if (diagonal == T{} || !std::isfinite(diagonal)) {
+                    throw std::invalid_argument("Jacobi preconditioner needs a nonzero diagonal");
+                }
+                inverse_diagonal_[row] = T{1} / diagonal;
+            }
+        });
+    }
+
+    void apply(std::span<const T> in, std::span<T> out) const {
+        if (in.size() != size() || out.size() != size()) {
+            throw std::invalid_argument("Preconditioner vector sizes do not match");
+        }
+        detail::for_each_partition(pool_, size(), [&](size_type begin, size_type end) {
+            for (size_type i = begin; i < end; ++i) {
+                out[i] = inverse_diagonal_[i] * in[i];
+            }
+        });
+    }
+
+private:
+    template<typename U>
+    using vector_type = typename matrix_type::template vector_type<U>;
+
+    execution::ThreadPool* pool_;
+    vector_type<T> inverse_diagonal_;
+
+    JacobiPreconditioner(const matrix_type& a, execution::ThreadPool* pool)
+        : pool_(pool), inverse_diagonal_(a.rows()) {
+        if (a.rows() != a.cols()) {
+            throw std::invalid_argument("Preconditioner needs a square matrix");
+        }
+        factorize(a);
+    }
+};
+
+} // namespace sparse_linalg
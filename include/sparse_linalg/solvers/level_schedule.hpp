@@ -0,0 +1,146 @@
+#pragma once
+
+#include "../core/allocators.hpp"
+#include "../execution/thread_pool.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace sparse_linalg {
+
+namespace detail {
+    // Rows of a triangular sweep grouped into levels. A row only reads rows
+    // of earlier levels, so the rows of one level can run concurrently and
+    // levels are separated by a barrier.
+    struct LevelSchedule {
+        std::vector<std::size_t> level_ptrs{0};  // rows of level l are rows[level_ptrs[l], level_ptrs[l + 1])
+        std::vector<std::size_t> rows;           // ascending within each level
+        std::size_t widest = 0;                  // rows in the largest level
+        bool backward = false;                   // rows only read later rows
+
+        [[nodiscard]] std::size_t levels() const noexcept { return level_ptrs.size() - 1; }
+    };
+
+    // Rows per chunk when a level is split across the pool
+    inline constexpr std::size_t level_grain = 128;
+
+    // Counting sort of rows by level
+    inline LevelSchedule group_levels(std::span<const std::size_t> level, std::size_t depth, bool backward) {
+        LevelSchedule schedule;
+        schedule.backward = backward;
+        schedule.level_ptrs.assign(depth + 1, 0);
+        for (auto l : level) {
+            ++schedule.level_ptrs[l + 1];
+        }
+        for (std::size_t l = 0; l < depth; ++l) {
+            schedule.widest = std::max(schedule.widest, schedule.level_ptrs[l + 1]);
+            schedule.level_ptrs[l + 1] += schedule.level_ptrs[l];
+        }
+        schedule.rows.resize(level.size());
+        pooled_vector<std::size_t> next(schedule.level_ptrs.begin(), schedule.level_ptrs.end() - 1);
+        for (std::size_t row = 0; row < level.size(); ++row) {
+            schedule.rows[next[level[row]]++] = row;
+        }
+        return schedule;
+    }
+
+    // Forward sweep: row i depends on the rows j < i it has entries in.
+    // Column indices must be sorted within each row.
+    template<typename Index, typename Offset>
+    LevelSchedule lower_level_schedule(std::span<const Offset> row_ptrs, std::span<const Index> col_indices) {
+        const std::size_t n = row_ptrs.size() - 1;
+        pooled_vector<std::size_t> level(n, 0);
+        std::size_t depth = 0;
+        for (std::size_t row = 0; row < n; ++row) {
+            std::size_t l = 0;
+            for (auto p = static_cast<std::size_t>(row_ptrs[row]); p < static_cast<std::size_t>(row_ptrs[row + 1]); ++p) {
+                const auto col = static_cast<std::size_t>(col_indices[p]);
+                if (col >= row) {
+                    break;
+                }
+                l = std::max(l, level[col] + 1);
+            }
+            level[row] = l;
+            depth = std::max(depth, l + 1);
+        }
+        return group_levels(level, depth, false);
+    }
+
+    // Backward sweep: row i depends on the rows j > i it has entries in
+    template<typename Index, typename Offset>
+    LevelSchedule upper_level_schedule(std::span<const Offset> row_ptrs, std::span<const Index> col_indices) {
+        const std::size_t n = row_ptrs.size() - 1;
+        pooled_vector<std::size_t> level(n, 0);
+        std::size_t depth = 0;
+        for (std::size_t row = n; row-- > 0;) {
+            std::size_t l = 0;
+            for (auto p = static_cast<std::size_t>(row_ptrs[row + 1]); p-- > static_cast<std::size_t>(row_ptrs[row]);) {
+                const auto col = static_cast<std::size_t>(col_indices[p]);
+                if (col <= row) {
+                    break;
+                }
+                l = std::max(l, level[col] + 1);
+            }
+            level[row] = l;
+            depth = std::max(depth, l + 1);
+        }
+        return group_levels(level, depth, true);
+    }
+
+    // Runs fn(row) for every row, level by level. Levels of at least two
+    // grains are split across the pool; smaller ones run on the caller,
+    // where a barrier would cost more than the rows. When no level is split
+    // the rows run in plain sweep order instead, which reads memory far
+    // more sequentially than hopping between the rows of a level.
+    template<typename F>
+    void for_each_level(execution::ThreadPool* pool, const LevelSchedule& schedule, F&& fn) {
+        if (!pool || schedule.widest < 2 * level_grain) {
+            const std::size_t n = schedule.rows.size();
+            for (std::size_t k = 0; k < n; ++k) {
+                fn(schedule.backward ? n - 1 - k : k);
+            }
+            return;
+        }
+        for (std::size_t l = 0; l < schedule.levels(); ++l) {
+            const std::size_t first = schedule.level_ptrs[l];
+            const std::size_t count = schedule.level_ptrs[l + 1] - first;
+            if (count < 2 * level_grain) {
+                for (std::size_t k = first; k < first + count; ++k) {
+                    fn(schedule.rows[k]);
+                }
+                continue;
+            }
+            pool->parallel_for(count, level_grain, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t k = first + begin; k < first + end; ++k) {
+                    fn(schedule.rows[k]);
+                }
+            });
+        }
+    }
+
+    // As for_each_level, but for data stored in level order: fn(k, row) for
+    // the row at position k of schedule.rows, and the sequential path walks
+    // the levels in order too so that storage is still read front to back
+    template<typename F>
+    void for_each_level_ordered(execution::ThreadPool* pool, const LevelSchedule& schedule, F&& fn) {
+        const bool split = pool && schedule.widest >= 2 * level_grain;
+        for (std::size_t l = 0; l < schedule.levels(); ++l) {
+            const std::size_t first = schedule.level_ptrs[l];
+            const std::size_t count = schedule.level_ptrs[l + 1] - first;
+            if (!split || count < 2 * level_grain) {
+                for (std::size_t k = first; k < first + count; ++k) {
+                    fn(k, schedule.rows[k]);
+                }
+                continue;
+            }
+            pool->parallel_for(count, level_grain, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t k = first + begin; k < first + end; ++k) {
+                    fn(k, schedule.rows[k]);
+                }
+            });
+        }
+    }
+}
+
+} // namespace sparse_linalg
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+namespace sparse_linalg {
+
+// A preconditioner applies out = M^-1 in, for an M that approximates A and
+// is cheap to invert. apply() may keep scratch state, so it is not const.
+template<typename P, typename T>
+concept Preconditioner = requires(P& preconditioner, std::span<const T> in, std::span<T> out) {
+    { preconditioner.apply(in, out) } -> std::same_as<void>;
+};
+
+// M = I. Solvers detect it and skip the copy.
+struct IdentityPreconditioner {
+    template<typename T>
+    void apply(std::span<const T> in, std::span<T> out) const {
+        if (in.size() != out.size()) {
+            throw std::invalid_argument("Preconditioner vector sizes do not match");
+        }
+        std::copy(in.begin(), in.end(), out.begin());
+    }
+};
+
+namespace detail {
+    // Position of entry (row, row) in CSR arrays with sorted rows
+    template<typename Index, typename Offset>
+    std::size_t diagonal_position(std::span<const Offset> row_ptrs, std::span<const Index> col_indices,
+                                  std::size_t row) {
+        const auto first = col_indices.begin() + static_cast<std::ptrdiff_t>(row_ptrs[row]);
+        const auto last = col_indices.begin() + static_cast<std::ptrdiff_t>(row_ptrs[row + 1]);
+        const auto it = std::lower_bound(first, last, row, [](Index col, std::size_t value) {
+            return std::cmp_less(col, value);
+        });
+        if (it == last || std::cmp_not_equal(*it, row)) {
+            throw std::invalid_argument("Preconditioner needs every diagonal entry stored");
+        }
+        return static_cast<std::size_t>(it - col_indices.begin());
+    }
+}
+
+} // namespace sparse_linalg
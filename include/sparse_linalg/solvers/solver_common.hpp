@@ -0,0 +1,130 @@
+#pragma once
+
+#include "../core/parallel_utils.hpp"
+#include "../core/partition.hpp"
+#include "../execution/thread_pool.hpp"
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace sparse_linalg {
+
+struct SolverOptions {
+    std::size_t max_iterations = 1000;
+    // Stop once ||b - A x|| <= tolerance * ||b||
+    double tolerance = 1e-8;
+    // Keep the relative residual of every iteration in the report
+    bool record_history = true;
+};
+
+enum class SolverStatus {
+    converged,
+    max_iterations,  // tolerance not reached within the iteration limit
+    breakdown        // the method cannot continue, e.g. A is not SPD for CG
+};
+
+// Wall time spent in each phase of a solve
+struct SolverTimings {
+    std::chrono::nanoseconds setup{};           // workspace and initial residual
+    std::chrono::nanoseconds spmv{};            // products with A, with any fused reductions
+    std::chrono::nanoseconds preconditioner{};  // applications of M^-1
+    std::chrono::nanoseconds orthogonalization{};
+    std::chrono::nanoseconds vector_updates{};  // axpy-style passes, with any fused reductions
+    std::chrono::nanoseconds total{};
+};
+
+struct SolverReport {
+    SolverStatus status = SolverStatus::max_iterations;
+    std::size_t iterations = 0;
+    // Final ||b - A x|| / ||b|| as tracked by the recurrence
+    double residual_norm = 0.0;
+    // Relative residual before the first iteration and after each one
+    std::vector<double> residual_history;
+    SolverTimings timings;
+
+    [[nodiscard]] bool converged() const noexcept { return status == SolverStatus::converged; }
+};
+
+namespace detail {
+    // Adds the lifetime of the timer to a phase total
+    class PhaseTimer {
+    public:
+        explicit PhaseTimer(std::chrono::nanoseconds& total)
+            : total_(total), start_(std::chrono::steady_clock::now()) {}
+
+        PhaseTimer(const PhaseTimer&) = delete;
+        PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+        ~PhaseTimer() {
+            total_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start_);
+        }
+
+    private:
+        std::chrono::nanoseconds& total_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    // Runs fn(i, spans[i]) for every span of a plan, on the pool when one is given
+    template<typename F>
+    void for_each_span(execution::ThreadPool* pool, const PartitionPlan& plan, F&& fn) {
+        const auto& spans = plan.spans;
+        if (!pool) {
+            for (std::size_t i = 0; i < spans.size(); ++i) {
+                fn(i, spans[i]);
+            }
+            return;
+        }
+        for_each_part(*pool, spans.size(), [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                fn(i, spans[i]);
+            }
+        });
+    }
+
+    // One partial sum per span, each on its own cache line. Summed in span
+    // order, so results do not depend on which thread ran which span.
+    class PartialSums {
+    public:
+        void resize(std::size_t parts) { sums_.assign(parts * stride, 0.0); }
+
+        double& operator[](std::size_t part) { return sums_[part * stride]; }
+
+        [[nodiscard]] double total() const {
+            double sum = 0.0;
+            for (std::size_t i = 0; i < sums_.size(); i += stride) {
+                sum += sums_[i];
+            }
+            return sum;
+        }
+
+    private:
+        static constexpr std::size_t stride = 64 / sizeof(double);
+        std::vector<double> sums_;
+    };
+
+    // Four independent sums so the adds pipeline; accumulates in double
+    template<typename T>
+    double dot(const T* u, const T* v, std::size_t n) {
+        double sums[4] = {0.0, 0.0, 0.0, 0.0};
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            for (std::size_t k = 0; k < 4; ++k) {
+                sums[k] += static_cast<double>(u[i + k]) * static_cast<double>(v[i + k]);
+            }
+        }
+        for (; i < n; ++i) {
+            sums[0] += static_cast<double>(u[i]) * static_cast<double>(v[i]);
+        }
+        return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    }
+
+    inline void validate_solver_options(const SolverOptions& options) {
+        if (!(options.tolerance >= 0.0)) {
+            throw std::invalid_argument("Solver tolerance must be non-negative");
+        }
+    }
+}
+
+} // namespace sparse_linalg
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "level_schedule.hpp"
+#include "../core/allocators.hpp"
+#include "../core/sparse_matrix.hpp"
+#include "../core/parallel_utils.hpp"
+#include "../execution/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace sparse_linalg {
+
+enum class Triangle {
+    lower,  // entries on and below the diagonal; solved top to bottom
+    upper   // entries on and above the diagonal; solved bottom to top
+};
+
+enum class Diagonal {
+    non_unit,  // divide by the stored diagonal, which must be present and nonzero
+    unit       // the diagonal is taken as one; stored diagonal entries are ignored
+};
+
+struct TriangularSolveOptions {
+    Triangle triangle = Triangle::lower;
+    Diagonal diagonal = Diagonal::non_unit;
+    // Store the rows in level order, so each level's rows are contiguous
+    // and every sweep reads the triangle front to back
+    bool level_order = false;
+};
+
+// Solves T x = b for the lower or upper triangle T of a square CSR matrix;
+// entries on the other side of the diagonal are ignored, so A itself can be
+// passed (e.g. for a Gauss-Seidel sweep with the lower triangle of A).
+//
+// The constructor runs the analysis: it copies the strict triangle out of
+// A, locates the diagonal and groups the rows into dependency levels, the
+// rows of one level only reading x from earlier levels. update() repeats
+// only the numeric gather, for when the values of A change but not its
+// pattern. Constructed with a pool, the analysis gathers and every solve
+// run level by level on it; levels too narrow to split, or schedules
+// without any wide level, run sequentially on the caller instead.
+template<typename T, typename ColIndex = std::size_t, typename RowPtr = std::size_t,
+         typename Allocator = std::allocator<T>>
+    requires std::floating_point<T> && MatrixIndex<ColIndex> && MatrixIndex<RowPtr>
+class TriangularSolver {
+public:
+    using matrix_type = SparseMatrix<T, ColIndex, RowPtr, Allocator>;
+    using value_type = T;
+    using size_type = std::size_t;
+
+    explicit TriangularSolver(const matrix_type& a, TriangularSolveOptions options = {})
+        : TriangularSolver(a, nullptr, options) {}
+
+    TriangularSolver(const matrix_type& a, execution::ThreadPool& pool, TriangularSolveOptions options = {})
+        : TriangularSolver(a, &pool, options) {}
+
+    [[nodiscard]] auto size() const noexcept -> size_type { return ptrs_.size() - 1; }
+    // Stored entries off the diagonal
+    [[nodiscard]] auto nnz() const noexcept -> size_type { return indices_.size(); }
+    [[nodiscard]] auto levels() const noexcept -> size_type { return schedule_.levels(); }
+    // Rows in the largest level: the parallelism available to a solve
+    [[nodiscard]] auto widest_level() const noexcept -> size_type { return schedule_.widest; }
+    [[nodiscard]] const TriangularSolveOptions& options() const noexcept { return options_; }
+
+    // Numeric phase. Only shapes and nonzero counts are checked; a changed
+    // pattern with the same counts is the caller's responsibility.
+    void update(const matrix_type& a) {
+        if (a.rows() != size() || a.cols() != size() || a.nnz() != source_nnz_) {
+            throw std::invalid_argument("Matrix does not match the triangular solve analysis");
+        }
+        const auto& source = a.raw_data().values;
+        detail::for_each_partition(pool_, nnz(), [&](size_type begin, size_type end) {
+            for (size_type q = begin; q < end; ++q) {
+                values_[q] = source[source_[q]];
+            }
+        });
+        if (options_.diagonal == Diagonal::unit) {
+            return;
+        }
+        detail::for_each_partition(pool_, size(), [&](size_type begin, size_type end) {
+            for (size_type slot = begin; slot < end; ++slot) {
+                const T pivot = source[diagonal_source_[slot]];
+                if (pivot == T{} || !std::isfinite(pivot)) {
+                    throw std::invalid_argument("Triangular matrix has a zero or non-finite diagonal entry");
+                }
+                inverse_diagonal_[slot] = T{1} / pivot;
+            }
+        });
+    }
+
+    // x = T^-1 b. b and x may be the same vector.
+    void solve(std::span<const T> b, std::span<T> x) const {
+        if (b.size() != size() || x.size() != size()) {
+            throw std::invalid_argument("Triangular solve vector sizes do not match");
+        }
+        if (options_.level_order) {
+            detail::for_each_level_ordered(pool_, schedule_, [&](size_type slot, size_type row) {
+                solve_row(slot, row, b, x);
+            });
+        } else {
+            detail::for_each_level(pool_, schedule_, [&](size_type row) { solve_row(row, row, b, x); });
+        }
+    }
+
+    // The same as solve(), so the solver can serve as a Preconditioner
+    void apply(std::span<const T> in, std::span<T> out) const { solve(in, out); }
+
+private:
+    template<typename U>
+    using vector_type = typename matrix_type::template vector_type<U>;
+
+    static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+    execution::ThreadPool* pool_;
+    TriangularSolveOptions options_;
+    size_type source_nnz_;
+    detail::LevelSchedule schedule_;
+    // The strict triangle, one slot per row: slot k holds row k, or row
+    // schedule_.rows[k] with level_order
+    vector_type<RowPtr> ptrs_;
+    vector_type<ColIndex> indices_;
+    vector_type<size_type> source_;           // position in A of each stored entry
+    vector_type<size_type> diagonal_source_;  // position in A of each slot's diagonal
+    vector_type<T> values_;
+    vector_type<T> inverse_diagonal_;         // so the sweeps do not divide
+
+    TriangularSolver(const matrix_type& a, execution::ThreadPool* pool, TriangularSolveOptions options)
+        : pool_(pool), options_(options), source_nnz_(a.nnz()) {
+        if (a.rows() != a.cols()) {
+            throw std::invalid_argument("Triangular solve needs a square matrix");
+        }
+        analyze(a);
+        update(a);
+    }
+
+    void analyze(const matrix_type& a) {
+        const auto& data = a.raw_data();
+        const size_type n = a.rows();
+        const std::span<const RowPtr> row_ptrs(data.row_ptrs);
+        const std::span<const ColIndex> col_indices(data.col_indices);
+        const bool lower = options_.triangle == Triangle::lower;
+        schedule_ = lower ? detail::lower_level_schedule(row_ptrs, col_indices)
+                          : detail::upper_level_schedule(row_ptrs, col_indices);
+        auto row_of = [this](size_type slot) { return options_.level_order ? schedule_.rows[slot] : slot; };
+
+        // Per row: the strict triangle [first, last) in A and the diagonal
+        pooled_vector<size_type> first(n);
+        pooled_vector<size_type> last(n);
+        diagonal_source_.assign(n, npos);
+        detail::for_each_partition(pool_, n, [&](size_type begin, size_type end) {
+            for (size_type slot = begin; slot < end; ++slot) {
+                const size_type row = row_of(slot);
+                const auto row_begin = col_indices.begin() + static_cast<std::ptrdiff_t>(row_ptrs[row]);
+                const auto row_end = col_indices.begin() + static_cast<std::ptrdiff_t>(row_ptrs[row + 1]);
+                const auto diagonal = std::lower_bound(row_begin, row_end, row, [](ColIndex col, size_type value) {
+                    return std::cmp_less(col, value);
+                });
+                const bool stored = diagonal != row_end && std::cmp_equal(*diagonal, row);
+                const auto position = static_cast<size_type>(diagonal - col_indices.begin());
+                if (stored) {
+                    diagonal_source_[slot] = position;
+                }
+                first[slot] = lower ? static_cast<size_type>(row_ptrs[row]) : stored ? position + 1 : position;
+                last[slot] = lower ? position : static_cast<size_type>(row_ptrs[row + 1]);
+            }
+        });
+        if (options_.diagonal == Diagonal::non_unit &&
+            std::find(diagonal_source_.begin(), diagonal_source_.end(), npos) != diagonal_source_.end()) {
+            throw std::invalid_argument("Triangular solve needs every diagonal entry stored");
+        }
+        if (options_.diagonal == Diagonal::unit) {
+            diagonal_source_ = {};
+        }
+
+        ptrs_.assign(n + 1, RowPtr{});
+        size_type count = 0;
+        for (size_type slot = 0; slot < n; ++slot) {
+            count += last[slot] - first[slot];
+            ptrs_[slot + 1] = detail::checked_index_cast<RowPtr>(count);
+        }
+        indices_.resize(count);
+        source_.resize(count);
+        values_.resize(count);
+        inverse_diagonal_.resize(options_.diagonal == Diagonal::unit ? 0 : n);
+        detail::for_each_partition(pool_, n, [&](size_type begin, size_type end) {
+            for (size_type slot = begin; slot < end; ++slot) {
+                auto q = static_cast<size_type>(ptrs_[slot]);
+                for (auto p = first[slot]; p < last[slot]; ++p, ++q) {
+                    indices_[q] = data.col_indices[p];
+                    source_[q] = p;
+                }
+            }
+        });
+    }
+
+    void solve_row(size_type slot, size_type row, std::span<const T> b, std::span<T> x) const {
+        T sum = b[row];
+        const auto end = static_cast<size_type>(ptrs_[slot + 1]);
+        for (auto q = static_cast<size_type>(ptrs_[slot]); q < end; ++q) {
+            sum -= values_[q] * x[static_cast<size_type>(indices_[q])];
+        }
+        x[row] = options_.diagonal == Diagonal::unit ? sum : sum * inverse_diagonal_[slot];
+    }
+};
+
+} // namespace sparse_linalg
@@ -0,0 +1,209 @@
+#include <doctest/doctest.h>
+#include "test_helpers.hpp"
+#include <sparse_linalg/core/allocators.hpp>
+#include <sparse_linalg/core/first_touch.hpp>
+#include <sparse_linalg/core/matrix_generators.hpp>
+#include <sparse_linalg/core/matrix_ops.hpp>
+#include <sparse_linalg/core/reordering.hpp>
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/core/sparse_matrix_view.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <sparse_linalg/solvers/conjugate_gradient.hpp>
+#include <sparse_linalg/solvers/gmres.hpp>
+#include <sparse_linalg/solvers/ic0.hpp>
+#include <sparse_linalg/solvers/ilu0.hpp>
+#include <sparse_linalg/solvers/jacobi.hpp>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+using namespace sparse_linalg;
+using namespace sparse_linalg::test;
+
+namespace {
+    bool aligned_to(const void* p, std::size_t alignment) {
+        return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+    }
+
+    using AlignedMatrix = SparseMatrix<double, std::uint32_t, std::uint32_t, AlignedAllocator<double>>;
+    using HugeMatrix = SparseMatrix<double, std::uint32_t, std::uint32_t,
+                                    AlignedAllocator<double, 64, HugePagePolicy::transparent>>;
+
+    // Workspaces that need cache lines keep allocators that provide them
+    static_assert(std::same_as<detail::at_least_aligned<std::allocator<float>, double, 64>, AlignedAllocator<double>>);
+    static_assert(std::same_as<detail::at_least_aligned<AlignedAllocator<float, 32>, double, 64>,
+                               AlignedAllocator<double>>);
+    static_assert(std::same_as<detail::at_least_aligned<HugeMatrix::allocator_type, float, 64>,
+                               AlignedAllocator<float, 64, HugePagePolicy::transparent>>);
+    static_assert(std::same_as<detail::at_least_aligned<PoolAllocator<int>, double, 64>, PoolAllocator<double>>);
+}
+
+TEST_SUITE("Allocators") {
+    TEST_CASE("aligned allocations") {
+        for (std::size_t n : {std::size_t{1}, std::size_t{3}, std::size_t{1000}}) {
+            aligned_vector<double> small(n, 1.5);
+            CHECK(aligned_to(small.data(), 64));
+            std::vector<float, AlignedAllocator<float, 256>> wide(n);
+            CHECK(aligned_to(wide.data(), 256));
+        }
+        AlignedAllocator<double> doubles;
+        AlignedAllocator<int> ints(doubles);
+        CHECK(doubles == ints);
+        CHECK_THROWS_AS(static_cast<void>(doubles.allocate(std::size_t{1} << 62)), std::bad_alloc);
+    }
+
+    TEST_CASE("huge page allocations") {
+        // Below one huge page the ordinary aligned path is used
+        aligned_vector<double, HugePagePolicy::transparent> small(100, 2.0);
+        CHECK(aligned_to(small.data(), 64));
+
+        for (auto n : {huge_page_size / sizeof(double), 3 * huge_page_size / sizeof(double) + 5}) {
+            aligned_vector<double, HugePagePolicy::transparent> large(n, 1.0);
+            CHECK(aligned_to(large.data(), huge_page_size));
+            large.back() = 4.0;
+            CHECK(large.front() == 1.0);
+            CHECK(large.back() == 4.0);
+        }
+
+        // Falls back to transparent pages when none are reserved
+        aligned_vector<double, HugePagePolicy::reserved> reserved(huge_page_size / sizeof(double), 3.0);
+        CHECK(aligned_to(reserved.data(), huge_page_size));
+        CHECK(reserved[12345] == 3.0);
+    }
+
+    TEST_CASE("memory pool recycles blocks") {
+        MemoryPool pool(1 << 20, HugePagePolicy::none);
+        {
+            std::vector<double, PoolAllocator<double>> a(1000, 1.0, PoolAllocator<double>(pool));
+            CHECK(aligned_to(a.data(), MemoryPool::min_block));
+        }
+        auto stats = pool.stats();
+        CHECK(stats.misses == 1);
+        CHECK(stats.hits == 0);
+        CHECK(stats.cached_bytes == 8192);  // 8000 bytes rounded to the size class
+
+        // Any size in the same class reuses the block
+        {
+            std::vector<double, PoolAllocator<double>> b(900, 0.0, PoolAllocator<double>(pool));
+            CHECK(b[899] == 0.0);
+            CHECK(pool.stats().cached_bytes == 0);
+        }
+        stats = pool.stats();
+        CHECK(stats.hits == 1);
+        CHECK(stats.misses == 1);
+
+        // Blocks past the cap are freed instead of cached
+        {
+            std::vector<char, PoolAllocator<char>> big((1 << 20) + 1, 'x', PoolAllocator<char>(pool));
+        }
+        CHECK(pool.stats().cached_bytes == 8192);
+        pool.release();
+        CHECK(pool.stats().cached_bytes == 0);
+
+        MemoryPool other(1 << 20, HugePagePolicy::none);
+        CHECK(PoolAllocator<int>(pool) == PoolAllocator<double>(pool));
+        CHECK(PoolAllocator<int>(pool) != PoolAllocator<int>(other));
+        CHECK(&PoolAllocator<int>().pool() == &MemoryPool::global());
+    }
+
+    TEST_CASE("memory pool is shared between threads") {
+        MemoryPool pool(std::size_t{64} << 20, HugePagePolicy::none);
+        execution::ThreadPool threads(4);
+        threads.parallel_for(400, 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                std::vector<std::size_t, PoolAllocator<std::size_t>> v(64 + i, i, PoolAllocator<std::size_t>(pool));
+                REQUIRE(v[63 + i] == i);
+            }
+        });
+        const auto stats = pool.stats();
+        CHECK(stats.hits + stats.misses == 400);
+        CHECK(stats.misses <= 4 * 4);  // at most one block per size class and thread
+    }
+
+    TEST_CASE("matrix with aligned storage") {
+        execution::ThreadPool pool(3);
+        const auto reference = poisson_2d<double, std::uint32_t, std::uint32_t>(30, 20);
+        const AlignedMatrix a(reference);
+        CHECK(same_entries(a, reference));
+        CHECK(aligned_to(a.raw_data().values.data(), 64));
+        CHECK(aligned_to(a.raw_data().col_indices.data(), 64));
+        CHECK(aligned_to(a.raw_data().row_ptrs.data(), 64));
+        CHECK(same_entries(SparseMatrix<double, std::uint32_t, std::uint32_t>(a), reference));
+
+        std::vector<double> x(a.cols());
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            x[i] = static_cast<double>(i % 7) - 3.0;
+        }
+        const std::span<const double> xs(x);
+        CHECK(MatrixOps<double>::multiply(a, xs) == MatrixOps<double>::multiply(reference, xs));
+        CHECK(MatrixOps<double>::multiply_parallel(a, xs, pool) ==
+              MatrixOps<double>::multiply_parallel(reference, xs, pool));
+        CHECK(MatrixOps<double>::multiply_transpose(a, xs) == MatrixOps<double>::multiply_transpose(reference, xs));
+
+        const auto product = MatrixOps<double>::multiply(a, a);
+        static_assert(std::same_as<decltype(product), const AlignedMatrix>);
+        CHECK(same_entries(product, MatrixOps<double>::multiply(reference, reference)));
+        CHECK(same_entries(MatrixOps<double>::multiply_parallel(a, a, pool), product));
+        CHECK(same_entries(MatrixOps<double>::transpose(a, pool), MatrixOps<double>::transpose(reference)));
+        CHECK(aligned_to(MatrixOps<double>::transpose(a).raw_data().values.data(), 64));
+
+        const auto perm = reverse_cuthill_mckee(a);
+        CHECK(perm == reverse_cuthill_mckee(reference));
+        CHECK(same_entries(permute(a, perm, perm), permute(reference, perm, perm)));
+        CHECK(same_entries(first_touch_copy(a, pool), reference));
+    }
+
+    TEST_CASE("view of aligned storage") {
+        execution::ThreadPool pool(2);
+        const auto reference = poisson_2d<double, std::uint32_t, std::uint32_t>(25, 18);
+        const HugeMatrix a(reference);
+        const SparseMatrixView view(a);
+        static_assert(std::same_as<decltype(view), const SparseMatrixView<double, std::uint32_t, std::uint32_t>>);
+        CHECK(view.values().data() == a.raw_data().values.data());
+        CHECK(view.col_indices().data() == a.raw_data().col_indices.data());
+        CHECK(view.row_ptrs().data() == a.raw_data().row_ptrs.data());
+        CHECK(same_entries(view, reference));
+
+        const auto x = make_vector(a.cols());
+        const std::span<const double> xs(x);
+        CHECK(MatrixOps<double>::multiply(view, xs) == MatrixOps<double>::multiply(reference, xs));
+        std::vector<double> y(a.rows());
+        MatrixOps<double>::multiply_parallel(view, xs, std::span<double>(y), pool);
+        CHECK(y == MatrixOps<double>::multiply_parallel(reference, xs, pool));
+    }
+
+    TEST_CASE("solvers on huge-page storage") {
+        execution::ThreadPool pool(2);
+        const HugeMatrix a(poisson_2d<double, std::uint32_t, std::uint32_t>(40, 40));
+        const std::vector<double> b(a.rows(), 1.0);
+
+        SolverOptions options;
+        options.tolerance = 1e-10;
+        options.max_iterations = 1000;
+        ConjugateGradient<double, std::uint32_t, std::uint32_t, HugeMatrix::allocator_type> cg(options);
+        auto check_solution = [&](const std::vector<double>& x, const SolverReport& report) {
+            CHECK(report.converged());
+            std::vector<double> ax(a.rows());
+            MatrixOps<double>::multiply(a, std::span<const double>(x), std::span<double>(ax));
+            for (std::size_t i = 0; i < ax.size(); ++i) {
+                REQUIRE(ax[i] == doctest::Approx(1.0).epsilon(1e-6));
+            }
+        };
+
+        std::vector<double> x(a.rows(), 0.0);
+        check_solution(x, cg.solve(a, b, x));
+        Ic0Preconditioner<double, std::uint32_t, std::uint32_t, HugeMatrix::allocator_type> ic(a, pool);
+        std::fill(x.begin(), x.end(), 0.0);
+        check_solution(x, cg.solve(a, b, x, ic, pool));
+        JacobiPreconditioner<double, std::uint32_t, std::uint32_t, HugeMatrix::allocator_type> jacobi(a);
+        std::fill(x.begin(), x.end(), 0.0);
+        check_solution(x, cg.solve(a, b, x, jacobi));
+
+        Gmres<double, std::uint32_t, std::uint32_t, HugeMatrix::allocator_type> gmres(options);
+        Ilu0Preconditioner<double, std::uint32_t, std::uint32_t, HugeMatrix::allocator_type> ilu(a);
+        std::fill(x.begin(), x.end(), 0.0);
+        check_solution(x, gmres.solve(a, b, x, ilu));
+    }
+}
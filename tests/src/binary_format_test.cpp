@@ -0,0 +1,173 @@
+#include <doctest/doctest.h>
+#include "test_helpers.hpp"
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/core/sparse_matrix_view.hpp>
+#include <sparse_linalg/core/matrix_ops.hpp>
+#include <sparse_linalg/io/binary_format.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace sparse_linalg;
+using namespace sparse_linalg::test;
+
+namespace {
+    template<typename T>
+    void patch(const std::filesystem::path& path, std::streamoff offset, const T& value) {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(offset);
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+}
+
+TEST_SUITE("BinaryFormat") {
+    TEST_CASE_TEMPLATE("round trip through a mapped view", Matrix,
+                       SparseMatrix<double>,
+                       SparseMatrix<float, std::uint32_t, std::uint32_t>,
+                       SparseMatrix<double, std::int32_t, std::int64_t>,
+                       SparseMatrix<int, std::uint16_t, std::uint32_t>) {
+        using Value = typename Matrix::value_type;
+        using Index = typename Matrix::index_type;
+        using Offset = typename Matrix::offset_type;
+        const auto matrix = make_irregular<Matrix>(57, 31, {5});
+        TempFile file("round_trip", ".bin");
+        io::write_binary(matrix, file.path);
+
+        const auto view = io::map_binary<Value, Index, Offset>(file.path);
+        CHECK(same_entries(view, matrix));
+        const auto col = static_cast<std::size_t>(matrix.row_indices(3)[0]);
+        CHECK(view(3, col) == matrix(3, col));
+        // Arrays are aligned in the mapping
+        CHECK(reinterpret_cast<std::uintptr_t>(view.values().data()) % io::binary_alignment == 0);
+        CHECK(reinterpret_cast<std::uintptr_t>(view.col_indices().data()) % io::binary_alignment == 0);
+
+        const auto copy = io::read_binary<Value, Index, Offset>(file.path);
+        CHECK(same_entries(copy, matrix));
+    }
+
+    TEST_CASE("mapped view multiplies in place") {
+        const auto matrix = make_irregular<SparseMatrix<double>>(300, 200, {5});
+        TempFile file("spmv", ".bin");
+        io::write_binary(matrix, file.path);
+        const auto view = io::map_binary<double>(file.path);
+        std::vector<double> x(200);
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            x[i] = static_cast<double>(i % 11) - 5.0;
+        }
+        const auto expected = MatrixOps<double>::multiply(matrix, std::span<const double>(x));
+
+        CHECK(MatrixOps<double>::multiply(view, std::span<const double>(x)) == expected);
+        execution::ThreadPool pool(3);
+        for (auto strategy : {PartitionStrategy::rows, PartitionStrategy::nnz, PartitionStrategy::merge_path}) {
+            std::vector<double> y(300, 1.0);
+            MatrixOps<double>::multiply_parallel(view, std::span<const double>(x), std::span<double>(y),
+                                                 pool, 1.0, 0.0, strategy);
+            for (std::size_t i = 0; i < y.size(); ++i) {
+                CHECK(y[i] == doctest::Approx(expected[i]));
+            }
+        }
+    }
+
+    TEST_CASE("map options and view lifetime") {
+        const auto matrix = make_irregular<SparseMatrix<float>>(100, 100, {5});
+        TempFile file("options", ".bin");
+        io::write_binary(matrix, file.path);
+
+        for (auto access : {io::AccessPattern::normal, io::AccessPattern::sequential, io::AccessPattern::random}) {
+            io::MapOptions options;
+            options.access = access;
+            options.prefetch = true;
+            options.populate = true;
+            options.huge_pages = true;
+            options.verify = false;
+            CHECK(same_entries(io::map_binary<float>(file.path, options), matrix));
+        }
+
+        // Copies share the mapping, which outlives the original view
+        std::optional<SparseMatrixView<float>> copy;
+        {
+            const auto view = io::map_binary<float>(file.path);
+            copy.emplace(view);
+        }
+        CHECK(same_entries(*copy, matrix));
+    }
+
+    TEST_CASE("view of an in-memory matrix") {
+        const auto matrix = make_irregular<SparseMatrix<double>>(20, 20, {5});
+        const SparseMatrixView<double> view(matrix);
+        CHECK(same_entries(view, matrix));
+        CHECK(view.values().data() == matrix.raw_data().values.data());
+        CHECK_NOTHROW(view.validate_structure());
+        CHECK_THROWS_AS(static_cast<void>(view.row_values(20)), std::out_of_range);
+        CHECK_THROWS_AS(static_cast<void>(view(0, 20)), std::out_of_range);
+
+        const std::vector<std::size_t> row_ptrs{0, 2, 1};
+        const std::vector<std::size_t> cols{0, 1};
+        const std::vector<double> values{1.0, 2.0};
+        CHECK_THROWS_AS(SparseMatrixView<double>(3, 2, row_ptrs, cols, values), std::invalid_argument);
+        const std::vector<std::size_t> bad_ptrs{0, 2, 1, 2};
+        const SparseMatrixView<double> unsorted(3, 2, bad_ptrs, cols, values);
+        CHECK_THROWS_AS(unsorted.validate_structure(), std::invalid_argument);
+    }
+
+    TEST_CASE("corrupt and mismatched files are rejected") {
+        const auto matrix = make_irregular<SparseMatrix<double>>(40, 30, {5});
+        TempFile file("corrupt", ".bin");
+        auto fresh = [&] { io::write_binary(matrix, file.path); };
+
+        fresh();
+        CHECK_THROWS_AS(static_cast<void>(io::map_binary<float>(file.path)), std::runtime_error);
+        CHECK_THROWS_AS(static_cast<void>(io::map_binary<double, std::uint32_t>(file.path)), std::runtime_error);
+
+        patch(file.path, 0, 'X');
+        CHECK_THROWS_AS(static_cast<void>(io::map_binary<double>(file.path)), std::runtime_error);
+
+        fresh();
+        patch(file.path, static_cast<std::streamoff>(offsetof(io::BinaryHeader, version)), std::uint32_t{2});
+        CHECK_THROWS_AS(static_cast<void>(io::map_binary<double>(file.path)), std::runtime_error);
+
+        fresh();
+        patch(file.path, static_cast<std::streamoff>(offsetof(io::BinaryHeader, byte_order)), std::uint32_t{0x04030201});
+        try {
+            static_cast<void>(io::map_binary<double>(file.path));
+            CHECK(false);
+        } catch (const std::runtime_error& error) {
+            CHECK(std::string(error.what()) == "Binary matrix was written with the other byte order");
+        }
+
+        fresh();
+        patch(file.path, static_cast<std::streamoff>(offsetof(io::BinaryHeader, nnz)), std::uint64_t{1} << 62);
+        CHECK_THROWS_AS(static_cast<void>(io::map_binary<double>(file.path)), std::runtime_error);
+
+        fresh();
+        std::filesystem::resize_file(file.path, std::filesystem::file_size(file.path) - 8);
+        CHECK_THROWS_AS(static_cast<void>(io::map_binary<double>(file.path)), std::runtime_error);
+
+        // A column index past the end is only caught by verification
+        fresh();
+        const auto header = io::detail::make_header<double, std::size_t, std::size_t>(40, 30, matrix.nnz());
+        patch(file.path, static_cast<std::streamoff>(header.col_indices_offset), std::size_t{1000});
+        CHECK_THROWS_AS(static_cast<void>(io::map_binary<double>(file.path)), std::invalid_argument);
+        io::MapOptions trusted;
+        trusted.verify = false;
+        CHECK_NOTHROW(static_cast<void>(io::map_binary<double>(file.path, trusted)));
+        CHECK_THROWS_AS(static_cast<void>(io::read_binary<double>(file.path)), std::invalid_argument);
+
+        CHECK_THROWS_AS(static_cast<void>(io::map_binary<double>(file.path.string() + ".missing")), std::system_error);
+        CHECK_THROWS_AS(io::write_binary(matrix, std::filesystem::path("/nonexistent_dir/matrix.bin")), std::system_error);
+    }
+
+    TEST_CASE("empty matrix") {
+        const SparseMatrix<double> matrix(0, 0);
+        TempFile file("empty", ".bin");
+        io::write_binary(matrix, file.path);
+        const auto view = io::map_binary<double>(file.path);
+        CHECK(view.rows() == 0);
+        CHECK(view.nnz() == 0);
+    }
+}
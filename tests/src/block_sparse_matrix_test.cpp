@@ -0,0 +1,230 @@
+#include <doctest/doctest.h>
+#include "test_helpers.hpp"
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/core/block_sparse_matrix.hpp>
+#include <sparse_linalg/core/matrix_ops.hpp>
+#include <sparse_linalg/core/sparse_matrix_builder.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace sparse_linalg;
+using namespace sparse_linalg::test;
+
+namespace {
+    // Block tridiagonal matrix of dense b x b blocks, as from a mesh with b
+    // unknowns per node, plus a few scattered entries that force partial
+    // blocks. extra_rows / extra_cols leave ragged edge blocks.
+    template<typename Matrix>
+    Matrix make_blocked(std::size_t nodes, std::size_t b, std::size_t extra_rows = 0, std::size_t extra_cols = 0) {
+        using Value = typename Matrix::value_type;
+        const std::size_t rows = nodes * b + extra_rows;
+        const std::size_t cols = nodes * b + extra_cols;
+        SparseMatrixBuilder<Value, typename Matrix::index_type, typename Matrix::offset_type> builder(rows, cols);
+        for (std::size_t node = 0; node < nodes; ++node) {
+            for (std::size_t other = node == 0 ? 0 : node - 1; other <= std::min(node + 1, nodes - 1); ++other) {
+                for (std::size_t i = 0; i < b; ++i) {
+                    for (std::size_t j = 0; j < b; ++j) {
+                        const auto value = static_cast<Value>((node * 5 + other * 3 + i * 2 + j) % 11 + 1) / Value{8};
+                        builder.add(node * b + i, other * b + j, value);
+                    }
+                }
+            }
+        }
+        for (std::size_t row = 0; row < rows; row += 7) {
+            builder.add(row, (row * 13) % cols, Value{1});
+        }
+        for (std::size_t row = nodes * b; row < rows; ++row) {
+            builder.add(row, cols - 1, Value{2});
+            builder.add(row, row % cols, Value{3});
+        }
+        return builder.build();
+    }
+}
+
+TEST_SUITE("BlockSparseMatrix") {
+    TEST_CASE("block layout") {
+        // [1 2 . .]
+        // [. 3 . 4]
+        // [. . . .]
+        SparseMatrix<double> csr(3, 4);
+        csr.insert(0, 0, 1.0);
+        csr.insert(0, 1, 2.0);
+        csr.insert(1, 1, 3.0);
+        csr.insert(1, 3, 4.0);
+
+        const BlockSparseMatrix<double, 2, 2> bsr(csr);
+        CHECK(bsr.block_rows() == 2);
+        CHECK(bsr.block_cols() == 2);
+        CHECK(bsr.nnz() == 4);
+        REQUIRE(bsr.blocks() == 2);
+        CHECK(bsr.stored() == 8);
+        CHECK(bsr.block_row_ptrs()[1] == 2);
+        CHECK(bsr.block_row_ptrs()[2] == 2);
+        CHECK(bsr.block_col_indices()[0] == 0);
+        CHECK(bsr.block_col_indices()[1] == 1);
+
+        // Column-major within a block
+        const auto first = bsr.block(0);
+        CHECK(first[0] == 1.0);
+        CHECK(first[1] == 0.0);
+        CHECK(first[2] == 2.0);
+        CHECK(first[3] == 3.0);
+        const auto second = bsr.block(1);
+        CHECK(second[2] == 0.0);
+        CHECK(second[3] == 4.0);
+        CHECK_THROWS_AS(static_cast<void>(bsr.block(2)), std::out_of_range);
+    }
+
+    TEST_CASE_TEMPLATE("entries match the CSR matrix", Bsr,
+                       BlockSparseMatrix<double, 3, 3>,
+                       BlockSparseMatrix<double, 2, 5>,
+                       BlockSparseMatrix<float, 4, 4, std::uint32_t, std::uint32_t>,
+                       BlockSparseMatrix<int, 1, 1, std::int32_t, std::int32_t>) {
+        using Value = typename Bsr::value_type;
+        using Csr = SparseMatrix<Value, typename Bsr::index_type, typename Bsr::offset_type>;
+        const auto csr = make_blocked<Csr>(13, 3, 2, 1);
+        execution::ThreadPool pool(4);
+
+        for (const auto& bsr : {Bsr(csr), Bsr(csr, pool)}) {
+            REQUIRE(bsr.rows() == csr.rows());
+            REQUIRE(bsr.cols() == csr.cols());
+            CHECK(bsr.nnz() == csr.nnz());
+            CHECK(bsr.stored() >= csr.nnz());
+            CHECK(bsr.stored() == bsr.blocks() * Bsr::block_size);
+            for (std::size_t i = 0; i < csr.rows(); ++i) {
+                for (std::size_t j = 0; j < csr.cols(); ++j) {
+                    CHECK(bsr(i, j) == csr(i, j));
+                }
+            }
+        }
+        const Bsr bsr(csr);
+        CHECK_THROWS_AS(static_cast<void>(bsr(csr.rows(), 0)), std::out_of_range);
+    }
+
+    TEST_CASE_TEMPLATE("product matches CSR", Bsr,
+                       BlockSparseMatrix<double, 1, 1>,
+                       BlockSparseMatrix<double, 2, 2>,
+                       BlockSparseMatrix<double, 3, 3>,
+                       BlockSparseMatrix<double, 4, 4>,
+                       BlockSparseMatrix<double, 8, 8>,
+                       BlockSparseMatrix<double, 3, 2>,
+                       BlockSparseMatrix<double, 6, 1>,
+                       BlockSparseMatrix<double, 40, 2>,
+                       BlockSparseMatrix<float, 3, 3>,
+                       BlockSparseMatrix<float, 8, 4, std::uint32_t, std::uint32_t>,
+                       BlockSparseMatrix<float, 16, 2>) {
+        using Value = typename Bsr::value_type;
+        using Csr = SparseMatrix<Value, typename Bsr::index_type, typename Bsr::offset_type>;
+        // Ragged edges in both directions
+        const auto csr = make_blocked<Csr>(17, Bsr::block_rows_per, 3, 5);
+        const auto x = make_vector<Value>(csr.cols());
+        const auto expected = MatrixOps<Value>::multiply(csr, std::span<const Value>(x));
+        const Bsr bsr(csr);
+        execution::ThreadPool pool(3);
+
+        check_close(MatrixOps<Value>::multiply(bsr, std::span<const Value>(x)), expected);
+
+        std::vector<Value> y(csr.rows(), Value{5});
+        MatrixOps<Value>::multiply_parallel(bsr, std::span<const Value>(x), std::span<Value>(y), pool);
+        check_close(y, expected);
+
+        // Every kernel the host can run
+        for (auto level : {execution::SimdLevel::scalar, execution::SimdLevel::avx2, execution::SimdLevel::avx512}) {
+            if (level > execution::active_simd_level()) {
+                continue;
+            }
+            using Kernel = detail::BsrKernel<Value, Bsr::block_rows_per, Bsr::block_cols_per,
+                                             typename Bsr::index_type, typename Bsr::offset_type>;
+            std::vector<Value> z(csr.rows());
+            Kernel::select(level)(detail::bsr_arrays(bsr), x.data(), z.data(), 0, bsr.block_rows(), Value{1}, Value{});
+            check_close(z, expected);
+        }
+    }
+
+    TEST_CASE("alpha and beta") {
+        const auto csr = make_blocked<SparseMatrix<double>>(20, 3);
+        const BlockSparseMatrix<double, 3, 3> bsr(csr);
+        const auto x = make_vector<double>(csr.cols());
+        const auto ax = MatrixOps<double>::multiply(csr, std::span<const double>(x));
+        execution::ThreadPool pool(2);
+
+        std::vector<double> expected(csr.rows());
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            expected[i] = 2.0 * ax[i] + 0.5;
+        }
+        std::vector<double> y(csr.rows(), 1.0);
+        MatrixOps<double>::multiply(bsr, std::span<const double>(x), std::span<double>(y), 2.0, 0.5);
+        check_close(y, expected);
+        std::vector<double> z(csr.rows(), 1.0);
+        MatrixOps<double>::multiply_parallel(bsr, std::span<const double>(x), std::span<double>(z), pool, 2.0, 0.5);
+        check_close(z, expected);
+
+        MatrixOps<double>::multiply(bsr, std::span<const double>(x), std::span<double>(z), 0.0, -1.0);
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            CHECK(z[i] == -expected[i]);
+        }
+    }
+
+    TEST_CASE("block size detection") {
+        for (std::size_t b : {std::size_t{2}, std::size_t{3}, std::size_t{4}}) {
+            const auto csr = make_blocked<SparseMatrix<double>>(50, b);
+            const auto shape = detect_block_size(csr);
+            CHECK(shape.rows == b);
+            CHECK(shape.cols == b);
+            CHECK(shape.fill >= 1.0);
+            CHECK(shape.fill < 1.2);
+            CHECK(shape.blocks == detail::count_blocks(csr, b, b));
+        }
+
+        // Scattered entries: blocking would store mostly zeros
+        SparseMatrixBuilder<double> builder(200, 200);
+        for (std::size_t i = 0; i < 200; ++i) {
+            builder.add(i, (i * 37) % 200, 1.0);
+            builder.add(i, (i * 91 + 5) % 200, 1.0);
+        }
+        const auto scattered = builder.build();
+        const auto shape = detect_block_size(scattered);
+        CHECK(shape.rows == 1);
+        CHECK(shape.blocks == scattered.nnz());
+
+        CHECK(detect_block_size(SparseMatrix<double>(5, 5)).rows == 1);
+    }
+
+    TEST_CASE("with_block_format converts to the detected size") {
+        const auto csr = make_blocked<SparseMatrix<double>>(30, 3, 1, 0);
+        const auto x = make_vector<double>(csr.cols());
+        const auto expected = MatrixOps<double>::multiply(csr, std::span<const double>(x));
+
+        const auto [block_rows, y] = with_block_format(csr, [&x](const auto& matrix) {
+            using Matrix = std::remove_cvref_t<decltype(matrix)>;
+            std::size_t rows_per = 1;
+            if constexpr (requires { Matrix::block_rows_per; }) {
+                rows_per = Matrix::block_rows_per;
+            }
+            return std::pair{rows_per, MatrixOps<double>::multiply(matrix, std::span<const double>(x))};
+        });
+        CHECK(block_rows == 3);
+        check_close(y, expected);
+    }
+
+    TEST_CASE("dimension errors") {
+        const auto csr = make_blocked<SparseMatrix<double>>(4, 2);
+        const BlockSparseMatrix<double, 2, 2> bsr(csr);
+        std::vector<double> x(csr.cols() + 1);
+        std::vector<double> y(csr.rows());
+        CHECK_THROWS_AS(static_cast<void>(MatrixOps<double>::multiply(bsr, std::span<const double>(x))),
+                        std::invalid_argument);
+        x.pop_back();
+        y.pop_back();
+        CHECK_THROWS_AS(MatrixOps<double>::multiply(bsr, std::span<const double>(x), std::span<double>(y)),
+                        std::invalid_argument);
+
+        const BlockSparseMatrix<double, 2, 2> empty(SparseMatrix<double>(0, 0));
+        CHECK(empty.blocks() == 0);
+        CHECK(MatrixOps<double>::multiply(empty, std::span<const double>()).empty());
+    }
+}
@@ -0,0 +1,118 @@
+#include <doctest/doctest.h>
+#include "test_helpers.hpp"
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/solvers/conjugate_gradient.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <cstdint>
+#include <vector>
+
+using namespace sparse_linalg;
+using namespace sparse_linalg::test;
+
+TEST_SUITE("ConjugateGradient") {
+    TEST_CASE_TEMPLATE("solves the Poisson problem", T, float, double) {
+        const auto a = make_stencil<T, std::uint32_t, std::uint32_t>(24);
+        const auto b = make_vector<T>(a.rows());
+        const double tolerance = std::is_same_v<T, float> ? 1e-5 : 1e-10;
+
+        ConjugateGradient<T, std::uint32_t, std::uint32_t> cg({.max_iterations = 500, .tolerance = tolerance});
+        std::vector<T> x(a.rows(), T{});
+        const auto report = cg.solve(a, b, x);
+
+        CHECK(report.converged());
+        CHECK(report.iterations > 0);
+        CHECK(report.residual_norm <= tolerance);
+        REQUIRE(report.residual_history.size() == report.iterations + 1);
+        CHECK(report.residual_history.front() == doctest::Approx(1.0));
+        CHECK(report.residual_history.back() == report.residual_norm);
+        CHECK(relative_residual(a, b, x) <= 10 * tolerance);
+
+        CHECK(report.timings.total >= report.timings.spmv + report.timings.vector_updates);
+        CHECK(report.timings.spmv.count() > 0);
+    }
+
+    TEST_CASE("parallel solve matches the sequential one") {
+        const auto a = make_stencil<double>(40);
+        const auto b = make_vector<double>(a.rows());
+        execution::ThreadPool pool(4);
+
+        ConjugateGradient<double> cg;
+        std::vector<double> sequential(a.rows(), 0.0);
+        std::vector<double> parallel(a.rows(), 0.0);
+        const auto seq_report = cg.solve(a, b, sequential);
+        const auto par_report = cg.solve(a, b, parallel, pool);
+
+        CHECK(seq_report.converged());
+        CHECK(par_report.converged());
+        CHECK(par_report.iterations <= seq_report.iterations + 2);
+        CHECK(relative_residual(a, b, parallel) <= 1e-7);
+        for (std::size_t i = 0; i < a.rows(); ++i) {
+            CHECK(parallel[i] == doctest::Approx(sequential[i]).epsilon(1e-6));
+        }
+
+        // Same pool, same split: bit-identical reruns
+        std::vector<double> again(a.rows(), 0.0);
+        const auto again_report = cg.solve(a, b, again, pool);
+        CHECK(again_report.iterations == par_report.iterations);
+        CHECK(again == parallel);
+    }
+
+    TEST_CASE("warm start and iteration limit") {
+        const auto a = make_stencil<double>(16);
+        const auto b = make_vector<double>(a.rows());
+        ConjugateGradient<double> cg({.max_iterations = 3, .tolerance = 1e-12, .record_history = false});
+
+        std::vector<double> x(a.rows(), 0.0);
+        auto report = cg.solve(a, b, x);
+        CHECK(report.status == SolverStatus::max_iterations);
+        CHECK(report.iterations == 3);
+        CHECK(report.residual_history.empty());
+        const double after_three = report.residual_norm;
+
+        // Continuing from x picks up where the last solve stopped
+        report = cg.solve(a, b, x);
+        CHECK(report.residual_norm < after_three);
+
+        ConjugateGradient<double> exact({.tolerance = 1e-12});
+        report = exact.solve(a, b, x);
+        CHECK(report.converged());
+        const auto reached = x;
+        report = exact.solve(a, b, x);
+        CHECK(report.iterations == 0);
+        CHECK(x == reached);
+    }
+
+    TEST_CASE("zero right-hand side") {
+        const auto a = make_stencil<double>(4);
+        std::vector<double> b(a.rows(), 0.0);
+        std::vector<double> x(a.rows(), 3.0);
+        ConjugateGradient<double> cg;
+        const auto report = cg.solve(a, b, x);
+        CHECK(report.converged());
+        CHECK(report.iterations == 0);
+        CHECK(x == std::vector<double>(a.rows(), 0.0));
+    }
+
+    TEST_CASE("indefinite matrices break down") {
+        SparseMatrix<double> a(2, 2);
+        a.insert(0, 0, 1.0);
+        a.insert(1, 1, -1.0);
+        std::vector<double> b{1.0, 1.0};
+        std::vector<double> x(2, 0.0);
+        ConjugateGradient<double> cg;
+        CHECK(cg.solve(a, b, x).status == SolverStatus::breakdown);
+    }
+
+    TEST_CASE("argument errors") {
+        CHECK_THROWS_AS(ConjugateGradient<double>({.tolerance = -1.0}), std::invalid_argument);
+
+        ConjugateGradient<double> cg;
+        SparseMatrix<double> rectangular(3, 2);
+        std::vector<double> b(3);
+        std::vector<double> x(2);
+        CHECK_THROWS_AS(cg.solve(rectangular, b, x), std::invalid_argument);
+
+        SparseMatrix<double> square(3, 3);
+        CHECK_THROWS_AS(cg.solve(square, b, x), std::invalid_argument);
+    }
+}
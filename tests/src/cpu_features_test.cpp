@@ -0,0 +1,32 @@
+#include <doctest/doctest.h>
+#include <sparse_linalg/execution/cpu_features.hpp>
+
+using namespace sparse_linalg::execution;
+
+TEST_SUITE("CpuFeatures") {
+    TEST_CASE("detected level matches feature flags") {
+        const auto features = detect_cpu_features();
+        const auto level = detected_simd_level();
+        
+        if (level >= SimdLevel::avx2) {
+            CHECK(features.avx2);
+            CHECK(features.fma);
+            CHECK(features.f16c);
+        }
+        if (level == SimdLevel::avx512) {
+            CHECK(features.avx512f);
+        }
+        CHECK(detected_simd_level() == level);
+    }
+    
+    TEST_CASE("active level never exceeds detected level") {
+        CHECK(active_simd_level() <= detected_simd_level());
+    }
+    
+    TEST_CASE("level names") {
+        CHECK(detail::parse_simd_level("scalar", SimdLevel::avx512) == SimdLevel::scalar);
+        CHECK(detail::parse_simd_level("avx2", SimdLevel::scalar) == SimdLevel::avx2);
+        CHECK(detail::parse_simd_level("avx512", SimdLevel::scalar) == SimdLevel::avx512);
+        CHECK(detail::parse_simd_level("sse9", SimdLevel::avx2) == SimdLevel::avx2);
+    }
+}
@@ -0,0 +1,143 @@
+#include <doctest/doctest.h>
+#include "test_helpers.hpp"
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/core/csc_matrix.hpp>
+#include <sparse_linalg/core/matrix_ops.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <cstdint>
+#include <limits>
+
+using namespace sparse_linalg;
+using namespace sparse_linalg::test;
+
+TEST_SUITE("CscMatrix") {
+    TEST_CASE_TEMPLATE("column access matches the CSR matrix", Matrix,
+                       SparseMatrix<double>,
+                       SparseMatrix<float, std::uint32_t, std::uint32_t>,
+                       SparseMatrix<int, std::int16_t, std::int32_t>) {
+        using Value = typename Matrix::value_type;
+        using Csc = CscMatrix<Value, typename Matrix::index_type, typename Matrix::offset_type>;
+        const auto csr = make_irregular<Matrix>(31, 17, {3, 9, 4, 17});
+        execution::ThreadPool pool(4);
+
+        for (const auto& csc : {Csc(csr), Csc(csr, pool)}) {
+            REQUIRE(csc.rows() == csr.rows());
+            REQUIRE(csc.cols() == csr.cols());
+            REQUIRE(csc.nnz() == csr.nnz());
+            for (std::size_t j = 0; j < csr.cols(); ++j) {
+                auto rows = csc.col_indices(j);
+                auto values = csc.col_values(j);
+                REQUIRE(rows.size() == values.size());
+                for (std::size_t k = 0; k < rows.size(); ++k) {
+                    if (k > 0) {
+                        CHECK(rows[k - 1] < rows[k]);
+                    }
+                    CHECK(values[k] == csr(static_cast<std::size_t>(rows[k]), j));
+                }
+            }
+            for (std::size_t i = 0; i < csr.rows(); ++i) {
+                for (std::size_t j = 0; j < csr.cols(); ++j) {
+                    CHECK(csc(i, j) == csr(i, j));
+                }
+            }
+        }
+    }
+
+    TEST_CASE("transpose") {
+        const auto matrix = make_irregular<SparseMatrix<double>>(40, 23, {3, 9, 4, 23});
+        execution::ThreadPool pool(3);
+
+        auto sequential = MatrixOps<double>::transpose(matrix);
+        auto parallel = MatrixOps<double>::transpose(matrix, pool);
+        REQUIRE(sequential.rows() == 23);
+        REQUIRE(sequential.cols() == 40);
+        CHECK(sequential.raw_data().col_indices == parallel.raw_data().col_indices);
+        CHECK(sequential.raw_data().values == parallel.raw_data().values);
+        CHECK(sequential.raw_data().row_ptrs == parallel.raw_data().row_ptrs);
+
+        for (std::size_t i = 0; i < matrix.rows(); ++i) {
+            for (std::size_t j = 0; j < matrix.cols(); ++j) {
+                CHECK(sequential(j, i) == matrix(i, j));
+            }
+        }
+
+        auto round_trip = MatrixOps<double>::transpose(sequential, pool);
+        CHECK(round_trip.raw_data().col_indices == matrix.raw_data().col_indices);
+        CHECK(round_trip.raw_data().values == matrix.raw_data().values);
+    }
+
+    TEST_CASE("transpose rejects row counts the index type cannot hold") {
+        SparseMatrix<double, std::uint8_t, std::uint32_t> tall(300, 2);
+        CHECK_THROWS_AS(static_cast<void>(MatrixOps<double>::transpose(tall)), std::overflow_error);
+    }
+
+    TEST_CASE("empty matrices") {
+        SparseMatrix<double> empty(0, 5);
+        auto t = MatrixOps<double>::transpose(empty);
+        CHECK(t.rows() == 5);
+        CHECK(t.cols() == 0);
+        CscMatrix<double> csc(SparseMatrix<double>(4, 0));
+        CHECK(csc.nnz() == 0);
+    }
+}
+
+TEST_SUITE("TransposeMultiply") {
+    TEST_CASE_TEMPLATE("A^T x matches the materialized transpose", Value, float, double) {
+        const auto matrix = make_irregular<SparseMatrix<Value, std::uint32_t, std::uint64_t>>(57, 33, {3, 9, 4, 33});
+        const auto transposed = MatrixOps<Value>::transpose(matrix);
+
+        std::vector<Value> x(matrix.rows());
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            x[i] = static_cast<Value>(i % 5) - Value{2};
+        }
+        std::vector<Value> y0(matrix.cols());
+        for (std::size_t j = 0; j < y0.size(); ++j) {
+            y0[j] = static_cast<Value>(j % 3);
+        }
+
+        const auto atx = MatrixOps<Value>::multiply(transposed, x);
+        CHECK(MatrixOps<Value>::multiply_transpose(matrix, x) == atx);
+
+        execution::ThreadPool pool(4);
+        for (auto scatter : {TransposeScatter::private_buffers, TransposeScatter::atomics}) {
+            std::vector<Value> seq = y0;
+            std::vector<Value> par = y0;
+            MatrixOps<Value>::multiply_transpose(matrix, x, seq, Value{2}, Value{-1});
+            MatrixOps<Value>::multiply_transpose_parallel(matrix, x, par, pool, Value{2}, Value{-1}, scatter);
+            for (std::size_t j = 0; j < y0.size(); ++j) {
+                const double expected = 2.0 * static_cast<double>(atx[j]) - static_cast<double>(y0[j]);
+                CHECK(static_cast<double>(seq[j]) == doctest::Approx(expected).epsilon(1e-5));
+                CHECK(static_cast<double>(par[j]) == doctest::Approx(expected).epsilon(1e-5));
+            }
+        }
+    }
+
+    TEST_CASE("beta == 0 never reads y and alpha == 0 only scales") {
+        const auto matrix = make_irregular<SparseMatrix<double>>(20, 12, {3, 9, 4, 12});
+        const std::vector<double> x(20, 1.0);
+        const auto expected = MatrixOps<double>::multiply_transpose(matrix, x);
+        execution::ThreadPool pool(2);
+
+        for (auto scatter : {TransposeScatter::private_buffers, TransposeScatter::atomics}) {
+            std::vector<double> y(12, std::numeric_limits<double>::quiet_NaN());
+            MatrixOps<double>::multiply_transpose_parallel(matrix, x, y, pool, 1.0, 0.0, scatter);
+            CHECK(y == expected);
+        }
+
+        std::vector<double> y(12, 2.0);
+        MatrixOps<double>::multiply_transpose_parallel(matrix, x, y, pool, 0.0, 0.5);
+        CHECK(y == std::vector<double>(12, 1.0));
+    }
+
+    TEST_CASE("transpose multiply dimension errors") {
+        SparseMatrix<double> matrix(3, 2);
+        std::vector<double> x(2);
+        std::vector<double> y(2);
+        CHECK_THROWS_AS(static_cast<void>(MatrixOps<double>::multiply_transpose(matrix, x)), std::invalid_argument);
+        std::vector<double> x3(3);
+        std::vector<double> y3(3);
+        CHECK_THROWS_AS(MatrixOps<double>::multiply_transpose(matrix, x3, y3), std::invalid_argument);
+        execution::ThreadPool pool(2);
+        CHECK_THROWS_AS(MatrixOps<double>::multiply_transpose_parallel(matrix, x, y, pool), std::invalid_argument);
+    }
+}
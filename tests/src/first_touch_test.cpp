@@ -0,0 +1,111 @@
+#include <doctest/doctest.h>
+#include "test_helpers.hpp"
+#include <sparse_linalg/core/first_touch.hpp>
+#include <sparse_linalg/core/matrix_generators.hpp>
+#include <sparse_linalg/core/matrix_ops.hpp>
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <sparse_linalg/execution/topology.hpp>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+using namespace sparse_linalg;
+using namespace sparse_linalg::test;
+
+namespace {
+    // Two emulated nodes of two CPUs each, whatever the machine has
+    execution::ThreadPool pinned_pool() {
+        return execution::ThreadPool(4, execution::ThreadAffinity::cores, execution::CpuTopology::emulated(2, 2));
+    }
+}
+
+TEST_SUITE("FirstTouch") {
+    TEST_CASE("released pages read back as zeros") {
+        // Large enough to span several whole pages wherever it lands
+        std::vector<double> data(1 << 16, 3.0);
+        detail::release_pages(data);
+        std::size_t zeros = 0;
+        for (double v : data) {
+            if (v == 0.0) {
+                ++zeros;
+            } else {
+                REQUIRE(v == 3.0);  // partial pages at either end keep their contents
+            }
+        }
+        CHECK(zeros >= data.size() - 2 * 4096);
+        std::vector<double> tiny(3, 1.0);
+        detail::release_pages(tiny);
+        CHECK(tiny == std::vector<double>{1.0, 1.0, 1.0});
+    }
+
+    TEST_CASE("first_touch_copy matches the source") {
+        auto pool = pinned_pool();
+        const auto a = power_law_rows<double, std::uint32_t, std::uint64_t>(20000, 4000, 0.7);
+        for (auto strategy : {PartitionStrategy::rows, PartitionStrategy::nnz, PartitionStrategy::merge_path}) {
+            const auto placed = first_touch_copy(a, pool, strategy);
+            CHECK(same_entries(a, placed));
+            // The plan used for placement is cached for multiply_parallel
+            const auto plan = placed.partition_plan(strategy, pool.thread_count());
+            CHECK(plan == placed.partition_plan(strategy, pool.thread_count()));
+
+            const auto x = first_touch_vector(placed, placed.cols(), 1.0, pool, strategy);
+            auto y = first_touch_vector(placed, placed.rows(), 0.0, pool, strategy);
+            MatrixOps<double>::multiply_parallel(placed, std::span<const double>(x), std::span<double>(y), pool,
+                                                 1.0, 0.0, strategy);
+            // Merge-path spans split rows, which changes the order of the sums
+            const auto expected = MatrixOps<double>::multiply(a, std::span<const double>(x));
+            std::size_t wrong = 0;
+            for (std::size_t i = 0; i < y.size(); ++i) {
+                if (y[i] != doctest::Approx(expected[i])) {
+                    ++wrong;
+                }
+            }
+            CHECK(wrong == 0);
+        }
+
+        const SparseMatrix<double> empty(0, 5);
+        CHECK(first_touch_copy(empty, pool).rows() == 0);
+    }
+
+    TEST_CASE("first_touch_vector") {
+        auto pool = pinned_pool();
+        CHECK(first_touch_vector(100000, 2.5f, pool) == std::vector<float>(100000, 2.5f));
+        CHECK(first_touch_vector(3, 7, pool) == std::vector<int>(3, 7));
+        CHECK(first_touch_vector(0, 1.0, pool).empty());
+
+        // Sized differently from the matrix rows: split in proportion
+        const auto a = banded(1000, 2, 2);
+        CHECK(first_touch_vector(a, 4321, 1.5, pool) == std::vector<double>(4321, 1.5));
+        const auto plan = a.partition_plan(PartitionStrategy::nnz, 4);
+        const auto bounds = detail::span_bounds(*plan, 1000, 2000);
+        REQUIRE(bounds.size() == 5);
+        for (std::size_t i = 0; i < 4; ++i) {
+            CHECK(bounds[i] == 2 * plan->spans[i].row_begin);
+        }
+        CHECK(bounds[4] == 2000);
+    }
+
+    TEST_CASE("pinned pools give the same results") {
+        auto pool = pinned_pool();
+        execution::ThreadPool unpinned(4);
+        // Generated on the pinned pool: each span filled by its worker
+        const auto a = poisson_2d<double, std::uint32_t, std::uint32_t>(120, 90, pool);
+        CHECK(same_entries(a, poisson_2d<double, std::uint32_t, std::uint32_t>(120, 90)));
+        CHECK(same_entries(banded(5000, 3, 4, pool), banded(5000, 3, 4)));
+
+        std::vector<double> x(a.cols());
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            x[i] = static_cast<double>(i % 17) - 8.0;
+        }
+        std::vector<double> pinned_y(a.rows());
+        std::vector<double> unpinned_y(a.rows());
+        for (auto strategy : {PartitionStrategy::nnz, PartitionStrategy::merge_path}) {
+            MatrixOps<double>::multiply_parallel(a, std::span<const double>(x), std::span<double>(pinned_y), pool,
+                                                 1.0, 0.0, strategy);
+            MatrixOps<double>::multiply_parallel(a, std::span<const double>(x), std::span<double>(unpinned_y),
+                                                 unpinned, 1.0, 0.0, strategy);
+            CHECK(pinned_y == unpinned_y);
+        }
+    }
+}
@@ -0,0 +1,174 @@
+#include <doctest/doctest.h>
+#include "test_helpers.hpp"
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/solvers/gmres.hpp>
+#include <sparse_linalg/solvers/preconditioner.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using namespace sparse_linalg;
+using namespace sparse_linalg::test;
+
+namespace {
+    // Right-hand sides shifted from the CG tests' so the two solvers do not
+    // start every Krylov space from the same vector
+    constexpr std::size_t rhs_seed = 7;
+
+    // Inverse of the diagonal, counting its applications
+    struct DiagonalScaling {
+        std::vector<double> inverse;
+        int applications = 0;
+
+        explicit DiagonalScaling(const SparseMatrix<double>& a) : inverse(a.rows()) {
+            for (std::size_t i = 0; i < a.rows(); ++i) {
+                inverse[i] = 1.0 / a(i, i);
+            }
+        }
+
+        void apply(std::span<const double> in, std::span<double> out) {
+            ++applications;
+            for (std::size_t i = 0; i < in.size(); ++i) {
+                out[i] = inverse[i] * in[i];
+            }
+        }
+    };
+
+    // Identity that records where each vector it is applied to lives
+    struct AddressRecorder {
+        std::vector<const double*> inputs;
+
+        void apply(std::span<const double> in, std::span<double> out) {
+            inputs.push_back(in.data());
+            std::copy(in.begin(), in.end(), out.begin());
+        }
+    };
+
+    static_assert(Preconditioner<IdentityPreconditioner, double>);
+    static_assert(Preconditioner<DiagonalScaling, double>);
+    static_assert(!Preconditioner<DiagonalScaling, float>);
+    static_assert(!Preconditioner<std::vector<double>, double>);
+}
+
+TEST_SUITE("GMRES") {
+    TEST_CASE("every Gram-Schmidt variant converges on a nonsymmetric system") {
+        const auto a = make_stencil(20, 2.0);
+        const auto b = make_vector<double>(a.rows(), rhs_seed);
+        execution::ThreadPool pool(3);
+
+        for (auto variant : {GramSchmidt::modified, GramSchmidt::classical, GramSchmidt::classical_twice}) {
+            Gmres<double> gmres({.max_iterations = 400, .tolerance = 1e-10}, {.restart = 20, .gram_schmidt = variant});
+            std::vector<double> sequential(a.rows(), 0.0);
+            std::vector<double> parallel(a.rows(), 0.0);
+            const auto seq_report = gmres.solve(a, b, sequential);
+            const auto par_report = gmres.solve(a, b, parallel, pool);
+
+            CHECK(seq_report.converged());
+            CHECK(par_report.converged());
+            CHECK(relative_residual(a, b, sequential) <= 1e-9);
+            CHECK(relative_residual(a, b, parallel) <= 1e-9);
+            REQUIRE(seq_report.residual_history.size() == seq_report.iterations + 1);
+            CHECK(seq_report.timings.orthogonalization.count() > 0);
+            CHECK(seq_report.timings.preconditioner.count() == 0);
+
+            // The GMRES residual never grows within a cycle
+            for (std::size_t k = 1; k < seq_report.residual_history.size(); ++k) {
+                if (k % 20 != 0) {
+                    CHECK(seq_report.residual_history[k] <= seq_report.residual_history[k - 1] * (1 + 1e-12));
+                }
+            }
+        }
+    }
+
+    TEST_CASE("float systems") {
+        const auto a = make_stencil(12, 1.0f);
+        const auto b = make_vector<float>(a.rows(), rhs_seed);
+        Gmres<float> gmres({.tolerance = 1e-5}, {.restart = 15});
+        std::vector<float> x(a.rows(), 0.0f);
+        CHECK(gmres.solve(a, b, x).converged());
+        CHECK(relative_residual(a, b, x) <= 1e-4);
+    }
+
+    TEST_CASE("right preconditioning") {
+        const auto a = make_stencil(16, 3.0);
+        const auto b = make_vector<double>(a.rows(), rhs_seed);
+        DiagonalScaling jacobi(a);
+        execution::ThreadPool pool(2);
+
+        Gmres<double> gmres({.tolerance = 1e-10}, {.restart = 10});
+        std::vector<double> x(a.rows(), 0.0);
+        const auto report = gmres.solve(a, b, x, jacobi, pool);
+        CHECK(report.converged());
+        CHECK(relative_residual(a, b, x) <= 1e-9);
+        // One application per iteration plus one per solution update
+        CHECK(static_cast<std::size_t>(jacobi.applications) > report.iterations);
+        CHECK(report.timings.preconditioner.count() > 0);
+    }
+
+    TEST_CASE("restarts, iteration limit and warm start") {
+        const auto a = make_stencil(16, 1.0);
+        const auto b = make_vector<double>(a.rows(), rhs_seed);
+
+        Gmres<double> limited({.max_iterations = 7, .tolerance = 1e-12}, {.restart = 3});
+        std::vector<double> x(a.rows(), 0.0);
+        auto report = limited.solve(a, b, x);
+        CHECK(report.status == SolverStatus::max_iterations);
+        CHECK(report.iterations == 7);
+        CHECK(report.residual_norm == doctest::Approx(relative_residual(a, b, x)).epsilon(1e-6));
+
+        Gmres<double> full({.tolerance = 1e-12});
+        report = full.solve(a, b, x);
+        CHECK(report.converged());
+        report = full.solve(a, b, x);
+        CHECK(report.iterations == 0);
+    }
+
+    TEST_CASE("basis vectors start on cache lines") {
+        // 143 rows: not a whole number of lines, so padding is needed too
+        const auto a = make_stencil(11, 1.0);
+        const auto b = make_vector<double>(a.rows(), rhs_seed);
+        AddressRecorder recorder;
+        Gmres<double> gmres({.max_iterations = 12}, {.restart = 6});
+        std::vector<double> x(a.rows(), 0.0);
+        gmres.solve(a, b, x, recorder);
+        REQUIRE(recorder.inputs.size() >= 6);
+        std::size_t misaligned = 0;
+        for (const double* v : recorder.inputs) {
+            misaligned += reinterpret_cast<std::uintptr_t>(v) % 64 == 0 ? 0 : 1;
+        }
+        CHECK(misaligned == 0);
+    }
+
+    TEST_CASE("a restart longer than the system ends in one cycle") {
+        SparseMatrix<double> a(3, 3);
+        a.insert(0, 0, 2.0);
+        a.insert(0, 1, 1.0);
+        a.insert(1, 1, 3.0);
+        a.insert(2, 0, -1.0);
+        a.insert(2, 2, 1.0);
+        const std::vector<double> b{3.0, 3.0, 0.0};
+        std::vector<double> x(3, 0.0);
+
+        Gmres<double> gmres({.tolerance = 1e-14}, {.restart = 50});
+        const auto report = gmres.solve(a, b, x);
+        CHECK(report.converged());
+        CHECK(report.iterations <= 3);
+        CHECK(x[0] == doctest::Approx(1.0));
+        CHECK(x[1] == doctest::Approx(1.0));
+        CHECK(x[2] == doctest::Approx(1.0));
+    }
+
+    TEST_CASE("zero right-hand side and argument errors") {
+        const auto a = make_stencil(3, 1.0);
+        std::vector<double> b(a.rows(), 0.0);
+        std::vector<double> x(a.rows(), 1.0);
+        Gmres<double> gmres;
+        CHECK(gmres.solve(a, b, x).converged());
+        CHECK(x == std::vector<double>(a.rows(), 0.0));
+
+        CHECK_THROWS_AS(Gmres<double>({}, {.restart = 0}), std::invalid_argument);
+        std::vector<double> short_x(2);
+        CHECK_THROWS_AS(gmres.solve(a, b, short_x), std::invalid_argument);
+    }
+}
@@ -0,0 +1,204 @@
+#include <doctest/doctest.h>
+#include <sparse_linalg/execution/instrumentation.hpp>
+#include <sparse_linalg/core/matrix_generators.hpp>
+#include <sparse_linalg/core/matrix_ops.hpp>
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <future>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace sparse_linalg;
+using namespace sparse_linalg::execution;
+
+// Built twice: into sparse_linalg_tests with the project setting and into
+// sparse_linalg_instrumentation_tests with recording always compiled in
+static_assert(instrumentation_enabled || std::is_empty_v<execution::detail::KernelTimer>);
+static_assert(instrumentation_enabled || std::is_empty_v<execution::detail::TaskStamp>);
+// The setting is part of the names, so the two builds never share a definition
+#ifdef SPARSE_LINALG_ENABLE_INSTRUMENTATION
+static_assert(std::is_same_v<ThreadPool, execution::instrumented::ThreadPool>);
+static_assert(std::is_same_v<MatrixOps<double>, sparse_linalg::instrumented::MatrixOps<double>>);
+#else
+static_assert(std::is_same_v<ThreadPool, execution::uninstrumented::ThreadPool>);
+static_assert(std::is_same_v<MatrixOps<double>, sparse_linalg::uninstrumented::MatrixOps<double>>);
+#endif
+
+namespace {
+    const KernelMetrics* find_kernel(const MetricsSnapshot& snapshot, Kernel kernel) {
+        for (const auto& metrics : snapshot.kernels) {
+            if (metrics.kernel == kernel) {
+                return &metrics;
+            }
+        }
+        return nullptr;
+    }
+
+    bool contains(const std::string& text, const std::string& part) {
+        return text.find(part) != std::string::npos;
+    }
+}
+
+TEST_SUITE("Instrumentation") {
+    TEST_CASE("histogram buckets and quantiles") {
+        execution::detail::LatencyHistogram histogram;
+        for (std::uint64_t ns : {0u, 1u, 3u, 1000u}) {
+            histogram.record(ns);
+        }
+        const auto h = histogram.snapshot();
+        CHECK(h.count == 4);
+        CHECK(h.sum_ns == 1004);
+        CHECK(h.max_ns == 1000);
+        CHECK(h.buckets[0] == 1);
+        CHECK(h.buckets[1] == 1);
+        CHECK(h.buckets[2] == 1);
+        CHECK(h.buckets[10] == 1);
+        CHECK(h.quantile_ns(0.0) == 1);
+        CHECK(h.quantile_ns(0.5) == 2);
+        CHECK(h.quantile_ns(1.0) == 1000);  // capped at the maximum
+        CHECK(h.mean_ns() == doctest::Approx(251.0));
+
+        histogram.record(std::uint64_t{1} << 62);
+        CHECK(histogram.snapshot().buckets[HistogramSnapshot::bucket_count - 1] == 1);
+        histogram.reset();
+        CHECK(histogram.snapshot().count == 0);
+        CHECK(HistogramSnapshot{}.quantile_ns(0.5) == 0);
+    }
+
+    TEST_CASE("compiled out when disabled") {
+        if constexpr (instrumentation_enabled) {
+            return;
+        } else {
+            const auto a = poisson_2d(16, 16);
+            const std::vector<double> x(a.cols(), 1.0);
+            static_cast<void>(MatrixOps<double>::multiply(a, std::span<const double>(x)));
+            ThreadPool pool(2);
+            pool.submit([] {}).get();
+
+            const auto snapshot = snapshot_metrics();
+            CHECK(!snapshot.enabled);
+            CHECK(snapshot.kernels.empty());
+            CHECK(snapshot.threads.empty());
+            CHECK(snapshot.pool.tasks == 0);
+            CHECK(contains(to_json(snapshot), "{\"enabled\":false,\"kernels\":[],\"threads\":[]"));
+            CHECK(contains(to_prometheus(snapshot), "sparse_linalg_pool_tasks_total 0\n"));
+        }
+    }
+
+    TEST_CASE("kernel calls, partitions and threads") {
+        if constexpr (!instrumentation_enabled) {
+            return;
+        } else {
+            const auto a = poisson_2d(64, 64);
+            const std::vector<double> x(a.cols(), 1.0);
+            std::vector<double> y(a.rows());
+            ThreadPool pool(3);
+            reset_metrics();
+
+            for (int call = 0; call < 2; ++call) {
+                MatrixOps<double>::multiply(a, std::span<const double>(x), std::span<double>(y));
+            }
+            MatrixOps<double>::multiply_parallel(a, std::span<const double>(x), std::span<double>(y), pool);
+            static_cast<void>(MatrixOps<double>::transpose(a));
+
+            const auto snapshot = snapshot_metrics();
+            CHECK(snapshot.enabled);
+            REQUIRE(snapshot.kernels.size() == 3);
+
+            const auto* spmv = find_kernel(snapshot, Kernel::spmv);
+            REQUIRE(spmv != nullptr);
+            CHECK(spmv->calls == 2);
+            CHECK(spmv->nnz == 2 * a.nnz());
+            CHECK(spmv->latency.count == 2);
+            CHECK(spmv->partitions == 0);
+            CHECK(spmv->imbalance() == 0.0);
+
+            const auto* parallel = find_kernel(snapshot, Kernel::spmv_parallel);
+            REQUIRE(parallel != nullptr);
+            const auto spans = a.partition_plan(PartitionStrategy::nnz, pool.thread_count())->spans.size();
+            CHECK(parallel->calls == 1);
+            CHECK(parallel->partitions == spans);
+            CHECK(parallel->busy_ns > 0);
+            CHECK(parallel->critical_ns <= parallel->busy_ns);
+            CHECK(parallel->critical_ns <= parallel->latency.sum_ns);
+            CHECK(parallel->imbalance() >= 1.0);
+            CHECK(parallel->overhead_ns() == parallel->latency.sum_ns - parallel->critical_ns);
+
+            CHECK(find_kernel(snapshot, Kernel::transpose) != nullptr);
+
+            // Every partition ran on some registered thread
+            std::uint64_t partitions = 0;
+            std::uint64_t busy = 0;
+            for (const auto& thread : snapshot.threads) {
+                partitions += thread.partitions;
+                busy += thread.busy_ns;
+            }
+            CHECK(partitions == spans);
+            CHECK(busy == parallel->busy_ns);
+
+            reset_metrics();
+            CHECK(snapshot_metrics().kernels.empty());
+        }
+    }
+
+    TEST_CASE("thread pool queue and task latency") {
+        if constexpr (!instrumentation_enabled) {
+            return;
+        } else {
+            ThreadPool pool(2);
+            reset_metrics();
+
+            std::promise<void> gate;
+            const auto opened = gate.get_future().share();
+            std::vector<std::future<void>> futures;
+            for (int i = 0; i < 20; ++i) {
+                futures.push_back(pool.submit([opened] { opened.wait(); }));
+            }
+            // Nothing can finish before the gate opens
+            CHECK(snapshot_metrics().pool.queue_depth == 20);
+            gate.set_value();
+            pool.wait_all();
+
+            const auto snapshot = snapshot_metrics();
+            CHECK(snapshot.pool.tasks == 20);
+            CHECK(snapshot.pool.queue_depth == 0);
+            CHECK(snapshot.pool.max_queue_depth == 20);
+            CHECK(snapshot.pool.queue_wait.count == 20);
+            CHECK(snapshot.pool.task_latency.count == 20);
+            CHECK(snapshot.pool.task_latency.sum_ns >= snapshot.pool.queue_wait.sum_ns);
+        }
+    }
+
+    TEST_CASE("json and prometheus export") {
+        if constexpr (!instrumentation_enabled) {
+            return;
+        } else {
+            const auto a = poisson_2d(8, 8);
+            const std::vector<double> x(a.cols(), 1.0);
+            ThreadPool pool(2);
+            reset_metrics();
+            static_cast<void>(MatrixOps<double>::multiply(a, std::span<const double>(x)));
+            pool.submit([] {}).get();
+            pool.wait_all();
+
+            const auto snapshot = snapshot_metrics();
+            const auto json = to_json(snapshot);
+            CHECK(contains(json, "{\"enabled\":true,\"kernels\":[{\"name\":\"spmv\",\"calls\":1,\"nnz\":288,"));
+            CHECK(contains(json, "\"pool\":{\"tasks\":1,\"queue_depth\":0,\"max_queue_depth\":1,"));
+            CHECK(json.back() == '}');
+
+            const auto text = to_prometheus(snapshot);
+            CHECK(contains(text, "# TYPE sparse_linalg_kernel_seconds histogram\n"));
+            CHECK(contains(text, "sparse_linalg_kernel_calls_total{kernel=\"spmv\"} 1\n"));
+            CHECK(contains(text, "sparse_linalg_kernel_nonzeros_total{kernel=\"spmv\"} 288\n"));
+            CHECK(contains(text, "sparse_linalg_kernel_seconds_bucket{kernel=\"spmv\",le=\"+Inf\"} 1\n"));
+            CHECK(contains(text, "sparse_linalg_kernel_seconds_count{kernel=\"spmv\"} 1\n"));
+            CHECK(contains(text, "sparse_linalg_pool_tasks_total 1\n"));
+            CHECK(contains(text, "sparse_linalg_pool_task_latency_seconds_count 1\n"));
+            // Sequential calls have no partitions to report
+            CHECK(!contains(text, "sparse_linalg_kernel_busy_seconds_total{"));
+        }
+    }
+}
@@ -0,0 +1,172 @@
+#include <doctest/doctest.h>
+#include "test_helpers.hpp"
+#include <sparse_linalg/core/matrix_generators.hpp>
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace sparse_linalg;
+using namespace sparse_linalg::test;
+
+namespace {
+    template<typename Matrix>
+    bool is_symmetric(const Matrix& a) {
+        for (std::size_t i = 0; i < a.rows(); ++i) {
+            const auto cols = a.row_indices(i);
+            const auto values = a.row_values(i);
+            for (std::size_t k = 0; k < cols.size(); ++k) {
+                if (a(static_cast<std::size_t>(cols[k]), i) != values[k]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+TEST_SUITE("MatrixGenerators") {
+    TEST_CASE("poisson_2d") {
+        const auto a = poisson_2d(4, 3);
+        REQUIRE(a.rows() == 12);
+        REQUIRE(a.cols() == 12);
+        // 5 * 12 minus the neighbours missing on the boundary: 2 * (4 + 3)
+        CHECK(a.nnz() == 46);
+        CHECK(is_symmetric(a));
+        CHECK(a(5, 5) == 4.0);
+        CHECK(a(5, 4) == -1.0);
+        CHECK(a(5, 6) == -1.0);
+        CHECK(a(5, 1) == -1.0);
+        CHECK(a(5, 9) == -1.0);
+        CHECK(a(3, 4) == 0.0);  // end of one grid row, start of the next
+        // Rows sum to zero in the interior
+        const auto values = a.row_values(5);
+        double sum = 0.0;
+        for (double v : values) {
+            sum += v;
+        }
+        CHECK(sum == 0.0);
+    }
+
+    TEST_CASE("poisson_3d") {
+        const auto a = poisson_3d<float, std::uint32_t, std::uint32_t>(3, 4, 5);
+        REQUIRE(a.rows() == 60);
+        CHECK(a.nnz() == 7 * 60 - 2 * (4 * 5 + 3 * 5 + 3 * 4));
+        CHECK(is_symmetric(a));
+        const std::size_t center = 1 + 3 * (1 + 4 * 2);
+        CHECK(a(center, center) == 6.0f);
+        CHECK(a(center, center - 12) == -1.0f);
+        CHECK(a(center, center + 12) == -1.0f);
+        CHECK(a.row_indices(center).size() == 7);
+
+        CHECK_THROWS_AS(static_cast<void>(poisson_3d(3, 0, 2)), std::invalid_argument);
+        CHECK_THROWS_AS(static_cast<void>(poisson_2d<double, std::uint8_t>(16, 17)), std::overflow_error);
+    }
+
+    TEST_CASE("banded") {
+        const auto a = banded(10, 2, 3, 7);
+        REQUIRE(a.rows() == 10);
+        CHECK(a.row_indices(0).size() == 4);
+        CHECK(a.row_indices(5).size() == 6);
+        CHECK(a.row_indices(9).size() == 3);
+        for (std::size_t i = 0; i < a.rows(); ++i) {
+            CHECK(a(i, i) == 6.0);
+            for (auto col : a.row_indices(i)) {
+                CHECK(col + 2 >= i);
+                CHECK(col <= i + 3);
+            }
+            for (double v : a.row_values(i)) {
+                CHECK(std::abs(v) <= 6.0);
+            }
+        }
+        CHECK(same_entries(a, banded(10, 2, 3, 7)));
+        CHECK(!same_entries(a, banded(10, 2, 3, 8)));
+    }
+
+    TEST_CASE("block_diagonal") {
+        const auto a = block_diagonal(5, 4);
+        REQUIRE(a.rows() == 20);
+        CHECK(a.nnz() == 80);
+        CHECK(a(6, 6) == 4.0);
+        CHECK(a(6, 4) != 0.0);
+        CHECK(a(6, 7) != 0.0);
+        CHECK(a(6, 3) == 0.0);
+        CHECK(a(6, 8) == 0.0);
+        CHECK(block_diagonal(0, 4).rows() == 0);
+    }
+
+    TEST_CASE("rmat") {
+        const auto a = rmat<double, std::uint32_t, std::uint64_t>(10, 8);
+        REQUIRE(a.rows() == 1024);
+        // Repeated edges collapse, so nnz falls short of the 8192 generated
+        CHECK(a.nnz() <= 8192);
+        CHECK(a.nnz() > 4096);
+        // Skewed toward the low vertices: row 0 has far more than the average of 8
+        CHECK(a.row_indices(0).size() > 64);
+        std::size_t empty = 0;
+        for (std::size_t i = 0; i < a.rows(); ++i) {
+            if (a.row_indices(i).empty()) {
+                ++empty;
+            }
+        }
+        CHECK(empty > 0);
+
+        // a = 1 puts every edge at (0, 0)
+        const auto corner = rmat(6, 4, RmatParameters{1.0, 0.0, 0.0});
+        CHECK(corner.nnz() == 1);
+        CHECK(corner(0, 0) != 0.0);
+        // d = 1 puts every edge at (n - 1, n - 1)
+        const auto opposite = rmat(6, 4, RmatParameters{0.0, 0.0, 0.0});
+        CHECK(opposite.nnz() == 1);
+        CHECK(opposite(63, 63) != 0.0);
+
+        CHECK_THROWS_AS(static_cast<void>(rmat(4, 2, RmatParameters{0.5, 0.5, 0.5})), std::invalid_argument);
+        CHECK_THROWS_AS(static_cast<void>(rmat(4, 2, RmatParameters{-0.1, 0.5, 0.3})), std::invalid_argument);
+        CHECK_THROWS_AS(static_cast<void>(rmat<double, std::uint8_t>(9, 2)), std::overflow_error);
+    }
+
+    TEST_CASE("power_law_rows") {
+        const auto a = power_law_rows(1000, 500, 1.0);
+        REQUIRE(a.rows() == 1000);
+        CHECK(a.row_indices(0).size() == 500);
+        CHECK(a.row_indices(1).size() == 250);
+        CHECK(a.row_indices(9).size() == 50);
+        CHECK(a.row_indices(999).size() == 1);
+        // One column per slice of the matrix
+        const auto cols = a.row_indices(1);
+        for (std::size_t k = 0; k < cols.size(); ++k) {
+            CHECK(cols[k] / 4 == k);
+        }
+        // Exponent 0: every row has max_row_length entries
+        CHECK(power_law_rows(100, 7, 0.0).nnz() == 700);
+        CHECK_THROWS_AS(static_cast<void>(power_law_rows(10, 11, 1.0)), std::invalid_argument);
+        CHECK_THROWS_AS(static_cast<void>(power_law_rows(10, 5, -1.0)), std::invalid_argument);
+    }
+
+    TEST_CASE("skewed_rows") {
+        const auto a = skewed_rows(1000, 3, 4, 400);
+        REQUIRE(a.rows() == 1000);
+        CHECK(a.nnz() == 996 * 3 + 4 * 400);
+        for (std::size_t row : {0u, 250u, 500u, 750u}) {
+            CHECK(a.row_indices(row).size() == 400);
+        }
+        CHECK(a.row_indices(1).size() == 3);
+        CHECK(a.row_indices(999).size() == 3);
+        CHECK(skewed_rows(10, 2, 10, 5).nnz() == 50);
+        CHECK_THROWS_AS(static_cast<void>(skewed_rows(10, 2, 1, 11)), std::invalid_argument);
+    }
+
+    TEST_CASE("parallel generation matches sequential") {
+        execution::ThreadPool pool(4);
+        CHECK(same_entries(poisson_2d(37, 23), poisson_2d(37, 23, pool)));
+        CHECK(same_entries(poisson_3d(11, 7, 5), poisson_3d(11, 7, 5, pool)));
+        CHECK(same_entries(banded(301, 5, 9, 3), banded(301, 5, 9, pool, 3)));
+        CHECK(same_entries(block_diagonal(33, 6), block_diagonal(33, 6, pool)));
+        CHECK(same_entries(rmat(12, 6), rmat(12, 6, pool)));
+        CHECK(same_entries(power_law_rows(2000, 1000, 0.8), power_law_rows(2000, 1000, 0.8, pool)));
+        CHECK(same_entries(skewed_rows(3000, 5, 3, 2000), skewed_rows(3000, 5, 3, 2000, pool)));
+        // Fewer rows than threads
+        CHECK(same_entries(banded(2, 1, 1), banded(2, 1, 1, pool)));
+    }
+}
@@ -0,0 +1,284 @@
+#include <doctest/doctest.h>
+#include "test_helpers.hpp"
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/core/sparse_matrix_builder.hpp>
+#include <sparse_linalg/io/matrix_market.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace sparse_linalg;
+using namespace sparse_linalg::test;
+
+namespace {
+    void write_text(const std::filesystem::path& path, std::string_view text) {
+        std::ofstream(path, std::ios::binary) << text;
+    }
+
+    std::string read_text(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // Unsorted general file with a few thousand entries, one per line, no duplicates
+    std::string make_general_text(std::size_t rows, std::size_t cols) {
+        std::string text = "%%MatrixMarket matrix coordinate real general\n% generated\n";
+        std::string body;
+        std::size_t entries = 0;
+        for (std::size_t k = 0; k < rows; ++k) {
+            const std::size_t row = (k * 37) % rows;
+            for (std::size_t j = 0; j < row % 9; ++j) {
+                const std::size_t col = (row * 11 + j * 5) % cols;
+                body += std::to_string(row + 1) + " " + std::to_string(col + 1) + " " +
+                        std::to_string(static_cast<double>(row % 7 + j) * 0.5 + 0.25) + "\n";
+                ++entries;
+            }
+        }
+        return text + std::to_string(rows) + " " + std::to_string(cols) + " " + std::to_string(entries) + "\n" + body;
+    }
+
+    template<typename F>
+    void check_parse_error(F&& parse, std::string_view message) {
+        try {
+            parse();
+            CHECK(false);
+        } catch (const std::runtime_error& error) {
+            CHECK(std::string_view(error.what()).find(message) != std::string_view::npos);
+        }
+    }
+}
+
+TEST_SUITE("MatrixMarket") {
+    TEST_CASE("general file with comments and loose formatting") {
+        const std::string_view text =
+            "%%MatrixMarket matrix coordinate real general\r\n"
+            "% a comment\n"
+            "%\n"
+            "\n"
+            "  3 4   5\r\n"
+            "1 1 1.5\n"
+            "3 4 -2e-3\r\n"
+            "% comment between entries\n"
+            "\t2 2 +7\n"
+            "\n"
+            "1 3 .25\n"
+            "3 1 1E2";  // no final newline
+        const auto matrix = io::parse_matrix_market(text);
+        REQUIRE(matrix.rows() == 3);
+        REQUIRE(matrix.cols() == 4);
+        CHECK(matrix.nnz() == 5);
+        CHECK(matrix(0, 0) == 1.5);
+        CHECK(matrix(0, 2) == 0.25);
+        CHECK(matrix(1, 1) == 7.0);
+        CHECK(matrix(2, 0) == 100.0);
+        CHECK(matrix(2, 3) == -2e-3);
+
+        const auto header = io::parse_matrix_market_header(text);
+        CHECK(header.field == io::MatrixMarketField::real);
+        CHECK(header.symmetry == io::MatrixMarketSymmetry::general);
+        CHECK(header.entries == 5);
+    }
+
+    TEST_CASE("symmetric, skew-symmetric and pattern files") {
+        const auto symmetric = io::parse_matrix_market(
+            "%%MatrixMarket matrix coordinate real symmetric\n3 3 4\n1 1 4\n2 1 -1\n3 2 -2\n3 3 5\n");
+        CHECK(symmetric.nnz() == 6);
+        CHECK(symmetric(0, 1) == -1.0);
+        CHECK(symmetric(1, 0) == -1.0);
+        CHECK(symmetric(1, 2) == -2.0);
+        CHECK(symmetric(2, 1) == -2.0);
+        CHECK(symmetric(2, 2) == 5.0);
+
+        const auto skew = io::parse_matrix_market<float>(
+            "%%MatrixMarket matrix coordinate real skew-symmetric\n3 3 2\n2 1 3\n3 1 -1.5\n");
+        CHECK(skew.nnz() == 4);
+        CHECK(skew(1, 0) == 3.0f);
+        CHECK(skew(0, 1) == -3.0f);
+        CHECK(skew(0, 2) == 1.5f);
+
+        const auto pattern = io::parse_matrix_market<int, std::uint32_t, std::uint32_t>(
+            "%%MatrixMarket matrix coordinate pattern symmetric\n4 4 3\n2 1\n4 4\n4 2\n");
+        CHECK(pattern.nnz() == 5);
+        CHECK(pattern(0, 1) == 1);
+        CHECK(pattern(3, 3) == 1);
+        CHECK(pattern(1, 3) == 1);
+
+        const auto integer = io::parse_matrix_market<std::int64_t>(
+            "%%MatrixMarket MATRIX Coordinate INTEGER General\n2 2 2\n1 2 -9000000000\n2 1 +3\n");
+        CHECK(integer(0, 1) == -9000000000);
+        CHECK(integer(1, 0) == 3);
+    }
+
+    TEST_CASE("duplicates are summed and zeros dropped") {
+        const auto matrix = io::parse_matrix_market(
+            "%%MatrixMarket matrix coordinate real general\n2 3 6\n"
+            "1 3 1\n1 1 2\n1 3 2.5\n2 2 0\n2 1 1\n2 1 -1\n");
+        CHECK(matrix.nnz() == 2);
+        CHECK(matrix(0, 0) == 2.0);
+        CHECK(matrix(0, 2) == 3.5);
+        CHECK(matrix.row_indices(1).empty());
+    }
+
+    TEST_CASE("duplicates in long rows are summed in file order") {
+        // Past the insertion-sort cutoff; 1e16 - 1e16 + 1 is 1, while any
+        // other order loses the 1 to rounding and drops the entry
+        std::string text = "%%MatrixMarket matrix coordinate real general\n1 50 43\n";
+        for (std::size_t col = 50; col > 10; --col) {
+            text += "1 " + std::to_string(col) + " 1\n";
+        }
+        text += "1 1 1e16\n1 1 -1e16\n1 1 1\n";
+        for (bool streaming : {false, true}) {
+            const auto matrix = io::parse_matrix_market(text, {streaming});
+            CHECK(matrix.nnz() == 41);
+            CHECK(matrix(0, 0) == 1.0);
+        }
+    }
+
+    TEST_CASE("parallel and streaming reads match the sequential one") {
+        const auto text = make_general_text(2000, 700);
+        const auto expected = io::parse_matrix_market(text);
+        CHECK(expected.nnz() > 5000);
+
+        io::MatrixMarketOptions streaming;
+        streaming.streaming = true;
+        CHECK(same_entries(io::parse_matrix_market(text, streaming), expected));
+        for (std::size_t threads : {std::size_t{2}, std::size_t{3}, std::size_t{8}}) {
+            execution::ThreadPool pool(threads);
+            CHECK(same_entries(io::parse_matrix_market(text, pool), expected));
+            CHECK(same_entries(io::parse_matrix_market(text, pool, streaming), expected));
+        }
+
+        // Long rows take the sort fallback
+        std::string dense = "%%MatrixMarket matrix coordinate integer general\n2 100 200\n";
+        for (std::size_t col = 100; col > 0; --col) {
+            dense += "1 " + std::to_string(col) + " " + std::to_string(col) + "\n";
+            dense += "2 " + std::to_string((col * 31) % 100 + 1) + " 1\n";
+        }
+        execution::ThreadPool pool(4);
+        const auto wide = io::parse_matrix_market<int>(dense, pool);
+        CHECK(wide.nnz() == 200);
+        for (std::size_t col = 0; col < 100; ++col) {
+            CHECK(wide(0, col) == static_cast<int>(col + 1));
+            CHECK(wide(1, col) == 1);
+        }
+    }
+
+    TEST_CASE_TEMPLATE("write then read round trips exactly", Matrix,
+                       SparseMatrix<double>,
+                       SparseMatrix<float, std::uint32_t, std::uint32_t>,
+                       SparseMatrix<int, std::int32_t, std::int64_t>) {
+        using Value = typename Matrix::value_type;
+        using Index = typename Matrix::index_type;
+        using Offset = typename Matrix::offset_type;
+        SparseMatrixBuilder<Value, Index, Offset> builder(300, 250);
+        for (std::size_t i = 0; i < 300; ++i) {
+            for (std::size_t k = 0; k < i % 7; ++k) {
+                const auto value = std::is_floating_point_v<Value>
+                    ? static_cast<Value>(1.0 / static_cast<double>(i + k + 3))
+                    : static_cast<Value>(static_cast<int>(i) - static_cast<int>(k * 50));
+                builder.add(i, (i * 13 + k * 17) % 250, value);
+            }
+        }
+        const auto matrix = builder.build();
+        TempFile sequential("write_sequential", ".mtx");
+        TempFile parallel("write_parallel", ".mtx");
+        execution::ThreadPool pool(3);
+        io::write_matrix_market(matrix, sequential.path);
+        io::write_matrix_market(matrix, parallel.path, pool);
+
+        CHECK(read_text(sequential.path) == read_text(parallel.path));
+        CHECK(read_text(sequential.path).starts_with(std::is_floating_point_v<Value>
+            ? "%%MatrixMarket matrix coordinate real general\n300 250 "
+            : "%%MatrixMarket matrix coordinate integer general\n300 250 "));
+        CHECK(same_entries(io::read_matrix_market<Value, Index, Offset>(sequential.path), matrix));
+        CHECK(same_entries(io::read_matrix_market<Value, Index, Offset>(parallel.path, pool), matrix));
+    }
+
+    TEST_CASE("symmetric output stores one triangle") {
+        SparseMatrixBuilder<double> builder(50, 50);
+        for (std::size_t i = 0; i < 50; ++i) {
+            builder.add(i, i, 4.0);
+            if (i + 3 < 50) {
+                builder.add(i, i + 3, -0.5 * static_cast<double>(i));
+                builder.add(i + 3, i, -0.5 * static_cast<double>(i));
+            }
+        }
+        const auto matrix = builder.build();
+        TempFile file("symmetric", ".mtx");
+        io::write_matrix_market(matrix, file.path, io::MatrixMarketSymmetry::symmetric);
+        const auto header = io::parse_matrix_market_header(read_text(file.path));
+        CHECK(header.symmetry == io::MatrixMarketSymmetry::symmetric);
+        CHECK(header.entries == 50 + 46);
+        CHECK(same_entries(io::read_matrix_market(file.path), matrix));
+
+        CHECK_THROWS_AS(io::write_matrix_market(SparseMatrix<double>(2, 3), file.path,
+                                                io::MatrixMarketSymmetry::symmetric),
+                        std::invalid_argument);
+    }
+
+    TEST_CASE("malformed and unsupported input is rejected") {
+        auto parse = [](std::string_view text) { return [text] { static_cast<void>(io::parse_matrix_market(text)); }; };
+        check_parse_error(parse(""), "banner");
+        check_parse_error(parse("%%MatrixMarket matrix coordinate real\n1 1 0\n"), "banner");
+        check_parse_error(parse("%%MatrixMarket matrix array real general\n2 2\n1\n2\n3\n4\n"), "coordinate");
+        check_parse_error(parse("%%MatrixMarket matrix coordinate complex general\n1 1 1\n1 1 1 0\n"), "complex");
+        check_parse_error(parse("%%MatrixMarket matrix coordinate real hermitian\n1 1 0\n"), "hermitian");
+        check_parse_error(parse("%%MatrixMarket matrix coordinate real general\n% no size line\n"), "size line");
+        check_parse_error(parse("%%MatrixMarket matrix coordinate real symmetric\n2 3 0\n"), "square");
+        check_parse_error(parse("%%MatrixMarket matrix coordinate real general\n2 2 1\n3 1 1.0\n"), "outside");
+        check_parse_error(parse("%%MatrixMarket matrix coordinate real general\n2 2 1\n0 1 1.0\n"), "outside");
+        check_parse_error(parse("%%MatrixMarket matrix coordinate real general\n2 2 1\n1 1 x\n"), "expected a value");
+        check_parse_error(parse("%%MatrixMarket matrix coordinate real general\n2 2 1\n1 1 1.0 2.0\n"), "after an entry");
+        check_parse_error(parse("%%MatrixMarket matrix coordinate real general\n2 2 2\n1 1 1.0\n"), "declares 2");
+        check_parse_error(parse("%%MatrixMarket matrix coordinate real general\n2 2 1\n1 1 1\n2 2 2\n"), "holds 2");
+        // Byte offset of the bad line
+        check_parse_error(parse("%%MatrixMarket matrix coordinate real general\n2 2 1\n1 -1 1\n"),
+                          "at byte 54");
+
+        check_parse_error([] {
+            static_cast<void>(io::parse_matrix_market<int>("%%MatrixMarket matrix coordinate real general\n1 1 0\n"));
+        }, "integer matrix");
+        check_parse_error([] {
+            static_cast<void>(io::parse_matrix_market<unsigned>(
+                "%%MatrixMarket matrix coordinate integer skew-symmetric\n1 1 0\n"));
+        }, "signed");
+        CHECK_THROWS_AS(static_cast<void>(io::parse_matrix_market<double, std::uint8_t>(
+                            "%%MatrixMarket matrix coordinate real general\n1 300 0\n")),
+                        std::overflow_error);
+
+        // Errors in a worker's chunk surface on the caller
+        auto text = make_general_text(500, 500);
+        text += "1 501 1.0\n";
+        execution::ThreadPool pool(4);
+        check_parse_error([&] { static_cast<void>(io::parse_matrix_market(text, pool)); }, "outside");
+
+        CHECK_THROWS_AS(static_cast<void>(io::read_matrix_market("/nonexistent_dir/matrix.mtx")), std::system_error);
+        CHECK_THROWS_AS(io::write_matrix_market(SparseMatrix<double>(1, 1), "/nonexistent_dir/matrix.mtx"),
+                        std::system_error);
+    }
+
+    TEST_CASE("empty matrices and files") {
+        const auto empty = io::parse_matrix_market("%%MatrixMarket matrix coordinate real general\n0 0 0\n");
+        CHECK(empty.rows() == 0);
+        CHECK(empty.nnz() == 0);
+
+        const auto no_entries = io::parse_matrix_market("%%MatrixMarket matrix coordinate pattern general\n5 3 0");
+        CHECK(no_entries.rows() == 5);
+        CHECK(no_entries.cols() == 3);
+        CHECK(no_entries.nnz() == 0);
+
+        TempFile file("empty", ".mtx");
+        io::write_matrix_market(SparseMatrix<double>(4, 2), file.path);
+        CHECK(read_text(file.path) == "%%MatrixMarket matrix coordinate real general\n4 2 0\n");
+        CHECK(io::read_matrix_market(file.path).rows() == 4);
+
+        write_text(file.path, "");
+        CHECK_THROWS_AS(static_cast<void>(io::read_matrix_market(file.path)), std::runtime_error);
+    }
+}
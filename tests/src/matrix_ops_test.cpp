@@ -2,6 +2,8 @@
 #include <sparse_linalg/core/sparse_matrix.hpp>
 #include <sparse_linalg/core/matrix_ops.hpp>
 #include <sparse_linalg/execution/thread_pool.hpp>
+#include <cstdint>
+#include <limits>
 
 using namespace sparse_linalg;
 
@@ -70,4 +72,200 @@ TEST_SUITE("MatrixOperations") {
             CHECK(result1[i] == doctest::Approx(result2[i]));
         }
     }
-}
\ No newline at end of file
+    
+    TEST_CASE_TEMPLATE("narrow index types", Matrix,
+                       SparseMatrix<double, std::uint32_t, std::uint64_t>,
+                       SparseMatrix<double, std::int32_t, std::int32_t>) {
+        const std::size_t size = 257;
+        Matrix matrix(size, size);
+        SparseMatrix<double> reference(size, size);
+        
+        for (std::size_t i = 0; i < size; ++i) {
+            for (std::size_t j = i % 3; j < size; j += 17) {
+                const auto value = static_cast<double>(i + j) / 100.0;
+                matrix.insert(i, j, value);
+                reference.insert(i, j, value);
+            }
+        }
+        
+        std::vector<double> vec(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            vec[i] = static_cast<double>(i % 7) - 3.0;
+        }
+        
+        auto expected = MatrixOps<double>::multiply(reference, vec);
+        auto result1 = MatrixOps<double>::multiply(matrix, vec);
+        
+        execution::ThreadPool pool(4);
+        auto result2 = MatrixOps<double>::multiply_parallel(matrix, vec, pool);
+        
+        REQUIRE(result1.size() == size);
+        REQUIRE(result2.size() == size);
+        for (std::size_t i = 0; i < size; ++i) {
+            CHECK(result1[i] == doctest::Approx(expected[i]));
+            CHECK(result2[i] == doctest::Approx(expected[i]));
+        }
+    }
+    
+    TEST_CASE_TEMPLATE("row lengths across vector widths", Matrix,
+                       SparseMatrix<double>,
+                       SparseMatrix<double, std::uint32_t, std::uint32_t>,
+                       SparseMatrix<double, std::uint16_t, std::uint32_t>,
+                       SparseMatrix<float, std::int32_t, std::int64_t>,
+                       SparseMatrix<float, std::uint32_t, std::uint64_t>,
+                       SparseMatrix<float>) {
+        using Value = typename Matrix::value_type;
+        const std::size_t rows = 80;
+        const std::size_t cols = 300;
+        Matrix matrix(rows, cols);
+        
+        // Row i holds i entries so every unroll and remainder path is hit
+        for (std::size_t i = 0; i < rows; ++i) {
+            for (std::size_t k = 0; k < i; ++k) {
+                matrix.insert(i, (k * 7 + i) % cols, static_cast<Value>(k % 5 + 1));
+            }
+        }
+        
+        std::vector<Value> vec(cols);
+        for (std::size_t j = 0; j < cols; ++j) {
+            vec[j] = static_cast<Value>(j % 11) / Value{4};
+        }
+        
+        std::vector<double> expected(rows, 0.0);
+        for (std::size_t i = 0; i < rows; ++i) {
+            auto vals = matrix.row_values(i);
+            auto cols_i = matrix.row_indices(i);
+            for (std::size_t k = 0; k < vals.size(); ++k) {
+                expected[i] += static_cast<double>(vals[k]) *
+                               static_cast<double>(vec[static_cast<std::size_t>(cols_i[k])]);
+            }
+        }
+        
+        auto result = MatrixOps<Value>::multiply(matrix, vec);
+        REQUIRE(result.size() == rows);
+        for (std::size_t i = 0; i < rows; ++i) {
+            CHECK(static_cast<double>(result[i]) == doctest::Approx(expected[i]).epsilon(1e-5));
+        }
+    }
+    
+    TEST_CASE_TEMPLATE("every SIMD level the host supports", Value, float, double) {
+        const std::size_t rows = 70;
+        const std::size_t cols = 500;
+        SparseMatrix<Value, std::uint32_t, std::uint32_t> matrix(rows, cols);
+        for (std::size_t i = 0; i < rows; ++i) {
+            for (std::size_t k = 0; k < i; ++k) {
+                matrix.insert(i, (k * 13 + 3 * i) % cols, static_cast<Value>(k % 3 + 1));
+            }
+        }
+        std::vector<Value> vec(cols);
+        for (std::size_t j = 0; j < cols; ++j) {
+            vec[j] = static_cast<Value>(j % 5) - Value{2};
+        }
+        
+        using Kernel = detail::SpmvKernel<Value, std::uint32_t, std::uint32_t>;
+        const auto arrays = detail::csr_arrays(matrix);
+        const PartitionSpan all{0, rows, 0, matrix.nnz()};
+        std::vector<Value> initial(rows);
+        for (std::size_t i = 0; i < rows; ++i) {
+            initial[i] = static_cast<Value>(i % 3);
+        }
+        std::vector<Value> expected = initial;
+        Kernel::select(execution::SimdLevel::scalar)(arrays, vec.data(), expected.data(), all, Value{2}, Value{0.5});
+        
+        for (auto level : {execution::SimdLevel::avx2, execution::SimdLevel::avx512}) {
+            if (level > execution::detected_simd_level()) {
+                continue;
+            }
+            std::vector<Value> result = initial;
+            Kernel::select(level)(arrays, vec.data(), result.data(), all, Value{2}, Value{0.5});
+            for (std::size_t i = 0; i < rows; ++i) {
+                CHECK(static_cast<double>(result[i]) == doctest::Approx(static_cast<double>(expected[i])));
+            }
+        }
+    }
+    
+    TEST_CASE("in-place multiply with alpha and beta") {
+        SparseMatrix<double> matrix(3, 3);
+        matrix.insert(0, 0, 1.0);
+        matrix.insert(0, 1, 2.0);
+        matrix.insert(1, 1, 3.0);
+        matrix.insert(2, 1, 4.0);
+        matrix.insert(2, 2, 5.0);
+        
+        std::vector<double> x{1.0, 2.0, 3.0};  // A * x = {5, 6, 23}
+        execution::ThreadPool pool(4);
+        
+        SUBCASE("general alpha and beta") {
+            std::vector<double> y1{1.0, -1.0, 2.0};
+            std::vector<double> y2 = y1;
+            MatrixOps<double>::multiply(matrix, x, y1, 2.0, 0.5);
+            MatrixOps<double>::multiply_parallel(matrix, x, y2, pool, 2.0, 0.5);
+            for (const auto& y : {y1, y2}) {
+                CHECK(y[0] == doctest::Approx(10.5));
+                CHECK(y[1] == doctest::Approx(11.5));
+                CHECK(y[2] == doctest::Approx(47.0));
+            }
+        }
+        
+        SUBCASE("beta == 0 never reads y") {
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+            std::vector<double> y1(3, nan);
+            std::vector<double> y2(3, nan);
+            MatrixOps<double>::multiply(matrix, x, y1);
+            MatrixOps<double>::multiply_parallel(matrix, x, y2, pool);
+            CHECK(y1 == std::vector<double>{5.0, 6.0, 23.0});
+            CHECK(y2 == std::vector<double>{5.0, 6.0, 23.0});
+        }
+        
+        SUBCASE("alpha == 0 only scales y") {
+            std::vector<double> y{1.0, 2.0, 3.0};
+            const std::vector<double> nan_x(3, std::numeric_limits<double>::quiet_NaN());
+            MatrixOps<double>::multiply(matrix, nan_x, y, 0.0, 3.0);
+            CHECK(y == std::vector<double>{3.0, 6.0, 9.0});
+            MatrixOps<double>::multiply_parallel(matrix, nan_x, y, pool, 0.0, 0.0);
+            CHECK(y == std::vector<double>{0.0, 0.0, 0.0});
+        }
+        
+        SUBCASE("output size must match rows") {
+            std::vector<double> y(2);
+            CHECK_THROWS_AS(MatrixOps<double>::multiply(matrix, x, y), std::invalid_argument);
+            CHECK_THROWS_AS(MatrixOps<double>::multiply_parallel(matrix, x, y, pool), std::invalid_argument);
+        }
+    }
+    
+    TEST_CASE_TEMPLATE("in-place multiply across partition strategies", Value, float, double) {
+        // Long rows, empty rows and short rows so merge-path spans split rows
+        const std::size_t rows = 40;
+        const std::size_t cols = 400;
+        SparseMatrix<Value, std::uint32_t, std::uint32_t> matrix(rows, cols);
+        for (std::size_t i = 0; i < rows; ++i) {
+            const std::size_t row_nnz = i % 10 == 3 ? cols : i % 4;
+            for (std::size_t k = 0; k < row_nnz; ++k) {
+                matrix.insert(i, (k * 3 + i) % cols, static_cast<Value>(k % 4 + 1) / Value{8});
+            }
+        }
+        std::vector<Value> x(cols);
+        std::vector<Value> y0(rows);
+        for (std::size_t j = 0; j < cols; ++j) {
+            x[j] = static_cast<Value>(j % 6) - Value{2};
+        }
+        for (std::size_t i = 0; i < rows; ++i) {
+            y0[i] = static_cast<Value>(i % 5);
+        }
+        
+        const Value alpha{-1.5};
+        const Value beta{0.25};
+        auto ax = MatrixOps<Value>::multiply(matrix, x);
+        
+        execution::ThreadPool pool(4);
+        for (auto strategy : {PartitionStrategy::rows, PartitionStrategy::nnz, PartitionStrategy::merge_path}) {
+            std::vector<Value> y = y0;
+            MatrixOps<Value>::multiply_parallel(matrix, x, y, pool, alpha, beta, strategy);
+            for (std::size_t i = 0; i < rows; ++i) {
+                const double expected = static_cast<double>(alpha) * static_cast<double>(ax[i]) +
+                                        static_cast<double>(beta) * static_cast<double>(y0[i]);
+                CHECK(static_cast<double>(y[i]) == doctest::Approx(expected).epsilon(1e-5));
+            }
+        }
+    }
+}
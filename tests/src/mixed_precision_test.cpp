@@ -0,0 +1,229 @@
+#include <doctest/doctest.h>
+#include "test_helpers.hpp"
+#include <sparse_linalg/core/half_precision.hpp>
+#include <sparse_linalg/core/mixed_precision_matrix.hpp>
+#include <sparse_linalg/core/matrix_ops.hpp>
+#include <sparse_linalg/core/sparse_matrix_builder.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+using namespace sparse_linalg;
+using namespace sparse_linalg::test;
+
+namespace {
+    // Lengths 0..40 exercise full vectors, unrolled blocks and tails; values
+    // are spread over several binades so rounding shows up in every entry
+    template<typename Matrix>
+    Matrix make_matrix(std::size_t rows, std::size_t cols) {
+        auto matrix = make_irregular<Matrix>(rows, cols, {40});
+        const auto values = matrix.values();
+        for (std::size_t k = 0; k < values.size(); ++k) {
+            const double scale = (1.0 + static_cast<double>(k % 97) / 97.0) *
+                                 std::ldexp(1.0, static_cast<int>(k % 9) - 4) * (k % 3 == 0 ? -1.0 : 1.0);
+            values[k] = static_cast<typename Matrix::value_type>(scale);
+        }
+        return matrix;
+    }
+
+    // |actual - expected| within tolerance * sum |a_ij x_j|, the error bound
+    // of rounding every entry by a relative `tolerance`
+    void check_within(const std::vector<double>& actual, const std::vector<double>& expected,
+                      const std::vector<double>& scale, double tolerance) {
+        REQUIRE(actual.size() == expected.size());
+        for (std::size_t i = 0; i < actual.size(); ++i) {
+            CHECK(std::abs(actual[i] - expected[i]) <= tolerance * scale[i] + 1e-300);
+        }
+    }
+
+    std::vector<double> abs_product(const SparseMatrix<double>& a, const std::vector<double>& x) {
+        std::vector<double> result(a.rows());
+        for (std::size_t i = 0; i < a.rows(); ++i) {
+            const auto cols = a.row_indices(i);
+            const auto values = a.row_values(i);
+            for (std::size_t k = 0; k < cols.size(); ++k) {
+                result[i] += std::abs(values[k] * x[cols[k]]);
+            }
+        }
+        return result;
+    }
+}
+
+TEST_SUITE("MixedPrecision") {
+    TEST_CASE("bfloat16 conversion") {
+        CHECK(bfloat16(1.0f).bits == 0x3F80);
+        CHECK(bfloat16(-2.0f).bits == 0xC000);
+        CHECK(static_cast<float>(bfloat16(3.140625f)) == 3.140625f);
+        // Ties round to even: 1 + 2^-8 lies halfway between 1 and 1 + 2^-7
+        CHECK(static_cast<float>(bfloat16(1.0f + 0x1p-8f)) == 1.0f);
+        CHECK(static_cast<float>(bfloat16(1.0f + 3 * 0x1p-8f)) == 1.0f + 0x1p-6f);
+        CHECK(static_cast<float>(bfloat16(1.0f + 0x1p-8f + 0x1p-20f)) == 1.0f + 0x1p-7f);
+        CHECK(std::isinf(static_cast<float>(bfloat16(std::numeric_limits<float>::infinity()))));
+        CHECK(std::isinf(static_cast<float>(bfloat16(std::numeric_limits<float>::max()))));
+        // A NaN whose payload sits in the dropped bits stays NaN
+        CHECK(std::isnan(static_cast<float>(bfloat16(std::bit_cast<float>(0x7F800001u)))));
+        CHECK(bfloat16(1e-40f).bits != 0);  // float subnormals are representable
+    }
+
+    TEST_CASE("float16 conversion") {
+        CHECK(float16(1.0f).bits == 0x3C00);
+        CHECK(float16(-2.0f).bits == 0xC000);
+        CHECK(float16(65504.0f).bits == 0x7BFF);
+        CHECK(float16(65519.0f).bits == 0x7BFF);
+        CHECK(float16(65520.0f).bits == 0x7C00);
+        CHECK(float16(1e9f).bits == 0x7C00);
+        CHECK(float16(-std::numeric_limits<float>::infinity()).bits == 0xFC00);
+        CHECK(std::isnan(static_cast<float>(float16(std::numeric_limits<float>::quiet_NaN()))));
+        CHECK(float16(0x1p-14f).bits == 0x0400);   // smallest normal
+        CHECK(float16(0x1p-24f).bits == 0x0001);   // smallest subnormal
+        CHECK(float16(0x1p-25f).bits == 0x0000);   // tie rounds to even zero
+        CHECK(float16(0x1.8p-25f).bits == 0x0001);
+        CHECK(float16(-0.0f).bits == 0x8000);
+        // Ties to even in the normal range: 1 + 2^-11 is halfway between 1 and 1 + 2^-10
+        CHECK(float16(1.0f + 0x1p-11f).bits == 0x3C00);
+        CHECK(float16(1.0f + 3 * 0x1p-11f).bits == 0x3C02);
+
+        // Every finite pattern survives widening and narrowing
+        for (std::uint32_t bits = 0; bits < 0x10000; ++bits) {
+            const auto half = float16::from_bits(static_cast<std::uint16_t>(bits));
+            if ((bits & 0x7C00) == 0x7C00 && (bits & 0x3FF) != 0) {
+                CHECK(std::isnan(static_cast<float>(half)));
+                continue;
+            }
+            REQUIRE(float16(static_cast<float>(half)) == half);
+        }
+    }
+
+    TEST_CASE("doubles are rounded once") {
+        // 1 + 2^-8 + 2^-30 is just above the tie between 1 and 1 + 2^-7 in
+        // bfloat16; rounded to float first it would land on the tie and go to 1
+        CHECK(detail::narrow<bfloat16>(1.0 + 0x1p-8 + 0x1p-30).bits == 0x3F81);
+        CHECK(detail::narrow<bfloat16>(-1.0 - 0x1p-8 - 0x1p-30).bits == 0xBF81);
+        CHECK(detail::narrow<bfloat16>(1.0 + 0x1p-8 - 0x1p-30).bits == 0x3F80);
+        CHECK(detail::narrow<bfloat16>(1.0 + 0x1p-8).bits == 0x3F80);        // exact tie stays even
+        CHECK(detail::narrow<bfloat16>(1.0 + 3 * 0x1p-8).bits == 0x3F82);
+        CHECK(detail::narrow<float16>(1.0 + 0x1p-11 + 0x1p-40).bits == 0x3C01);
+        CHECK(detail::narrow<float16>(1.0 + 0x1p-11).bits == 0x3C00);
+        CHECK(detail::narrow<float16>(0x1p-25 + 0x1p-60).bits == 0x0001);   // above the subnormal tie
+        CHECK(detail::narrow<float>(1.0 + 0x1p-24 + 0x1p-40) == 1.0f + 0x1p-23f);
+
+        // Beyond float's range in either direction
+        CHECK(detail::narrow<bfloat16>(1e300).bits == 0x7F80);
+        CHECK(detail::narrow<bfloat16>(-1e300).bits == 0xFF80);
+        CHECK(detail::narrow<bfloat16>(1e-300).bits == 0x0000);
+        CHECK(detail::narrow<float16>(-1e-300).bits == 0x8000);
+        CHECK(std::isnan(static_cast<float>(detail::narrow<bfloat16>(std::numeric_limits<double>::quiet_NaN()))));
+        static_assert(detail::narrow<bfloat16>(1.0 + 0x1p-8 + 0x1p-30).bits == 0x3F81);
+    }
+
+    TEST_CASE_TEMPLATE("stored values are the rounded source values", Storage, float, bfloat16, float16) {
+        const auto a = make_matrix<SparseMatrix<double>>(50, 60);
+        execution::ThreadPool pool(3);
+        for (const auto& mixed : {MixedPrecisionMatrix<Storage>(a), MixedPrecisionMatrix<Storage>(a, pool)}) {
+            REQUIRE(mixed.rows() == a.rows());
+            REQUIRE(mixed.cols() == a.cols());
+            REQUIRE(mixed.nnz() == a.nnz());
+            for (std::size_t k = 0; k < a.nnz(); ++k) {
+                CHECK(mixed.values()[k] == detail::narrow<Storage>(a.raw_data().values[k]));
+            }
+            static_assert(std::is_same_v<decltype(mixed(0, 0)), Storage>);
+            CHECK(mixed(3, mixed.row_indices(3)[0]) == mixed.row_values(3)[0]);
+            CHECK(mixed(0, 59) == Storage{});
+        }
+        const MixedPrecisionMatrix<Storage> mixed(a);
+        CHECK_THROWS_AS(static_cast<void>(mixed(50, 0)), std::out_of_range);
+        const auto widened = mixed.template to_matrix<double>();
+        CHECK(widened.raw_data().col_indices == a.raw_data().col_indices);
+    }
+
+    TEST_CASE_TEMPLATE("double accumulation over narrow storage", Storage, float, bfloat16, float16) {
+        // Per-entry rounding bound of each format
+        const double unit = std::is_same_v<Storage, float> ? 0x1p-24
+                          : std::is_same_v<Storage, float16> ? 0x1p-11 : 0x1p-8;
+        const auto a = make_matrix<SparseMatrix<double>>(400, 300);
+        const auto x = make_vector(300);
+        const auto exact = MatrixOps<double>::multiply(a, std::span<const double>(x));
+        const auto scale = abs_product(a, x);
+        const MixedPrecisionMatrix<Storage, std::uint32_t, std::uint32_t> mixed(
+            make_matrix<SparseMatrix<double, std::uint32_t, std::uint32_t>>(400, 300));
+        const auto widened = mixed.template to_matrix<double>();
+        const auto reference = MatrixOps<double>::multiply(widened, std::span<const double>(x));
+
+        // Against the exact product: only the storage rounding shows
+        check_within(MatrixOps<double>::multiply(mixed, std::span<const double>(x)), exact, scale, unit);
+        // Against the widened matrix in double: the same arithmetic up to summation order
+        check_within(MatrixOps<double>::multiply(mixed, std::span<const double>(x)), reference, scale, 1e-14);
+
+        execution::ThreadPool pool(4);
+        for (auto strategy : {PartitionStrategy::rows, PartitionStrategy::nnz, PartitionStrategy::merge_path}) {
+            std::vector<double> y(400, 7.0);
+            MatrixOps<double>::multiply_parallel(mixed, std::span<const double>(x), std::span<double>(y),
+                                                 pool, 1.0, 0.0, strategy);
+            check_within(y, reference, scale, 1e-14);
+        }
+
+        // Every kernel the host can run
+        for (auto level : {execution::SimdLevel::scalar, execution::SimdLevel::avx2, execution::SimdLevel::avx512}) {
+            if (level > execution::active_simd_level()) {
+                continue;
+            }
+            using Kernel = detail::MixedSpmvKernel<Storage, double, std::uint32_t, std::uint32_t>;
+            std::vector<double> y(400);
+            Kernel::select(level)(detail::csr_arrays(mixed), x.data(), y.data(),
+                                  PartitionSpan{0, 400, 0, mixed.nnz()}, 1.0, 0.0);
+            check_within(y, reference, scale, 1e-14);
+        }
+    }
+
+    TEST_CASE_TEMPLATE("16-bit storage with float arithmetic", Storage, bfloat16, float16) {
+        const auto a = make_matrix<SparseMatrix<float>>(200, 150);
+        const MixedPrecisionMatrix<Storage> mixed(a);
+        const auto widened = mixed.template to_matrix<float>();
+        std::vector<float> x(150);
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            x[i] = static_cast<float>(i % 11) * 0.25f - 1.0f;
+        }
+        const auto expected = MatrixOps<float>::multiply(widened, std::span<const float>(x));
+        for (auto level : {execution::SimdLevel::scalar, execution::SimdLevel::avx2, execution::SimdLevel::avx512}) {
+            if (level > execution::active_simd_level()) {
+                continue;
+            }
+            using Kernel = detail::MixedSpmvKernel<Storage, float, std::size_t, std::size_t>;
+            std::vector<float> y(200);
+            Kernel::select(level)(detail::csr_arrays(mixed), x.data(), y.data(),
+                                  PartitionSpan{0, 200, 0, mixed.nnz()}, 1.0f, 0.0f);
+            for (std::size_t i = 0; i < y.size(); ++i) {
+                CHECK(y[i] == doctest::Approx(expected[i]).epsilon(1e-4));
+            }
+        }
+    }
+
+    TEST_CASE("alpha, beta and dimension errors") {
+        const auto a = make_matrix<SparseMatrix<double>>(30, 20);
+        const MixedPrecisionMatrix<float> mixed(a);
+        const auto x = make_vector(20);
+        const auto ax = MatrixOps<double>::multiply(mixed, std::span<const double>(x));
+
+        std::vector<double> y(30, 1.0);
+        MatrixOps<double>::multiply(mixed, std::span<const double>(x), std::span<double>(y), 2.0, 0.5);
+        for (std::size_t i = 0; i < y.size(); ++i) {
+            CHECK(y[i] == doctest::Approx(2.0 * ax[i] + 0.5));
+        }
+        MatrixOps<double>::multiply(mixed, std::span<const double>(x), std::span<double>(y), 0.0, 0.0);
+        for (double value : y) {
+            CHECK(value == 0.0);
+        }
+
+        std::vector<double> short_x(19);
+        CHECK_THROWS_AS(static_cast<void>(MatrixOps<double>::multiply(mixed, std::span<const double>(short_x))),
+                        std::invalid_argument);
+        std::vector<double> short_y(29);
+        CHECK_THROWS_AS(MatrixOps<double>::multiply(mixed, std::span<const double>(x), std::span<double>(short_y)),
+                        std::invalid_argument);
+        CHECK(MatrixOps<double>::multiply(MixedPrecisionMatrix<bfloat16>(SparseMatrix<double>(0, 0)),
+                                          std::span<const double>()).empty());
+    }
+}
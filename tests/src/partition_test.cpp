@@ -0,0 +1,120 @@
+#include <doctest/doctest.h>
+#include "test_helpers.hpp"
+#include <sparse_linalg/core/partition.hpp>
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/core/sparse_matrix_builder.hpp>
+#include <sparse_linalg/core/matrix_ops.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <cstdint>
+
+using namespace sparse_linalg;
+using namespace sparse_linalg::test;
+
+TEST_SUITE("Partition") {
+    TEST_CASE("nnz partitions balance a skewed matrix") {
+        const std::vector<std::size_t> row_ptrs{0, 1, 2, 3, 4, 104, 105, 106, 107, 108};
+        auto parts = detail::partition_by_nnz(std::span<const std::size_t>(row_ptrs), 4);
+        
+        REQUIRE(parts.size() == 5);
+        CHECK(parts.front() == 0);
+        CHECK(parts.back() == 9);
+        for (std::size_t i = 0; i < 4; ++i) {
+            CHECK(parts[i] <= parts[i + 1]);
+        }
+        // The heavy row gets a part of its own
+        CHECK(parts[1] == 4);
+        CHECK(parts[2] == 5);
+    }
+    
+    TEST_CASE("merge-path spans cover every row and nonzero") {
+        const std::vector<std::uint32_t> row_ptrs{0, 0, 3, 3, 50, 52, 52, 60};
+        const std::span<const std::uint32_t> ptrs(row_ptrs);
+        
+        for (std::size_t parts : {1u, 2u, 3u, 7u, 16u}) {
+            auto plan = detail::make_partition_plan(ptrs, PartitionStrategy::merge_path, parts);
+            REQUIRE(plan.spans.size() == parts);
+            CHECK(plan.spans.front().row_begin == 0);
+            CHECK(plan.spans.front().nnz_begin == 0);
+            CHECK(plan.spans.back().row_end == 7);
+            CHECK(plan.spans.back().nnz_end == 60);
+            
+            std::size_t largest = 0;
+            for (std::size_t i = 0; i < parts; ++i) {
+                const auto& span = plan.spans[i];
+                CHECK(span.row_begin <= span.row_end);
+                CHECK(span.nnz_begin <= span.nnz_end);
+                if (i > 0) {
+                    CHECK(span.row_begin == plan.spans[i - 1].row_end);
+                    CHECK(span.nnz_begin == plan.spans[i - 1].nnz_end);
+                }
+                largest = std::max(largest, span.row_end - span.row_begin + span.nnz_end - span.nnz_begin);
+            }
+            // Every span gets its share of rows + nonzeros, rounded up
+            CHECK(largest <= (7 + 60 + parts - 1) / parts);
+        }
+    }
+    
+    TEST_CASE_TEMPLATE("every strategy matches sequential multiply", Matrix,
+                       SparseMatrix<double>,
+                       SparseMatrix<float, std::uint32_t, std::uint32_t>) {
+        using Value = typename Matrix::value_type;
+        const std::size_t size = 300;
+        // One dense row among short ones, the worst case for row splits
+        auto matrix = make_irregular<Matrix>(size, size, {2, size, 17, size});
+        
+        std::vector<Value> vec(size);
+        for (std::size_t j = 0; j < size; ++j) {
+            vec[j] = static_cast<Value>(j % 9) / Value{4} - Value{1};
+        }
+        auto expected = MatrixOps<Value>::multiply(matrix, vec);
+        
+        execution::ThreadPool pool(4);
+        for (auto strategy : {PartitionStrategy::rows, PartitionStrategy::nnz, PartitionStrategy::merge_path}) {
+            auto result = MatrixOps<Value>::multiply_parallel(matrix, vec, pool, strategy);
+            REQUIRE(result.size() == size);
+            for (std::size_t i = 0; i < size; ++i) {
+                CHECK(static_cast<double>(result[i]) ==
+                      doctest::Approx(static_cast<double>(expected[i])).epsilon(1e-5));
+            }
+        }
+    }
+    
+    TEST_CASE("merge-path splits a single long row") {
+        SparseMatrix<double> matrix(3, 200);
+        std::vector<double> vec(200, 1.0);
+        for (std::size_t j = 0; j < 200; ++j) {
+            matrix.insert(1, j, 0.5);
+        }
+        matrix.insert(0, 0, 1.0);
+        matrix.insert(2, 199, 3.0);
+        
+        execution::ThreadPool pool(4);
+        auto plan = matrix.partition_plan(PartitionStrategy::merge_path, 4);
+        CHECK(plan->spans[1].row_begin == 1);
+        CHECK(plan->spans[1].row_end == 1);
+        
+        auto result = MatrixOps<double>::multiply_parallel(matrix, vec, pool, PartitionStrategy::merge_path);
+        CHECK(result[0] == doctest::Approx(1.0));
+        CHECK(result[1] == doctest::Approx(100.0));
+        CHECK(result[2] == doctest::Approx(3.0));
+    }
+    
+    TEST_CASE("plans are cached until the pattern changes") {
+        auto matrix = make_irregular<SparseMatrix<double>>(50, 50, {2, 50, 3, 50});  // row 3 is dense
+        
+        auto first = matrix.partition_plan(PartitionStrategy::nnz, 4);
+        CHECK(matrix.partition_plan(PartitionStrategy::nnz, 4) == first);
+        
+        // Updating an existing entry keeps the pattern
+        matrix.insert(3, 0, 42.0);
+        CHECK(matrix.partition_plan(PartitionStrategy::nnz, 4) == first);
+        
+        matrix.insert(49, 20, 1.0);
+        auto rebuilt = matrix.partition_plan(PartitionStrategy::nnz, 4);
+        CHECK(rebuilt != first);
+        CHECK(rebuilt->spans.back().nnz_end == matrix.nnz());
+        
+        CHECK(matrix.partition_plan(PartitionStrategy::merge_path, 4)->strategy == PartitionStrategy::merge_path);
+        CHECK_THROWS_AS(static_cast<void>(matrix.partition_plan(PartitionStrategy::rows, 0)), std::invalid_argument);
+    }
+}
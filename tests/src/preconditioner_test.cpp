@@ -0,0 +1,309 @@
+#include <doctest/doctest.h>
+#include "test_helpers.hpp"
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/core/sparse_matrix_builder.hpp>
+#include <sparse_linalg/core/matrix_ops.hpp>
+#include <sparse_linalg/solvers/jacobi.hpp>
+#include <sparse_linalg/solvers/ilu0.hpp>
+#include <sparse_linalg/solvers/ic0.hpp>
+#include <sparse_linalg/solvers/level_schedule.hpp>
+#include <sparse_linalg/solvers/conjugate_gradient.hpp>
+#include <sparse_linalg/solvers/gmres.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <vector>
+
+using namespace sparse_linalg;
+using namespace sparse_linalg::test;
+
+namespace {
+    SparseMatrix<double> make_tridiagonal(std::size_t n, double lower, double upper) {
+        SparseMatrixBuilder<double> builder(n, n);
+        for (std::size_t i = 0; i < n; ++i) {
+            builder.add(i, i, 3.0 + 0.01 * static_cast<double>(i % 5));
+            if (i > 0) builder.add(i, i - 1, lower);
+            if (i + 1 < n) builder.add(i, i + 1, upper);
+        }
+        return builder.build();
+    }
+
+    template<typename P>
+    std::vector<double> applied(const P& preconditioner, const std::vector<double>& in) {
+        std::vector<double> out(in.size());
+        preconditioner.apply(in, out);
+        return out;
+    }
+
+    // ILU(0) on a dense copy, eliminating only inside the pattern, then
+    // (LU)^-1 in by dense triangular solves
+    std::vector<double> reference_ilu0(const SparseMatrix<double>& a, const std::vector<double>& in) {
+        const std::size_t n = a.rows();
+        std::vector<double> lu(n * n, 0.0);
+        std::vector<bool> pattern(n * n, false);
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto cols = a.row_indices(i);
+            const auto values = a.row_values(i);
+            for (std::size_t p = 0; p < cols.size(); ++p) {
+                lu[i * n + cols[p]] = values[p];
+                pattern[i * n + cols[p]] = true;
+            }
+        }
+        for (std::size_t i = 1; i < n; ++i) {
+            for (std::size_t k = 0; k < i; ++k) {
+                if (!pattern[i * n + k]) continue;
+                lu[i * n + k] /= lu[k * n + k];
+                for (std::size_t j = k + 1; j < n; ++j) {
+                    if (pattern[i * n + j]) {
+                        lu[i * n + j] -= lu[i * n + k] * lu[k * n + j];
+                    }
+                }
+            }
+        }
+        std::vector<double> out(in);
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = 0; j < i; ++j) out[i] -= lu[i * n + j] * out[j];
+        }
+        for (std::size_t i = n; i-- > 0;) {
+            for (std::size_t j = i + 1; j < n; ++j) out[i] -= lu[i * n + j] * out[j];
+            out[i] /= lu[i * n + i];
+        }
+        return out;
+    }
+
+    static_assert(Preconditioner<JacobiPreconditioner<double>, double>);
+    static_assert(Preconditioner<Ilu0Preconditioner<float>, float>);
+    static_assert(Preconditioner<Ic0Preconditioner<double>, double>);
+}
+
+TEST_SUITE("LevelSchedule") {
+    TEST_CASE("levels follow the dependencies of each sweep") {
+        // Row 2 reads row 0, row 3 reads rows 1 and 2
+        SparseMatrix<double> a(4, 4);
+        for (std::size_t i = 0; i < 4; ++i) a.insert(i, i, 1.0);
+        a.insert(2, 0, 1.0);
+        a.insert(3, 1, 1.0);
+        a.insert(3, 2, 1.0);
+        a.insert(0, 3, 1.0);
+
+        const auto& data = a.raw_data();
+        const auto lower = detail::lower_level_schedule(std::span<const std::size_t>(data.row_ptrs),
+                                                        std::span<const std::size_t>(data.col_indices));
+        CHECK(lower.level_ptrs == std::vector<std::size_t>{0, 2, 3, 4});
+        CHECK(lower.rows == std::vector<std::size_t>{0, 1, 2, 3});
+
+        // Only row 0 reads a later row
+        const auto upper = detail::upper_level_schedule(std::span<const std::size_t>(data.row_ptrs),
+                                                        std::span<const std::size_t>(data.col_indices));
+        CHECK(upper.level_ptrs == std::vector<std::size_t>{0, 3, 4});
+        CHECK(upper.rows == std::vector<std::size_t>{1, 2, 3, 0});
+    }
+
+    TEST_CASE("wide levels run on the pool") {
+        const auto a = make_strided(3000, 600);
+        const auto& data = a.raw_data();
+        const auto schedule = detail::lower_level_schedule(std::span<const std::size_t>(data.row_ptrs),
+                                                           std::span<const std::size_t>(data.col_indices));
+        CHECK(schedule.levels() == 5);
+
+        execution::ThreadPool pool(3);
+        std::vector<std::size_t> level_of(a.rows(), 0);
+        std::vector<std::size_t> order(a.rows(), 0);
+        std::atomic<std::size_t> visits{0};
+        detail::for_each_level(&pool, schedule, [&](std::size_t row) {
+            order[row] = visits.fetch_add(1);
+            level_of[row] = row / 600;
+        });
+        CHECK(visits.load() == a.rows());
+        // Every row ran after all rows of the previous level
+        bool ordered = true;
+        for (std::size_t row = 600; row < a.rows(); ++row) {
+            ordered = ordered && order[row] >= 600 * level_of[row];
+        }
+        CHECK(ordered);
+    }
+}
+
+TEST_SUITE("Preconditioners") {
+    TEST_CASE("Jacobi scales by the inverse diagonal") {
+        auto a = make_stencil(6, 1.0);
+        const auto in = make_vector(a.rows());
+        JacobiPreconditioner<double> jacobi(a);
+        const auto out = applied(jacobi, in);
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            CHECK(out[i] == doctest::Approx(in[i] / 5.0));
+        }
+
+        execution::ThreadPool pool(2);
+        JacobiPreconditioner<double> parallel(a, pool);
+        CHECK(applied(parallel, in) == out);
+
+        for (auto& v : a.values()) v *= 2.0;
+        jacobi.factorize(a);
+        const auto halved = applied(jacobi, in);
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            CHECK(halved[i] == doctest::Approx(out[i] / 2.0));
+        }
+    }
+
+    TEST_CASE("ILU(0) is exact on tridiagonal matrices") {
+        const auto a = make_tridiagonal(50, -1.0, -0.5);
+        const auto x = make_vector(a.rows());
+        const auto ax = MatrixOps<double>::multiply(a, x);
+        Ilu0Preconditioner<double> ilu(a);
+        check_close(applied(ilu, ax), x, 1e-12);
+        CHECK(ilu.lower_levels() == 50);
+        CHECK(ilu.upper_levels() == 50);
+    }
+
+    TEST_CASE("ILU(0) matches a dense reference") {
+        const auto a = make_stencil(7, 2.0);
+        const auto in = make_vector(a.rows());
+        Ilu0Preconditioner<double> ilu(a);
+        check_close(applied(ilu, in), reference_ilu0(a, in), 1e-12);
+        // Wavefronts of the grid
+        CHECK(ilu.lower_levels() == 13);
+    }
+
+    TEST_CASE("parallel ILU(0) matches the sequential one") {
+        const auto a = make_strided(4000, 700);
+        const auto in = make_vector(a.rows());
+        execution::ThreadPool pool(4);
+        Ilu0Preconditioner<double> sequential(a);
+        Ilu0Preconditioner<double> parallel(a, pool);
+        // Each row is computed the same way wherever it runs
+        CHECK(applied(parallel, in) == applied(sequential, in));
+        check_close(applied(sequential, MatrixOps<double>::multiply(a, in)), in, 1e-2);
+    }
+
+    TEST_CASE("ILU(0) numeric refactorization") {
+        auto a = make_stencil(8, 1.0);
+        const auto in = make_vector(a.rows());
+        Ilu0Preconditioner<double> ilu(a);
+        for (std::size_t i = 0; i < a.values().size(); ++i) {
+            a.values()[i] *= 1.0 + 0.01 * static_cast<double>(i % 4);
+        }
+        ilu.factorize(a);
+        Ilu0Preconditioner<double> fresh(a);
+        CHECK(applied(ilu, in) == applied(fresh, in));
+    }
+
+    TEST_CASE("IC(0) is exact on tridiagonal SPD matrices") {
+        const auto a = make_tridiagonal(40, -1.0, -1.0);
+        const auto x = make_vector(a.rows());
+        Ic0Preconditioner<double> ic(a);
+        check_close(applied(ic, MatrixOps<double>::multiply(a, x)), x, 1e-12);
+        CHECK(ic.nnz() == 79);
+    }
+
+    TEST_CASE("IC(0) agrees with ILU(0) on symmetric matrices") {
+        // For symmetric A, L_ic = L_ilu D^(1/2) and U_ilu = D L_ilu^T
+        const auto a = make_stencil(9, 0.0);
+        const auto in = make_vector(a.rows());
+        Ic0Preconditioner<double> ic(a);
+        Ilu0Preconditioner<double> ilu(a);
+        check_close(applied(ic, in), applied(ilu, in), 1e-12);
+    }
+
+    TEST_CASE("parallel IC(0) and refactorization") {
+        // Symmetric version of the strided matrix
+        const std::size_t n = 3000;
+        const std::size_t stride = 600;
+        SparseMatrixBuilder<double> builder(n, n);
+        for (std::size_t i = 0; i < n; ++i) {
+            builder.add(i, i, 4.0);
+            if (i >= stride) builder.add(i, i - stride, -1.0);
+            if (i + stride < n) builder.add(i, i + stride, -1.0);
+        }
+        auto a = builder.build();
+        const auto in = make_vector(n);
+        execution::ThreadPool pool(3);
+
+        Ic0Preconditioner<double> sequential(a);
+        Ic0Preconditioner<double> parallel(a, pool);
+        CHECK(parallel.lower_levels() == 5);
+        CHECK(applied(parallel, in) == applied(sequential, in));
+
+        for (auto& v : a.values()) v *= 4.0;
+        parallel.factorize(a);
+        const auto before = applied(sequential, in);
+        const auto after = applied(parallel, in);
+        for (std::size_t i = 0; i < n; i += 97) {
+            CHECK(after[i] == doctest::Approx(before[i] / 4.0));
+        }
+    }
+
+    TEST_CASE("preconditioner errors") {
+        const auto a = make_stencil(3, 0.0);
+        const SparseMatrix<double> rectangular(3, 4);
+        CHECK_THROWS_AS(JacobiPreconditioner<double>{rectangular}, std::invalid_argument);
+        CHECK_THROWS_AS(Ilu0Preconditioner<double>{rectangular}, std::invalid_argument);
+        CHECK_THROWS_AS(Ic0Preconditioner<double>{rectangular}, std::invalid_argument);
+
+        SparseMatrix<double> missing(2, 2);
+        missing.insert(0, 0, 1.0);
+        missing.insert(1, 0, 1.0);
+        CHECK_THROWS_AS(JacobiPreconditioner<double>{missing}, std::invalid_argument);
+        CHECK_THROWS_AS(Ilu0Preconditioner<double>{missing}, std::invalid_argument);
+        CHECK_THROWS_AS(Ic0Preconditioner<double>{missing}, std::invalid_argument);
+
+        // u_11 = 1 - 1 * 1 = 0
+        SparseMatrix<double> singular(2, 2);
+        singular.insert(0, 0, 1.0);
+        singular.insert(0, 1, 1.0);
+        singular.insert(1, 0, 1.0);
+        singular.insert(1, 1, 1.0);
+        CHECK_THROWS_AS(Ilu0Preconditioner<double>{singular}, std::invalid_argument);
+        CHECK_THROWS_AS(Ic0Preconditioner<double>{singular}, std::invalid_argument);
+
+        Ilu0Preconditioner<double> ilu(a);
+        CHECK_THROWS_AS(ilu.factorize(make_stencil(4, 0.0)), std::invalid_argument);
+        std::vector<double> short_in(2);
+        std::vector<double> out(a.rows());
+        CHECK_THROWS_AS(ilu.apply(short_in, out), std::invalid_argument);
+    }
+}
+
+TEST_SUITE("Preconditioned solvers") {
+    TEST_CASE("IC(0) cuts CG iterations") {
+        const auto a = make_stencil(30, 0.0);
+        const auto b = make_vector(a.rows());
+        ConjugateGradient<double> cg({.tolerance = 1e-10});
+        execution::ThreadPool pool(2);
+
+        std::vector<double> x(a.rows(), 0.0);
+        const auto plain = cg.solve(a, b, x);
+        REQUIRE(plain.converged());
+
+        Ic0Preconditioner<double> ic(a, pool);
+        std::fill(x.begin(), x.end(), 0.0);
+        const auto preconditioned = cg.solve(a, b, x, ic, pool);
+        CHECK(preconditioned.converged());
+        CHECK(preconditioned.iterations < plain.iterations);
+        CHECK(preconditioned.timings.preconditioner.count() > 0);
+
+        // The reported residual is the true residual, not the preconditioned one
+        CHECK(relative_residual(a, b, x) <= 1e-9);
+
+        JacobiPreconditioner<double> jacobi(a);
+        std::fill(x.begin(), x.end(), 0.0);
+        const auto scaled = cg.solve(a, b, x, jacobi);
+        CHECK(scaled.converged());
+        // Constant diagonal: Jacobi only rescales, so the iterates match plain CG
+        CHECK(scaled.iterations == plain.iterations);
+    }
+
+    TEST_CASE("ILU(0) cuts GMRES iterations") {
+        const auto a = make_stencil(30, 4.0);
+        const auto b = make_vector(a.rows());
+        Gmres<double> gmres({.tolerance = 1e-10}, {.restart = 20});
+
+        std::vector<double> x(a.rows(), 0.0);
+        const auto plain = gmres.solve(a, b, x);
+        REQUIRE(plain.converged());
+
+        Ilu0Preconditioner<double> ilu(a);
+        std::fill(x.begin(), x.end(), 0.0);
+        const auto preconditioned = gmres.solve(a, b, x, ilu);
+        CHECK(preconditioned.converged());
+        CHECK(preconditioned.iterations * 2 < plain.iterations);
+    }
+}
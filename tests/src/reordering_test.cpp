@@ -0,0 +1,211 @@
+#include <doctest/doctest.h>
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/core/sparse_matrix_builder.hpp>
+#include <sparse_linalg/core/matrix_ops.hpp>
+#include <sparse_linalg/core/reordering.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace sparse_linalg;
+
+namespace {
+    Permutation shuffled(std::size_t n, unsigned seed) {
+        Permutation perm(n);
+        std::iota(perm.begin(), perm.end(), std::size_t{0});
+        std::mt19937 gen(seed);
+        std::shuffle(perm.begin(), perm.end(), gen);
+        return perm;
+    }
+
+    // 5-point Laplacian with its vertices numbered by scramble
+    template<typename Index = std::size_t, typename Offset = std::size_t>
+    SparseMatrix<double, Index, Offset> make_scrambled_grid(std::size_t grid, const Permutation& scramble) {
+        const std::size_t n = grid * grid;
+        const auto position = inverse_permutation(scramble);
+        SparseMatrixBuilder<double, Index, Offset> builder(n, n);
+        auto add = [&](std::size_t u, std::size_t v, double value) { builder.add(position[u], position[v], value); };
+        for (std::size_t i = 0; i < grid; ++i) {
+            for (std::size_t j = 0; j < grid; ++j) {
+                const std::size_t v = i * grid + j;
+                add(v, v, 4.0);
+                if (i > 0) add(v, v - grid, -1.0);
+                if (i + 1 < grid) add(v, v + grid, -1.0);
+                if (j > 0) add(v, v - 1, -1.0);
+                if (j + 1 < grid) add(v, v + 1, -1.0);
+            }
+        }
+        return builder.build();
+    }
+
+    bool is_permutation_of_range(const Permutation& perm, std::size_t n) {
+        auto sorted = perm;
+        std::sort(sorted.begin(), sorted.end());
+        for (std::size_t i = 0; i < sorted.size(); ++i) {
+            if (sorted[i] != i) return false;
+        }
+        return sorted.size() == n;
+    }
+}
+
+TEST_SUITE("Reordering") {
+    TEST_CASE("RCM recovers a scrambled path") {
+        const std::size_t n = 200;
+        const auto scramble = shuffled(n, 7);
+        const auto position = inverse_permutation(scramble);
+        SparseMatrixBuilder<double> builder(n, n);
+        for (std::size_t v = 0; v < n; ++v) {
+            builder.add(position[v], position[v], 2.0);
+            if (v + 1 < n) {
+                builder.add(position[v], position[v + 1], -1.0);
+                builder.add(position[v + 1], position[v], -1.0);
+            }
+        }
+        const auto a = builder.build();
+        CHECK(bandwidth_stats(a).bandwidth > 100);
+
+        const auto perm = reverse_cuthill_mckee(a);
+        REQUIRE(is_permutation_of_range(perm, n));
+        const auto b = permute(a, perm, perm);
+        const auto stats = bandwidth_stats(b);
+        CHECK(stats.bandwidth == 1);
+        CHECK(stats.profile == n - 1);
+    }
+
+    TEST_CASE("RCM narrows a scrambled grid") {
+        const std::size_t grid = 30;
+        const auto a = make_scrambled_grid(grid, shuffled(grid * grid, 3));
+        const auto before = bandwidth_stats(a);
+        const auto perm = reverse_cuthill_mckee(a);
+        REQUIRE(is_permutation_of_range(perm, a.rows()));
+        const auto after = bandwidth_stats(permute(a, perm, perm));
+        // A grid's natural numbering has bandwidth grid; RCM orders by
+        // anti-diagonals, which are at most grid + 1 apart
+        CHECK(after.bandwidth <= grid + 1);
+        CHECK(after.profile * 10 < before.profile);
+        CHECK(after.average_distance * 10 < before.average_distance);
+    }
+
+    TEST_CASE("RCM handles disconnected and nonsymmetric patterns") {
+        // Two components plus an isolated vertex; the one-sided entries
+        // still connect their rows
+        SparseMatrix<double> a(6, 6);
+        for (std::size_t i = 0; i < 6; ++i) a.insert(i, i, 1.0);
+        a.insert(0, 4, 1.0);
+        a.insert(4, 2, 1.0);
+        a.insert(3, 1, 1.0);
+        const auto perm = reverse_cuthill_mckee(a);
+        REQUIRE(is_permutation_of_range(perm, 6));
+        CHECK(bandwidth_stats(permute(a, perm, perm)).bandwidth == 1);
+
+        CHECK(reverse_cuthill_mckee(SparseMatrix<double>(0, 0)).empty());
+        CHECK_THROWS_AS(static_cast<void>(reverse_cuthill_mckee(SparseMatrix<double>(2, 3))), std::invalid_argument);
+    }
+
+    TEST_CASE("bisection ordering gives contiguous connected blocks") {
+        const std::size_t grid = 32;
+        const auto a = make_scrambled_grid(grid, shuffled(grid * grid, 11));
+        for (std::size_t parts : {1u, 3u, 4u}) {
+            const auto perm = bisection_ordering(a, parts);
+            REQUIRE(is_permutation_of_range(perm, a.rows()));
+            const auto b = permute(a, perm, perm);
+            const auto stats = bandwidth_stats(b);
+            CHECK(stats.average_distance * 10 < bandwidth_stats(a).average_distance);
+
+            // Few entries couple different blocks of an equal-rows split
+            const std::size_t block = (a.rows() + parts - 1) / parts;
+            std::size_t crossing = 0;
+            for (std::size_t row = 0; row < b.rows(); ++row) {
+                for (auto col : b.row_indices(row)) {
+                    crossing += row / block != col / block ? 1u : 0u;
+                }
+            }
+            CHECK(crossing <= 2 * parts * grid * 2);
+        }
+        CHECK_THROWS_AS(static_cast<void>(bisection_ordering(a, 0)), std::invalid_argument);
+        // More parts than rows
+        CHECK(is_permutation_of_range(bisection_ordering(make_scrambled_grid(2, shuffled(4, 1)), 9), 4));
+    }
+
+    TEST_CASE("permute gathers rows and columns") {
+        SparseMatrix<double, std::uint32_t, std::uint32_t> a(3, 4);
+        a.insert(0, 0, 1.0);
+        a.insert(0, 3, 2.0);
+        a.insert(1, 1, 3.0);
+        a.insert(2, 0, 4.0);
+        a.insert(2, 2, 5.0);
+        const Permutation rows{2, 0, 1};
+        const Permutation cols{3, 2, 1, 0};
+        const auto b = permute(a, rows, cols);
+        for (std::size_t i = 0; i < 3; ++i) {
+            for (std::size_t j = 0; j < 4; ++j) {
+                CHECK(b(i, j) == a(rows[i], cols[j]));
+            }
+        }
+        CHECK(b.nnz() == a.nnz());
+
+        CHECK_THROWS_AS(static_cast<void>(permute(a, Permutation{0, 1}, cols)), std::invalid_argument);
+        CHECK_THROWS_AS(static_cast<void>(permute(a, Permutation{0, 0, 1}, cols)), std::invalid_argument);
+        CHECK_THROWS_AS(static_cast<void>(permute(a, rows, Permutation{0, 1, 2, 4})), std::invalid_argument);
+    }
+
+    TEST_CASE("permute re-sorts long rows") {
+        // One dense row among short ones; reversing the columns turns it
+        // into a descending run that must come out sorted
+        constexpr std::size_t n = 5000;
+        SparseMatrixBuilder<double, std::uint32_t, std::uint32_t> builder(n, n);
+        for (std::size_t j = 0; j < n; ++j) {
+            builder.add(7, j, static_cast<double>(j) + 1.0);
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            builder.add(i, i, 2.0);
+            if (i + 1 < n) builder.add(i, i + 1, -1.0);
+        }
+        const auto a = builder.build();
+        Permutation reversed(n);
+        std::iota(reversed.begin(), reversed.end(), std::size_t{0});
+        std::reverse(reversed.begin(), reversed.end());
+
+        execution::ThreadPool pool(2);
+        for (const auto& b : {permute(a, reversed, reversed), permute(a, reversed, reversed, pool)}) {
+            CHECK(b.nnz() == a.nnz());
+            CHECK(b.row_indices(n - 1 - 7).size() == n);
+            for (std::size_t i = 0; i < n; ++i) {
+                const auto cols = b.row_indices(i);
+                REQUIRE(std::is_sorted(cols.begin(), cols.end()));
+            }
+            for (std::size_t j = 0; j < n; j += 97) {
+                REQUIRE(b(n - 1 - 7, j) == a(7, n - 1 - j));
+            }
+        }
+    }
+
+    TEST_CASE("parallel permute and permuted SpMV") {
+        const auto a = make_scrambled_grid<std::uint32_t, std::uint32_t>(40, shuffled(1600, 5));
+        const auto perm = reverse_cuthill_mckee(a);
+        execution::ThreadPool pool(3);
+        const auto sequential = permute(a, perm, perm);
+        const auto parallel = permute(a, perm, perm, pool);
+        CHECK(parallel.raw_data().row_ptrs == sequential.raw_data().row_ptrs);
+        CHECK(parallel.raw_data().col_indices == sequential.raw_data().col_indices);
+        CHECK(parallel.raw_data().values == sequential.raw_data().values);
+
+        // (P A P^T)(P x) = P (A x)
+        std::vector<double> x(a.rows());
+        for (std::size_t i = 0; i < x.size(); ++i) x[i] = static_cast<double>(i % 13) - 6.0;
+        std::vector<double> px(x.size());
+        permute_vector<double>(perm, x, px);
+        const auto ax = MatrixOps<double>::multiply(a, x);
+        std::vector<double> p_ax(x.size());
+        permute_vector<double>(perm, ax, p_ax);
+        CHECK(MatrixOps<double>::multiply(parallel, px) == p_ax);
+
+        const auto inverse = inverse_permutation(perm);
+        std::vector<double> back(x.size());
+        permute_vector<double>(inverse, px, back);
+        CHECK(back == x);
+    }
+}
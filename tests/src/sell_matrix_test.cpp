@@ -0,0 +1,191 @@
+#include <doctest/doctest.h>
+#include "test_helpers.hpp"
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/core/sell_matrix.hpp>
+#include <sparse_linalg/core/matrix_ops.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <sparse_linalg/execution/cpu_features.hpp>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace sparse_linalg;
+using namespace sparse_linalg::test;
+
+namespace {
+    // Row lengths 0..12 with an occasional dense row, so chunks need
+    // padding and sorting has something to do
+    constexpr RowPattern pattern{12, 37, 5};
+}
+
+TEST_SUITE("SellMatrix") {
+    TEST_CASE("chunk layout and padding") {
+        // Rows of length 1, 3, 0, 2 with C = 2 and no sorting
+        SparseMatrix<double> csr(4, 5);
+        csr.insert(0, 4, 1.0);
+        csr.insert(1, 0, 2.0);
+        csr.insert(1, 2, 3.0);
+        csr.insert(1, 3, 4.0);
+        csr.insert(3, 1, 5.0);
+        csr.insert(3, 2, 6.0);
+
+        const SellMatrix<double> sell(csr, SellOptions{2, 1});
+        CHECK(sell.chunk_height() == 2);
+        CHECK(sell.chunks() == 2);
+        CHECK(sell.nnz() == 6);
+        CHECK(sell.row_permutation().empty());
+        REQUIRE(sell.stored() == 10);
+        CHECK(sell.chunk_ptrs()[1] == 6);
+        CHECK(sell.chunk_ptrs()[2] == 10);
+
+        // Chunk 0 column-major: (row 0, row 1) per step, row 0 padded with
+        // its last column and zero values
+        const std::vector<std::size_t> cols{4, 0, 4, 2, 4, 3, 0, 1, 0, 2};
+        const std::vector<double> values{1, 2, 0, 3, 0, 4, 0, 5, 0, 6};
+        for (std::size_t k = 0; k < sell.stored(); ++k) {
+            CHECK(sell.col_indices()[k] == cols[k]);
+            CHECK(sell.values()[k] == values[k]);
+        }
+    }
+
+    TEST_CASE("sigma sorting reorders rows within windows") {
+        const auto csr = make_irregular<SparseMatrix<double>>(100, 60, pattern);
+        const SellMatrix<double> unsorted(csr, SellOptions{4, 1});
+        const SellMatrix<double> sorted(csr, SellOptions{4, 16});
+        const SellMatrix<double> global(csr, SellOptions{4, 100 * 4});
+
+        CHECK(sorted.sigma() == 16);
+        CHECK(sorted.stored() <= unsorted.stored());
+        CHECK(global.stored() <= sorted.stored());
+        CHECK(global.stored() >= global.nnz());
+
+        const auto perm = sorted.row_permutation();
+        REQUIRE(perm.size() == csr.rows());
+        std::vector<bool> seen(csr.rows(), false);
+        for (std::size_t slot = 0; slot < perm.size(); ++slot) {
+            // Rows never leave their window, and lengths fall within it
+            CHECK(perm[slot] / 16 == slot / 16);
+            CHECK_FALSE(seen[perm[slot]]);
+            seen[perm[slot]] = true;
+            if (slot % 16 != 0) {
+                CHECK(csr.row_indices(perm[slot - 1]).size() >= csr.row_indices(perm[slot]).size());
+            }
+        }
+    }
+
+    TEST_CASE_TEMPLATE("product matches CSR", Matrix,
+                       SparseMatrix<double>,
+                       SparseMatrix<float>,
+                       SparseMatrix<double, std::uint32_t, std::uint32_t>,
+                       SparseMatrix<float, std::uint32_t, std::uint64_t>,
+                       SparseMatrix<double, std::uint16_t, std::uint32_t>) {
+        using Value = typename Matrix::value_type;
+        using Sell = SellMatrix<Value, typename Matrix::index_type>;
+        const auto csr = make_irregular<Matrix>(203, 150, pattern);
+        const auto x = make_vector<Value>(csr.cols());
+        const auto expected = MatrixOps<Value>::multiply(csr, std::span<const Value>(x));
+        execution::ThreadPool pool(4);
+
+        // Host SIMD width (vector kernel), both vector widths, and heights
+        // that only the scalar kernel handles
+        const std::size_t auto_height = detail::simd_lanes<Value>(execution::active_simd_level());
+        for (std::size_t height : {std::size_t{0}, std::size_t{1}, std::size_t{3},
+                                   32 / sizeof(Value), 64 / sizeof(Value)}) {
+            for (std::size_t sigma : {std::size_t{1}, std::size_t{0}}) {
+                const Sell sell(csr, SellOptions{height, sigma});
+                CHECK(sell.chunk_height() == (height == 0 ? auto_height : height));
+                check_close(MatrixOps<Value>::multiply(sell, std::span<const Value>(x)), expected);
+
+                std::vector<Value> y(csr.rows(), Value{7});
+                MatrixOps<Value>::multiply_parallel(sell, std::span<const Value>(x), std::span<Value>(y), pool);
+                check_close(y, expected);
+
+                const Sell parallel_built(csr, pool, SellOptions{height, sigma});
+                REQUIRE(parallel_built.stored() == sell.stored());
+                for (std::size_t k = 0; k < sell.stored(); ++k) {
+                    CHECK(parallel_built.col_indices()[k] == sell.col_indices()[k]);
+                    CHECK(parallel_built.values()[k] == sell.values()[k]);
+                }
+            }
+        }
+    }
+
+    TEST_CASE("every kernel the host supports gives the same product") {
+        const auto csr = make_irregular<SparseMatrix<double>>(77, 90, pattern);
+        const auto x = make_vector<double>(csr.cols());
+        const auto expected = MatrixOps<double>::multiply(csr, std::span<const double>(x));
+
+        for (auto level : {execution::SimdLevel::scalar, execution::SimdLevel::avx2, execution::SimdLevel::avx512}) {
+            if (level > execution::active_simd_level()) {
+                continue;
+            }
+            const SellMatrix<double> sell(csr, SellOptions{detail::simd_lanes<double>(level), 0});
+            const auto kernel = detail::SellKernel<double, std::size_t, std::size_t>::select(level, sell.chunk_height());
+            std::vector<double> y(csr.rows());
+            kernel(detail::sell_arrays(sell), x.data(), y.data(), 0, sell.chunks(), 1.0, 0.0);
+            check_close(y, expected);
+        }
+    }
+
+    TEST_CASE("alpha and beta") {
+        const auto csr = make_irregular<SparseMatrix<double>>(64, 64, pattern);
+        const SellMatrix<double> sell(csr);
+        const auto x = make_vector<double>(64);
+        const auto ax = MatrixOps<double>::multiply(csr, std::span<const double>(x));
+        execution::ThreadPool pool(3);
+
+        std::vector<double> y(64, 2.0);
+        MatrixOps<double>::multiply(sell, std::span<const double>(x), std::span<double>(y), 0.5, -1.0);
+        std::vector<double> expected(64);
+        for (std::size_t i = 0; i < 64; ++i) {
+            expected[i] = 0.5 * ax[i] - 2.0;
+        }
+        check_close(y, expected);
+
+        std::vector<double> z(64, 2.0);
+        MatrixOps<double>::multiply_parallel(sell, std::span<const double>(x), std::span<double>(z), pool, 0.5, -1.0);
+        check_close(z, expected);
+
+        // alpha == 0 only scales y
+        MatrixOps<double>::multiply(sell, std::span<const double>(x), std::span<double>(z), 0.0, 2.0);
+        for (std::size_t i = 0; i < 64; ++i) {
+            expected[i] *= 2.0;
+        }
+        check_close(z, expected);
+    }
+
+    TEST_CASE("empty rows and empty matrix") {
+        SparseMatrix<double> csr(10, 4);
+        csr.insert(9, 3, 2.0);
+        const SellMatrix<double> sell(csr, SellOptions{4, 8});
+        const std::vector<double> x{1.0, 1.0, 1.0, 1.0};
+        const auto y = MatrixOps<double>::multiply(sell, std::span<const double>(x));
+        for (std::size_t i = 0; i < 9; ++i) {
+            CHECK(y[i] == 0.0);
+        }
+        CHECK(y[9] == 2.0);
+
+        const SellMatrix<double> none(SparseMatrix<double>(0, 3));
+        CHECK(none.chunks() == 0);
+        CHECK(none.stored() == 0);
+        execution::ThreadPool pool(2);
+        std::vector<double> out;
+        MatrixOps<double>::multiply_parallel(none, std::span<const double>(x.data(), 3), std::span<double>(out), pool);
+    }
+
+    TEST_CASE("invalid options and dimensions") {
+        const auto csr = make_irregular<SparseMatrix<double>>(20, 20, pattern);
+        CHECK_THROWS_AS(SellMatrix<double>(csr, SellOptions{4, 6}), std::invalid_argument);
+        CHECK_NOTHROW(SellMatrix<double>(csr, SellOptions{4, 1}));
+
+        const SellMatrix<double> sell(csr);
+        std::vector<double> x(19);
+        std::vector<double> y(20);
+        CHECK_THROWS_AS(static_cast<void>(MatrixOps<double>::multiply(sell, std::span<const double>(x))),
+                        std::invalid_argument);
+        x.resize(20);
+        y.resize(21);
+        CHECK_THROWS_AS(MatrixOps<double>::multiply(sell, std::span<const double>(x), std::span<double>(y)),
+                        std::invalid_argument);
+    }
+}
@@ -0,0 +1,128 @@
+#include <doctest/doctest.h>
+#include <sparse_linalg/core/sparse_matrix_builder.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <cstdint>
+#include <random>
+
+using namespace sparse_linalg;
+
+TEST_SUITE("SparseMatrixBuilder") {
+    TEST_CASE("unsorted triplets") {
+        SparseMatrixBuilder<double> builder(4, 4);
+        builder.add(3, 1, 4.0);
+        builder.add(0, 2, 2.0);
+        builder.add(0, 0, 1.0);
+        builder.add(2, 3, 3.0);
+        
+        auto matrix = builder.build();
+        
+        CHECK(matrix.rows() == 4);
+        CHECK(matrix.cols() == 4);
+        CHECK(matrix.nnz() == 4);
+        CHECK(matrix(0, 0) == doctest::Approx(1.0));
+        CHECK(matrix(0, 2) == doctest::Approx(2.0));
+        CHECK(matrix(2, 3) == doctest::Approx(3.0));
+        CHECK(matrix(3, 1) == doctest::Approx(4.0));
+        CHECK(matrix.row_values(1).empty());
+        
+        auto indices = matrix.row_indices(0);
+        REQUIRE(indices.size() == 2);
+        CHECK(indices[0] == 0);
+        CHECK(indices[1] == 2);
+    }
+    
+    TEST_CASE("duplicate policies") {
+        SUBCASE("sum") {
+            SparseMatrixBuilder<double> builder(2, 2, DuplicatePolicy::sum);
+            builder.add(1, 1, 1.0);
+            builder.add(1, 1, 2.5);
+            auto matrix = builder.build();
+            CHECK(matrix.nnz() == 1);
+            CHECK(matrix(1, 1) == doctest::Approx(3.5));
+        }
+        
+        SUBCASE("last wins") {
+            SparseMatrixBuilder<double> builder(2, 2, DuplicatePolicy::last_wins);
+            builder.add(1, 1, 1.0);
+            builder.add(0, 0, 7.0);
+            builder.add(1, 1, 2.5);
+            auto matrix = builder.build();
+            CHECK(matrix.nnz() == 2);
+            CHECK(matrix(1, 1) == doctest::Approx(2.5));
+        }
+        
+        SUBCASE("error") {
+            SparseMatrixBuilder<double> builder(2, 2, DuplicatePolicy::error);
+            builder.add(0, 1, 1.0);
+            builder.add(0, 1, 2.0);
+            CHECK_THROWS_AS([[maybe_unused]] auto m = builder.build(), std::invalid_argument);
+            
+            execution::ThreadPool pool(2);
+            CHECK_THROWS_AS([[maybe_unused]] auto m = builder.build(pool), std::invalid_argument);
+        }
+        
+        SUBCASE("cancelling entries are dropped") {
+            SparseMatrixBuilder<double> builder(2, 2);
+            builder.add(0, 0, 1.0);
+            builder.add(0, 0, -1.0);
+            builder.add(1, 0, 0.0);
+            CHECK(builder.build().nnz() == 0);
+        }
+    }
+    
+    TEST_CASE("bounds checking") {
+        SparseMatrixBuilder<double> builder(3, 3);
+        CHECK_THROWS_AS(builder.add(3, 0, 1.0), std::out_of_range);
+        CHECK_THROWS_AS(builder.add(0, 3, 1.0), std::out_of_range);
+        
+        SparseMatrix<double>::CSRMatrix bad{{1.0}, {5}, {0, 1, 1, 1}};
+        CHECK_THROWS_AS(SparseMatrix<double>(3, 3, bad), std::invalid_argument);
+    }
+    
+    TEST_CASE("parallel build matches insert") {
+        const std::size_t size = 500;
+        std::mt19937 gen(7);
+        std::uniform_int_distribution<std::size_t> index_dist(0, size - 1);
+        std::uniform_real_distribution<double> val_dist(1.0, 2.0);
+        
+        SparseMatrix<double> reference(size, size);
+        SparseMatrixBuilder<double> builder(size, size, DuplicatePolicy::last_wins);
+        for (std::size_t i = 0; i < 20000; ++i) {
+            const auto row = index_dist(gen);
+            const auto col = index_dist(gen);
+            const auto value = val_dist(gen);
+            reference.insert(row, col, value);
+            builder.add(row, col, value);
+        }
+        
+        execution::ThreadPool pool(4);
+        auto matrix = builder.build(pool);
+        
+        const auto& expected = reference.raw_data();
+        const auto& actual = matrix.raw_data();
+        CHECK(actual.row_ptrs == expected.row_ptrs);
+        CHECK(actual.col_indices == expected.col_indices);
+        CHECK(actual.values == expected.values);
+    }
+    
+    TEST_CASE("narrow index types") {
+        SparseMatrixBuilder<double, std::uint32_t, std::uint64_t> builder(3, 3);
+        builder.add(2, 1, 1.0);
+        builder.add(0, 2, 2.0);
+        auto matrix = builder.build();
+        
+        CHECK(matrix.nnz() == 2);
+        CHECK(matrix(2, 1) == doctest::Approx(1.0));
+        CHECK(matrix(0, 2) == doctest::Approx(2.0));
+        
+        using TinyBuilder = SparseMatrixBuilder<double, std::uint8_t, std::uint8_t>;
+        CHECK_THROWS_AS(TinyBuilder(2, 300), std::overflow_error);
+        
+        TinyBuilder tiny(2, 200);
+        for (std::size_t col = 0; col < 200; ++col) {
+            tiny.add(0, col, 1.0);
+            tiny.add(1, col, 1.0);
+        }
+        CHECK_THROWS_AS([[maybe_unused]] auto m = tiny.build(), std::overflow_error);
+    }
+}
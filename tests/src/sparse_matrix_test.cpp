@@ -1,5 +1,6 @@
 #include <doctest/doctest.h>
 #include <sparse_linalg/core/sparse_matrix.hpp>
+#include <cstdint>
 
 using namespace sparse_linalg;
 
@@ -68,4 +69,43 @@ TEST_SUITE("SparseMatrix") {
         CHECK(indices[1] == 2);
         CHECK(indices[2] == 4);
     }
-}
\ No newline at end of file
+    
+    TEST_CASE_TEMPLATE("narrow index types", Matrix,
+                       SparseMatrix<double, std::uint32_t, std::uint64_t>,
+                       SparseMatrix<double, std::int32_t, std::int32_t>,
+                       SparseMatrix<float, std::uint16_t, std::uint32_t>) {
+        Matrix matrix(5, 5);
+        matrix.insert(2, 4, 3.0);
+        matrix.insert(2, 0, 1.0);
+        matrix.insert(4, 2, 2.0);
+        
+        CHECK(matrix.nnz() == 3);
+        CHECK(matrix(2, 4) == doctest::Approx(3.0));
+        CHECK(matrix(4, 2) == doctest::Approx(2.0));
+        
+        auto indices = matrix.row_indices(2);
+        static_assert(std::is_same_v<typename decltype(indices)::value_type,
+                                     typename Matrix::index_type>);
+        REQUIRE(indices.size() == 2);
+        CHECK(indices[0] == 0);
+        CHECK(indices[1] == 4);
+        CHECK(matrix.raw_data().row_ptrs.back() == 3);
+    }
+    
+    TEST_CASE("index overflow checking") {
+        using TinyMatrix = SparseMatrix<double, std::uint8_t, std::uint8_t>;
+        
+        CHECK_THROWS_AS(TinyMatrix(4, 257), std::overflow_error);
+        CHECK_NOTHROW(TinyMatrix(4, 256));
+        
+        TinyMatrix matrix(255, 2);
+        for (std::size_t i = 0; i < 127; ++i) {
+            matrix.insert(i, 0, 1.0);
+            matrix.insert(i, 1, 1.0);
+        }
+        matrix.insert(127, 0, 1.0);
+        CHECK(matrix.nnz() == 255);
+        CHECK_THROWS_AS(matrix.insert(127, 1, 1.0), std::overflow_error);
+        CHECK(matrix.nnz() == 255);
+    }
+}
@@ -0,0 +1,178 @@
+#include <doctest/doctest.h>
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/core/spgemm.hpp>
+#include <sparse_linalg/core/matrix_ops.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <cstdint>
+
+using namespace sparse_linalg;
+
+namespace {
+    template<typename Matrix>
+    Matrix make_pattern_matrix(std::size_t rows, std::size_t cols, std::size_t seed) {
+        using Value = typename Matrix::value_type;
+        Matrix matrix(rows, cols);
+        for (std::size_t i = 0; i < rows; ++i) {
+            const std::size_t row_nnz = (i * seed) % 6;
+            for (std::size_t k = 0; k < row_nnz; ++k) {
+                matrix.insert(i, (i * 7 + k * (seed + 3)) % cols, static_cast<Value>((i + k + seed) % 5 + 1));
+            }
+        }
+        return matrix;
+    }
+
+    template<typename Matrix>
+    std::vector<double> dense_product(const Matrix& a, const Matrix& b) {
+        std::vector<double> c(a.rows() * b.cols(), 0.0);
+        for (std::size_t i = 0; i < a.rows(); ++i) {
+            for (std::size_t k = 0; k < a.cols(); ++k) {
+                for (std::size_t j = 0; j < b.cols(); ++j) {
+                    c[i * b.cols() + j] += static_cast<double>(a(i, k)) * static_cast<double>(b(k, j));
+                }
+            }
+        }
+        return c;
+    }
+
+    template<typename Matrix>
+    void check_product(const Matrix& c, const std::vector<double>& expected) {
+        for (std::size_t i = 0; i < c.rows(); ++i) {
+            for (std::size_t j = 0; j < c.cols(); ++j) {
+                CHECK(static_cast<double>(c(i, j)) == doctest::Approx(expected[i * c.cols() + j]));
+            }
+            auto cols = c.row_indices(i);
+            for (std::size_t k = 1; k < cols.size(); ++k) {
+                CHECK(cols[k - 1] < cols[k]);
+            }
+        }
+    }
+}
+
+TEST_SUITE("SpGEMM") {
+    TEST_CASE("small product") {
+        SparseMatrix<double> a(2, 3);
+        a.insert(0, 0, 1.0);
+        a.insert(0, 2, 2.0);
+        a.insert(1, 1, 3.0);
+
+        SparseMatrix<double> b(3, 2);
+        b.insert(0, 1, 4.0);
+        b.insert(1, 0, 5.0);
+        b.insert(2, 0, 6.0);
+        b.insert(2, 1, 7.0);
+
+        auto c = MatrixOps<double>::multiply(a, b);
+        REQUIRE(c.rows() == 2);
+        REQUIRE(c.cols() == 2);
+        CHECK(c.nnz() == 3);
+        CHECK(c(0, 0) == doctest::Approx(12.0));
+        CHECK(c(0, 1) == doctest::Approx(18.0));
+        CHECK(c(1, 0) == doctest::Approx(15.0));
+        CHECK(c(1, 1) == 0.0);
+    }
+
+    TEST_CASE_TEMPLATE("matches the dense product", Matrix,
+                       SparseMatrix<double>,
+                       SparseMatrix<float, std::uint32_t, std::uint32_t>,
+                       SparseMatrix<int, std::int32_t, std::int64_t>) {
+        const auto a = make_pattern_matrix<Matrix>(37, 23, 1);
+        const auto b = make_pattern_matrix<Matrix>(23, 41, 2);
+        const auto expected = dense_product(a, b);
+        execution::ThreadPool pool(4);
+
+        for (auto kind : {SpgemmAccumulator::dense, SpgemmAccumulator::hash}) {
+            using Value = typename Matrix::value_type;
+            using Index = typename Matrix::index_type;
+            using Offset = typename Matrix::offset_type;
+
+            SparseProduct<Value, Index, Offset> sequential(a, b, kind);
+            SparseProduct<Value, Index, Offset> parallel(a, b, pool, kind);
+            CHECK(sequential.accumulator() == kind);
+            CHECK(sequential.nnz() == parallel.nnz());
+
+            check_product(sequential.compute(a, b), expected);
+            check_product(parallel.compute(a, b, pool), expected);
+        }
+
+        check_product(MatrixOps<typename Matrix::value_type>::multiply_parallel(a, b, pool), expected);
+    }
+
+    TEST_CASE("numeric-only recompute") {
+        auto a = make_pattern_matrix<SparseMatrix<double>>(30, 30, 1);
+        auto b = make_pattern_matrix<SparseMatrix<double>>(30, 30, 3);
+        execution::ThreadPool pool(4);
+
+        SparseProduct<double> product(a, b, pool);
+        auto c = product.compute(a, b, pool);
+        const auto pattern = c.raw_data().col_indices;
+
+        // New values, same patterns
+        for (auto& value : a.values()) {
+            value = value * 2.0 - 1.0;
+        }
+        for (auto& value : b.values()) {
+            value = -value;
+        }
+
+        product.recompute(a, b, c, pool);
+        check_product(c, dense_product(a, b));
+        CHECK(c.raw_data().col_indices == pattern);
+
+        product.recompute(a, b, c);
+        check_product(c, dense_product(a, b));
+    }
+
+    TEST_CASE("cancellation keeps the symbolic pattern") {
+        SparseMatrix<double> a(1, 2);
+        a.insert(0, 0, 1.0);
+        a.insert(0, 1, 1.0);
+        SparseMatrix<double> b(2, 1);
+        b.insert(0, 0, 2.0);
+        b.insert(1, 0, -2.0);
+
+        auto c = MatrixOps<double>::multiply(a, b);
+        CHECK(c.nnz() == 1);
+        CHECK(c(0, 0) == 0.0);
+    }
+
+    TEST_CASE("hash accumulator on wide outputs") {
+        // Wide enough that automatic selection picks the hash map
+        const std::size_t wide = (std::size_t{1} << 16) + 100;
+        SparseMatrix<double> a(50, 20);
+        SparseMatrix<double> b(20, wide);
+        for (std::size_t i = 0; i < 50; ++i) {
+            a.insert(i, i % 20, 1.0 + static_cast<double>(i));
+            a.insert(i, (i * 3 + 1) % 20, 2.0);
+        }
+        for (std::size_t k = 0; k < 20; ++k) {
+            for (std::size_t j = 0; j < 8; ++j) {
+                b.insert(k, (k * 4099 + j * 8191) % wide, static_cast<double>(j + 1));
+            }
+        }
+
+        SparseProduct<double> product(a, b);
+        CHECK(product.accumulator() == SpgemmAccumulator::hash);
+        auto c = product.compute(a, b);
+        SparseProduct<double> dense(a, b, SpgemmAccumulator::dense);
+        auto reference = dense.compute(a, b);
+        CHECK(c.raw_data().col_indices == reference.raw_data().col_indices);
+        CHECK(c.raw_data().values == reference.raw_data().values);
+    }
+
+    TEST_CASE("dimension and pattern errors") {
+        SparseMatrix<double> a(3, 4);
+        SparseMatrix<double> b(3, 3);
+        CHECK_THROWS_AS(MatrixOps<double>::multiply(a, b), std::invalid_argument);
+
+        auto x = make_pattern_matrix<SparseMatrix<double>>(6, 6, 1);
+        auto y = make_pattern_matrix<SparseMatrix<double>>(6, 6, 2);
+        SparseProduct<double> product(x, y);
+        auto c = product.compute(x, y);
+
+        SparseMatrix<double> wrong(6, 6);
+        CHECK_THROWS_AS(product.recompute(x, y, wrong), std::invalid_argument);
+
+        x.insert(0, 5, 9.0);
+        CHECK_THROWS_AS(product.recompute(x, y, c), std::invalid_argument);
+    }
+}
@@ -0,0 +1,210 @@
+#include <doctest/doctest.h>
+#include "test_helpers.hpp"
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/core/dense_block.hpp>
+#include <sparse_linalg/core/matrix_ops.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <cstdint>
+#include <limits>
+
+using namespace sparse_linalg;
+using namespace sparse_linalg::test;
+
+namespace {
+    // Empty, short and long rows
+    constexpr RowPattern pattern{4, 7, 2};
+
+    template<typename Value>
+    std::vector<Value> make_block(std::size_t rows, std::size_t cols) {
+        std::vector<Value> block(rows * cols);
+        for (std::size_t i = 0; i < block.size(); ++i) {
+            block[i] = static_cast<Value>(i % 9) / Value{2} - Value{2};
+        }
+        return block;
+    }
+
+    // Column c of A * X computed through SpMV, for reference
+    template<typename Matrix, typename Value = typename Matrix::value_type>
+    std::vector<Value> reference_column(const Matrix& matrix, DenseBlockView<const Value> x, std::size_t c) {
+        std::vector<Value> column(x.rows());
+        for (std::size_t j = 0; j < x.rows(); ++j) {
+            column[j] = x(j, c);
+        }
+        return MatrixOps<Value>::multiply(matrix, column);
+    }
+}
+
+TEST_SUITE("SpMM") {
+    TEST_CASE("dense block views") {
+        std::vector<double> data(12);
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<double>(i);
+        }
+
+        DenseBlockView<double> rm(data, 3, 4);
+        CHECK(rm.leading_dimension() == 4);
+        CHECK(rm(1, 2) == 6.0);
+
+        DenseBlockView<double> cm(data, 3, 4, Layout::col_major);
+        CHECK(cm.leading_dimension() == 3);
+        CHECK(cm(1, 2) == 7.0);
+
+        DenseBlockView<double> padded(data, 2, 3, Layout::row_major, 5);
+        CHECK(padded(1, 0) == 5.0);
+
+        DenseBlockView<const double> read_only = rm;
+        CHECK(read_only(2, 3) == 11.0);
+
+        CHECK_THROWS_AS(DenseBlockView<double>(data, 4, 4), std::invalid_argument);
+        CHECK_THROWS_AS(DenseBlockView<double>(data, 2, 4, Layout::row_major, 3), std::invalid_argument);
+        CHECK_THROWS_AS(static_cast<void>(rm(3, 0)), std::out_of_range);
+    }
+
+    TEST_CASE_TEMPLATE("block multiply matches column-wise SpMV", Matrix,
+                       SparseMatrix<double>,
+                       SparseMatrix<double, std::uint32_t, std::uint32_t>,
+                       SparseMatrix<float, std::uint16_t, std::uint32_t>,
+                       SparseMatrix<int>) {
+        using Value = typename Matrix::value_type;
+        const std::size_t rows = 45;
+        const std::size_t cols = 60;
+        const auto matrix = make_irregular<Matrix>(rows, cols, pattern);
+
+        for (std::size_t k : {1u, 3u, 4u, 8u, 16u, 17u, 32u, 64u}) {
+            auto x_data = make_block<Value>(cols, k);
+            std::vector<Value> y_data(rows * k, Value{});
+            DenseBlockView<const Value> x(std::span<const Value>(x_data), cols, k);
+            DenseBlockView<Value> y(y_data, rows, k);
+
+            MatrixOps<Value>::multiply(matrix, x, y);
+
+            for (std::size_t c = 0; c < k; ++c) {
+                const auto expected = reference_column(matrix, x, c);
+                for (std::size_t i = 0; i < rows; ++i) {
+                    CHECK(static_cast<double>(y(i, c)) ==
+                          doctest::Approx(static_cast<double>(expected[i])).epsilon(1e-5));
+                }
+            }
+        }
+    }
+
+    TEST_CASE_TEMPLATE("every SIMD level and k", Value, float, double) {
+        const std::size_t rows = 30;
+        const std::size_t cols = 50;
+        const auto matrix = make_irregular<SparseMatrix<Value, std::int32_t, std::int64_t>>(rows, cols, pattern);
+        using Kernel = detail::SpmmKernel<Value, std::int32_t, std::int64_t>;
+        const auto arrays = detail::csr_arrays(matrix);
+
+        for (std::size_t k : {4u, 8u, 13u, 16u, 32u, 64u}) {
+            auto x = make_block<Value>(cols, k);
+            std::vector<Value> initial(rows * k);
+            for (std::size_t i = 0; i < initial.size(); ++i) {
+                initial[i] = static_cast<Value>(i % 3);
+            }
+            std::vector<Value> acc(k);
+
+            std::vector<Value> expected = initial;
+            const detail::SpmmArgs<Value> ref_args{x.data(), k, expected.data(), k, 1, k, Value{2}, Value{0.5}};
+            Kernel::select(execution::SimdLevel::scalar, k)(arrays, ref_args, 0, rows, acc.data());
+
+            for (auto level : {execution::SimdLevel::avx2, execution::SimdLevel::avx512}) {
+                if (level > execution::detected_simd_level()) {
+                    continue;
+                }
+                std::vector<Value> result = initial;
+                const detail::SpmmArgs<Value> args{x.data(), k, result.data(), k, 1, k, Value{2}, Value{0.5}};
+                Kernel::select(level, k)(arrays, args, 0, rows, acc.data());
+                for (std::size_t i = 0; i < result.size(); ++i) {
+                    CHECK(static_cast<double>(result[i]) ==
+                          doctest::Approx(static_cast<double>(expected[i])).epsilon(1e-5));
+                }
+            }
+        }
+    }
+
+    TEST_CASE("layouts, padding and alpha/beta") {
+        const std::size_t rows = 25;
+        const std::size_t cols = 40;
+        const std::size_t k = 8;
+        const auto matrix = make_irregular<SparseMatrix<double>>(rows, cols, pattern);
+        execution::ThreadPool pool(4);
+
+        auto x_rm_data = make_block<double>(cols, k);
+        DenseBlockView<const double> x_rm(std::span<const double>(x_rm_data), cols, k);
+
+        // Same X stored column-major with a padded leading dimension
+        const std::size_t ld = cols + 3;
+        std::vector<double> x_cm_data(ld * k, std::numeric_limits<double>::quiet_NaN());
+        DenseBlockView<double> x_cm(x_cm_data, cols, k, Layout::col_major, ld);
+        for (std::size_t j = 0; j < cols; ++j) {
+            for (std::size_t c = 0; c < k; ++c) {
+                x_cm(j, c) = x_rm(j, c);
+            }
+        }
+
+        std::vector<double> y0(rows * k);
+        for (std::size_t i = 0; i < y0.size(); ++i) {
+            y0[i] = static_cast<double>(i % 4);
+        }
+
+        for (auto x_layout : {Layout::row_major, Layout::col_major}) {
+            for (auto y_layout : {Layout::row_major, Layout::col_major}) {
+                std::vector<double> seq_data = y0;
+                std::vector<double> par_data = y0;
+                DenseBlockView<double> y_seq(seq_data, rows, k, y_layout);
+                DenseBlockView<double> y_par(par_data, rows, k, y_layout);
+                const DenseBlockView<const double> x = x_layout == Layout::row_major
+                    ? x_rm : DenseBlockView<const double>(x_cm);
+
+                MatrixOps<double>::multiply(matrix, x, y_seq, -1.0, 0.5);
+                MatrixOps<double>::multiply_parallel(matrix, x, y_par, pool, -1.0, 0.5);
+
+                for (std::size_t c = 0; c < k; ++c) {
+                    const auto ax = reference_column(matrix, x_rm, c);
+                    for (std::size_t i = 0; i < rows; ++i) {
+                        const double before = y_layout == Layout::row_major ? y0[i * k + c] : y0[c * rows + i];
+                        CHECK(y_seq(i, c) == doctest::Approx(-ax[i] + 0.5 * before));
+                        CHECK(y_par(i, c) == doctest::Approx(-ax[i] + 0.5 * before));
+                    }
+                }
+            }
+        }
+    }
+
+    TEST_CASE("beta == 0 never reads Y") {
+        const auto matrix = make_irregular<SparseMatrix<double>>(20, 20, pattern);
+        const std::size_t k = 16;
+        auto x_data = make_block<double>(20, k);
+        DenseBlockView<const double> x(std::span<const double>(x_data), 20, k);
+
+        std::vector<double> y_data(20 * k, std::numeric_limits<double>::quiet_NaN());
+        DenseBlockView<double> y(y_data, 20, k);
+        execution::ThreadPool pool(2);
+        MatrixOps<double>::multiply_parallel(matrix, x, y, pool);
+
+        for (std::size_t c = 0; c < k; ++c) {
+            const auto expected = reference_column(matrix, x, c);
+            for (std::size_t i = 0; i < 20; ++i) {
+                CHECK(y(i, c) == doctest::Approx(expected[i]));
+            }
+        }
+    }
+
+    TEST_CASE("block dimension errors") {
+        SparseMatrix<double> matrix(4, 3);
+        std::vector<double> x_data(3 * 2);
+        std::vector<double> y_data(4 * 2);
+        std::vector<double> wrong(5 * 2);
+
+        DenseBlockView<const double> x(std::span<const double>(x_data), 3, 2);
+        DenseBlockView<double> y(y_data, 4, 2);
+
+        CHECK_THROWS_AS(MatrixOps<double>::multiply(matrix, DenseBlockView<const double>(std::span<const double>(wrong), 5, 2), y),
+                        std::invalid_argument);
+        CHECK_THROWS_AS(MatrixOps<double>::multiply(matrix, x, DenseBlockView<double>(wrong, 5, 2)),
+                        std::invalid_argument);
+        CHECK_THROWS_AS(MatrixOps<double>::multiply(matrix, x, DenseBlockView<double>(y_data, 4, 1)),
+                        std::invalid_argument);
+        CHECK_NOTHROW(MatrixOps<double>::multiply(matrix, x, y));
+    }
+}
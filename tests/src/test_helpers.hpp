@@ -0,0 +1,156 @@
+#pragma once
+
+// Matrices, vectors, temporary files and checks shared by the test files
+
+#include <doctest/doctest.h>
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/core/sparse_matrix_builder.hpp>
+#include <sparse_linalg/core/matrix_ops.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace sparse_linalg::test {
+
+// Row lengths of make_irregular. Short rows hold (7 i) mod (short_max + 1)
+// entries, so every length up to short_max appears; rows with
+// i % long_every == long_first hold long_length entries instead.
+struct RowPattern {
+    std::size_t short_max = 12;
+    std::size_t long_every = 0;   // 0 = no long rows
+    std::size_t long_first = 0;
+    std::size_t long_length = 0;  // 0 = cols / 2
+};
+
+// Irregular pattern for kernels that must cope with empty, short and long
+// rows. Values are small multiples of 1/4, exact in every storage format,
+// so sums over them do not depend on the order of accumulation.
+template<typename Matrix>
+Matrix make_irregular(std::size_t rows, std::size_t cols, RowPattern pattern = {}) {
+    using Value = typename Matrix::value_type;
+    SparseMatrixBuilder<Value, typename Matrix::index_type, typename Matrix::offset_type> builder(rows, cols);
+    const std::size_t long_length = pattern.long_length == 0 ? cols / 2 : pattern.long_length;
+    for (std::size_t i = 0; i < rows; ++i) {
+        const bool long_row = pattern.long_every != 0 && i % pattern.long_every == pattern.long_first;
+        const std::size_t length = long_row ? long_length : (i * 7) % (pattern.short_max + 1);
+        for (std::size_t k = 0; k < length; ++k) {
+            // Long rows are contiguous runs so they never repeat a column
+            const std::size_t col = long_row ? (i + k) % cols : (k * 11 + i * 3) % cols;
+            builder.add(i, col, static_cast<Value>((i + 2 * k) % 9 + 1) / Value{4});
+        }
+    }
+    return builder.build();
+}
+
+// 5-point stencil on a grid x grid mesh with an upwinded convection term:
+// the Laplacian, symmetric positive definite, when convection is zero, and
+// nonsymmetric but diagonally dominant otherwise
+template<typename T, typename Index = std::size_t, typename Offset = std::size_t>
+SparseMatrix<T, Index, Offset> make_stencil(std::size_t grid, T convection = T{}) {
+    const std::size_t n = grid * grid;
+    SparseMatrixBuilder<T, Index, Offset> builder(n, n);
+    for (std::size_t i = 0; i < grid; ++i) {
+        for (std::size_t j = 0; j < grid; ++j) {
+            const std::size_t row = i * grid + j;
+            builder.add(row, row, static_cast<T>(4 + convection));
+            if (i > 0) builder.add(row, row - grid, T{-1});
+            if (i + 1 < grid) builder.add(row, row + grid, T{-1});
+            if (j > 0) builder.add(row, row - 1, static_cast<T>(-1 - convection));
+            if (j + 1 < grid) builder.add(row, row + 1, T{-1});
+        }
+    }
+    return builder.build();
+}
+
+// Couples rows stride apart only, so every level of either triangular sweep
+// holds stride rows and level schedules split across a pool
+inline SparseMatrix<double> make_strided(std::size_t n, std::size_t stride) {
+    SparseMatrixBuilder<double> builder(n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+        builder.add(i, i, 5.0 + static_cast<double>(i % 3));
+        if (i >= stride) builder.add(i, i - stride, -1.0 - 0.001 * static_cast<double>(i % 11));
+        if (i + stride < n) builder.add(i, i + stride, -1.5);
+    }
+    return builder.build();
+}
+
+// Multiples of 1/8 in [-1, 1], exact in float; seed shifts the pattern
+template<typename T = double>
+std::vector<T> make_vector(std::size_t n, std::size_t seed = 0) {
+    std::vector<T> x(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        x[i] = static_cast<T>(static_cast<double>((i + seed) % 17) * 0.125 - 1.0);
+    }
+    return x;
+}
+
+// ||b - A x|| / ||b||, accumulated in double
+template<typename Matrix, typename T>
+double relative_residual(const Matrix& a, const std::vector<T>& b, const std::vector<T>& x) {
+    const auto ax = MatrixOps<T>::multiply(a, x);
+    double r = 0.0;
+    double nb = 0.0;
+    for (std::size_t i = 0; i < b.size(); ++i) {
+        const double d = static_cast<double>(b[i]) - static_cast<double>(ax[i]);
+        r += d * d;
+        nb += static_cast<double>(b[i]) * static_cast<double>(b[i]);
+    }
+    return std::sqrt(r / nb);
+}
+
+// Same shape and the same entries row by row. Works across allocators and
+// between matrices and views.
+template<typename A, typename B>
+bool same_entries(const A& a, const B& b) {
+    if (a.rows() != b.rows() || a.cols() != b.cols() || a.nnz() != b.nnz()) return false;
+    for (std::size_t row = 0; row < a.rows(); ++row) {
+        const auto a_indices = a.row_indices(row);
+        const auto b_indices = b.row_indices(row);
+        const auto a_values = a.row_values(row);
+        const auto b_values = b.row_values(row);
+        if (!std::equal(a_indices.begin(), a_indices.end(), b_indices.begin(), b_indices.end()) ||
+            !std::equal(a_values.begin(), a_values.end(), b_values.begin(), b_values.end())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Removes the file when the test ends, pass or fail
+struct TempFile {
+    std::filesystem::path path;
+
+    TempFile(const std::string& name, const std::string& extension)
+        : path(std::filesystem::temp_directory_path() /
+               (name + "_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + extension)) {}
+    ~TempFile() {
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+    }
+};
+
+// Default tolerance of check_close: a few ulps of accumulated rounding
+template<typename T>
+inline constexpr double default_tolerance = sizeof(T) == 4 ? 1e-4 : 1e-12;
+
+// |actual - expected| <= tolerance * (1 + |expected|) entrywise
+template<typename T>
+void check_close(const std::vector<T>& actual, const std::vector<T>& expected,
+                 double tolerance = default_tolerance<T>) {
+    REQUIRE(actual.size() == expected.size());
+    std::size_t wrong = 0;
+    for (std::size_t i = 0; i < actual.size(); ++i) {
+        if (!(std::abs(static_cast<double>(actual[i] - expected[i])) <=
+              tolerance * (1.0 + std::abs(static_cast<double>(expected[i]))))) {
+            ++wrong;
+        }
+    }
+    CHECK(wrong == 0);
+}
+
+} // namespace sparse_linalg::test
@@ -1,9 +1,17 @@
 #include <doctest/doctest.h>
 #include <sparse_linalg/execution/thread_pool.hpp>
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <cmath>
+#include <future>
 #include <vector>
+#include <memory>
 #include <numeric>
+#include <thread>
+
+#include <sched.h>
 
 using namespace sparse_linalg::execution;
 using namespace std::chrono_literals;
@@ -117,4 +125,419 @@ TEST_SUITE("ThreadPool") {
             CHECK(completed_tasks == num_tasks);
         }
     }
-}
\ No newline at end of file
+}
+TEST_SUITE("ThreadPool work stealing") {
+    TEST_CASE("tasks submitted from workers") {
+        ThreadPool pool(4);
+        std::atomic<std::size_t> leaves{0};
+        constexpr std::size_t fan_out = 64;
+
+        // Each outer task spawns more than a local deque holds, so both the
+        // local push and the overflow path run
+        std::vector<std::future<void>> outer;
+        for (std::size_t i = 0; i < 4; ++i) {
+            outer.push_back(pool.submit([&pool, &leaves]() {
+                for (std::size_t k = 0; k < ThreadPool::local_capacity + fan_out; ++k) {
+                    pool.submit([&leaves]() { leaves.fetch_add(1, std::memory_order_relaxed); });
+                }
+            }));
+        }
+        for (auto& future : outer) {
+            future.get();
+        }
+        pool.wait_all();
+        CHECK(leaves == 4 * (ThreadPool::local_capacity + fan_out));
+    }
+
+    TEST_CASE("arguments are bound by value") {
+        ThreadPool pool(2);
+        auto future = pool.submit([](std::vector<int> values, int scale) {
+            return std::accumulate(values.begin(), values.end(), 0) * scale;
+        }, std::vector<int>{1, 2, 3}, 2);
+        CHECK(future.get() == 12);
+    }
+
+    TEST_CASE("idle workers wake for new work") {
+        ThreadPool pool(3);
+        for (int round = 0; round < 5; ++round) {
+            std::this_thread::sleep_for(5ms);
+            auto future = pool.submit([round]() { return round; });
+            CHECK(future.get() == round);
+        }
+    }
+}
+
+TEST_SUITE("ThreadPool parallel_for") {
+    TEST_CASE("every index is visited once") {
+        for (auto policy : {IdlePolicy::park, IdlePolicy::spin_then_park}) {
+            ThreadPool pool(4, policy);
+            CHECK(pool.idle_policy() == policy);
+            for (std::size_t grain : {std::size_t{0}, std::size_t{1}, std::size_t{7}, std::size_t{5000}}) {
+                constexpr std::size_t n = 1000;
+                std::vector<std::atomic<int>> hits(n);
+                std::atomic<std::size_t> max_chunk{0};
+                pool.parallel_for(n, grain, [&](std::size_t begin, std::size_t end) {
+                    REQUIRE(begin < end);
+                    REQUIRE(end <= n);
+                    std::size_t seen = max_chunk.load();
+                    while (seen < end - begin && !max_chunk.compare_exchange_weak(seen, end - begin)) {}
+                    for (std::size_t i = begin; i < end; ++i) {
+                        hits[i].fetch_add(1, std::memory_order_relaxed);
+                    }
+                });
+                std::size_t wrong = 0;
+                for (auto& hit : hits) {
+                    wrong += hit.load() == 1 ? 0u : 1u;
+                }
+                CHECK(wrong == 0);
+                if (grain > 0) {
+                    CHECK(max_chunk.load() <= grain);
+                }
+            }
+        }
+    }
+
+    TEST_CASE("back-to-back calls") {
+        ThreadPool pool(3, IdlePolicy::spin_then_park);
+        std::vector<double> data(4096, 1.0);
+        for (int round = 0; round < 200; ++round) {
+            pool.parallel_for(data.size(), 64, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    data[i] *= 2.0;
+                }
+            });
+            if (round % 50 == 49) {
+                // Mixed with queued tasks
+                CHECK(pool.submit([]() { return 3; }).get() == 3);
+            }
+        }
+        CHECK(data.front() == std::ldexp(1.0, 200));
+        CHECK(data.back() == std::ldexp(1.0, 200));
+    }
+
+    TEST_CASE("exceptions reach the caller") {
+        ThreadPool pool(4);
+        std::atomic<int> calls{0};
+        CHECK_THROWS_AS(pool.parallel_for(100, 1, [&](std::size_t begin, std::size_t) {
+            calls.fetch_add(1);
+            if (begin == 10) {
+                throw std::runtime_error("chunk failed");
+            }
+        }), std::runtime_error);
+        CHECK(calls.load() >= 1);
+
+        // The pool is still usable
+        std::atomic<std::size_t> total{0};
+        pool.parallel_for(100, 10, [&](std::size_t begin, std::size_t end) { total += end - begin; });
+        CHECK(total == 100);
+    }
+
+    TEST_CASE("nested and concurrent calls") {
+        ThreadPool pool(4);
+        std::atomic<std::size_t> total{0};
+
+        // From inside a task the chunks run inline
+        pool.submit([&]() {
+            pool.parallel_for(50, 5, [&](std::size_t begin, std::size_t end) { total += end - begin; });
+        }).get();
+        CHECK(total == 50);
+
+        // Callers outside the pool take turns
+        std::vector<std::thread> callers;
+        for (int t = 0; t < 3; ++t) {
+            callers.emplace_back([&]() {
+                for (int round = 0; round < 20; ++round) {
+                    pool.parallel_for(100, 3, [&](std::size_t begin, std::size_t end) { total += end - begin; });
+                }
+            });
+        }
+        for (auto& caller : callers) {
+            caller.join();
+        }
+        CHECK(total == 50 + 3 * 20 * 100);
+
+        bool called = false;
+        pool.parallel_for(0, 1, [&](std::size_t, std::size_t) { called = true; });
+        CHECK_FALSE(called);
+    }
+}
+
+TEST_SUITE("ThreadPool placement") {
+    TEST_CASE("parallel_for_static gives each worker a fixed block") {
+        ThreadPool pool(3);
+        constexpr std::size_t n = 10;
+        std::vector<std::size_t> owner(n, 99);
+        for (int round = 0; round < 20; ++round) {
+            std::vector<std::size_t> seen(n, 99);
+            std::atomic<int> calls{0};
+            pool.parallel_for_static(n, [&](std::size_t begin, std::size_t end) {
+                calls.fetch_add(1);
+                const auto worker = pool.worker_index();
+                REQUIRE(worker.has_value());
+                for (std::size_t i = begin; i < end; ++i) {
+                    seen[i] = *worker;
+                }
+            });
+            CHECK(calls.load() == 3);
+            if (round == 0) {
+                owner = seen;
+            }
+            CHECK(seen == owner);
+        }
+        // Blocks of 4, 3 and 3 in worker order
+        CHECK(owner == std::vector<std::size_t>{0, 0, 0, 0, 1, 1, 1, 2, 2, 2});
+        CHECK_FALSE(pool.worker_index().has_value());
+
+        // Fewer indices than workers: the others get empty blocks
+        std::atomic<std::size_t> total{0};
+        pool.parallel_for_static(2, [&](std::size_t begin, std::size_t end) { total += end - begin; });
+        CHECK(total == 2);
+
+        // Inline from a worker of the same pool
+        pool.submit([&]() {
+            pool.parallel_for_static(7, [&](std::size_t begin, std::size_t end) { total += end - begin; });
+        }).get();
+        CHECK(total == 9);
+    }
+
+    TEST_CASE("parallel_for_static rethrows and stays usable") {
+        ThreadPool pool(4);
+        CHECK_THROWS_AS(pool.parallel_for_static(8, [](std::size_t begin, std::size_t) {
+            if (begin == 2) {
+                throw std::runtime_error("block failed");
+            }
+        }), std::runtime_error);
+        std::atomic<std::size_t> total{0};
+        pool.parallel_for_static(8, [&](std::size_t begin, std::size_t end) { total += end - begin; });
+        CHECK(total == 8);
+    }
+
+    TEST_CASE("static blocks run once after a parallel_for") {
+        // A worker that registers for a parallel_for after the caller has
+        // finished it alone must not then run the following static job's
+        // block twice, or leave another worker's block unrun
+        ThreadPool pool(4, IdlePolicy::spin_then_park);
+        constexpr std::size_t n = 64;
+        std::vector<std::atomic<int>> runs(n);
+        std::atomic<std::size_t> total{0};
+        for (int round = 0; round < 2000; ++round) {
+            pool.parallel_for(8, 1, [&](std::size_t begin, std::size_t end) { total += end - begin; });
+            pool.parallel_for_static(n, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    runs[i].fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+        CHECK(total == 2000 * 8);
+        std::size_t wrong = 0;
+        for (const auto& count : runs) {
+            if (count.load() != 2000) {
+                ++wrong;
+            }
+        }
+        CHECK(wrong == 0);
+    }
+
+    TEST_CASE("a worker blocked in a task does not stall parallel_for_static") {
+        ThreadPool pool(2, ThreadAffinity::cores, CpuTopology::emulated(1, 2));
+        std::promise<void> release;
+        std::atomic<bool> started{false};
+        auto blocked = pool.submit([&, gate = release.get_future()]() {
+            started = true;
+            gate.wait();
+        });
+        while (!started) {
+            std::this_thread::yield();
+        }
+
+        // The blocked worker's block runs on the caller, the other on its worker
+        for (int round = 0; round < 50; ++round) {
+            std::vector<int> runs(100, 0);
+            std::atomic<int> on_caller{0};
+            pool.parallel_for_static(runs.size(), [&](std::size_t begin, std::size_t end) {
+                if (!pool.worker_index()) {
+                    on_caller.fetch_add(1);
+                }
+                for (std::size_t i = begin; i < end; ++i) {
+                    ++runs[i];
+                }
+            });
+            CHECK(runs == std::vector<int>(100, 1));
+            CHECK(on_caller.load() == 1);
+        }
+
+        // Once the task is over the worker runs its own block again
+        release.set_value();
+        blocked.get();
+        pool.wait_all();
+        std::atomic<int> on_caller{0};
+        pool.parallel_for_static(10, [&](std::size_t, std::size_t) {
+            if (!pool.worker_index()) {
+                on_caller.fetch_add(1);
+            }
+        });
+        CHECK(on_caller.load() == 0);
+    }
+
+    TEST_CASE("workers are pinned on an emulated topology") {
+        // Two nodes of two CPUs, laid over however many CPUs this machine has
+        const auto topology = CpuTopology::emulated(2, 2);
+        for (auto affinity : {ThreadAffinity::cores, ThreadAffinity::nodes}) {
+            ThreadPool pool(4, affinity, topology);
+            CHECK(pool.affinity() == affinity);
+            for (std::size_t i = 0; i < 4; ++i) {
+                CHECK(pool.worker_node(i) == i / 2);
+                const auto cpus = pool.worker_cpus(i);
+                const auto& node_cpus = topology.nodes()[i / 2].cpus;
+                if (affinity == ThreadAffinity::cores) {
+                    REQUIRE(cpus.size() == 1);
+                    CHECK(cpus[0] == node_cpus[i % 2]);
+                } else {
+                    CHECK(std::vector<unsigned>(cpus.begin(), cpus.end()) == node_cpus);
+                }
+            }
+
+            // Each worker's affinity mask as the kernel reports it
+            std::vector<std::vector<unsigned>> masks(4);
+            pool.parallel_for_static(4, [&](std::size_t begin, std::size_t) {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                REQUIRE(sched_getaffinity(0, sizeof(set), &set) == 0);
+                for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                    if (CPU_ISSET(cpu, &set)) {
+                        masks[begin].push_back(cpu);
+                    }
+                }
+            });
+            for (std::size_t i = 0; i < 4; ++i) {
+                auto expected = std::vector<unsigned>(pool.worker_cpus(i).begin(), pool.worker_cpus(i).end());
+                std::sort(expected.begin(), expected.end());
+                expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+                CHECK(masks[i] == expected);
+            }
+            CHECK(pool.submit([]() { return 5; }).get() == 5);
+        }
+
+        // More workers than nodes and CPUs: blocks per node, CPUs reused
+        ThreadPool wide(5, ThreadAffinity::cores, CpuTopology::emulated(3, 1));
+        CHECK(wide.worker_node(0) == 0);
+        CHECK(wide.worker_node(1) == 0);
+        CHECK(wide.worker_node(2) == 1);
+        CHECK(wide.worker_node(3) == 1);
+        CHECK(wide.worker_node(4) == 2);
+
+        ThreadPool unpinned(2);
+        CHECK(unpinned.affinity() == ThreadAffinity::none);
+        CHECK(unpinned.worker_cpus(0).empty());
+    }
+}
+
+TEST_SUITE("Task") {
+    TEST_CASE("small callables are stored inline") {
+        int calls = 0;
+        Task task([&calls]() { ++calls; });
+        CHECK(Task::fits_inline<decltype([&calls]() { ++calls; })>);
+        task();
+        Task moved(std::move(task));
+        CHECK_FALSE(static_cast<bool>(task));
+        moved();
+        CHECK(calls == 2);
+    }
+
+    TEST_CASE("large callables fall back to the heap") {
+        std::array<double, 32> payload{};
+        payload[31] = 7.0;
+        double seen = 0.0;
+        Task task([payload, &seen]() { seen = payload[31]; });
+        CHECK_FALSE(Task::fits_inline<decltype([payload, &seen]() { seen = payload[31]; })>);
+        Task other;
+        other = std::move(task);
+        other();
+        CHECK(seen == 7.0);
+    }
+
+    TEST_CASE("move-only captures are destroyed once") {
+        auto counter = std::make_shared<int>(0);
+        {
+            Task task([owned = std::make_unique<int>(1), counter]() { ++*counter; });
+            CHECK(counter.use_count() == 2);
+            Task moved(std::move(task));
+            moved();
+            CHECK(counter.use_count() == 2);
+        }
+        CHECK(*counter == 1);
+        CHECK(counter.use_count() == 1);
+    }
+}
+
+TEST_SUITE("WorkStealingDeque") {
+    TEST_CASE("owner pops newest, thieves steal oldest") {
+        WorkStealingDeque<int> deque(4);
+        for (int i = 0; i < 4; ++i) {
+            CHECK(deque.push(i));
+        }
+        int extra = 9;
+        CHECK_FALSE(deque.push(extra));
+        CHECK(extra == 9);
+
+        CHECK(deque.pop() == 3);
+        CHECK(deque.steal() == 0);
+        CHECK(deque.steal() == 1);
+        CHECK(deque.pop() == 2);
+        CHECK_FALSE(deque.pop().has_value());
+        CHECK_FALSE(deque.steal().has_value());
+
+        // Wraps around the ring
+        for (int i = 10; i < 14; ++i) {
+            CHECK(deque.push(i));
+        }
+        CHECK(deque.size_hint() == 4);
+        CHECK(deque.steal() == 10);
+    }
+
+    TEST_CASE("concurrent steals take every element once") {
+        constexpr int count = 20000;
+        WorkStealingDeque<int> deque(256);
+        std::vector<std::atomic<int>> taken(count);
+        std::atomic<bool> done{false};
+
+        auto thief = [&]() {
+            while (!done.load(std::memory_order_acquire) || deque.size_hint() > 0) {
+                if (auto value = deque.steal()) {
+                    taken[static_cast<std::size_t>(*value)].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        };
+        std::vector<std::thread> thieves;
+        for (int i = 0; i < 3; ++i) {
+            thieves.emplace_back(thief);
+        }
+
+        for (int i = 0; i < count; ++i) {
+            int value = i;
+            while (!deque.push(value)) {
+                if (auto own = deque.pop()) {
+                    taken[static_cast<std::size_t>(*own)].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            if (i % 3 == 0) {
+                if (auto own = deque.pop()) {
+                    taken[static_cast<std::size_t>(*own)].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+        while (auto own = deque.pop()) {
+            taken[static_cast<std::size_t>(*own)].fetch_add(1, std::memory_order_relaxed);
+        }
+        done.store(true, std::memory_order_release);
+        for (auto& t : thieves) {
+            t.join();
+        }
+
+        std::size_t wrong = 0;
+        for (auto& t : taken) {
+            wrong += t.load() == 1 ? 0u : 1u;
+        }
+        CHECK(wrong == 0);
+    }
+}
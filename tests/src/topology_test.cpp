@@ -0,0 +1,84 @@
+#include <doctest/doctest.h>
+#include <sparse_linalg/execution/topology.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace sparse_linalg::execution;
+
+namespace {
+    // A fake /sys/devices/system/node tree, removed when the test ends
+    struct FakeSysfs {
+        std::filesystem::path root;
+
+        FakeSysfs()
+            : root(std::filesystem::temp_directory_path() /
+                   ("sparse_linalg_nodes_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()))) {
+            std::filesystem::create_directories(root);
+        }
+        ~FakeSysfs() {
+            std::error_code ignored;
+            std::filesystem::remove_all(root, ignored);
+        }
+
+        void add(const std::string& name, const std::string& cpulist) const {
+            std::filesystem::create_directories(root / name);
+            std::ofstream(root / name / "cpulist") << cpulist << '\n';
+        }
+    };
+}
+
+TEST_SUITE("CpuTopology") {
+    TEST_CASE("cpu lists") {
+        using detail::parse_cpu_list;
+        CHECK(parse_cpu_list("0") == std::vector<unsigned>{0});
+        CHECK(parse_cpu_list("0-3,8,10-11\n") == std::vector<unsigned>{0, 1, 2, 3, 8, 10, 11});
+        CHECK(parse_cpu_list("4,2-3,2") == std::vector<unsigned>{2, 3, 4});
+        CHECK(parse_cpu_list("").empty());
+        CHECK_THROWS_AS(static_cast<void>(parse_cpu_list("3-1")), std::invalid_argument);
+        CHECK_THROWS_AS(static_cast<void>(parse_cpu_list("1,,2")), std::invalid_argument);
+        CHECK_THROWS_AS(static_cast<void>(parse_cpu_list("a-b")), std::invalid_argument);
+    }
+
+    TEST_CASE("sysfs nodes restricted to allowed cpus") {
+        FakeSysfs sysfs;
+        sysfs.add("node1", "4-7");
+        sysfs.add("node0", "0-3");
+        sysfs.add("node2", "8-9");
+        sysfs.add("possible", "0-2");  // not a node directory
+        const std::vector<unsigned> allowed{1, 2, 5, 6, 7};
+
+        const auto nodes = detail::read_numa_nodes(sysfs.root, allowed);
+        REQUIRE(nodes.size() == 2);  // node2 has no allowed CPU
+        CHECK(nodes[0].id == 0);
+        CHECK(nodes[0].cpus == std::vector<unsigned>{1, 2});
+        CHECK(nodes[1].id == 1);
+        CHECK(nodes[1].cpus == std::vector<unsigned>{5, 6, 7});
+
+        CHECK(detail::read_numa_nodes(sysfs.root / "missing", allowed).empty());
+    }
+
+    TEST_CASE("detected topology covers the allowed cpus") {
+        const auto topology = CpuTopology::detect();
+        CHECK(topology.node_count() >= 1);
+        CHECK(topology.cpu_count() == detail::allowed_cpus().size());
+    }
+
+    TEST_CASE("emulated topology") {
+        const auto allowed = detail::allowed_cpus();
+        const auto topology = CpuTopology::emulated(3, 2);
+        REQUIRE(topology.node_count() == 3);
+        CHECK(topology.cpu_count() == 6);
+        for (std::size_t n = 0; n < 3; ++n) {
+            CHECK(topology.nodes()[n].id == n);
+            for (std::size_t k = 0; k < 2; ++k) {
+                CHECK(topology.nodes()[n].cpus[k] == allowed[(2 * n + k) % allowed.size()]);
+            }
+        }
+        CHECK_THROWS_AS(static_cast<void>(CpuTopology::emulated(0, 2)), std::invalid_argument);
+        CHECK_THROWS_AS(CpuTopology(std::vector<NumaNode>{{0, {}}}), std::invalid_argument);
+        CHECK_THROWS_AS(CpuTopology(std::vector<NumaNode>{}), std::invalid_argument);
+    }
+}
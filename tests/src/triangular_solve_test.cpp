@@ -0,0 +1,166 @@
+#include <doctest/doctest.h>
+#include "test_helpers.hpp"
+#include <sparse_linalg/core/matrix_generators.hpp>
+#include <sparse_linalg/core/sparse_matrix.hpp>
+#include <sparse_linalg/core/sparse_matrix_builder.hpp>
+#include <sparse_linalg/execution/thread_pool.hpp>
+#include <sparse_linalg/solvers/gmres.hpp>
+#include <sparse_linalg/solvers/triangular_solve.hpp>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+using namespace sparse_linalg;
+using namespace sparse_linalg::test;
+
+namespace {
+    // T x computed straight from the entries of A in the chosen triangle
+    template<typename Matrix>
+    std::vector<double> triangle_times(const Matrix& a, const std::vector<double>& x, TriangularSolveOptions options) {
+        const auto& data = a.raw_data();
+        std::vector<double> result(a.rows(), 0.0);
+        for (std::size_t row = 0; row < a.rows(); ++row) {
+            for (auto p = static_cast<std::size_t>(data.row_ptrs[row]); p < static_cast<std::size_t>(data.row_ptrs[row + 1]); ++p) {
+                const auto col = static_cast<std::size_t>(data.col_indices[p]);
+                const bool inside = options.triangle == Triangle::lower ? col < row : col > row;
+                if (inside || (col == row && options.diagonal == Diagonal::non_unit)) {
+                    result[row] += data.values[p] * x[col];
+                }
+            }
+            if (options.diagonal == Diagonal::unit) {
+                result[row] += x[row];
+            }
+        }
+        return result;
+    }
+}
+
+TEST_SUITE("TriangularSolver") {
+    TEST_CASE("solves every triangle and diagonal kind") {
+        execution::ThreadPool pool(4);
+        const auto a = make_strided(3000, 400);
+        const auto b = make_vector(a.rows());
+        for (auto triangle : {Triangle::lower, Triangle::upper}) {
+            for (auto diagonal : {Diagonal::non_unit, Diagonal::unit}) {
+                for (bool level_order : {false, true}) {
+                    const TriangularSolveOptions options{triangle, diagonal, level_order};
+                    const TriangularSolver<double> sequential(a, options);
+                    const TriangularSolver<double> parallel(a, pool, options);
+                    CHECK(sequential.size() == a.rows());
+                    CHECK(sequential.widest_level() >= 400);
+
+                    std::vector<double> x(a.rows(), 0.0);
+                    sequential.solve(b, x);
+                    check_close(triangle_times(a, x, options), b, 1e-10);
+
+                    // Same dependencies, same operation order: identical results
+                    std::vector<double> y(a.rows(), 0.0);
+                    parallel.solve(b, y);
+                    CHECK(y == x);
+                }
+            }
+        }
+    }
+
+    TEST_CASE("levels follow the dependencies") {
+        const auto tridiagonal = banded(50, 1, 1);
+        const TriangularSolver<double> chain(tridiagonal);
+        CHECK(chain.levels() == 50);
+        CHECK(chain.widest_level() == 1);
+        CHECK(chain.nnz() == 49);
+
+        // Only the diagonal: one level holding every row
+        const auto diagonal = banded(30, 0, 0);
+        const TriangularSolver<double> flat(diagonal, {Triangle::upper});
+        CHECK(flat.levels() == 1);
+        CHECK(flat.widest_level() == 30);
+        CHECK(flat.nnz() == 0);
+
+        const auto strided = make_strided(1000, 100);
+        const TriangularSolver<double> lower(strided, {Triangle::lower});
+        const TriangularSolver<double> upper(strided, {Triangle::upper});
+        CHECK(lower.levels() == 10);
+        CHECK(upper.levels() == 10);
+        CHECK(lower.widest_level() == 100);
+    }
+
+    TEST_CASE("unit diagonal needs no stored diagonal") {
+        SparseMatrixBuilder<double> builder(3, 3);
+        builder.add(1, 0, 2.0);
+        builder.add(2, 0, -1.0);
+        builder.add(2, 1, 3.0);
+        builder.add(0, 2, 7.0);  // upper triangle, ignored
+        const auto a = builder.build();
+        const TriangularSolver<double> solver(a, {Triangle::lower, Diagonal::unit});
+        std::vector<double> x(3);
+        solver.solve(std::vector<double>{1.0, 4.0, 2.0}, x);
+        CHECK(x == std::vector<double>{1.0, 2.0, -3.0});
+
+        CHECK_THROWS_AS(TriangularSolver<double>{a}, std::invalid_argument);
+    }
+
+    TEST_CASE("in place solve and numeric update") {
+        execution::ThreadPool pool(3);
+        auto a = make_strided(2000, 300);
+        const TriangularSolveOptions options{Triangle::upper, Diagonal::non_unit, true};
+        TriangularSolver<double> solver(a, pool, options);
+
+        const auto b = make_vector(a.rows());
+        std::vector<double> x = b;
+        solver.solve(x, x);
+        check_close(triangle_times(a, x, options), b, 1e-10);
+
+        for (auto& value : a.values()) {
+            value *= 2.0;
+        }
+        solver.update(a);
+        std::vector<double> half(a.rows());
+        solver.solve(b, half);
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            REQUIRE(half[i] == doctest::Approx(x[i] / 2.0));
+        }
+    }
+
+    TEST_CASE("index widths") {
+        const auto a = poisson_2d<double, std::uint32_t, std::uint64_t>(40, 30);
+        const TriangularSolveOptions options{Triangle::lower, Diagonal::non_unit, true};
+        const TriangularSolver<double, std::uint32_t, std::uint64_t> solver(a, options);
+        const auto b = make_vector(a.rows());
+        std::vector<double> x(a.rows());
+        solver.solve(b, x);
+        check_close(triangle_times(a, x, options), b, 1e-10);
+        // Anti-diagonals of the grid are the levels of a 5-point stencil
+        CHECK(solver.levels() == 40 + 30 - 1);
+    }
+
+    TEST_CASE("Gauss-Seidel preconditioned GMRES") {
+        const auto a = make_strided(2000, 50);
+        const auto b = make_vector(a.rows());
+        TriangularSolver<double> gauss_seidel(a, {Triangle::lower});
+        SolverOptions options;
+        options.tolerance = 1e-10;
+        Gmres<double> gmres(options);
+        std::vector<double> x(a.rows(), 0.0);
+        CHECK(gmres.solve(a, b, x, gauss_seidel).converged());
+    }
+
+    TEST_CASE("invalid input") {
+        CHECK_THROWS_AS(TriangularSolver<double>(SparseMatrix<double>(3, 4)), std::invalid_argument);
+
+        auto singular = banded(3, 1, 0);
+        singular.values()[2] = 0.0;  // diagonal of row 1
+        CHECK_THROWS_AS(TriangularSolver<double>{singular}, std::invalid_argument);
+
+        const auto a = banded(10, 1, 1);
+        TriangularSolver<double> solver(a);
+        std::vector<double> x(10);
+        CHECK_THROWS_AS(solver.solve(std::vector<double>(9), x), std::invalid_argument);
+        CHECK_THROWS_AS(solver.update(banded(10, 2, 1)), std::invalid_argument);
+
+        const TriangularSolver<double> empty(SparseMatrix<double>(0, 0));
+        CHECK(empty.size() == 0);
+        CHECK(empty.levels() == 0);
+        empty.solve(std::span<const double>{}, std::span<double>{});
+    }
+}